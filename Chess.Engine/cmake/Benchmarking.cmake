@@ -0,0 +1,43 @@
+include(cpm)
+
+CPMAddPackage(
+        NAME benchmark
+        GITHUB_REPOSITORY google/benchmark
+        VERSION 1.9.1
+        SOURCE_DIR ${LIB_DIR}/benchmark
+        OPTIONS
+        "BENCHMARK_ENABLE_TESTING OFF"
+        "BENCHMARK_ENABLE_INSTALL OFF"
+        "BENCHMARK_ENABLE_GTEST_TESTS OFF"
+        "BENCHMARK_INSTALL_DOCS OFF"
+        )
+
+set(BENCHMARK_COMPARE_SCRIPT ${CMAKE_CURRENT_LIST_DIR}/../tests/Core.Benchmarks/compare_benchmarks.py)
+
+find_package(Python3 COMPONENTS Interpreter)
+
+macro(AddBenchmarks target)
+    message("Adding benchmarks to ${target}")
+    target_link_libraries(${target} PRIVATE benchmark::benchmark_main)
+
+    # Run the benchmarks and write the results as JSON next to the executable
+    add_custom_target(${target}.Run
+        COMMAND ${target} --benchmark_out=$<TARGET_FILE_DIR:${target}>/benchmark_results.json --benchmark_out_format=json
+        DEPENDS ${target}
+        COMMENT "Running ${target}"
+        USES_TERMINAL
+    )
+
+    # Compare the last results against the stored baseline (BENCHMARK_BASELINE), fails on regressions
+    if(Python3_Interpreter_FOUND)
+        set(BENCHMARK_BASELINE "${CMAKE_CURRENT_SOURCE_DIR}/baseline.json" CACHE FILEPATH "Benchmark results the comparison runs against")
+        set(BENCHMARK_THRESHOLD "10" CACHE STRING "Slowdown in percent that counts as a regression")
+
+        add_custom_target(${target}.Compare
+            COMMAND ${Python3_EXECUTABLE} ${BENCHMARK_COMPARE_SCRIPT} ${BENCHMARK_BASELINE} $<TARGET_FILE_DIR:${target}>/benchmark_results.json --threshold ${BENCHMARK_THRESHOLD}
+            DEPENDS ${target}.Run
+            COMMENT "Comparing ${target} against ${BENCHMARK_BASELINE}"
+            USES_TERMINAL
+        )
+    endif()
+endmacro()
@@ -5,10 +5,28 @@
   ==============================================================================
 */
 
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
 
+#include "BookBuilder.h"
 #include "Chessboard.h"
+#include "MaterialKey.h"
 #include "Moves/Generation/MoveGeneration.h"
+#include "Notation/MoveNotation.h"
+#include "Perft.h"
+#include "PonderBench.h"
+#include "SearchBench.h"
+#include "TablebaseGenerator.h"
+#include "TablebaseLayout.h"
+#include "TestSuite.h"
+
+
+static constexpr const char *START_POSITION = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
 
 
 static void printBitboard(U64 bitboard)
@@ -112,8 +130,409 @@ static void printAttackedSquares(MoveGeneration &gen, Side side)
 
 
 
-int main()
+static void printUsage()
+{
+	std::cout << "Usage: Chess.Engine.ConsoleApp [command] [options]\n"
+			  << "  (no command)               Print the squares attacked in the start position\n"
+			  << "  perft <depth> [fen]        Count the leaf nodes (start position by default)\n"
+			  << "  divide <depth> [fen]       Count the leaf nodes below every root move\n"
+			  << "  suite <file.epd> [depth]   Check every count of an EPD perft suite, up to the depth\n"
+			  << "  bench [depth]              Search the built-in bench positions (default depth " << SearchBenchOptions::DEFAULT_DEPTH << ")\n"
+			  << "  ponder [games] [ms]        Measure the ponder hit rate and reply latency in self-play (default " << PonderBenchOptions::DEFAULT_GAMES << " games, "
+			  << PonderBenchOptions::DEFAULT_MOVE_TIME_MS << " ms per move)\n"
+			  << "  solve <file.epd> [ms]      Solve a bm / am test suite, ms per position (default " << TestSuiteOptions::DEFAULT_MOVE_TIME_MS << ")\n"
+			  << "  book-build <pgn> <bin>     Build a Polyglot opening book from a PGN collection\n"
+			  << "  tablebase-generate <dir> <code>...\n"
+			  << "                             Generate Syzygy tables (.rtbw/.rtbz) like KQvK into the directory (smallest first)\n\n"
+			  << "  --threads <n>              Perft / solve worker threads (default all cores)\n"
+			  << "  --hash <mb>                Perft node count cache size (default 64, 0 disables it)\n"
+			  << "  --nodes <n>                Bench / solve: search n nodes per position instead of a fixed depth / time\n"
+			  << "  --json <file>              Bench / solve: also write the results as JSON\n"
+			  << "  --min-games <n>            Book: games a move needs to enter the book (default 3)\n"
+			  << "  --max-ply <n>              Book: plies of every game that enter the book (default 30)\n"
+			  << "  --memory <mb>              Book: memory for counting before sorted runs are spilled to disk\n"
+			  << "  --merge-runs <n>           Book: run files merged at once (default 64)\n";
+}
+
+
+static void printPerftResult(const PerftResult &result)
+{
+	printf("Nodes: %llu\n", static_cast<unsigned long long>(result.nodes));
+	printf("Time:  %.3f s (%.2f Mnps, %llu hash hits)\n", result.seconds, result.nodesPerSecond() / 1e6, static_cast<unsigned long long>(result.hashHits));
+}
+
+
+static void printPerftCheck(const PerftCheck &check)
+{
+	if (!check.parsed)
+	{
+		printf("BAD  line %d is no perft entry: %s\n", check.line, check.fen.c_str());
+		return;
+	}
+
+	if (!check.result.valid)
+	{
+		printf("BAD  invalid position %s\n", check.fen.c_str());
+		return;
+	}
+
+	printf("%s D%d %llu %s (%.2f Mnps)\n", check.passed() ? "ok  " : "FAIL", check.depth, static_cast<unsigned long long>(check.result.nodes), check.fen.c_str(),
+		   check.result.nodesPerSecond() / 1e6);
+}
+
+
+static int runPerft(Perft &perft, const std::vector<std::string> &args, bool divide)
+{
+	if (args.size() < 2)
+	{
+		printUsage();
+		return 1;
+	}
+
+	int			depth = std::atoi(args[1].c_str());
+	std::string fen;
+
+	// The FEN may be passed quoted or as separate fields
+	for (size_t i = 2; i < args.size(); ++i)
+		fen += (fen.empty() ? "" : " ") + args[i];
+
+	if (fen.empty())
+		fen = START_POSITION;
+
+	if (!divide)
+	{
+		PerftResult result = perft.run(fen, depth);
+
+		if (!result.valid)
+		{
+			printf("Invalid position %s\n", fen.c_str());
+			return 1;
+		}
+
+		printPerftResult(result);
+		return 0;
+	}
+
+	std::vector<PerftDivideEntry> entries;
+	PerftResult					  result = perft.divide(fen, depth, entries);
+
+	if (!result.valid)
+	{
+		printf("Invalid position %s\n", fen.c_str());
+		return 1;
+	}
+
+	for (const auto &entry : entries)
+		printf("%s: %llu\n", MoveNotation::toUCI(entry.move).c_str(), static_cast<unsigned long long>(entry.nodes));
+
+	printf("\nMoves: %zu\n", entries.size());
+	printPerftResult(result);
+	return 0;
+}
+
+
+static int runPerftSuite(Perft &perft, const std::vector<std::string> &args)
+{
+	if (args.size() < 2)
+	{
+		printUsage();
+		return 1;
+	}
+
+	int						maxDepth = args.size() > 2 ? std::atoi(args[2].c_str()) : 0;
+
+	std::vector<PerftCheck> checks;
+	bool					passed = perft.runSuite(args[1], maxDepth, checks, printPerftCheck);
+
+	uint64_t				nodes	  = 0;
+	double					seconds	  = 0.0;
+	size_t					failures  = 0;
+	size_t					invalid	  = 0;
+	size_t					malformed = 0;
+
+	for (const auto &check : checks)
+	{
+		nodes += check.result.nodes;
+		seconds += check.result.seconds;
+		failures += check.passed() || !check.result.valid ? 0 : 1;
+		invalid += check.result.valid || !check.parsed ? 0 : 1;
+		malformed += check.parsed ? 0 : 1;
+	}
+
+	printf("\n%zu checks, %zu failed, %zu invalid positions, %zu malformed lines, %llu nodes in %.3f s (%.2f Mnps)\n", checks.size(), failures, invalid, malformed,
+		   static_cast<unsigned long long>(nodes), seconds, seconds > 0.0 ? nodes / seconds / 1e6 : 0.0);
+
+	return passed ? 0 : 1;
+}
+
+
+static void printBenchPosition(const SearchBenchPosition &position)
+{
+	printf("%-72s %-6s %10llu nodes %8.3f s\n", position.fen.c_str(), MoveNotation::toUCI(position.bestMove).c_str(), static_cast<unsigned long long>(position.nodes),
+		   position.seconds);
+}
+
+
+static int runBench(const std::vector<std::string> &args, uint64_t nodeLimit, const std::string &jsonPath)
+{
+	SearchBenchOptions options;
+	options.nodeLimit = nodeLimit;
+
+	if (args.size() > 1)
+		options.depth = std::atoi(args[1].c_str());
+
+	if (options.depth <= 0)
+	{
+		printUsage();
+		return 1;
+	}
+
+	SearchBenchResult result = SearchBench::run(options, printBenchPosition);
+
+	printf("\n===========================\n");
+	printf("Positions : %zu\n", result.positions.size());
+	printf("Total time: %.0f ms\n", result.seconds * 1000.0);
+	printf("Nodes     : %llu\n", static_cast<unsigned long long>(result.signature()));
+	printf("Nodes/s   : %.0f\n", result.nodesPerSecond());
+
+	if (jsonPath.empty())
+		return 0;
+
+	std::ofstream file(jsonPath);
+
+	if (!(file << result.toJson() << "\n"))
+	{
+		std::cout << "Could not write " << jsonPath << "\n";
+		return 1;
+	}
+
+	std::cout << "Wrote " << jsonPath << "\n";
+	return 0;
+}
+
+
+static int runPonderBench(const std::vector<std::string> &args)
+{
+	PonderBenchOptions options;
+
+	if (args.size() > 1)
+		options.games = std::atoi(args[1].c_str());
+
+	if (args.size() > 2)
+		options.moveTimeMs = std::atoi(args[2].c_str());
+
+	if (options.games <= 0 || options.moveTimeMs <= 0)
+	{
+		printUsage();
+		return 1;
+	}
+
+	PonderBenchResult result = PonderBench::run(options);
+
+	printf("Games     : %d per run, %d ms per move\n", options.games, options.moveTimeMs);
+	printf("Hit rate  : %.1f %% (%d hits, %d misses, %d replies already searched)\n", result.ponder.hitRate() * 100.0, result.ponder.hits, result.ponder.misses,
+		   result.ponder.instantReplies);
+	printf("Latency   : %.1f ms pondering (%d replies), %.1f ms without (%d replies)\n", result.pondering.meanLatencyMs(), result.pondering.replies,
+		   result.baseline.meanLatencyMs(), result.baseline.replies);
+	printf("Saved     : %.1f %% of the reply latency\n", result.latencyReduction() * 100.0);
+	printf("Time      : %.1f s\n", result.seconds);
+	return 0;
+}
+
+
+static void printSolvedPosition(const TestSuitePositionResult &position)
+{
+	printf("%-12s %-6s %-4s depth %2d/%2d %10llu nodes %8.3f s\n", position.id.empty() ? "-" : position.id.c_str(), MoveNotation::toUCI(position.move).c_str(),
+		   position.solved ? "ok" : "FAIL", position.solveDepth, position.depth, static_cast<unsigned long long>(position.solveNodes), position.solveSeconds);
+}
+
+
+static int runTestSuite(const std::vector<std::string> &args, int threads, uint64_t nodeLimit, const std::string &jsonPath)
+{
+	if (args.size() < 2)
+	{
+		printUsage();
+		return 1;
+	}
+
+	TestSuite suite;
+
+	if (!suite.load(args[1]))
+	{
+		std::cout << "Could not load " << args[1] << "\n";
+		return 1;
+	}
+
+	TestSuiteOptions options;
+	options.threads	   = threads;
+	options.nodeLimit  = nodeLimit;
+	options.moveTimeMs = nodeLimit > 0 ? 0 : TestSuiteOptions::DEFAULT_MOVE_TIME_MS;
+
+	if (args.size() > 2)
+		options.moveTimeMs = std::atoi(args[2].c_str());
+
+	if (options.moveTimeMs <= 0 && options.nodeLimit == 0)
+	{
+		printUsage();
+		return 1;
+	}
+
+	TestSuiteResult result = suite.run(options, printSolvedPosition);
+
+	printf("\n===========================\n");
+	printf("Solved    : %zu / %zu\n", result.solvedCount(), result.positions.size());
+	printf("Total time: %.0f ms\n", result.seconds * 1000.0);
+
+	for (double p : {50.0, 90.0, 100.0})
+	{
+		printf("p%-3.0f      : %.3f s, %llu nodes to solution\n", p, result.solveSecondsPercentile(p), static_cast<unsigned long long>(result.solveNodesPercentile(p)));
+	}
+
+	if (jsonPath.empty())
+		return 0;
+
+	std::ofstream file(jsonPath);
+
+	if (!(file << result.toJson() << "\n"))
+	{
+		std::cout << "Could not write " << jsonPath << "\n";
+		return 1;
+	}
+
+	std::cout << "Wrote " << jsonPath << "\n";
+	return 0;
+}
+
+
+static int runBookBuild(const std::vector<std::string> &args, const BookBuildOptions &options)
+{
+	if (args.size() < 3)
+	{
+		printUsage();
+		return 1;
+	}
+
+	BookBuildResult result;
+
+	if (!BookBuilder::build(args[1], args[2], options, result))
+	{
+		std::cout << "Could not build " << args[2] << "\n";
+		return 1;
+	}
+
+	printf("Games     : %zu (%zu skipped, %zu with a broken move)\n", result.games, result.skippedGames, result.brokenGames);
+	printf("Positions : %llu moves counted, %zu spilled runs, %zu merge passes\n", static_cast<unsigned long long>(result.samples), result.spilledRuns,
+		   result.mergePasses);
+	printf("Entries   : %zu\n", result.entries);
+	printf("Time      : %.3f s\n", result.seconds);
+	return 0;
+}
+
+
+static int runTablebaseGenerate(const std::vector<std::string> &args)
+{
+	if (args.size() < 3)
+	{
+		printUsage();
+		return 1;
+	}
+
+	// Captures lead into tables with fewer pieces and promotions into tables with fewer pawns, which have to exist first
+	auto order = [](const std::string &code)
+	{
+		uint64_t key = MaterialKey::fromCode(code);
+		return std::make_pair(TablebaseLayout(key).pieceCount(), MaterialKey::count(key, WPawn) + MaterialKey::count(key, BPawn));
+	};
+
+	std::vector<std::string> codes(args.begin() + 2, args.end());
+	std::stable_sort(codes.begin(), codes.end(), [&](const std::string &a, const std::string &b) { return order(a) < order(b); });
+
+	for (const std::string &code : codes)
+	{
+		TablebaseGenerationResult result;
+
+		if (!TablebaseGenerator::generate(args[1], code, result))
+		{
+			std::cout << "Could not generate " << code << "\n";
+			return 1;
+		}
+
+		printf("%-8s %zu positions: %zu wins, %zu draws, %zu losses, longest dtz %d (%.3f s)\n", code.c_str(), result.positions, result.wins, result.draws, result.losses,
+			   result.maxDtz, result.seconds);
+	}
+
+	return 0;
+}
+
+
+int main(int argc, char *argv[])
 {
+	std::vector<std::string> args;
+	int						 threads   = 0;
+	size_t					 hashMb	   = 64;
+	uint64_t				 nodeLimit = 0;
+	std::string				 jsonPath;
+	BookBuildOptions		 bookOptions;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg = argv[i];
+
+		if (arg == "--threads" && i + 1 < argc)
+			threads = std::atoi(argv[++i]);
+		else if (arg == "--hash" && i + 1 < argc)
+			hashMb = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--nodes" && i + 1 < argc)
+			nodeLimit = std::strtoull(argv[++i], nullptr, 10);
+		else if (arg == "--json" && i + 1 < argc)
+			jsonPath = argv[++i];
+		else if (arg == "--min-games" && i + 1 < argc)
+			bookOptions.minGames = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+		else if (arg == "--max-ply" && i + 1 < argc)
+			bookOptions.maxPly = std::atoi(argv[++i]);
+		else if (arg == "--memory" && i + 1 < argc)
+			bookOptions.maxEntries = BookBuildOptions::entriesForMegabytes(std::strtoull(argv[++i], nullptr, 10));
+		else if (arg == "--merge-runs" && i + 1 < argc)
+			bookOptions.maxMergeRuns = std::strtoull(argv[++i], nullptr, 10);
+		else
+			args.push_back(arg);
+	}
+
+	if (!args.empty() && args[0] == "bench")
+		return runBench(args, nodeLimit, jsonPath);
+
+	if (!args.empty() && args[0] == "ponder")
+		return runPonderBench(args);
+
+	if (!args.empty() && args[0] == "solve")
+		return runTestSuite(args, threads, nodeLimit, jsonPath);
+
+	if (!args.empty() && args[0] == "book-build")
+	{
+		bookOptions.threads = threads;
+		return runBookBuild(args, bookOptions);
+	}
+
+	if (!args.empty() && args[0] == "tablebase-generate")
+		return runTablebaseGenerate(args);
+
+	if (!args.empty())
+	{
+		Perft perft(threads, hashMb);
+
+		if (args[0] == "perft")
+			return runPerft(perft, args, false);
+
+		if (args[0] == "divide")
+			return runPerft(perft, args, true);
+
+		if (args[0] == "suite")
+			return runPerftSuite(perft, args);
+
+		printUsage();
+		return 1;
+	}
+
 	std::cout << "Console app starting..\n";
 
 	Chessboard	   *board	   = new Chessboard();
@@ -0,0 +1,126 @@
+/*
+  ==============================================================================
+	Module:         PonderBench
+	Description:    Self-play measurement of the ponder hit rate and reply latency
+  ==============================================================================
+*/
+
+#include "PonderBench.h"
+
+#include <chrono>
+#include <future>
+#include <memory>
+
+#include "GameEngine.h"
+#include "SearchBench.h"
+
+
+namespace
+{
+
+using Clock				 = std::chrono::steady_clock;
+
+// The first bench positions are openings, the games start from them in turn
+constexpr size_t OPENINGS			 = 8;
+
+// Iterative deepening cap, the move time ends the search first
+constexpr int	 TIME_LIMITED_DEPTH = 64;
+
+constexpr int	 FIFTY_MOVE_PLIES	 = 100;
+
+
+CPUConfiguration benchConfiguration(const PonderBenchOptions &options, Side side, bool ponder)
+{
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.cpuColor			   = side;
+	config.difficulty		   = CPUDifficulty::Hard;
+	config.maxDepth			   = TIME_LIMITED_DEPTH;
+	config.moveTimeMs		   = options.moveTimeMs;
+	config.enableRandomization = false;
+	config.enablePondering	   = ponder;
+	return config;
+}
+
+
+/**
+ * @brief	Play the games of one run and time the replies of the player that moves first.
+ */
+PonderBenchRun playGames(const PonderBenchOptions &options, bool ponder, PonderStatistics &statistics)
+{
+	PonderBenchRun run;
+
+	GameEngine	   engine;
+	engine.init();
+
+	CPUPlayer player(engine);
+	CPUPlayer opponent(engine);
+
+	for (int game = 0; game < options.games; ++game)
+	{
+		engine.resetGame();
+		engine.getBoard().parseFEN(SearchBench::positions()[game % OPENINGS]);
+
+		Side side = engine.getBoard().getCurrentSide();
+		player.configure(benchConfiguration(options, side, ponder));
+		opponent.configure(benchConfiguration(options, side == Side::White ? Side::Black : Side::White, false));
+
+		Move opponentMove{};
+
+		for (int ply = 0; ply < options.maxPlies && engine.getBoard().getHalfMoveClock() < FIFTY_MOVE_PLIES; ++ply)
+		{
+			MoveList legalMoves;
+			engine.generateLegalMoves(legalMoves);
+
+			if (legalMoves.size() == 0)
+				break;
+
+			if (engine.getBoard().getCurrentSide() != side)
+			{
+				opponentMove = opponent.calculateMove();
+				engine.makeMove(opponentMove);
+				continue;
+			}
+
+			// The reply arrives on the search thread, like it does for the UI
+			auto reply	  = std::make_shared<std::promise<Move>>();
+			auto future	  = reply->get_future();
+			auto callback = [reply](Move move) { reply->set_value(move); };
+
+			auto start	  = Clock::now();
+
+			if (!opponentMove.isValid() || !player.ponderHit(opponentMove, callback))
+				player.calculateMoveAsync(callback);
+
+			Move move = future.get();
+			run.latencyMs += std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			++run.replies;
+
+			engine.makeMove(move);
+			player.startPondering();
+		}
+
+		player.stopPondering();
+	}
+
+	statistics = player.getPonderStatistics();
+	return run;
+}
+
+} // namespace
+
+
+PonderBenchResult PonderBench::run(const PonderBenchOptions &options)
+{
+	PonderBenchResult result;
+	result.options = options;
+
+	auto			 start = Clock::now();
+	PonderStatistics withoutPondering;
+
+	result.pondering = playGames(options, true, result.ponder);
+	result.baseline	 = playGames(options, false, withoutPondering);
+	result.seconds	 = std::chrono::duration<double>(Clock::now() - start).count();
+
+	return result;
+}
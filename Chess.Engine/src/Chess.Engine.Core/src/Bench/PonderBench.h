@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+	Module:         PonderBench
+	Description:    Self-play measurement of the ponder hit rate and reply latency
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#include "CPUPlayer.h"
+
+
+struct PonderBenchOptions
+{
+	static constexpr int DEFAULT_GAMES		  = 8;
+	static constexpr int DEFAULT_MOVE_TIME_MS = 200;
+
+	int					 games				  = DEFAULT_GAMES;		  // Games per run, starting from the bench openings in turn
+	int					 moveTimeMs			  = DEFAULT_MOVE_TIME_MS; // Search time of both players per move
+	int					 maxPlies			  = 60;					  // Plies after which a game is stopped
+};
+
+
+struct PonderBenchRun
+{
+	int	   replies	 = 0;	// Moves of the measured player
+	double latencyMs = 0.0; // Time from the opponent's move to the measured player's reply, summed
+
+	double meanLatencyMs() const { return replies > 0 ? latencyMs / replies : 0.0; }
+};
+
+
+struct PonderBenchResult
+{
+	PonderBenchOptions options;
+	PonderBenchRun	   pondering; // The measured player ponders on the opponent's time
+	PonderBenchRun	   baseline;  // The same games without pondering
+	PonderStatistics   ponder;	  // Predictions of the pondering run
+	double			   seconds = 0.0;
+
+	/**
+	 * @brief	Share of the baseline reply latency saved by pondering (0.4 = replies 40 % faster).
+	 */
+	double			   latencyReduction() const
+	{
+		return baseline.meanLatencyMs() > 0.0 ? 1.0 - pondering.meanLatencyMs() / baseline.meanLatencyMs() : 0.0;
+	}
+};
+
+
+/**
+ * @brief	Plays CPU games twice, once with the side to move in the opening pondering and once without,
+ *			and times every reply of that side from the opponent's move on, like a player waiting for it.
+ *			The opponent searches with the same move time and never ponders. Time-limited searches make
+ *			the games differ between machines and runs, so the numbers are a measurement, not a signature.
+ */
+class PonderBench
+{
+public:
+	static PonderBenchResult run(const PonderBenchOptions &options);
+};
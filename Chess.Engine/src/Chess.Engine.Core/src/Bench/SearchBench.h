@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+	Module:         SearchBench
+	Description:    Deterministic search benchmark over a fixed set of positions
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Move.h"
+
+
+struct SearchBenchOptions
+{
+	static constexpr int DEFAULT_DEPTH = 5;
+
+	int					 depth		   = DEFAULT_DEPTH; // Fixed search depth (ignored if a node limit is set)
+	uint64_t			 nodeLimit	   = 0;				// Nodes per position instead of a fixed depth, 0 for none
+};
+
+
+struct SearchBenchPosition
+{
+	std::string fen;
+	uint64_t	nodes	 = 0;
+	double		seconds	 = 0.0;
+	Move		bestMove = {};
+};
+
+
+struct SearchBenchResult
+{
+	SearchBenchOptions				 options;
+	std::vector<SearchBenchPosition> positions;
+	uint64_t						 nodes	 = 0;
+	double							 seconds = 0.0;
+
+	/**
+	 * @brief	Total node count. It only depends on the search and evaluation code, never on the machine
+	 *			or the timing, so any change of it means the search behaves differently.
+	 */
+	uint64_t						 signature() const { return nodes; }
+
+	double							 nodesPerSecond() const { return seconds > 0.0 ? static_cast<double>(nodes) / seconds : 0.0; }
+
+	/**
+	 * @brief	Options, totals and per-position results as a JSON document (for dashboards).
+	 */
+	[[nodiscard]] std::string		 toJson() const;
+};
+
+
+/**
+ * @brief	Searches a built-in set of positions (openings, middlegames, endgames) one after the other,
+ *			single threaded, with the strongest CPU level and a transposition table cleared before
+ *			every position. Without time limits and randomization the node counts are reproducible.
+ */
+class SearchBench
+{
+public:
+	/**
+	 * @brief	The built-in positions.
+	 */
+	[[nodiscard]] static const std::vector<std::string_view> &positions();
+
+	/**
+	 * @param	onPosition	Called after every searched position (optional).
+	 */
+	static SearchBenchResult run(const SearchBenchOptions &options, const std::function<void(const SearchBenchPosition &)> &onPosition = nullptr);
+};
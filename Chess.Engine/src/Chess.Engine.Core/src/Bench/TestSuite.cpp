@@ -0,0 +1,360 @@
+/*
+  ==============================================================================
+	Module:         TestSuite
+	Description:    Solves EPD test suites (bm / am) and measures the time to solution
+  ==============================================================================
+*/
+
+#include "TestSuite.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include <nlohmann/json.hpp>
+
+#include "CPUPlayer.h"
+#include "GameEngine.h"
+#include "Logging.h"
+#include "Notation/MoveNotation.h"
+
+
+using json = nlohmann::json;
+
+
+namespace
+{
+
+/**
+ * @brief	Resolve SAN moves (or UCI moves, which some suites use) to legal moves.
+ * @return	false if one of them is no legal move.
+ */
+bool resolveMoves(const std::vector<std::string> &written, const Chessboard &board, const MoveList &legalMoves, std::vector<Move> &moves)
+{
+	for (const auto &text : written)
+	{
+		Move move = MoveNotation::fromSAN(text, board, legalMoves);
+
+		if (!move.isValid())
+		{
+			for (Move legal : legalMoves)
+			{
+				if (MoveNotation::toUCI(legal) == text)
+					move = legal;
+			}
+		}
+
+		if (!move.isValid())
+			return false;
+
+		moves.push_back(move);
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief	Nearest rank percentile of sorted values.
+ */
+template <typename T>
+T percentile(const std::vector<T> &sorted, double p)
+{
+	if (sorted.empty())
+		return T{};
+
+	double rank	 = std::ceil(std::clamp(p, 0.0, 100.0) / 100.0 * static_cast<double>(sorted.size()));
+	size_t index = rank < 1.0 ? 0 : static_cast<size_t>(rank) - 1;
+
+	return sorted[std::min(index, sorted.size() - 1)];
+}
+
+} // namespace
+
+
+bool TestSuiteEntry::isCorrect(Move move) const
+{
+	if (!move.isValid())
+		return false;
+
+	if (!bestMoves.empty() && std::find(bestMoves.begin(), bestMoves.end(), move) == bestMoves.end())
+		return false;
+
+	return std::find(avoidMoves.begin(), avoidMoves.end(), move) == avoidMoves.end();
+}
+
+
+bool TestSuite::load(const std::string &path)
+{
+	std::ifstream file(path);
+
+	if (!file)
+	{
+		LOG_ERROR("Could not open test suite {}", path);
+		return false;
+	}
+
+	mEntries.clear();
+
+	std::string line;
+
+	while (std::getline(file, line))
+	{
+		size_t first = line.find_first_not_of(" \t\r");
+
+		if (first == std::string::npos || line[first] == '#')
+			continue;
+
+		add(line);
+	}
+
+	if (mEntries.empty())
+	{
+		LOG_ERROR("{} holds no usable test position", path);
+		return false;
+	}
+
+	LOG_INFO("Loaded {} test positions from {}", mEntries.size(), path);
+	return true;
+}
+
+
+bool TestSuite::add(std::string_view line)
+{
+	TestSuiteEntry entry;
+	FenError	   error = Epd::parse(line, entry.record);
+
+	if (error == FenError::None)
+		error = Fen::validate(entry.record.position);
+
+	if (error != FenError::None)
+	{
+		LOG_WARNING("Skipped test position ({}): {}", Fen::errorMessage(error), line);
+		return false;
+	}
+
+	if (entry.record.bestMoves.empty() && entry.record.avoidMoves.empty())
+	{
+		LOG_WARNING("Skipped test position without bm or am: {}", line);
+		return false;
+	}
+
+	GameEngine engine;
+	engine.init();
+	engine.getBoard().setPosition(entry.record.position);
+
+	MoveList legalMoves;
+	engine.generateLegalMoves(legalMoves);
+
+	if (!resolveMoves(entry.record.bestMoves, engine.getBoard(), legalMoves, entry.bestMoves) ||
+		!resolveMoves(entry.record.avoidMoves, engine.getBoard(), legalMoves, entry.avoidMoves))
+	{
+		LOG_WARNING("Skipped test position with an illegal bm or am move: {}", line);
+		return false;
+	}
+
+	mEntries.push_back(std::move(entry));
+	return true;
+}
+
+
+TestSuiteResult TestSuite::run(const TestSuiteOptions &options, const std::function<void(const TestSuitePositionResult &)> &onPosition) const
+{
+	using Clock = std::chrono::steady_clock;
+
+	TestSuiteResult result;
+	result.options = options;
+	result.positions.resize(mEntries.size());
+
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.difficulty		   = CPUDifficulty::Hard;
+	config.maxDepth			   = options.maxDepth;
+	config.nodeLimit		   = options.nodeLimit;
+	config.moveTimeMs		   = options.moveTimeMs;
+	config.hashMegabytes	   = options.hashMegabytes;
+	config.enableRandomization = false;
+	config.enablePondering	   = false;
+
+	unsigned threads = options.threads > 0 ? static_cast<unsigned>(options.threads) : std::max(1u, std::thread::hardware_concurrency());
+	threads			 = std::min<unsigned>(threads, static_cast<unsigned>(std::max<size_t>(1, mEntries.size())));
+
+	std::atomic<size_t> next{0};
+	std::mutex			reportMutex;
+	auto				start = Clock::now();
+
+	auto				work  = [&]()
+	{
+		GameEngine engine;
+		engine.init();
+
+		CPUPlayer cpu(engine);
+
+		// Time to solution, updated by every completed iteration of the running search
+		const TestSuiteEntry	*entry	  = nullptr;
+		TestSuitePositionResult *position = nullptr;
+		Clock::time_point		 searchStart;
+
+		cpu.setIterationCallback(
+			[&](const SearchInfo &info)
+			{
+				position->depth = std::max(position->depth, info.depth);
+
+				if (info.pvLength == 0)
+					return;
+
+				if (!entry->isCorrect(info.pv[0]))
+				{
+					position->solveDepth = 0;
+					return;
+				}
+
+				// Keep the first iteration of the current streak
+				if (position->solveDepth == 0)
+				{
+					position->solveSeconds = std::chrono::duration<double>(Clock::now() - searchStart).count();
+					position->solveNodes   = info.nodes;
+					position->solveDepth   = info.depth;
+				}
+			});
+
+		for (size_t index = next++; index < mEntries.size(); index = next++)
+		{
+			entry	 = &mEntries[index];
+			position = &result.positions[index];
+
+			position->id  = entry->record.id;
+			position->fen = Fen::toString(entry->record.position);
+
+			engine.resetGame();
+			engine.getBoard().setPosition(entry->record.position);
+
+			// Configuring clears the transposition table
+			cpu.configure(config);
+
+			searchStart		  = Clock::now();
+			position->move	  = cpu.calculateMove();
+			position->seconds = std::chrono::duration<double>(Clock::now() - searchStart).count();
+			position->nodes	  = cpu.getNodesSearched();
+
+			position->solved = entry->isCorrect(position->move);
+
+			if (!position->solved)
+			{
+				position->solveSeconds = 0.0;
+				position->solveNodes   = 0;
+				position->solveDepth   = 0;
+			}
+			else if (position->solveDepth == 0)
+			{
+				// No iteration finished (the limit ended the first one), the whole search counts
+				position->solveSeconds = position->seconds;
+				position->solveNodes   = position->nodes;
+			}
+
+			if (onPosition)
+			{
+				std::lock_guard<std::mutex> lock(reportMutex);
+				onPosition(*position);
+			}
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(threads);
+
+	for (unsigned t = 0; t < threads; ++t)
+		workers.emplace_back(work);
+
+	for (auto &worker : workers)
+		worker.join();
+
+	result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	return result;
+}
+
+
+size_t TestSuiteResult::solvedCount() const
+{
+	return static_cast<size_t>(std::count_if(positions.begin(), positions.end(), [](const TestSuitePositionResult &position) { return position.solved; }));
+}
+
+
+double TestSuiteResult::solveSecondsPercentile(double p) const
+{
+	std::vector<double> values;
+
+	for (const auto &position : positions)
+	{
+		if (position.solved)
+			values.push_back(position.solveSeconds);
+	}
+
+	std::sort(values.begin(), values.end());
+	return percentile(values, p);
+}
+
+
+uint64_t TestSuiteResult::solveNodesPercentile(double p) const
+{
+	std::vector<uint64_t> values;
+
+	for (const auto &position : positions)
+	{
+		if (position.solved)
+			values.push_back(position.solveNodes);
+	}
+
+	std::sort(values.begin(), values.end());
+	return percentile(values, p);
+}
+
+
+std::string TestSuiteResult::toJson() const
+{
+	json positionList = json::array();
+
+	for (const auto &position : positions)
+	{
+		positionList.push_back({
+			{"id", position.id},
+			{"fen", position.fen},
+			{"move", MoveNotation::toUCI(position.move)},
+			{"solved", position.solved},
+			{"solveSeconds", position.solveSeconds},
+			{"solveNodes", position.solveNodes},
+			{"solveDepth", position.solveDepth},
+			{"seconds", position.seconds},
+			{"nodes", position.nodes},
+			{"depth", position.depth},
+		});
+	}
+
+	json percentiles = json::object();
+
+	for (int p : {50, 90, 99})
+	{
+		percentiles["p" + std::to_string(p)] = {
+			{"seconds", solveSecondsPercentile(p)},
+			{"nodes", solveNodesPercentile(p)},
+		};
+	}
+
+	json document = {
+		{"threads", options.threads},
+		{"moveTimeMs", options.moveTimeMs},
+		{"nodeLimit", options.nodeLimit},
+		{"maxDepth", options.maxDepth},
+		{"positions", positionList},
+		{"total", positions.size()},
+		{"solved", solvedCount()},
+		{"timeToSolution", percentiles},
+		{"seconds", seconds},
+	};
+
+	return document.dump(2);
+}
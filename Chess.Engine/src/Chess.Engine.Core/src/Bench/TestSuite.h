@@ -0,0 +1,118 @@
+/*
+  ==============================================================================
+	Module:         TestSuite
+	Description:    Solves EPD test suites (bm / am) and measures the time to solution
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Epd.h"
+#include "Move.h"
+
+
+struct TestSuiteOptions
+{
+	static constexpr int DEFAULT_MOVE_TIME_MS = 1000;
+
+	int					 threads		   = 0;					   // Positions searched at once, 0 for all cores
+	int					 moveTimeMs		   = DEFAULT_MOVE_TIME_MS; // Time per position, 0 for no time limit
+	uint64_t			 nodeLimit		   = 0;					   // Nodes per position, 0 for none
+	int					 maxDepth		   = 64;
+	size_t				 hashMegabytes	   = 16;				   // Transposition table of every worker
+};
+
+
+/**
+ * @brief	A suite position with its bm / am moves resolved against the legal moves.
+ */
+struct TestSuiteEntry
+{
+	EpdRecord		  record;
+	std::vector<Move> bestMoves;
+	std::vector<Move> avoidMoves;
+
+	/**
+	 * @brief	The move is one of the best moves (if any are given) and none of the moves to avoid.
+	 */
+	bool			  isCorrect(Move move) const;
+};
+
+
+struct TestSuitePositionResult
+{
+	std::string id;
+	std::string fen;
+	Move		move		 = {};	 // Move played after the full search
+	bool		solved		 = false;
+	double		solveSeconds = 0.0; // When the move became best and stayed best (solved positions only)
+	uint64_t	solveNodes	 = 0;
+	int			solveDepth	 = 0;
+	double		seconds		 = 0.0; // Whole search
+	uint64_t	nodes		 = 0;
+	int			depth		 = 0;
+};
+
+
+struct TestSuiteResult
+{
+	TestSuiteOptions					 options;
+	std::vector<TestSuitePositionResult> positions; // In suite order
+	double								 seconds = 0.0; // Wall time of the run
+
+	size_t								 solvedCount() const;
+
+	/**
+	 * @brief	Time / nodes to solution below which p percent (0 - 100) of the solved positions were solved,
+	 *			nearest rank. 0 if nothing was solved.
+	 */
+	double								 solveSecondsPercentile(double p) const;
+	uint64_t							 solveNodesPercentile(double p) const;
+
+	/**
+	 * @brief	Options, totals, percentiles and per-position results as a JSON document.
+	 */
+	[[nodiscard]] std::string			 toJson() const;
+};
+
+
+/**
+ * @brief	Runs a suite like WAC or STS: every position is searched with the strongest CPU level under a
+ *			time or node limit, and counts as solved if the move played is a bm move and no am move.
+ *
+ * The positions are searched concurrently, one CPUPlayer (with its own transposition table) per worker
+ * thread. The time to solution is taken from the completed iterations: the point where the correct move
+ * became the first PV move and was not replaced by another move anymore.
+ */
+class TestSuite
+{
+public:
+	/**
+	 * @brief	Read an EPD file. Lines whose position is invalid, that have neither bm nor am, or whose moves
+	 *			don't resolve to legal moves are skipped with a warning.
+	 * @return	false if the file can't be read or holds no usable position.
+	 */
+	bool										load(const std::string &path);
+
+	/**
+	 * @brief	Add a single EPD line.
+	 * @return	false (logged) if the line is skipped.
+	 */
+	bool										add(std::string_view line);
+
+	/**
+	 * @param	onPosition	Called after every searched position, from the worker threads one at a time (optional).
+	 */
+	TestSuiteResult								run(const TestSuiteOptions &options, const std::function<void(const TestSuitePositionResult &)> &onPosition = nullptr) const;
+
+	[[nodiscard]] const std::vector<TestSuiteEntry> &entries() const { return mEntries; }
+
+private:
+	std::vector<TestSuiteEntry> mEntries;
+};
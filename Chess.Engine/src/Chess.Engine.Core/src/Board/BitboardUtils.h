@@ -55,4 +55,59 @@ inline constexpr int countBits(U64 bitboard)
 }
 
 
+//=========================================================================
+// Set-wise shifts and fills (a8 = bit 0, so north is towards bit 0)
+//=========================================================================
+
+inline constexpr U64 north(U64 bb)
+{
+	return bb >> 8;
+}
+
+inline constexpr U64 south(U64 bb)
+{
+	return bb << 8;
+}
+
+inline constexpr U64 east(U64 bb)
+{
+	return (bb << 1) & not_A_file;
+}
+
+inline constexpr U64 west(U64 bb)
+{
+	return (bb >> 1) & not_H_file;
+}
+
+inline constexpr U64 northFill(U64 bb)
+{
+	bb |= bb >> 8;
+	bb |= bb >> 16;
+	bb |= bb >> 32;
+	return bb;
+}
+
+inline constexpr U64 southFill(U64 bb)
+{
+	bb |= bb << 8;
+	bb |= bb << 16;
+	bb |= bb << 32;
+	return bb;
+}
+
+inline constexpr U64 fileFill(U64 bb)
+{
+	return northFill(bb) | southFill(bb);
+}
+
+/**
+ * @brief	Mirror the board vertically (rank 1 <-> rank 8), turning black's view into white's.
+ */
+inline constexpr U64 flipVertical(U64 bb)
+{
+	bb = ((bb >> 8) & 0x00FF00FF00FF00FFULL) | ((bb & 0x00FF00FF00FF00FFULL) << 8);
+	bb = ((bb >> 16) & 0x0000FFFF0000FFFFULL) | ((bb & 0x0000FFFF0000FFFFULL) << 16);
+	return (bb >> 32) | (bb << 32);
+}
+
 } // namespace BitUtils
@@ -9,6 +9,8 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "Logging.h"
+
 
 void Chessboard::init()
 {
@@ -29,95 +31,60 @@ void Chessboard::clear()
 	mHalfMoveClock	 = 0;
 	mMoveCounter	 = 0;
 	mHash			 = 0;
+	mPawnHash		 = 0;
+	mPieceScore		 = 0;
+	mPhase			 = 0;
+	mMaterialKey	 = 0;
+	mAccumulator	 = NNUEAccumulator{};
 }
 
 
-void Chessboard::parseFEN(std::string_view fen)
+bool Chessboard::parseFEN(std::string_view fen)
 {
-	clear();
+	FenPosition position;
+	FenError	error = Fen::parse(fen, position);
 
-	size_t i		  = 0;
+	if (error == FenError::None)
+		error = Fen::validate(position);
 
-	auto   skipSpaces = [&]()
+	if (error != FenError::None)
 	{
-		while (i < fen.size() && fen[i] == ' ')
-			++i;
-	};
-
-	// 1 Piece placement
-	int rank = 0;
-	int file = 0;
-
-	while (i < fen.size() && fen[i] != ' ')
-	{
-		char c = fen[i++];
-
-		if (c == '/')
-		{
-			++rank;
-			file = 0;
-			continue;
-		}
-
-		if (c >= '1' && c <= '8')
-		{
-			file += (c - '0');
-			continue;
-		}
-
-		if ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'))
-		{
-			int piece  = GetPieceTypeFromChar(c);
-			int square = rank * 8 + file;
-			BitUtils::setBit(mBitBoards[piece], square);
-			++file;
-		}
+		LOG_WARNING("Rejected FEN \"{}\": {}", std::string(fen), Fen::errorMessage(error));
+		return false;
 	}
 
-	skipSpaces();
-
-	// 2 Side to move
-	if (i <= fen.size())
-	{
-		mSide = (fen[i] == 'w') ? Side::White : Side::Black;
-		++i;
-	}
+	setPosition(position);
+	return true;
+}
 
-	skipSpaces();
 
-	// 3 Castling
-	while (i < fen.size() && fen[i] != ' ')
-	{
-		switch (fen[i])
-		{
-		case 'K': mCastlingRights |= Castling::WK; break;
-		case 'Q': mCastlingRights |= Castling::WQ; break;
-		case 'k': mCastlingRights |= Castling::BK; break;
-		case 'q': mCastlingRights |= Castling::BQ; break;
-		case '-': break;
-		}
-		++i;
-	}
+void Chessboard::setPosition(const FenPosition &position)
+{
+	clear();
 
-	skipSpaces();
+	mBitBoards		 = position.pieces;
+	mSide			 = position.side;
+	mCastlingRights	 = position.castling;
+	mEnPassantSquare = position.enPassant;
+	mHalfMoveClock	 = position.halfMoveClock;
+	mMoveCounter	 = position.fullMoveNumber;
 
-	// 4 En Passant
-	if (i < fen.size() && fen[i] != '-')
-	{
-		int epFile		 = fen[i + 0] - 'a';
-		int epRank		 = 8 - (fen[i + 1] - '0');
-		mEnPassantSquare = (Square)(epRank * 8 + epFile);
-	}
-	else
-	{
-		mEnPassantSquare = Square::None;
-	}
-
-	// 5 occupancies
 	updateOccupancies();
-
-	// 6 Compute hash
 	computeHash();
+	computePieceScore();
+}
+
+
+FenPosition Chessboard::getPosition() const
+{
+	FenPosition position;
+	position.pieces			= mBitBoards;
+	position.side			= mSide;
+	position.castling		= mCastlingRights;
+	position.enPassant		= mEnPassantSquare;
+	position.halfMoveClock	= static_cast<uint16_t>(std::clamp(mHalfMoveClock, 0, static_cast<int>(UINT16_MAX)));
+	position.fullMoveNumber = static_cast<uint16_t>(std::clamp(mMoveCounter, 1, static_cast<int>(UINT16_MAX)));
+	return position;
 }
 
 
@@ -130,6 +97,12 @@ void Chessboard::removePiece(PieceType piece, Square sq)
 
 	// Update hash
 	hashPiece(piece, sq);
+
+	// Update score
+	scorePiece(piece, sq, -1);
+
+	// Update NNUE accumulator
+	NNUE::updateAccumulator(mAccumulator, piece, sq, -1);
 }
 
 
@@ -142,6 +115,12 @@ void Chessboard::addPiece(PieceType piece, Square sq)
 
 	// update hash
 	hashPiece(piece, sq);
+
+	// update score
+	scorePiece(piece, sq, 1);
+
+	// update NNUE accumulator
+	NNUE::updateAccumulator(mAccumulator, piece, sq, 1);
 }
 
 
@@ -225,7 +204,7 @@ void Chessboard::setEnPassantSquare(Square sq) noexcept
 
 BoardState Chessboard::saveState() const
 {
-	return {mCastlingRights, mEnPassantSquare, mHalfMoveClock, PieceType::None, mHash};
+	return {mCastlingRights, mEnPassantSquare, mHalfMoveClock, PieceType::None, mHash, mPawnHash, mPieceScore, mPhase, mMaterialKey};
 }
 
 
@@ -235,12 +214,17 @@ void Chessboard::restoreState(const BoardState &state)
 	mEnPassantSquare = state.enPassant;
 	mHalfMoveClock	 = state.halfMoveClock;
 	mHash			 = state.hash;
+	mPawnHash		 = state.pawnHash;
+	mPieceScore		 = state.pieceScore;
+	mPhase			 = state.phase;
+	mMaterialKey	 = state.materialKey;
 }
 
 
 void Chessboard::computeHash()
 {
-	mHash = 0;
+	mHash	  = 0;
+	mPawnHash = 0;
 
 	// hash all pieces
 	for (int piece = 0; piece < 12; piece++)
@@ -265,3 +249,23 @@ void Chessboard::computeHash()
 	// hash enpassant
 	hashEnPassant(mEnPassantSquare);
 }
+
+
+void Chessboard::computePieceScore()
+{
+	mPieceScore	 = 0;
+	mPhase		 = 0;
+	mMaterialKey = 0;
+
+	for (int piece = 0; piece < 12; piece++)
+	{
+		U64 bb = mBitBoards[piece];
+
+		while (bb)
+		{
+			int sq = BitUtils::lsb(bb);
+			scorePiece((PieceType)piece, (Square)sq, 1);
+			BitUtils::popBit(bb, sq);
+		}
+	}
+}
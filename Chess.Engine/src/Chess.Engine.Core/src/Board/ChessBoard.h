@@ -13,8 +13,12 @@
 #include <array>
 
 #include "BitboardTypes.h"
+#include "Fen.h"
 #include "AttackTables.h"
 #include "ZobristHash.h"
+#include "MaterialKey.h"
+#include "PieceSquareTables.h"
+#include "NNUE.h"
 
 
 /*
@@ -112,6 +116,10 @@ struct BoardState
 	int		  halfMoveClock = 0;
 	PieceType capturedPiece = PieceType::None;
 	uint64_t  hash			= 0;
+	uint64_t  pawnHash		= 0;
+	Score	  pieceScore	= 0;
+	int		  phase			= 0;
+	uint64_t  materialKey	= 0;
 };
 
 
@@ -126,7 +134,15 @@ public:
 
 	void							 init();
 	void							 clear();
-	void							 parseFEN(std::string_view fen);
+
+	/**
+	 * @brief	Set up the position of a FEN (the move counters are optional).
+	 * @return	false if the FEN is malformed or not playable, the board is left unchanged then.
+	 */
+	bool							 parseFEN(std::string_view fen);
+	void							 setPosition(const FenPosition &position);
+	[[nodiscard]] FenPosition		 getPosition() const;
+	[[nodiscard]] std::string		 toFEN() const { return Fen::toString(getPosition()); }
 
 	void							 removePiece(PieceType piece, Square sq);
 	void							 addPiece(PieceType piece, Square sq);
@@ -144,6 +160,7 @@ public:
 	[[nodiscard]] Castling			 getCurrentCastlingRights() const noexcept { return mCastlingRights; }
 	[[nodiscard]] Square			 getCurrentEnPassantSqaure() const noexcept { return mEnPassantSquare; }
 	[[nodiscard]] int				 getHalfMoveClock() const noexcept { return mHalfMoveClock; }
+	[[nodiscard]] int				 getMoveCounter() const noexcept { return mMoveCounter; }
 
 	void							 setSide(Side s) noexcept;
 	void							 flipSide() noexcept;
@@ -163,13 +180,52 @@ public:
 	[[nodiscard]] uint64_t	 getHash() const noexcept { return mHash; }
 	void					 computeHash();
 
+	/**
+	 * @brief	Zobrist key over the pawns of both sides only (key for the pawn hash table).
+	 */
+	[[nodiscard]] uint64_t	 getPawnHash() const noexcept { return mPawnHash; }
+
+	/**
+	 * @brief	Packed midgame/endgame material plus piece-square score (white - black)
+	 *			and game phase, updated with every piece change like the hash.
+	 */
+	[[nodiscard]] Score		 getPieceScore() const noexcept { return mPieceScore; }
+	[[nodiscard]] int		 getPhase() const noexcept { return mPhase; }
+	void					 computePieceScore();
+
+	/**
+	 * @brief	Piece count of every piece type (see MaterialKey), updated together with the piece score.
+	 */
+	[[nodiscard]] uint64_t	 getMaterialKey() const noexcept { return mMaterialKey; }
+
+	/**
+	 * @brief	NNUE first layer state, every piece change is recorded in it.
+	 *			Mutable: pending changes are applied lazily by NNUE::evaluate().
+	 */
+	[[nodiscard]] NNUEAccumulator &accumulator() const noexcept { return mAccumulator; }
+
 private:
 	// Hash update helpers (called internally when board changes)
-	void							  hashPiece(PieceType piece, Square sq) { mHash ^= ZobristHash::piece(piece, sq); }
+	void							  hashPiece(PieceType piece, Square sq)
+	{
+		uint64_t key = ZobristHash::piece(piece, sq);
+		mHash ^= key;
+
+		if (piece == PieceType::WPawn || piece == PieceType::BPawn)
+			mPawnHash ^= key;
+	}
 	void							  hashSide() { mHash ^= ZobristHash::sideToMove(); }
 	void							  hashCastling(Castling rights) { mHash ^= ZobristHash::castling(rights); }
 	void							  hashEnPassant(Square sq) { mHash ^= ZobristHash::enPassant(sq); }
 
+	// Score update helper (called internally when a piece is added or removed)
+	void							  scorePiece(PieceType piece, Square sq, int sign)
+	{
+		mPieceScore	 += sign * PieceSquareTables::score(piece, sq);
+		mPhase		 += sign * GamePhase::BY_TYPE[piece];
+		mMaterialKey += sign * MaterialKey::unit(piece);
+	}
+
 
 	Bitboards						  mBitBoards{};						 // Array of all bitboards
 	Occupancies						  mOccupancyBitboards{};			 // Occupancies
@@ -182,8 +238,13 @@ private:
 	int								  mMoveCounter	   = 1;
 
 	uint64_t						  mHash			   = 0; // Zobrist Hash
+	uint64_t						  mPawnHash		   = 0; // Zobrist Hash of the pawns only
+	Score							  mPieceScore	   = 0; // Material + piece-square tables (white - black)
+	int								  mPhase		   = 0; // Non-pawn material weight, GamePhase::MAX at the start
+	uint64_t						  mMaterialKey	   = 0; // Piece counts (MaterialKey)
+
+	mutable NNUEAccumulator			  mAccumulator;
 
 	// FEN positions
-	static constexpr std::string_view mEmptyBoard	   = "8/8/8/8/8/8/8/8 w - - ";
-	static constexpr std::string_view mStartPosition   = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 ";
+	static constexpr std::string_view mStartPosition = Fen::START_POSITION;
 };
@@ -0,0 +1,432 @@
+/*
+  ==============================================================================
+	Module:         Epd
+	Description:    Extended Position Description records and batch loading
+  ==============================================================================
+*/
+
+#include "Epd.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <thread>
+
+#include "Logging.h"
+#include "MappedFile.h"
+
+
+namespace
+{
+
+int resolveThreads(int threads)
+{
+	if (threads > 0)
+		return threads;
+
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+inline bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+
+inline bool isOpcodeChar(char c)
+{
+	return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+
+template <typename T>
+bool parseNumber(const std::vector<std::string> &operands, T &value)
+{
+	if (operands.size() != 1)
+		return false;
+
+	const std::string &text	  = operands.front();
+	auto [end, error]		  = std::from_chars(text.data(), text.data() + text.size(), value);
+
+	return error == std::errc() && end == text.data() + text.size();
+}
+
+
+/**
+ * @brief	Read one operation at pos: the opcode, then operands up to the semicolon (or the end of the line).
+ *			A quoted operand keeps its spaces and semicolons.
+ * @param	raw		Operands as written, for opcodes that are passed through.
+ * @return	false on a missing opcode or an unterminated quote.
+ */
+bool parseOperation(std::string_view line, size_t &pos, std::string &opcode, std::string &raw, std::vector<std::string> &operands)
+{
+	size_t start = pos;
+
+	if (!isOpcodeChar(line[pos]) || (line[pos] >= '0' && line[pos] <= '9'))
+		return false;
+
+	while (pos < line.size() && isOpcodeChar(line[pos]))
+		++pos;
+
+	opcode.assign(line.substr(start, pos - start));
+	operands.clear();
+
+	size_t rawStart = std::string_view::npos;
+	size_t rawEnd	= pos;
+
+	while (true)
+	{
+		while (pos < line.size() && isSpace(line[pos]))
+			++pos;
+
+		if (pos == line.size())
+			break;
+
+		if (line[pos] == ';')
+		{
+			++pos;
+			break;
+		}
+
+		if (rawStart == std::string_view::npos)
+			rawStart = pos;
+
+		if (line[pos] == '"')
+		{
+			size_t close = line.find('"', pos + 1);
+
+			if (close == std::string_view::npos)
+				return false;
+
+			operands.emplace_back(line.substr(pos + 1, close - pos - 1));
+			pos = close + 1;
+		}
+		else
+		{
+			size_t begin = pos;
+
+			while (pos < line.size() && !isSpace(line[pos]) && line[pos] != ';')
+				++pos;
+
+			operands.emplace_back(line.substr(begin, pos - begin));
+		}
+
+		rawEnd = pos;
+	}
+
+	raw.assign(rawStart == std::string_view::npos ? std::string_view{} : line.substr(rawStart, rawEnd - rawStart));
+	return true;
+}
+
+
+void appendOperation(std::string &line, std::string_view opcode, std::string_view operands)
+{
+	line += ' ';
+	line += opcode;
+
+	if (!operands.empty())
+	{
+		line += ' ';
+		line += operands;
+	}
+
+	line += ';';
+}
+
+
+void appendMoves(std::string &line, std::string_view opcode, const std::vector<std::string> &moves)
+{
+	if (moves.empty())
+		return;
+
+	std::string operands;
+
+	for (const auto &move : moves)
+	{
+		if (!operands.empty())
+			operands += ' ';
+
+		operands += move;
+	}
+
+	appendOperation(line, opcode, operands);
+}
+
+
+/**
+ * @brief	Line-aligned part of the input parsed by one thread.
+ */
+struct Chunk
+{
+	std::string_view text;
+	size_t			 lineCount		  = 0; // All lines, for the line numbers
+	size_t			 firstLine		  = 0; // Lines before this chunk
+	size_t			 firstSlot		  = 0; // First position slot of this chunk
+	size_t			 positions		  = 0; // Lines holding a position
+	size_t			 parsed			  = 0;
+	size_t			 firstInvalidLine = 0;
+	FenError		 firstError		  = FenError::None;
+};
+
+
+size_t countLines(std::string_view text)
+{
+	size_t lines = static_cast<size_t>(std::count(text.begin(), text.end(), '\n'));
+
+	if (!text.empty() && text.back() != '\n')
+		++lines;
+
+	return lines;
+}
+
+
+void parseChunk(Chunk &chunk, FenPosition *slots)
+{
+	std::string_view text = chunk.text;
+	size_t			 pos  = 0;
+	size_t			 line = chunk.firstLine;
+
+	while (pos < text.size())
+	{
+		size_t end = text.find('\n', pos);
+
+		if (end == std::string_view::npos)
+			end = text.size();
+
+		std::string_view current = text.substr(pos, end - pos);
+		pos						 = end + 1;
+		++line;
+
+		size_t first = 0;
+
+		while (first < current.size() && isSpace(current[first]))
+			++first;
+
+		if (first == current.size() || current[first] == '#')
+			continue;
+
+		++chunk.positions;
+
+		FenPosition &position = slots[chunk.parsed];
+		FenError	 error	  = Fen::parse(current, position);
+
+		if (error == FenError::None)
+			error = Fen::validate(position);
+
+		if (error != FenError::None)
+		{
+			if (chunk.firstInvalidLine == 0)
+			{
+				chunk.firstInvalidLine = line;
+				chunk.firstError	   = error;
+			}
+			continue;
+		}
+
+		++chunk.parsed;
+	}
+}
+
+} // namespace
+
+
+FenError Epd::parse(std::string_view line, EpdRecord &record)
+{
+	record		  = EpdRecord();
+
+	size_t	 pos  = 0;
+	FenError error = Fen::parse(line, record.position, &pos);
+
+	if (error != FenError::None)
+		return error;
+
+	std::string				 opcode;
+	std::string				 raw;
+	std::vector<std::string> operands;
+
+	while (true)
+	{
+		while (pos < line.size() && isSpace(line[pos]))
+			++pos;
+
+		if (pos == line.size())
+			break;
+
+		if (!parseOperation(line, pos, opcode, raw, operands))
+			return FenError::Operation;
+
+		if (opcode == "bm")
+		{
+			record.bestMoves = operands;
+		}
+		else if (opcode == "am")
+		{
+			record.avoidMoves = operands;
+		}
+		else if (opcode == "id")
+		{
+			record.id = operands.empty() ? std::string() : operands.front();
+		}
+		else if (opcode == "c0")
+		{
+			record.comment = operands.empty() ? std::string() : operands.front();
+		}
+		else if (opcode == "acd")
+		{
+			if (!parseNumber(operands, record.depth) || record.depth < 0)
+				return FenError::Operation;
+		}
+		else if (opcode == "hmvc")
+		{
+			if (!parseNumber(operands, record.position.halfMoveClock))
+				return FenError::HalfMoveClock;
+		}
+		else if (opcode == "fmvn")
+		{
+			if (!parseNumber(operands, record.position.fullMoveNumber) || record.position.fullMoveNumber == 0)
+				return FenError::FullMoveNumber;
+		}
+		else
+		{
+			record.operations.emplace_back(opcode, raw);
+		}
+	}
+
+	return FenError::None;
+}
+
+
+std::string Epd::toString(const EpdRecord &record)
+{
+	std::string line = Fen::toString(record.position, false);
+
+	appendMoves(line, "bm", record.bestMoves);
+	appendMoves(line, "am", record.avoidMoves);
+
+	if (!record.id.empty())
+		appendOperation(line, "id", "\"" + record.id + "\"");
+
+	if (!record.comment.empty())
+		appendOperation(line, "c0", "\"" + record.comment + "\"");
+
+	if (record.depth > 0)
+		appendOperation(line, "acd", std::to_string(record.depth));
+
+	if (record.position.halfMoveClock != 0)
+		appendOperation(line, "hmvc", std::to_string(record.position.halfMoveClock));
+
+	if (record.position.fullMoveNumber != 1)
+		appendOperation(line, "fmvn", std::to_string(record.position.fullMoveNumber));
+
+	for (const auto &[opcode, operands] : record.operations)
+		appendOperation(line, opcode, operands);
+
+	return line;
+}
+
+
+bool EpdBatchLoader::load(const std::string &path, std::vector<FenPosition> &positions, EpdLoadResult &result, int threads)
+{
+	MappedFile file;
+
+	if (!file.open(path))
+		return false;
+
+	result = parse(file.view(), positions, threads);
+
+	if (result.invalid > 0)
+	{
+		LOG_WARNING("{}: rejected {} of {} positions, first at line {} ({})", path, result.invalid, result.lines, result.firstInvalidLine, Fen::errorMessage(result.firstError));
+	}
+
+	return true;
+}
+
+
+EpdLoadResult EpdBatchLoader::parse(std::string_view text, std::vector<FenPosition> &positions, int threads)
+{
+	using Clock		= std::chrono::steady_clock;
+	auto start		= Clock::now();
+
+	size_t maxChunks = std::max<size_t>(1, text.size() / MIN_CHUNK_BYTES);
+	size_t count	 = std::min(static_cast<size_t>(resolveThreads(threads)), maxChunks);
+
+	// Split at line breaks
+	std::vector<Chunk> chunks(count);
+	size_t			   begin = 0;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		size_t end = i + 1 == count ? text.size() : std::max(begin, text.size() * (i + 1) / count);
+
+		if (end < text.size())
+		{
+			size_t lineEnd = text.find('\n', end);
+			end			   = lineEnd == std::string_view::npos ? text.size() : lineEnd + 1;
+		}
+
+		chunks[i].text = text.substr(begin, end - begin);
+		begin		   = end;
+	}
+
+	auto runChunks = [&](auto &&work)
+	{
+		if (count == 1)
+		{
+			work(chunks.front());
+			return;
+		}
+
+		std::vector<std::thread> workers;
+		workers.reserve(count);
+
+		for (auto &chunk : chunks)
+			workers.emplace_back([&work, &chunk]() { work(chunk); });
+
+		for (auto &thread : workers)
+			thread.join();
+	};
+
+	// Reserve a slot per line, then parse every chunk into its own slots
+	runChunks([](Chunk &chunk) { chunk.lineCount = countLines(chunk.text); });
+
+	size_t lines = 0;
+
+	for (auto &chunk : chunks)
+	{
+		chunk.firstLine = lines;
+		chunk.firstSlot = lines;
+		lines += chunk.lineCount;
+	}
+
+	positions.clear();
+	positions.resize(lines);
+
+	runChunks([&positions](Chunk &chunk) { parseChunk(chunk, positions.data() + chunk.firstSlot); });
+
+	// Close the gaps of rejected and blank lines
+	EpdLoadResult result;
+	size_t		  filled = 0;
+
+	for (const auto &chunk : chunks)
+	{
+		if (filled != chunk.firstSlot)
+			std::copy_n(positions.begin() + chunk.firstSlot, chunk.parsed, positions.begin() + filled);
+
+		filled += chunk.parsed;
+		result.lines += chunk.positions;
+		result.invalid += chunk.positions - chunk.parsed;
+
+		if (result.firstInvalidLine == 0 && chunk.firstInvalidLine != 0)
+		{
+			result.firstInvalidLine = chunk.firstInvalidLine;
+			result.firstError		= chunk.firstError;
+		}
+	}
+
+	positions.resize(filled);
+
+	result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+	return result;
+}
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+	Module:         Epd
+	Description:    Extended Position Description records and batch loading
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "Fen.h"
+
+
+/**
+ * @brief	One EPD line: a position followed by operations ("bm Nf3 Qd2; id \"WAC.001\";").
+ *			The common opcodes get their own fields, all others are kept with their raw operands.
+ */
+struct EpdRecord
+{
+	FenPosition										 position;
+	std::vector<std::string>						 bestMoves;	 // bm, in SAN
+	std::vector<std::string>						 avoidMoves; // am, in SAN
+	std::string										 id;
+	std::string										 comment; // c0
+	int												 depth = 0; // acd (analysis count depth), 0 if not given
+	std::vector<std::pair<std::string, std::string>> operations; // Other opcodes with their operands as written
+
+	bool											 operator==(const EpdRecord &other) const = default;
+};
+
+
+class Epd
+{
+public:
+	/**
+	 * @brief	Parse an EPD line. The move counters may be given as FEN fields or with the hmvc and fmvn opcodes.
+	 *			The last operation may omit its closing semicolon.
+	 */
+	static FenError	   parse(std::string_view line, EpdRecord &record);
+
+	/**
+	 * @brief	Write a record as an EPD line that parses back into the same record.
+	 */
+	static std::string toString(const EpdRecord &record);
+};
+
+
+struct EpdLoadResult
+{
+	size_t	 lines			  = 0; // Lines holding a position (blank lines and '#' comments are not counted)
+	size_t	 invalid		  = 0; // Lines rejected by Fen::parse() or Fen::validate()
+	size_t	 firstInvalidLine = 0; // 1-based line number of the first rejected line, 0 if none
+	FenError firstError		  = FenError::None;
+	double	 seconds		  = 0.0;
+
+	double	 positionsPerSecond() const { return seconds > 0.0 ? static_cast<double>(lines - invalid) / seconds : 0.0; }
+};
+
+
+/**
+ * @brief	Parses large FEN / EPD files into a flat position array for tuning and test suites.
+ *
+ * The text is split into line-aligned chunks, one per thread. Every thread counts the lines of its chunk,
+ * the counts reserve a slot per line in one allocation, and the threads then parse straight into their slots.
+ * Rejected lines leave gaps that are closed at the end, so the positions keep the order of the file.
+ * Only the position is parsed, EPD operations behind it are skipped.
+ */
+class EpdBatchLoader
+{
+public:
+	/**
+	 * @brief	Memory-map the file and parse it, replacing the contents of positions.
+	 * @param	threads		Parsing threads, 0 for all cores.
+	 * @return	false if the file can't be mapped. Rejected lines are counted in the result and logged once.
+	 */
+	static bool			 load(const std::string &path, std::vector<FenPosition> &positions, EpdLoadResult &result, int threads = 0);
+
+	/**
+	 * @brief	Parse text that is already in memory, replacing the contents of positions.
+	 */
+	static EpdLoadResult parse(std::string_view text, std::vector<FenPosition> &positions, int threads = 0);
+
+	static constexpr size_t MIN_CHUNK_BYTES = 64 * 1024; // Smaller inputs are parsed by fewer threads
+};
@@ -0,0 +1,360 @@
+/*
+  ==============================================================================
+	Module:         Fen
+	Description:    Forsyth-Edwards Notation parsing and writing
+  ==============================================================================
+*/
+
+#include "Fen.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "AttackTables.h"
+
+
+namespace
+{
+
+constexpr int8_t NO_PIECE = -1;
+
+constexpr U64	 RANK_8	  = 0xFFULL;
+constexpr U64	 RANK_1	  = 0xFFULL << 56;
+
+constexpr int	 MAX_PIECES_PER_SIDE = 16;
+constexpr int	 MAX_PAWNS_PER_SIDE	 = 8;
+constexpr int	 MAX_PIECES_PER_TYPE = 15;
+
+
+/*
+ * Piece placement characters, decoded by table so the parser does not branch per character:
+ * bits 0-3 hold the board the square is recorded in (a piece, or the spare board 12 for empty squares),
+ * bits 4-7 the number of squares the character covers. '/' and invalid characters cover none.
+ */
+constexpr uint8_t SPARE_BOARD = 12;
+constexpr uint8_t SLASH		  = SPARE_BOARD;
+constexpr uint8_t INVALID	  = 15; // Recorded in an unused board
+
+constexpr std::array<uint8_t, 256> PLACEMENT = []
+{
+	std::array<uint8_t, 256> table{};
+	table.fill(INVALID);
+
+	for (int piece = 0; piece < 12; ++piece)
+		table[static_cast<unsigned char>(asciiPieces[piece])] = static_cast<uint8_t>(1 << 4 | piece);
+
+	for (int empty = 1; empty <= 8; ++empty)
+		table['0' + empty] = static_cast<uint8_t>(empty << 4 | SPARE_BOARD);
+
+	table['/'] = SLASH;
+	return table;
+}();
+
+
+inline bool isDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+
+/**
+ * @brief	Skip the spaces at pos. @return false if the text ends there.
+ */
+inline bool skipSpaces(std::string_view text, size_t &pos)
+{
+	while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t'))
+		++pos;
+
+	return pos < text.size();
+}
+
+
+inline bool atFieldEnd(std::string_view text, size_t pos)
+{
+	return pos == text.size() || text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r' || text[pos] == '\n';
+}
+
+
+bool parseCounter(std::string_view text, size_t &pos, uint16_t &value)
+{
+	uint32_t number = 0;
+	size_t	 start	= pos;
+
+	while (pos < text.size() && isDigit(text[pos]) && pos - start < 5)
+		number = number * 10 + static_cast<uint32_t>(text[pos++] - '0');
+
+	if (pos == start || number > UINT16_MAX || !atFieldEnd(text, pos))
+		return false;
+
+	value = static_cast<uint16_t>(number);
+	return true;
+}
+
+} // namespace
+
+
+FenError Fen::parse(std::string_view text, FenPosition &position, size_t *length)
+{
+	position  = FenPosition();
+	size_t pos = 0;
+
+	if (!skipSpaces(text, pos))
+		return FenError::PiecePlacement;
+
+	// 1 Piece placement, a8 first. A rank of more or less than 8 squares shows at the next '/' or at the end.
+	std::array<U64, 16> boards{};
+	unsigned			square	= 0;
+	unsigned			ranks	= 0;
+	bool				invalid = false;
+
+	for (; pos < text.size() && !atFieldEnd(text, pos); ++pos)
+	{
+		uint8_t code = PLACEMENT[static_cast<unsigned char>(text[pos])];
+		bool	slash = code == SLASH;
+
+		invalid |= code == INVALID;
+		ranks += slash;
+		invalid |= slash && square != ranks * 8;
+
+		boards[code & 0x0F] |= 1ULL << (square & 63);
+		square += code >> 4;
+	}
+
+	if (invalid || ranks != 7 || square != 64)
+		return FenError::PiecePlacement;
+
+	std::copy_n(boards.begin(), 12, position.pieces.begin());
+
+	// 2 Side to move
+	if (!skipSpaces(text, pos) || (text[pos] != 'w' && text[pos] != 'b') || !atFieldEnd(text, pos + 1))
+		return FenError::SideToMove;
+
+	position.side = text[pos++] == 'w' ? Side::White : Side::Black;
+
+	// 3 Castling rights
+	if (!skipSpaces(text, pos))
+		return FenError::Castling;
+
+	if (text[pos] == '-')
+	{
+		++pos;
+	}
+	else
+	{
+		for (; pos < text.size() && !atFieldEnd(text, pos); ++pos)
+		{
+			Castling right;
+
+			switch (text[pos])
+			{
+			case 'K': right = Castling::WK; break;
+			case 'Q': right = Castling::WQ; break;
+			case 'k': right = Castling::BK; break;
+			case 'q': right = Castling::BQ; break;
+			default: return FenError::Castling;
+			}
+
+			if (has(position.castling, right))
+				return FenError::Castling;
+
+			position.castling |= right;
+		}
+	}
+
+	if (!atFieldEnd(text, pos))
+		return FenError::Castling;
+
+	// 4 En passant target, behind the pawn of the side that just moved
+	if (!skipSpaces(text, pos))
+		return FenError::EnPassant;
+
+	if (text[pos] == '-')
+	{
+		++pos;
+	}
+	else
+	{
+		if (pos + 1 >= text.size() || text[pos] < 'a' || text[pos] > 'h')
+			return FenError::EnPassant;
+
+		char expectedRank = position.side == Side::White ? '6' : '3';
+
+		if (text[pos + 1] != expectedRank)
+			return FenError::EnPassant;
+
+		position.enPassant = static_cast<Square>((8 - (text[pos + 1] - '0')) * 8 + (text[pos] - 'a'));
+		pos += 2;
+	}
+
+	if (!atFieldEnd(text, pos))
+		return FenError::EnPassant;
+
+	// 5, 6 Move counters (optional: EPD continues with operations, which never start with a digit)
+	size_t end = pos;
+
+	if (skipSpaces(text, pos) && isDigit(text[pos]))
+	{
+		if (!parseCounter(text, pos, position.halfMoveClock))
+			return FenError::HalfMoveClock;
+
+		end = pos;
+
+		if (skipSpaces(text, pos) && isDigit(text[pos]))
+		{
+			if (!parseCounter(text, pos, position.fullMoveNumber) || position.fullMoveNumber == 0)
+				return FenError::FullMoveNumber;
+
+			end = pos;
+		}
+	}
+
+	if (length)
+		*length = end;
+
+	return FenError::None;
+}
+
+
+FenError Fen::validate(const FenPosition &position)
+{
+	const auto &pieces = position.pieces;
+
+	if (std::popcount(pieces[WKing]) != 1 || std::popcount(pieces[BKing]) != 1)
+		return FenError::KingCount;
+
+	if ((pieces[WPawn] | pieces[BPawn]) & (RANK_8 | RANK_1))
+		return FenError::PawnOnBackRank;
+
+	if (std::any_of(pieces.begin(), pieces.end(), [](U64 bb) { return std::popcount(bb) > MAX_PIECES_PER_TYPE; }))
+		return FenError::PieceTypeCount;
+
+	U64 white = 0;
+	U64 black = 0;
+
+	for (int type = WKing; type <= WRook; ++type)
+	{
+		white |= pieces[type];
+		black |= pieces[type + BKing];
+	}
+
+	if (std::popcount(white) > MAX_PIECES_PER_SIDE || std::popcount(black) > MAX_PIECES_PER_SIDE)
+		return FenError::PieceCount;
+
+	if (std::popcount(pieces[WPawn]) > MAX_PAWNS_PER_SIDE || std::popcount(pieces[BPawn]) > MAX_PAWNS_PER_SIDE)
+		return FenError::PawnCount;
+
+	// The king of the side that just moved must not be attacked by the side to move
+	const AttackTables &tables	   = AttackTables::instance();
+	bool				whiteMoves = position.side == Side::White;
+	int					first	   = whiteMoves ? WKing : BKing;
+	Square				king	   = static_cast<Square>(std::countr_zero(pieces[whiteMoves ? BKing : WKing]));
+	U64					occupied   = white | black;
+
+	U64 attackers = (tables.pawnAttacks(whiteMoves ? Side::Black : Side::White, king) & pieces[first + WPawn]) | (tables.knightAttacks(king) & pieces[first + WKnight])
+				  | (tables.kingAttacks(king) & pieces[first + WKing]) | (tables.bishopAttacks(king, occupied) & (pieces[first + WBishop] | pieces[first + WQueen]))
+				  | (tables.rookAttacks(king, occupied) & (pieces[first + WRook] | pieces[first + WQueen]));
+
+	if (attackers)
+		return FenError::OpponentInCheck;
+
+	return FenError::None;
+}
+
+
+std::string Fen::toString(const FenPosition &position, bool moveCounters)
+{
+	std::string fen;
+	fen.reserve(90);
+
+	for (int rank = 0; rank < 8; ++rank)
+	{
+		int empty = 0;
+
+		for (int file = 0; file < 8; ++file)
+		{
+			U64 bit	  = 1ULL << (rank * 8 + file);
+			int piece = NO_PIECE;
+
+			for (int type = 0; type < 12; ++type)
+			{
+				if (position.pieces[type] & bit)
+				{
+					piece = type;
+					break;
+				}
+			}
+
+			if (piece == NO_PIECE)
+			{
+				++empty;
+				continue;
+			}
+
+			if (empty > 0)
+				fen += static_cast<char>('0' + empty);
+
+			empty = 0;
+			fen += asciiPieces[piece];
+		}
+
+		if (empty > 0)
+			fen += static_cast<char>('0' + empty);
+
+		if (rank < 7)
+			fen += '/';
+	}
+
+	fen += position.side == Side::Black ? " b " : " w ";
+
+	if (position.castling == Castling::None)
+	{
+		fen += '-';
+	}
+	else
+	{
+		if (has(position.castling, Castling::WK))
+			fen += 'K';
+		if (has(position.castling, Castling::WQ))
+			fen += 'Q';
+		if (has(position.castling, Castling::BK))
+			fen += 'k';
+		if (has(position.castling, Castling::BQ))
+			fen += 'q';
+	}
+
+	fen += ' ';
+	fen += position.enPassant == Square::None ? "-" : square_to_coordinates[to_index(position.enPassant)];
+
+	if (moveCounters)
+	{
+		fen += ' ';
+		fen += std::to_string(position.halfMoveClock);
+		fen += ' ';
+		fen += std::to_string(position.fullMoveNumber);
+	}
+
+	return fen;
+}
+
+
+std::string_view Fen::errorMessage(FenError error)
+{
+	switch (error)
+	{
+	case FenError::None: return "no error";
+	case FenError::PiecePlacement: return "invalid piece placement";
+	case FenError::SideToMove: return "invalid side to move";
+	case FenError::Castling: return "invalid castling rights";
+	case FenError::EnPassant: return "invalid en passant square";
+	case FenError::HalfMoveClock: return "invalid halfmove clock";
+	case FenError::FullMoveNumber: return "invalid fullmove number";
+	case FenError::KingCount: return "each side needs exactly one king";
+	case FenError::PawnOnBackRank: return "pawn on the first or last rank";
+	case FenError::PieceTypeCount: return "more than 15 pieces of one type";
+	case FenError::PieceCount: return "more than 16 pieces of one side";
+	case FenError::PawnCount: return "more than 8 pawns of one side";
+	case FenError::OpponentInCheck: return "the side not to move is in check";
+	case FenError::Operation: return "malformed EPD operation";
+	default: return "unknown error";
+	}
+}
@@ -0,0 +1,81 @@
+/*
+  ==============================================================================
+	Module:         Fen
+	Description:    Forsyth-Edwards Notation parsing and writing
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "BitboardTypes.h"
+
+
+/**
+ * @brief	Reason a FEN or EPD line was rejected.
+ */
+enum class FenError : uint8_t
+{
+	None,
+	PiecePlacement,	 // Unknown piece, rank longer or shorter than 8 squares, or not 8 ranks
+	SideToMove,
+	Castling,
+	EnPassant,		 // Malformed square, or not on the rank behind a pawn that just moved two squares
+	HalfMoveClock,
+	FullMoveNumber,
+	KingCount,		 // Not exactly one king per side
+	PawnOnBackRank,
+	PieceTypeCount,	 // More than 15 pieces of one type (the limit of MaterialKey's counts)
+	PieceCount,		 // More than 16 pieces of one side
+	PawnCount,		 // More than 8 pawns of one side
+	OpponentInCheck, // The side that just moved left its king in check
+	Operation,		 // Malformed EPD operation
+};
+
+
+/**
+ * @brief	Board state described by a FEN, without any derived data (hashes, scores, occupancies).
+ *			Plain data, so large batches can be parsed into preallocated arrays.
+ */
+struct FenPosition
+{
+	std::array<U64, 12> pieces{};
+	Side				side		   = Side::White;
+	Castling			castling	   = Castling::None;
+	Square				enPassant	   = Square::None;
+	uint16_t			halfMoveClock  = 0;
+	uint16_t			fullMoveNumber = 1;
+
+	bool				operator==(const FenPosition &other) const = default;
+};
+
+
+class Fen
+{
+public:
+	static constexpr std::string_view START_POSITION = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+	/**
+	 * @brief	Parse the four position fields and the optional move counters (EPD lines have none).
+	 *			Only the syntax is checked, see validate() for the rules of a playable position.
+	 * @param	length	Receives the number of characters consumed (optional). EPD operations start behind them.
+	 */
+	static FenError			parse(std::string_view text, FenPosition &position, size_t *length = nullptr);
+
+	/**
+	 * @brief	Check that a parsed position can be played: one king per side, no pawns on the first or last rank,
+	 *			no more pieces than a game can have (16 per side, 8 of them pawns) and the side not to move not in check.
+	 */
+	static FenError			validate(const FenPosition &position);
+
+	/**
+	 * @param	moveCounters	Append the halfmove clock and the fullmove number (FEN), or stop after the en passant field (EPD).
+	 */
+	static std::string		toString(const FenPosition &position, bool moveCounters = true);
+
+	static std::string_view errorMessage(FenError error);
+};
@@ -0,0 +1,80 @@
+/*
+  ==============================================================================
+	Module:         MaterialKey
+	Description:    Material signature of a position (piece count of every piece type)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "BitboardTypes.h"
+
+
+/**
+ * @brief	The material key packs the number of pieces of every PieceType into 4 bits each
+ *			(white pieces in bits 0-23, black pieces in bits 24-47). Adding or removing a piece
+ *			adds or subtracts its unit, so the board keeps the key up to date incrementally, and
+ *			two positions with the same material always have the same key.
+ */
+namespace MaterialKey
+{
+
+constexpr int	   BITS		 = 4;
+constexpr int	   SIDE_BITS = 6 * BITS;
+constexpr uint64_t SIDE_MASK = (1ULL << SIDE_BITS) - 1;
+
+
+constexpr uint64_t unit(PieceType piece)
+{
+	return 1ULL << (BITS * piece);
+}
+
+
+constexpr int count(uint64_t key, PieceType piece)
+{
+	return static_cast<int>((key >> (BITS * piece)) & 0xF);
+}
+
+
+/**
+ * @brief	Key with the colours swapped.
+ */
+constexpr uint64_t mirror(uint64_t key)
+{
+	return ((key & SIDE_MASK) << SIDE_BITS) | (key >> SIDE_BITS);
+}
+
+
+/**
+ * @brief	Key of a material code like "KRKB": the white pieces up to the second king, the black pieces after it.
+ */
+constexpr uint64_t fromCode(std::string_view code)
+{
+	uint64_t key   = 0;
+	int		 kings = 0;
+
+	for (char c : code)
+	{
+		kings += c == 'K';
+
+		for (int type = 0; type < 6; ++type)
+		{
+			if (asciiPieces[type] == c)
+				key += unit(static_cast<PieceType>(kings > 1 ? type + BKing : type));
+		}
+	}
+
+	return key;
+}
+
+
+/**
+ * @brief	Mask of the pawns, rooks and queens of both sides (material that can always force mate).
+ */
+constexpr uint64_t HEAVY_MATERIAL = 0xFULL << (BITS * WPawn) | 0xFULL << (BITS * WRook) | 0xFULL << (BITS * WQueen) | 0xFULL << (BITS * BPawn)
+								  | 0xFULL << (BITS * BRook) | 0xFULL << (BITS * BQueen);
+
+} // namespace MaterialKey
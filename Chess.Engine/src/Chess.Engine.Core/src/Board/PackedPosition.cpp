@@ -0,0 +1,368 @@
+/*
+  ==============================================================================
+	Module:         PackedPosition
+	Description:    Fixed-size 32 byte position encoding for datasets and caches
+  ==============================================================================
+*/
+
+#include "PackedPosition.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Chessboard.h"
+#include "Logging.h"
+
+
+namespace
+{
+
+constexpr int OCCUPANCY_OFFSET = 0;
+constexpr int NIBBLES_OFFSET   = 8;
+constexpr int META_OFFSET	   = 24;
+
+
+inline void storeLE64(uint8_t *out, uint64_t value)
+{
+	for (int i = 0; i < 8; ++i)
+		out[i] = static_cast<uint8_t>(value >> (8 * i));
+}
+
+
+inline uint64_t loadLE64(const uint8_t *in)
+{
+	uint64_t value = 0;
+
+	for (int i = 0; i < 8; ++i)
+		value |= static_cast<uint64_t>(in[i]) << (8 * i);
+
+	return value;
+}
+
+
+inline void storeLE16(char *out, uint16_t value)
+{
+	out[0] = static_cast<char>(value & 0xFF);
+	out[1] = static_cast<char>(value >> 8);
+}
+
+
+inline uint16_t loadLE16(const char *in)
+{
+	return static_cast<uint16_t>(static_cast<uint8_t>(in[0]) | static_cast<uint8_t>(in[1]) << 8);
+}
+
+
+/*
+ * The piece types are handled as four bit planes: plane k holds the squares whose piece type has bit k set.
+ * Encoding reads a square's type from the planes, decoding writes the planes and rebuilds the twelve
+ * bitboards from them, so neither direction has data-dependent branches or read-modify-write chains
+ * through memory.
+ */
+using Planes = std::array<U64, 4>;
+
+
+inline uint64_t typeAt(const Planes &planes, int square)
+{
+	return (planes[0] >> square & 1) | (planes[1] >> square & 1) << 1 | (planes[2] >> square & 1) << 2 | (planes[3] >> square & 1) << 3;
+}
+
+
+inline void recordType(Planes &planes, int square, uint64_t type)
+{
+	for (int k = 0; k < 4; ++k)
+		planes[k] |= (type >> k & 1) << square;
+}
+
+
+/**
+ * @brief	Square index of the en passant target of the side to move, for the file (0 - 7).
+ */
+inline int enPassantSquare(Side side, int file)
+{
+	return (side == Side::White ? to_index(Square::a6) : to_index(Square::a3)) + file;
+}
+
+} // namespace
+
+
+bool PackedPosition::pack(const FenPosition &position, const PackedAnnotation &annotation, PackedPosition &packed)
+{
+	if (position.side != Side::White && position.side != Side::Black)
+		return false;
+
+	if (position.halfMoveClock > MAX_HALF_MOVE_CLOCK || position.fullMoveNumber == 0 || position.fullMoveNumber > MAX_FULL_MOVE_NUMBER)
+		return false;
+
+	U64	   occupancy = 0;
+	int	   pieces	 = 0;
+	Planes planes{};
+
+	for (int type = 0; type < 12; ++type)
+	{
+		U64 board = position.pieces[type];
+		occupancy |= board;
+		pieces += BitUtils::popCount(board);
+
+		for (int k = 0; k < 4; ++k)
+			planes[k] |= (type >> k & 1) ? board : 0;
+	}
+
+	// Squares claimed by two piece types have no single code
+	if (pieces > static_cast<int>(MAX_PIECES) || pieces != BitUtils::popCount(occupancy))
+		return false;
+
+	uint64_t enPassant = 0;
+
+	if (position.enPassant != Square::None)
+	{
+		int file = to_index(position.enPassant) & 7;
+
+		if (to_index(position.enPassant) != enPassantSquare(position.side, file))
+			return false;
+
+		enPassant = static_cast<uint64_t>(file) + 1;
+	}
+
+	// Piece types in square order, 16 per word
+	uint64_t low  = 0;
+	uint64_t high = 0;
+	U64		 rest = occupancy;
+
+	for (int slot = 0; rest && slot < 16; ++slot, rest &= rest - 1)
+		low |= typeAt(planes, BitUtils::lsb(rest)) << (slot * 4);
+
+	for (int slot = 0; rest; ++slot, rest &= rest - 1)
+		high |= typeAt(planes, BitUtils::lsb(rest)) << (slot * 4);
+
+	uint64_t meta = (position.side == Side::Black ? 1ULL : 0ULL);
+	meta |= static_cast<uint64_t>(position.castling) << 1;
+	meta |= enPassant << 5;
+	meta |= static_cast<uint64_t>(annotation.result) << 9;
+	meta |= static_cast<uint64_t>(position.halfMoveClock) << 11;
+	meta |= static_cast<uint64_t>(position.fullMoveNumber) << 19;
+	meta |= static_cast<uint64_t>(static_cast<uint16_t>(annotation.score)) << 32;
+	meta |= static_cast<uint64_t>(annotation.bestMove.raw()) << 48;
+
+	storeLE64(packed.mBytes.data() + OCCUPANCY_OFFSET, occupancy);
+	storeLE64(packed.mBytes.data() + NIBBLES_OFFSET, low);
+	storeLE64(packed.mBytes.data() + NIBBLES_OFFSET + 8, high);
+	storeLE64(packed.mBytes.data() + META_OFFSET, meta);
+	return true;
+}
+
+
+bool PackedPosition::pack(const Chessboard &board, const PackedAnnotation &annotation, PackedPosition &packed)
+{
+	return pack(board.getPosition(), annotation, packed);
+}
+
+
+void PackedPosition::unpack(FenPosition &position, PackedAnnotation *annotation) const
+{
+	U64		 occupancy = loadLE64(mBytes.data() + OCCUPANCY_OFFSET);
+	uint64_t low	   = loadLE64(mBytes.data() + NIBBLES_OFFSET);
+	uint64_t high	   = loadLE64(mBytes.data() + NIBBLES_OFFSET + 8);
+	uint64_t meta	   = loadLE64(mBytes.data() + META_OFFSET);
+
+	Planes	 planes{};
+	U64		 rest = occupancy;
+
+	for (int slot = 0; rest && slot < 16; ++slot, rest &= rest - 1)
+		recordType(planes, BitUtils::lsb(rest), low >> (slot * 4) & 0xF);
+
+	for (int slot = 0; rest; ++slot, rest &= rest - 1)
+		recordType(planes, BitUtils::lsb(rest), high >> (slot * 4) & 0xF);
+
+	for (int type = 0; type < 12; ++type)
+	{
+		U64 board = occupancy;
+
+		for (int k = 0; k < 4; ++k)
+			board &= (type >> k & 1) ? planes[k] : ~planes[k];
+
+		position.pieces[type] = board;
+	}
+
+	position.side			= (meta & 1) ? Side::Black : Side::White;
+	position.castling		= static_cast<Castling>(meta >> 1 & 0xF);
+
+	int enPassant			= static_cast<int>(meta >> 5 & 0xF);
+	position.enPassant		= enPassant == 0 ? Square::None : static_cast<Square>(enPassantSquare(position.side, (enPassant - 1) & 7));
+
+	position.halfMoveClock	= static_cast<uint16_t>(meta >> 11 & 0xFF);
+	position.fullMoveNumber = static_cast<uint16_t>(meta >> 19 & 0x1FFF);
+
+	if (annotation)
+	{
+		annotation->result	 = static_cast<PackedResult>(meta >> 9 & 0x3);
+		annotation->score	 = static_cast<int16_t>(static_cast<uint16_t>(meta >> 32));
+		annotation->bestMove = Move(static_cast<uint16_t>(meta >> 48));
+	}
+}
+
+
+void PackedPosition::unpack(Chessboard &board, PackedAnnotation *annotation) const
+{
+	FenPosition position;
+	unpack(position, annotation);
+	board.setPosition(position);
+}
+
+
+size_t PackedPosition::packAll(const FenPosition *positions, const PackedAnnotation *annotations, PackedPosition *packed, size_t count)
+{
+	const PackedAnnotation none;
+	size_t				   rejected = 0;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		if (!pack(positions[i], annotations ? annotations[i] : none, packed[i]))
+		{
+			packed[i] = PackedPosition();
+			++rejected;
+		}
+	}
+
+	return rejected;
+}
+
+
+void PackedPosition::unpackAll(const PackedPosition *packed, FenPosition *positions, PackedAnnotation *annotations, size_t count)
+{
+	for (size_t i = 0; i < count; ++i)
+		packed[i].unpack(positions[i], annotations ? annotations + i : nullptr);
+}
+
+
+bool PackedPositionWriter::open(const std::string &path)
+{
+	close();
+
+	mFile.open(path, std::ios::binary | std::ios::trunc);
+
+	if (!mFile)
+	{
+		LOG_ERROR("Could not create packed position file {}", path);
+		mOk = false;
+		return false;
+	}
+
+	char header[PackedFileHeader::SIZE];
+	std::memcpy(header, PackedFileHeader::MAGIC, sizeof(PackedFileHeader::MAGIC));
+	storeLE16(header + 4, PackedFileHeader::VERSION);
+	storeLE16(header + 6, static_cast<uint16_t>(PackedPosition::SIZE));
+
+	mFile.write(header, sizeof(header));
+
+	mBuffer.clear();
+	mBuffer.reserve(BUFFER_RECORDS);
+	mCount = 0;
+	mOk	   = static_cast<bool>(mFile);
+	return mOk;
+}
+
+
+bool PackedPositionWriter::write(const PackedPosition &position)
+{
+	return write(&position, 1);
+}
+
+
+bool PackedPositionWriter::write(const PackedPosition *positions, size_t count)
+{
+	if (!mFile.is_open())
+		return false;
+
+	while (count > 0)
+	{
+		size_t chunk = std::min(count, BUFFER_RECORDS - mBuffer.size());
+		mBuffer.insert(mBuffer.end(), positions, positions + chunk);
+
+		positions += chunk;
+		count -= chunk;
+		mCount += chunk;
+
+		if (mBuffer.size() == BUFFER_RECORDS)
+			flush();
+	}
+
+	return mOk;
+}
+
+
+bool PackedPositionWriter::close()
+{
+	if (!mFile.is_open())
+		return mOk;
+
+	flush();
+	mFile.close();
+
+	if (!mFile)
+		mOk = false;
+
+	return mOk;
+}
+
+
+bool PackedPositionWriter::flush()
+{
+	if (!mBuffer.empty())
+	{
+		// PackedPosition is a plain byte array, so the records are written as they are
+		mFile.write(reinterpret_cast<const char *>(mBuffer.data()), static_cast<std::streamsize>(mBuffer.size() * PackedPosition::SIZE));
+		mBuffer.clear();
+	}
+
+	if (!mFile)
+		mOk = false;
+
+	return mOk;
+}
+
+
+bool PackedPositionReader::open(const std::string &path)
+{
+	mFile.close();
+	mFile.clear();
+	mFile.open(path, std::ios::binary);
+
+	if (!mFile)
+	{
+		LOG_ERROR("Could not open packed position file {}", path);
+		return false;
+	}
+
+	char header[PackedFileHeader::SIZE];
+
+	if (!mFile.read(header, sizeof(header)) || std::memcmp(header, PackedFileHeader::MAGIC, sizeof(PackedFileHeader::MAGIC)) != 0)
+	{
+		LOG_ERROR("{} is no packed position file", path);
+		mFile.close();
+		return false;
+	}
+
+	mVersion			= loadLE16(header + 4);
+	uint16_t recordSize = loadLE16(header + 6);
+
+	if (mVersion != PackedFileHeader::VERSION || recordSize != PackedPosition::SIZE)
+	{
+		LOG_ERROR("{} has version {} with {} byte records, expected version {} with {} byte records", path, mVersion, recordSize, PackedFileHeader::VERSION, PackedPosition::SIZE);
+		mFile.close();
+		return false;
+	}
+
+	return true;
+}
+
+
+size_t PackedPositionReader::read(PackedPosition *positions, size_t max)
+{
+	if (!mFile.is_open() || max == 0)
+		return 0;
+
+	mFile.read(reinterpret_cast<char *>(positions), static_cast<std::streamsize>(max * PackedPosition::SIZE));
+
+	return static_cast<size_t>(mFile.gcount()) / PackedPosition::SIZE;
+}
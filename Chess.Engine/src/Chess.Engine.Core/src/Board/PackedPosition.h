@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+	Module:         PackedPosition
+	Description:    Fixed-size 32 byte position encoding for datasets and caches
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "Fen.h"
+#include "Move.h"
+
+class Chessboard;
+
+
+/**
+ * @brief	Game outcome stored with a packed position, ordered like white's result in half points (+1).
+ */
+enum class PackedResult : uint8_t
+{
+	Unknown	 = 0,
+	BlackWin = 1,
+	Draw	 = 2,
+	WhiteWin = 3,
+};
+
+
+/**
+ * @brief	Optional data stored next to the position.
+ */
+struct PackedAnnotation
+{
+	int16_t		 score	  = 0; // Centipawns, from the side to move's view
+	PackedResult result	  = PackedResult::Unknown;
+	Move		 bestMove = Move::none();
+
+	bool		 operator==(const PackedAnnotation &other) const = default;
+};
+
+
+/**
+ * @brief	A position in 32 bytes, all fields little-endian whatever the host byte order:
+ *
+ *	bytes  0 -  7	occupancy bitboard (a8 = bit 0)
+ *	bytes  8 - 23	4-bit piece type of every occupied square in bit order, low nibble first
+ *	bytes 24 - 31	bit  0		side to move (1 = black)
+ *					bits 1-4	castling rights
+ *					bits 5-8	en passant file + 1, 0 for none (the rank follows from the side to move)
+ *					bits 9-10	PackedResult
+ *					bits 11-18	halfmove clock (0 - 255)
+ *					bits 19-31	fullmove number (1 - 8191)
+ *					bits 32-47	score
+ *					bits 48-63	best move
+ *
+ * Positions with more than 32 pieces or clocks out of range are rejected rather than stored lossy,
+ * so everything that packs unpacks to exactly the same position.
+ */
+class PackedPosition
+{
+public:
+	static constexpr size_t	  SIZE					= 32;
+	static constexpr size_t	  MAX_PIECES			= 32;
+	static constexpr uint16_t MAX_HALF_MOVE_CLOCK	= 255;
+	static constexpr uint16_t MAX_FULL_MOVE_NUMBER	= 8191;
+
+	/**
+	 * @return	false if the position has more than 32 pieces or a clock out of range, packed is not written then.
+	 */
+	[[nodiscard]] static bool	pack(const FenPosition &position, const PackedAnnotation &annotation, PackedPosition &packed);
+	[[nodiscard]] static bool	pack(const Chessboard &board, const PackedAnnotation &annotation, PackedPosition &packed);
+
+	void						unpack(FenPosition &position, PackedAnnotation *annotation = nullptr) const;
+	void						unpack(Chessboard &board, PackedAnnotation *annotation = nullptr) const;
+
+	/**
+	 * @brief	Pack count positions (annotations optional). Rejected positions are stored as all zero bytes.
+	 * @return	Number of rejected positions.
+	 */
+	static size_t				packAll(const FenPosition *positions, const PackedAnnotation *annotations, PackedPosition *packed, size_t count);
+
+	/**
+	 * @brief	Unpack count positions (annotations optional).
+	 */
+	static void					unpackAll(const PackedPosition *packed, FenPosition *positions, PackedAnnotation *annotations, size_t count);
+
+	[[nodiscard]] const uint8_t *data() const { return mBytes.data(); }
+	[[nodiscard]] uint8_t		*data() { return mBytes.data(); }
+
+	bool						operator==(const PackedPosition &other) const = default;
+
+private:
+	std::array<uint8_t, SIZE> mBytes{};
+};
+
+static_assert(sizeof(PackedPosition) == PackedPosition::SIZE);
+
+
+/**
+ * @brief	Header of a packed position file, followed by the records back to back.
+ */
+struct PackedFileHeader
+{
+	static constexpr char	  MAGIC[4] = {'C', 'P', 'O', 'S'};
+	static constexpr uint16_t VERSION  = 1;
+	static constexpr size_t	  SIZE	   = 8; // Magic, version (LE16), record size (LE16)
+};
+
+
+/**
+ * @brief	Streams packed positions into a file through a buffer of whole records.
+ */
+class PackedPositionWriter
+{
+public:
+	PackedPositionWriter() = default;
+	~PackedPositionWriter() { close(); }
+
+	/**
+	 * @brief	Create (or truncate) the file and write the header.
+	 * @return	false (logged) if the file can't be created.
+	 */
+	bool						open(const std::string &path);
+
+	bool						write(const PackedPosition &position);
+	bool						write(const PackedPosition *positions, size_t count);
+
+	/**
+	 * @brief	Flush the buffer and close the file.
+	 * @return	false if a write failed since open().
+	 */
+	bool						close();
+
+	[[nodiscard]] size_t		count() const { return mCount; }
+
+private:
+	bool						flush();
+
+	static constexpr size_t		BUFFER_RECORDS = 4096;
+
+	std::ofstream				mFile;
+	std::vector<PackedPosition> mBuffer;
+	size_t						mCount = 0;
+	bool						mOk	   = false;
+};
+
+
+/**
+ * @brief	Streams packed positions out of a file, checking the header first.
+ */
+class PackedPositionReader
+{
+public:
+	/**
+	 * @return	false (logged) if the file can't be opened, is no packed position file, or has another version or record size.
+	 */
+	bool				 open(const std::string &path);
+
+	/**
+	 * @brief	Read up to max records.
+	 * @return	Records read, 0 at the end of the file. A truncated last record is dropped.
+	 */
+	size_t				 read(PackedPosition *positions, size_t max);
+
+	bool				 next(PackedPosition &position) { return read(&position, 1) == 1; }
+
+	void				 close() { mFile.close(); }
+
+	[[nodiscard]] uint16_t version() const { return mVersion; }
+
+private:
+	std::ifstream		 mFile;
+	uint16_t			 mVersion = 0;
+};
@@ -0,0 +1,874 @@
+/*
+  ==============================================================================
+	Module:         BookBuilder
+	Description:    Builds Polyglot opening books from PGN game collections
+  ==============================================================================
+*/
+
+#include "BookBuilder.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <queue>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "GameEngine.h"
+#include "Logging.h"
+#include "MappedFile.h"
+#include "Notation/MoveNotation.h"
+#include "PolyglotBook.h"
+
+
+namespace
+{
+
+constexpr size_t SHARD_COUNT	  = 64;
+constexpr size_t MIN_CHUNK_BYTES  = 1 << 20;
+constexpr size_t FLUSH_SAMPLES	  = 4096; // Samples a worker collects before taking the shard locks
+constexpr size_t RUN_BUFFER		  = 4096; // Records read from a run file at once
+
+
+/**
+ * @brief	Counts of one (position, move) pair, also the record format of the run files.
+ */
+struct BookRecord
+{
+	uint64_t key	= 0;
+	uint16_t move	= 0;
+	uint32_t wins	= 0;
+	uint32_t draws	= 0;
+	uint32_t losses = 0;
+
+	uint64_t games() const { return static_cast<uint64_t>(wins) + draws + losses; }
+	uint64_t weight() const { return 2 * static_cast<uint64_t>(wins) + draws; }
+};
+
+
+inline bool recordLess(const BookRecord &a, const BookRecord &b)
+{
+	return a.key != b.key ? a.key < b.key : a.move < b.move;
+}
+
+
+struct EntryKey
+{
+	uint64_t key  = 0;
+	uint16_t move = 0;
+
+	bool	 operator==(const EntryKey &other) const = default;
+};
+
+
+struct EntryKeyHash
+{
+	size_t operator()(const EntryKey &entry) const { return static_cast<size_t>(entry.key ^ (entry.move * 0x9E3779B97F4A7C15ULL)); }
+};
+
+
+struct Counts
+{
+	uint32_t wins	= 0;
+	uint32_t draws	= 0;
+	uint32_t losses = 0;
+};
+
+
+/**
+ * @brief	A position and move seen in a game, with the game's result for the side to move (+1, 0, -1).
+ */
+struct Sample
+{
+	uint64_t key	= 0;
+	uint16_t move	= 0;
+	int8_t	 result = 0;
+};
+
+
+inline size_t shardOf(uint64_t key, uint16_t move)
+{
+	return EntryKeyHash()({key, move}) >> 58; // Top 6 bits: 64 shards
+}
+
+static_assert(SHARD_COUNT == 64);
+
+
+struct Shard
+{
+	std::mutex										  mutex;
+	std::unordered_map<EntryKey, Counts, EntryKeyHash> entries;
+};
+
+
+/**
+ * @brief	Shared state of one build.
+ */
+struct BuildState
+{
+	const BookBuildOptions			 &options;
+	std::array<Shard, SHARD_COUNT>	  shards;
+	size_t							  shardLimit = 0;
+
+	std::mutex						  runMutex;
+	std::vector<std::string>		  runs;
+	std::string						  runPrefix;
+	std::atomic<bool>				  failed{false};
+
+	std::atomic<size_t>				  games{0};
+	std::atomic<size_t>				  skippedGames{0};
+	std::atomic<size_t>				  brokenGames{0};
+	std::atomic<uint64_t>			  samples{0};
+
+	explicit BuildState(const BookBuildOptions &buildOptions) : options(buildOptions) {}
+};
+
+
+std::vector<BookRecord> sortedRecords(const std::unordered_map<EntryKey, Counts, EntryKeyHash> &entries)
+{
+	std::vector<BookRecord> records;
+	records.reserve(entries.size());
+
+	for (const auto &[entry, counts] : entries)
+		records.push_back({entry.key, entry.move, counts.wins, counts.draws, counts.losses});
+
+	std::sort(records.begin(), records.end(), recordLess);
+	return records;
+}
+
+
+/**
+ * @brief	Write the shard as a sorted run and empty it (the caller holds the shard lock).
+ */
+void spillShard(BuildState &state, Shard &shard)
+{
+	std::vector<BookRecord> records = sortedRecords(shard.entries);
+	shard.entries.clear();
+
+	std::string path;
+
+	{
+		std::lock_guard<std::mutex> lock(state.runMutex);
+		path = state.runPrefix + std::to_string(state.runs.size()) + ".run";
+		state.runs.push_back(path);
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(reinterpret_cast<const char *>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(BookRecord)));
+
+	if (!file)
+	{
+		LOG_ERROR("Could not write the book run {}", path);
+		state.failed.store(true);
+	}
+}
+
+
+void flushSamples(BuildState &state, std::vector<Sample> &samples)
+{
+	// Group by shard, so every shard is locked once per flush
+	std::sort(samples.begin(), samples.end(), [](const Sample &a, const Sample &b) { return shardOf(a.key, a.move) < shardOf(b.key, b.move); });
+
+	for (size_t begin = 0; begin < samples.size();)
+	{
+		size_t index = shardOf(samples[begin].key, samples[begin].move);
+		size_t end	 = begin;
+		Shard &shard = state.shards[index];
+
+		std::lock_guard<std::mutex> lock(shard.mutex);
+
+		for (; end < samples.size() && shardOf(samples[end].key, samples[end].move) == index; ++end)
+		{
+			Counts &counts = shard.entries[{samples[end].key, samples[end].move}];
+
+			if (samples[end].result > 0)
+				++counts.wins;
+			else if (samples[end].result < 0)
+				++counts.losses;
+			else
+				++counts.draws;
+		}
+
+		if (shard.entries.size() > state.shardLimit)
+			spillShard(state, shard);
+
+		begin = end;
+	}
+
+	state.samples += samples.size();
+	samples.clear();
+}
+
+
+inline bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+
+/**
+ * @brief	Value of a tag line ([Result "1-0"]) if it has the name, empty otherwise.
+ */
+std::string_view tagValue(std::string_view line, std::string_view name)
+{
+	if (line.size() < name.size() + 2 || line.substr(1, name.size()) != name || !isSpace(line[name.size() + 1]))
+		return {};
+
+	size_t open	 = line.find('"');
+	size_t close = line.rfind('"');
+
+	if (open == std::string_view::npos || close <= open)
+		return {};
+
+	return line.substr(open + 1, close - open - 1);
+}
+
+
+/**
+ * @brief	Next SAN token of the movetext, skipping comments, variations, NAGs, move numbers and the result.
+ * @return	false at the end of the movetext.
+ */
+bool nextSAN(std::string_view text, size_t &pos, std::string_view &san)
+{
+	while (pos < text.size())
+	{
+		char c = text[pos];
+
+		if (isSpace(c))
+		{
+			++pos;
+			continue;
+		}
+
+		if (c == '{')
+		{
+			size_t close = text.find('}', pos);
+			pos			 = close == std::string_view::npos ? text.size() : close + 1;
+			continue;
+		}
+
+		if (c == ';')
+		{
+			size_t lineEnd = text.find('\n', pos);
+			pos			   = lineEnd == std::string_view::npos ? text.size() : lineEnd + 1;
+			continue;
+		}
+
+		if (c == '(')
+		{
+			// Variations nest
+			int depth = 0;
+
+			for (; pos < text.size(); ++pos)
+			{
+				if (text[pos] == '{')
+				{
+					size_t close = text.find('}', pos);
+					pos			 = close == std::string_view::npos ? text.size() - 1 : close;
+				}
+				else if (text[pos] == '(')
+					++depth;
+				else if (text[pos] == ')' && --depth == 0)
+					break;
+			}
+
+			++pos;
+			continue;
+		}
+
+		size_t begin = pos;
+
+		while (pos < text.size() && !isSpace(text[pos]) && text[pos] != '{' && text[pos] != '(' && text[pos] != ';')
+			++pos;
+
+		std::string_view token = text.substr(begin, pos - begin);
+
+		// Move numbers may be glued to the move ("12.e4", "12...Nf6")
+		size_t digits = 0;
+
+		while (digits < token.size() && token[digits] >= '0' && token[digits] <= '9')
+			++digits;
+
+		if (digits > 0 && digits < token.size() && token[digits] == '.')
+		{
+			token.remove_prefix(digits);
+		}
+		else if (digits == token.size() || token == "1-0" || token == "0-1" || token == "1/2-1/2")
+		{
+			continue;
+		}
+
+		while (!token.empty() && token.front() == '.')
+			token.remove_prefix(1);
+
+		if (token.empty() || token.front() == '$' || token == "*")
+			continue;
+
+		san = token;
+		return true;
+	}
+
+	return false;
+}
+
+
+/**
+ * @brief	Replay the movetext and collect the samples of the first maxPly plies.
+ */
+void replayGame(BuildState &state, GameEngine &engine, std::string_view fen, int whiteResult, std::string_view movetext, std::vector<Sample> &samples)
+{
+	engine.resetGame();
+
+	if (!fen.empty())
+	{
+		FenPosition position;
+
+		if (Fen::parse(fen, position) != FenError::None || Fen::validate(position) != FenError::None)
+		{
+			++state.skippedGames;
+			return;
+		}
+
+		engine.getBoard().setPosition(position);
+	}
+
+	++state.games;
+
+	MoveList		 legalMoves;
+	std::string_view san;
+	size_t			 pos = 0;
+
+	for (int ply = 0; ply < state.options.maxPly && nextSAN(movetext, pos, san); ++ply)
+	{
+		engine.generateLegalMoves(legalMoves);
+
+		Move move = MoveNotation::fromSAN(san, engine.getBoard(), legalMoves);
+
+		if (!move.isValid())
+		{
+			++state.brokenGames;
+			return;
+		}
+
+		Side   side	  = engine.getBoard().getCurrentSide();
+		int8_t result = static_cast<int8_t>(side == Side::White ? whiteResult : -whiteResult);
+
+		samples.push_back({PolyglotBook::computeKey(engine.getBoard()), PolyglotBook::encodeMove(move), result});
+
+		if (samples.size() >= FLUSH_SAMPLES)
+			flushSamples(state, samples);
+
+		engine.makeMoveUnchecked(move);
+	}
+}
+
+
+/**
+ * @brief	Parse the games of a chunk: tag lines, then movetext up to the next tag line.
+ */
+void parseChunk(BuildState &state, GameEngine &engine, std::string_view text, std::vector<Sample> &samples)
+{
+	std::string_view result;
+	std::string_view fen;
+	size_t			 movetextBegin = std::string_view::npos;
+	size_t			 pos		   = 0;
+
+	auto			 finishGame	   = [&](size_t movetextEnd)
+	{
+		if (movetextBegin == std::string_view::npos)
+			return;
+
+		std::string_view movetext = text.substr(movetextBegin, movetextEnd - movetextBegin);
+
+		if (result == "1-0")
+			replayGame(state, engine, fen, 1, movetext, samples);
+		else if (result == "0-1")
+			replayGame(state, engine, fen, -1, movetext, samples);
+		else if (result == "1/2-1/2")
+			replayGame(state, engine, fen, 0, movetext, samples);
+		else
+			++state.skippedGames;
+
+		result		  = {};
+		fen			  = {};
+		movetextBegin = std::string_view::npos;
+	};
+
+	while (pos < text.size())
+	{
+		size_t end = text.find('\n', pos);
+
+		if (end == std::string_view::npos)
+			end = text.size();
+
+		std::string_view line = text.substr(pos, end - pos);
+
+		if (!line.empty() && line.back() == '\r')
+			line.remove_suffix(1);
+
+		if (!line.empty() && line.front() == '[')
+		{
+			finishGame(pos);
+
+			if (auto value = tagValue(line, "Result"); !value.empty())
+				result = value;
+			else if (auto value = tagValue(line, "FEN"); !value.empty())
+				fen = value;
+		}
+		else if (movetextBegin == std::string_view::npos && !line.empty() && line.front() != '%')
+		{
+			movetextBegin = pos;
+		}
+
+		pos = end + 1;
+	}
+
+	finishGame(text.size());
+}
+
+
+/**
+ * @brief	Cut the text into chunks that start at a game ("[Event " at the start of a line).
+ */
+std::vector<std::string_view> splitGames(std::string_view text, size_t count)
+{
+	std::vector<std::string_view> chunks;
+	size_t						  begin = 0;
+
+	for (size_t i = 1; i <= count && begin < text.size(); ++i)
+	{
+		size_t end = i == count ? text.size() : std::max(begin, text.size() * i / count);
+
+		if (end < text.size())
+		{
+			size_t next = text.find("\n[Event ", end);
+			end			= next == std::string_view::npos ? text.size() : next + 1;
+		}
+
+		if (end > begin)
+			chunks.push_back(text.substr(begin, end - begin));
+
+		begin = end;
+	}
+
+	return chunks;
+}
+
+
+/**
+ * @brief	Sorted records of a run file or of a shard left in memory.
+ */
+class RunSource
+{
+public:
+	explicit RunSource(std::vector<BookRecord> records) : mBuffer(std::move(records)) {}
+	explicit RunSource(const std::string &path) : mFile(path, std::ios::binary), mFromFile(true)
+	{
+		mBuffer.reserve(RUN_BUFFER);
+		mFailed = !mFile.is_open();
+	}
+
+	bool next(BookRecord &record)
+	{
+		if (mIndex == mBuffer.size() && !refill())
+			return false;
+
+		record = mBuffer[mIndex++];
+		return true;
+	}
+
+	/**
+	 * @brief	The run file could not be opened or was not read to its end in whole records.
+	 */
+	bool failed() const { return mFailed; }
+
+private:
+	bool refill()
+	{
+		if (!mFromFile || mFailed)
+			return false;
+
+		mBuffer.resize(RUN_BUFFER);
+		mFile.read(reinterpret_cast<char *>(mBuffer.data()), static_cast<std::streamsize>(RUN_BUFFER * sizeof(BookRecord)));
+
+		size_t bytes = static_cast<size_t>(mFile.gcount());
+		mBuffer.resize(bytes / sizeof(BookRecord));
+		mIndex = 0;
+
+		if (mFile.bad() || bytes % sizeof(BookRecord) != 0)
+		{
+			mFailed = true;
+			mBuffer.clear();
+		}
+
+		return !mBuffer.empty();
+	}
+
+	std::ifstream			mFile;
+	std::vector<BookRecord> mBuffer;
+	size_t					mIndex	  = 0;
+	bool					mFromFile = false;
+	bool					mFailed	  = false;
+};
+
+
+/**
+ * @brief	Open the run files of [begin, end) as merge sources.
+ * @return	false (logged) if one can't be opened.
+ */
+bool openRuns(const std::vector<std::string> &runs, size_t begin, size_t end, std::vector<RunSource> &sources)
+{
+	for (size_t i = begin; i < end; ++i)
+	{
+		sources.emplace_back(runs[i]);
+
+		if (sources.back().failed())
+		{
+			LOG_ERROR("Could not open the book run {}", runs[i]);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief	Merge the sources in (key, move) order, records of the same key and move combined, and hand each to emit.
+ * @return	false (logged) if a run file could not be read to its end.
+ */
+template <typename Emit>
+bool mergeRecords(std::vector<RunSource> &sources, Emit &&emit)
+{
+	using Head = std::pair<BookRecord, size_t>;
+
+	auto greater = [](const Head &a, const Head &b) { return recordLess(b.first, a.first); };
+	std::priority_queue<Head, std::vector<Head>, decltype(greater)> heads(greater);
+
+	for (size_t i = 0; i < sources.size(); ++i)
+	{
+		BookRecord record;
+
+		if (sources[i].next(record))
+			heads.push({record, i});
+	}
+
+	BookRecord current;
+	bool	   hasCurrent = false;
+
+	while (!heads.empty())
+	{
+		auto [record, source] = heads.top();
+		heads.pop();
+
+		if (hasCurrent && current.key == record.key && current.move == record.move)
+		{
+			current.wins += record.wins;
+			current.draws += record.draws;
+			current.losses += record.losses;
+		}
+		else
+		{
+			if (hasCurrent)
+				emit(current);
+
+			current	   = record;
+			hasCurrent = true;
+		}
+
+		if (sources[source].next(record))
+			heads.push({record, source});
+	}
+
+	if (hasCurrent)
+		emit(current);
+
+	for (const auto &source : sources)
+	{
+		if (source.failed())
+		{
+			LOG_ERROR("A book run could not be read to its end");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief	Merge the run files of [begin, end) into one run file.
+ * @return	false (logged) if a run can't be read or the merged run can't be written.
+ */
+bool mergeRuns(const std::vector<std::string> &runs, size_t begin, size_t end, const std::string &path)
+{
+	std::vector<RunSource> sources;
+	sources.reserve(end - begin);
+
+	if (!openRuns(runs, begin, end, sources))
+		return false;
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+
+	if (!file)
+	{
+		LOG_ERROR("Could not create the book run {}", path);
+		return false;
+	}
+
+	std::vector<BookRecord> buffer;
+	buffer.reserve(RUN_BUFFER);
+
+	auto flush = [&]
+	{
+		file.write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size() * sizeof(BookRecord)));
+		buffer.clear();
+	};
+
+	bool merged = mergeRecords(sources,
+							   [&](const BookRecord &record)
+							   {
+								   buffer.push_back(record);
+
+								   if (buffer.size() == RUN_BUFFER)
+									   flush();
+							   });
+
+	flush();
+	file.close();
+
+	if (!file)
+	{
+		LOG_ERROR("Could not write the book run {}", path);
+		return false;
+	}
+
+	return merged;
+}
+
+
+/**
+ * @brief	Writes the moves of one position, weighted with 2 * wins + draws and scaled to 16 bits.
+ */
+size_t writePosition(std::ofstream &book, const std::vector<BookRecord> &moves, uint32_t minGames)
+{
+	uint64_t maxWeight = 0;
+
+	for (const auto &move : moves)
+	{
+		if (move.games() >= minGames)
+			maxWeight = std::max(maxWeight, move.weight());
+	}
+
+	if (maxWeight == 0)
+		return 0;
+
+	size_t written = 0;
+
+	for (const auto &move : moves)
+	{
+		uint64_t weight = move.weight();
+
+		if (move.games() < minGames || weight == 0)
+			continue;
+
+		if (maxWeight > UINT16_MAX)
+			weight = std::max<uint64_t>(1, weight * UINT16_MAX / maxWeight);
+
+		PolyglotEntry entry;
+		entry.key	 = move.key;
+		entry.move	 = move.move;
+		entry.weight = static_cast<uint16_t>(weight);
+
+		char bytes[PolyglotBook::ENTRY_SIZE];
+		PolyglotBook::writeEntry(entry, bytes);
+		book.write(bytes, sizeof(bytes));
+		++written;
+	}
+
+	return written;
+}
+
+
+/**
+ * @brief	Merge the sources in (key, move) order into the book.
+ * @return	false (logged) if a run file could not be read to its end.
+ */
+bool mergeInto(std::ofstream &book, std::vector<RunSource> &sources, uint32_t minGames, size_t &written)
+{
+	std::vector<BookRecord> position; // Moves of the current key
+	written = 0;
+
+	bool merged = mergeRecords(sources,
+							   [&](const BookRecord &record)
+							   {
+								   if (!position.empty() && position.back().key != record.key)
+								   {
+									   written += writePosition(book, position, minGames);
+									   position.clear();
+								   }
+
+								   position.push_back(record);
+							   });
+
+	written += writePosition(book, position, minGames);
+	return merged;
+}
+
+} // namespace
+
+
+bool BookBuilder::build(const std::string &pgnPath, const std::string &bookPath, const BookBuildOptions &options, BookBuildResult &result)
+{
+	using Clock = std::chrono::steady_clock;
+	auto start	= Clock::now();
+
+	result		= BookBuildResult();
+
+	MappedFile pgn;
+
+	if (!pgn.open(pgnPath))
+		return false;
+
+	BuildState state(options);
+	state.shardLimit = std::max<size_t>(1, options.maxEntries / SHARD_COUNT);
+
+	std::filesystem::path tempDirectory = options.tempDirectory.empty() ? std::filesystem::temp_directory_path() : std::filesystem::path(options.tempDirectory);
+	state.runPrefix = (tempDirectory / ("book_" + std::to_string(Clock::now().time_since_epoch().count()) + "_")).string();
+
+	// Parse and count
+	int threads = options.threads > 0 ? options.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+	std::vector<std::string_view> chunks = splitGames(pgn.view(), std::max<size_t>(1, std::min<size_t>(threads * 8, pgn.size() / MIN_CHUNK_BYTES)));
+	std::atomic<size_t>			  next{0};
+
+	auto						  work = [&]()
+	{
+		GameEngine engine;
+		engine.init();
+
+		std::vector<Sample> samples;
+		samples.reserve(FLUSH_SAMPLES);
+
+		for (size_t index = next++; index < chunks.size() && !state.failed.load(); index = next++)
+			parseChunk(state, engine, chunks[index], samples);
+
+		flushSamples(state, samples);
+	};
+
+	std::vector<std::thread> workers;
+
+	for (int t = 0; t < std::min<int>(threads, static_cast<int>(std::max<size_t>(1, chunks.size()))); ++t)
+		workers.emplace_back(work);
+
+	for (auto &worker : workers)
+		worker.join();
+
+	result.games		= state.games;
+	result.skippedGames = state.skippedGames;
+	result.brokenGames	= state.brokenGames;
+	result.samples		= state.samples;
+	result.spilledRuns	= state.runs.size();
+
+	bool					 ok		 = !state.failed.load();
+	std::vector<std::string> runs	 = state.runs;
+	size_t					 fanIn	 = std::max<size_t>(2, options.maxMergeRuns);
+	size_t					 nextRun = runs.size();
+
+	// Too many runs to open at once: merge groups of them into larger runs until few enough are left
+	while (ok && runs.size() > fanIn)
+	{
+		std::vector<std::string> merged;
+
+		for (size_t begin = 0; begin < runs.size(); begin += fanIn)
+		{
+			size_t end = std::min(begin + fanIn, runs.size());
+
+			if (end - begin == 1)
+			{
+				merged.push_back(runs[begin]);
+				continue;
+			}
+
+			std::string path = state.runPrefix + std::to_string(nextRun++) + ".run";
+			merged.push_back(path);
+
+			if (!mergeRuns(runs, begin, end, path))
+			{
+				ok = false;
+				merged.insert(merged.end(), runs.begin() + begin, runs.end()); // Removed below
+				break;
+			}
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				std::error_code error;
+				std::filesystem::remove(runs[i], error);
+			}
+		}
+
+		runs.swap(merged);
+		++result.mergePasses;
+	}
+
+	// Merge the runs with what is left in memory
+	std::vector<RunSource> sources;
+	sources.reserve(runs.size() + SHARD_COUNT);
+
+	if (ok)
+		ok = openRuns(runs, 0, runs.size(), sources);
+
+	if (ok)
+	{
+		for (auto &shard : state.shards)
+		{
+			if (!shard.entries.empty())
+				sources.emplace_back(sortedRecords(shard.entries));
+
+			shard.entries.clear();
+		}
+
+		std::ofstream book(bookPath, std::ios::binary | std::ios::trunc);
+
+		if (!book)
+		{
+			LOG_ERROR("Could not create the book {}", bookPath);
+			ok = false;
+		}
+		else
+		{
+			ok = mergeInto(book, sources, std::max<uint32_t>(1, options.minGames), result.entries);
+			book.close();
+
+			if (!book)
+			{
+				LOG_ERROR("Could not write the book {}", bookPath);
+				ok = false;
+			}
+		}
+	}
+
+	sources.clear(); // Close the run files before removing them
+
+	for (const auto &run : runs)
+	{
+		std::error_code error;
+		std::filesystem::remove(run, error);
+	}
+
+	result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	if (ok)
+	{
+		LOG_INFO("Built {} with {} entries from {} games ({} skipped, {} broken, {} spilled runs, {} merge passes) in {:.1f} s", bookPath, result.entries,
+				 result.games, result.skippedGames, result.brokenGames, result.spilledRuns, result.mergePasses, result.seconds);
+	}
+
+	return ok;
+}
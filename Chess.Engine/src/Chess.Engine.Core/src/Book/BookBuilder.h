@@ -0,0 +1,63 @@
+/*
+  ==============================================================================
+	Module:         BookBuilder
+	Description:    Builds Polyglot opening books from PGN game collections
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+
+struct BookBuildOptions
+{
+	static constexpr size_t DEFAULT_MAX_ENTRIES	   = 4'000'000;
+	static constexpr size_t DEFAULT_MAX_MERGE_RUNS = 64;
+	static constexpr size_t BYTES_PER_ENTRY		   = 64; // Hash map node with key, counts and its share of the buckets
+
+	static constexpr size_t entriesForMegabytes(size_t megabytes) { return megabytes * 1024 * 1024 / BYTES_PER_ENTRY; }
+
+	int						threads				   = 0;						 // Parsing threads, 0 for all cores
+	int						maxPly				   = 30;					 // Plies of every game that enter the book
+	uint32_t				minGames			   = 3;						 // Games a move needs to be kept
+	size_t					maxEntries			   = DEFAULT_MAX_ENTRIES;	 // (position, move) pairs held in memory before sorted runs are spilled to disk
+	size_t					maxMergeRuns		   = DEFAULT_MAX_MERGE_RUNS; // Run files open at once, more are first merged in passes (at least 2)
+	std::string				tempDirectory;									 // Directory of the spilled runs, empty for the system temp directory
+};
+
+
+struct BookBuildResult
+{
+	size_t	 games		  = 0; // Games replayed
+	size_t	 skippedGames = 0; // Games without a result or with an invalid start position
+	size_t	 brokenGames  = 0; // Games with an unreadable or illegal move (replayed up to it)
+	uint64_t samples	  = 0; // (position, move) occurrences counted
+	size_t	 entries	  = 0; // Book entries written
+	size_t	 spilledRuns  = 0;
+	size_t	 mergePasses  = 0; // Passes that merged runs into larger runs before the book was written
+	double	 seconds	  = 0.0;
+};
+
+
+/**
+ * @brief	Turns a PGN collection into a Polyglot book.
+ *
+ * The file is mapped and cut at game boundaries into chunks that worker threads take from a shared counter.
+ * Every worker replays its games on its own GameEngine and counts wins, draws and losses (seen from the side
+ * to move) per position key and move in a sharded hash map, one mutex per shard. A shard that grows past its
+ * part of maxEntries is sorted and spilled to a run file, so memory stays bounded whatever the input size.
+ * In the end the runs and the remaining shards are merged in key order; moves played in fewer than minGames
+ * games are dropped and the others weighted with 2 * wins + draws, scaled per position to fit 16 bits.
+ * With more than maxMergeRuns runs, groups of that many are first merged into larger runs, pass by pass,
+ * so the number of open files stays bounded too.
+ */
+class BookBuilder
+{
+public:
+	/**
+	 * @return	false (logged) if the PGN file can't be mapped, the book can't be written or a run file can't be written or read back.
+	 */
+	static bool build(const std::string &pgnPath, const std::string &bookPath, const BookBuildOptions &options, BookBuildResult &result);
+};
@@ -0,0 +1,104 @@
+/*
+  ==============================================================================
+	Module:         PolyglotBook
+	Description:    Memory-mapped opening book in the Polyglot .bin format
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+#include "Fen.h"
+#include "MappedFile.h"
+#include "Move.h"
+
+class Chessboard;
+
+
+/**
+ * @brief	One book entry, decoded from its 16 big-endian bytes: key (8), move (2), weight (2), learn (4).
+ */
+struct PolyglotEntry
+{
+	uint64_t key	= 0;
+	uint16_t move	= 0; // Polyglot move encoding, see PolyglotBook::encodeMove()
+	uint16_t weight = 0;
+	uint32_t learn	= 0;
+
+	bool	 operator==(const PolyglotEntry &other) const = default;
+};
+
+
+/**
+ * @brief	Read-only opening book. The file is mapped, not loaded: a probe is a binary search over the
+ *			entries sorted by key (O(log n) page touches) and never allocates.
+ *
+ * Positions are keyed the Polyglot way (pieces by kind and square, castling rights, the en passant file only
+ * if a pawn can take, white to move), independent of ZobristHash. The 781 random values behind the key are
+ * generated here rather than copied from the published Random64 table, so books written with computeKey()
+ * match, while third-party books only match once that table replaces the generated one.
+ */
+class PolyglotBook
+{
+public:
+	static constexpr size_t ENTRY_SIZE = 16;
+
+	/**
+	 * @brief	Map a book file, replacing the book opened before.
+	 * @return	false (logged) if the file can't be mapped or its size is no multiple of the entry size.
+	 */
+	bool					open(const std::string &path);
+
+	void					close();
+
+	[[nodiscard]] bool		isOpen() const { return mFile.isOpen(); }
+	[[nodiscard]] size_t	size() const { return mFile.size() / ENTRY_SIZE; }
+
+	[[nodiscard]] PolyglotEntry entry(size_t index) const;
+
+	/**
+	 * @brief	Index of the first entry with the key (or with the next larger key, size() if none).
+	 */
+	[[nodiscard]] size_t	lowerBound(uint64_t key) const;
+
+	/**
+	 * @brief	Number of entries with the key, starting at lowerBound(key).
+	 */
+	[[nodiscard]] size_t	count(uint64_t key) const;
+
+	/**
+	 * @brief	Choose a book move for the position among its legal moves.
+	 * @param	random		Picks a move with a probability proportional to its weight, nullptr for the heaviest move.
+	 * @return	Move::none() if the position is not in the book or none of its moves is legal with weight > 0.
+	 */
+	Move					probe(const Chessboard &board, const MoveList &legalMoves, std::mt19937 *random = nullptr) const;
+
+	//=========================================================================
+	// Format
+	//=========================================================================
+
+	static uint64_t			computeKey(const FenPosition &position);
+	static uint64_t			computeKey(const Chessboard &board);
+
+	/**
+	 * @brief	Polyglot move: to file (bits 0-2), to row (3-5), from file (6-8), from row (9-11), promotion
+	 *			(12-14: none, N, B, R, Q). Castling is written as the king taking its own rook (e1h1).
+	 */
+	static uint16_t			encodeMove(Move move);
+
+	/**
+	 * @brief	The legal move written as raw, Move::none() if there is none.
+	 */
+	static Move				decodeMove(uint16_t raw, const MoveList &legalMoves);
+
+	static PolyglotEntry	readEntry(const char *bytes);
+	static void				writeEntry(const PolyglotEntry &entry, char *bytes);
+
+private:
+	[[nodiscard]] uint64_t	keyAt(size_t index) const;
+
+	MappedFile				mFile;
+};
@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+	Module:         BitboardKernels
+	Description:    Batched bitboard operations (AVX2 with a scalar fallback)
+  ==============================================================================
+*/
+
+#pragma once
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "BitboardUtils.h"
+
+
+/**
+ * @brief	Bitboard kernels working on 4 bitboards at a time.
+ *			With AVX2 (e.g. /arch:AVX2 or -mavx2) four bitboards fit one 256-bit register,
+ *			otherwise the same interface falls back to scalar loops.
+ *			Arrays passed to the kernels hold a multiple of LANES entries (pad with 0).
+ */
+namespace BitKernels
+{
+
+constexpr int LANES = 4;
+
+
+#if defined(__AVX2__)
+
+/**
+ * @brief	Per-lane popcount of four 64-bit values (nibble lookup, then byte sums per lane).
+ */
+inline __m256i popCountLanes(__m256i v)
+{
+	const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i low	 = _mm256_set1_epi8(0x0F);
+
+	__m256i		  lo	 = _mm256_shuffle_epi8(lookup, _mm256_and_si256(v, low));
+	__m256i		  hi	 = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(v, 4), low));
+
+	return _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256());
+}
+
+#endif
+
+
+/**
+ * @brief	counts[i] = popCount(bitboards[i] & mask) for four bitboards.
+ */
+inline void popCount4(const U64 *bitboards, U64 mask, int *counts)
+{
+#if defined(__AVX2__)
+	__m256i v = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(bitboards)), _mm256_set1_epi64x(static_cast<long long>(mask)));
+
+	alignas(32) U64 lanes[LANES];
+	_mm256_store_si256(reinterpret_cast<__m256i *>(lanes), popCountLanes(v));
+
+	for (int i = 0; i < LANES; ++i)
+		counts[i] = static_cast<int>(lanes[i]);
+#else
+	for (int i = 0; i < LANES; ++i)
+		counts[i] = BitUtils::popCount(bitboards[i] & mask);
+#endif
+}
+
+
+/**
+ * @brief	Union of four bitboards.
+ */
+inline U64 union4(const U64 *bitboards)
+{
+#if defined(__AVX2__)
+	__m256i v	   = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(bitboards));
+	__m128i folded = _mm_or_si128(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+	folded		   = _mm_or_si128(folded, _mm_unpackhi_epi64(folded, folded));
+	return static_cast<U64>(_mm_cvtsi128_si64(folded));
+#else
+	return bitboards[0] | bitboards[1] | bitboards[2] | bitboards[3];
+#endif
+}
+
+
+/**
+ * @brief	counts[i] = popCount(bitboards[i] & mask) for `size` bitboards (size is a multiple of LANES).
+ */
+inline void popCountMasked(const U64 *bitboards, int size, U64 mask, int *counts)
+{
+	for (int i = 0; i < size; i += LANES)
+		popCount4(bitboards + i, mask, counts + i);
+}
+
+
+/**
+ * @brief	Union of `size` bitboards (size is a multiple of LANES).
+ */
+inline U64 unionAll(const U64 *bitboards, int size)
+{
+	U64 result = 0;
+
+	for (int i = 0; i < size; i += LANES)
+		result |= union4(bitboards + i);
+
+	return result;
+}
+
+} // namespace BitKernels
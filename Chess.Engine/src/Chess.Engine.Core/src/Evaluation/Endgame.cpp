@@ -0,0 +1,342 @@
+/*
+  ==============================================================================
+	Module:         Endgame
+	Description:    Specialized evaluation of endgames, dispatched by the material key
+  ==============================================================================
+*/
+
+#include "Endgame.h"
+
+#include <algorithm>
+#include <array>
+
+#include "KPKBitbase.h"
+#include "PieceValues.h"
+
+
+namespace
+{
+
+// a8, h1 and every other square of their colour
+constexpr U64 EVEN_SQUARES = 0xAA55AA55AA55AA55ULL;
+
+
+//=========================================================================
+// Helpers
+//=========================================================================
+
+int squareOf(U64 bb)
+{
+	return BitUtils::lsb(bb);
+}
+
+
+constexpr int distance(int a, int b)
+{
+	int files = a % 8 > b % 8 ? a % 8 - b % 8 : b % 8 - a % 8;
+	int rows  = a / 8 > b / 8 ? a / 8 - b / 8 : b / 8 - a / 8;
+	return std::max(files, rows);
+}
+
+
+/**
+ * @brief	Manhattan distance to the four centre squares (0 to 6).
+ */
+constexpr int centreDistance(int sq)
+{
+	int file = sq % 8;
+	int row	 = sq / 8;
+	return (file < 4 ? 3 - file : file - 4) + (row < 4 ? 3 - row : row - 4);
+}
+
+
+// Drive the losing king to the edge and bring the winning king closer
+constexpr int pushToEdge(int sq)
+{
+	return 20 * centreDistance(sq);
+}
+
+
+constexpr int pushClose(int a, int b)
+{
+	return 10 * (7 - distance(a, b));
+}
+
+
+PieceType ofSide(PieceType white, Side side)
+{
+	return side == Side::White ? white : static_cast<PieceType>(white + BKing);
+}
+
+
+Side opponent(Side side)
+{
+	return side == Side::White ? Side::Black : Side::White;
+}
+
+
+//=========================================================================
+// Endgames
+//=========================================================================
+
+/**
+ * @brief	Bare kings, a single minor piece or two knights: no forced mate.
+ */
+bool evaluateDraw(const Chessboard &, Side, int &score)
+{
+	score = 0;
+	return true;
+}
+
+
+/**
+ * @brief	Rook or queen against a bare king: a known win, the losing king is driven to the edge.
+ */
+bool evaluateKXK(const Chessboard &board, Side strong, int &score)
+{
+	const auto &pieces	   = board.pieces();
+	int			strongKing = squareOf(pieces[ofSide(WKing, strong)]);
+	int			weakKing   = squareOf(pieces[ofSide(WKing, opponent(strong))]);
+
+	int			material   = BitUtils::popCount(pieces[ofSide(WQueen, strong)]) * PieceValues::QUEEN + BitUtils::popCount(pieces[ofSide(WRook, strong)]) * PieceValues::ROOK;
+
+	score				   = Endgames::KNOWN_WIN + material + pushToEdge(weakKing) + pushClose(strongKing, weakKing);
+	return true;
+}
+
+
+/**
+ * @brief	Bishop and knight against a bare king: mate is only possible in a corner of the bishop's colour.
+ */
+bool evaluateKBNK(const Chessboard &board, Side strong, int &score)
+{
+	const auto &pieces		   = board.pieces();
+	int			strongKing	   = squareOf(pieces[ofSide(WKing, strong)]);
+	int			weakKing	   = squareOf(pieces[ofSide(WKing, opponent(strong))]);
+	bool		evenBishop	   = pieces[ofSide(WBishop, strong)] & EVEN_SQUARES;
+
+	// a8/h1 for a bishop on the squares of their colour, h8/a1 otherwise
+	int			cornerDistance = evenBishop ? std::min(distance(weakKing, 0), distance(weakKing, 63)) : std::min(distance(weakKing, 7), distance(weakKing, 56));
+
+	score = Endgames::KNOWN_WIN + PieceValues::BISHOP + PieceValues::KNIGHT + 30 * (7 - cornerDistance) + pushClose(strongKing, weakKing);
+	return true;
+}
+
+
+/**
+ * @brief	King and pawn against king, looked up in the bitbase.
+ */
+bool evaluateKPK(const Chessboard &board, Side strong, int &score)
+{
+	const auto &pieces	   = board.pieces();
+	int			strongKing = squareOf(pieces[ofSide(WKing, strong)]);
+	int			weakKing   = squareOf(pieces[ofSide(WKing, opponent(strong))]);
+	int			pawn	   = squareOf(pieces[ofSide(WPawn, strong)]);
+
+	// Normalize to a white pawn on files a-d
+	if (strong == Side::Black)
+	{
+		strongKing ^= 56;
+		weakKing ^= 56;
+		pawn ^= 56;
+	}
+
+	if (pawn % 8 >= 4)
+	{
+		strongKing ^= 7;
+		weakKing ^= 7;
+		pawn ^= 7;
+	}
+
+	Side sideToMove = board.getCurrentSide() == strong ? Side::White : Side::Black;
+
+	if (!KPKBitbase::probe(Square(strongKing), Square(pawn), Square(weakKing), sideToMove))
+	{
+		score = 0;
+		return true;
+	}
+
+	// Row 6 is the second rank, so the bonus grows as the pawn advances
+	score = Endgames::KNOWN_WIN + PieceValues::PAWN + 10 * (6 - pawn / 8);
+	return true;
+}
+
+
+/**
+ * @brief	Rook against bishop is usually drawn, the rook side only gets a small edge for a cornered king.
+ */
+bool evaluateKRKB(const Chessboard &board, Side strong, int &score)
+{
+	int weakKing = squareOf(board.pieces()[ofSide(WKing, opponent(strong))]);
+
+	score		 = pushToEdge(weakKing) / 4;
+	return true;
+}
+
+
+/**
+ * @brief	Rook against knight is usually drawn, unless the knight gets separated from its king.
+ */
+bool evaluateKRKN(const Chessboard &board, Side strong, int &score)
+{
+	const auto &pieces	 = board.pieces();
+	Side		weak	 = opponent(strong);
+	int			weakKing = squareOf(pieces[ofSide(WKing, weak)]);
+	int			knight	 = squareOf(pieces[ofSide(WKnight, weak)]);
+
+	score				 = pushToEdge(weakKing) / 4 + 4 * distance(weakKing, knight);
+	return true;
+}
+
+
+/**
+ * @brief	Bishop and rook pawns against a bare king: drawn if the bishop doesn't control the promotion
+ *			square and the defending king stands next to it. Otherwise the general evaluation applies.
+ */
+bool evaluateKBPsK(const Chessboard &board, Side strong, int &score)
+{
+	constexpr U64 FILE_A = 0x0101010101010101ULL;
+	constexpr U64 FILE_H = FILE_A << 7;
+
+	const auto	 &pieces = board.pieces();
+	U64			  pawns	 = pieces[ofSide(WPawn, strong)];
+
+	if ((pawns & FILE_A) != pawns && (pawns & FILE_H) != pawns)
+		return false;
+
+	int	 file	   = (pawns & FILE_A) ? 0 : 7;
+	int	 promotion = strong == Side::White ? file : 56 + file;
+
+	bool evenBishop	   = pieces[ofSide(WBishop, strong)] & EVEN_SQUARES;
+	bool evenPromotion = (1ULL << promotion) & EVEN_SQUARES;
+	int	 weakKing	   = squareOf(pieces[ofSide(WKing, opponent(strong))]);
+
+	if (evenBishop == evenPromotion || distance(weakKing, promotion) > 1)
+		return false;
+
+	score = 0;
+	return true;
+}
+
+
+//=========================================================================
+// Dispatch table
+//=========================================================================
+
+struct Entry
+{
+	uint64_t		   key		= 0;
+	Endgames::Function function = nullptr;
+	Side			   strong	= Side::White;
+};
+
+constexpr int TABLE_BITS = 7;
+constexpr int TABLE_SIZE = 1 << TABLE_BITS;
+
+using Table				 = std::array<Entry, TABLE_SIZE>;
+
+
+constexpr int slot(uint64_t key)
+{
+	return static_cast<int>((key * 0x9E3779B97F4A7C15ULL) >> (64 - TABLE_BITS));
+}
+
+
+constexpr Table buildTable()
+{
+	Table table{};
+
+	auto  insert = [&table](uint64_t key, Endgames::Function function, Side strong)
+	{
+		int i = slot(key);
+
+		while (table[i].function)
+			i = (i + 1) & (TABLE_SIZE - 1);
+
+		table[i] = {key, function, strong};
+	};
+
+	// Every endgame is registered for both colours
+	auto add = [&insert](uint64_t key, Endgames::Function function)
+	{
+		insert(key, function, Side::White);
+
+		if (MaterialKey::mirror(key) != key)
+			insert(MaterialKey::mirror(key), function, Side::Black);
+	};
+
+	using MaterialKey::fromCode;
+
+	add(fromCode("KK"), evaluateDraw);
+	add(fromCode("KNK"), evaluateDraw);
+	add(fromCode("KBK"), evaluateDraw);
+	add(fromCode("KNNK"), evaluateDraw);
+
+	add(fromCode("KPK"), evaluateKPK);
+	add(fromCode("KBNK"), evaluateKBNK);
+	add(fromCode("KRK"), evaluateKXK);
+	add(fromCode("KQK"), evaluateKXK);
+	add(fromCode("KRKB"), evaluateKRKB);
+	add(fromCode("KRKN"), evaluateKRKN);
+
+	for (int pawns = 1; pawns <= 8; ++pawns)
+		add(fromCode("KBK") + pawns * MaterialKey::unit(WPawn), evaluateKBPsK);
+
+	return table;
+}
+
+constexpr Table TABLE = buildTable();
+
+} // namespace
+
+
+namespace Endgames
+{
+
+bool probe(const Chessboard &board, int &score)
+{
+	uint64_t key = board.getMaterialKey();
+
+	for (int i = slot(key); TABLE[i].function; i = (i + 1) & (TABLE_SIZE - 1))
+	{
+		const Entry &entry = TABLE[i];
+
+		if (entry.key != key)
+			continue;
+
+		if (!entry.function(board, entry.strong, score))
+			return false;
+
+		score = entry.strong == Side::White ? score : -score;
+		return true;
+	}
+
+	// Positions like bishops on one colour, too many combinations for the table
+	if (isInsufficientMaterial(board))
+	{
+		score = 0;
+		return true;
+	}
+
+	return false;
+}
+
+
+bool isInsufficientMaterial(const Chessboard &board)
+{
+	uint64_t key = board.getMaterialKey();
+
+	if (key & MaterialKey::HEAVY_MATERIAL)
+		return false;
+
+	const auto &pieces	= board.pieces();
+	int			knights = MaterialKey::count(key, WKnight) + MaterialKey::count(key, BKnight);
+	U64			bishops = pieces[WBishop] | pieces[BBishop];
+
+	if (knights == 0)
+		return !(bishops & EVEN_SQUARES) || !(bishops & ~EVEN_SQUARES);
+
+	return knights == 1 && !bishops;
+}
+
+} // namespace Endgames
@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+	Module:         Endgame
+	Description:    Specialized evaluation of endgames, dispatched by the material key
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Chessboard.h"
+
+
+/**
+ * @brief	Endgames the general evaluation misjudges get their own evaluation function:
+ *			KPK (bitbase), KBNK, KRK, KQK, the drawish KRKB and KRKN, bishop and wrong rook pawns
+ *			against a bare king, and the positions without mating material.
+ *			The function is found with one lookup of the board's material key in a constexpr table.
+ */
+namespace Endgames
+{
+
+// Base score of a won endgame, far above any material balance and below mate scores
+constexpr int KNOWN_WIN = 10000;
+
+/**
+ * @brief	Evaluation of one endgame.
+ * @param	strong	The side with the extra material the endgame is named after.
+ * @param	score	Centipawns from the strong side's view.
+ * @return	false if the function doesn't apply to the position (the general evaluation is used).
+ */
+using Function			= bool (*)(const Chessboard &board, Side strong, int &score);
+
+/**
+ * @brief	Evaluate the position with the specialized function of its material, if there is one.
+ * @param	score	Centipawns from white's view.
+ */
+[[nodiscard]] bool probe(const Chessboard &board, int &score);
+
+/**
+ * @brief	Neither side can mate with any sequence of legal moves: bare kings, a single minor
+ *			piece, or only bishops that all stand on squares of one colour.
+ */
+[[nodiscard]] bool isInsufficientMaterial(const Chessboard &board);
+
+} // namespace Endgames
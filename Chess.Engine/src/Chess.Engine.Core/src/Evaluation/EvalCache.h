@@ -0,0 +1,95 @@
+/*
+  ==============================================================================
+	Module:         EvalCache
+	Description:    Lock-free cache of static evaluations keyed by the Zobrist hash
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "NNUE.h"
+
+
+/**
+ * @brief	Direct-mapped cache of static evaluations, shared by all search threads.
+ *
+ * Every slot is a single 64-bit word: the upper 48 bits of the position hash verify the entry,
+ * the lower 16 bits hold the score. Slots are read and written with one atomic access each, so
+ * a reader sees either a complete old or a complete new entry and no lock is needed. Racing
+ * writers simply overwrite each other, which only costs a later miss.
+ *
+ * The generation of the active evaluator is folded into the key, so after loading a network or switching
+ * between the network and the classical evaluation the entries of the old evaluator are never hit.
+ */
+class EvalCache
+{
+public:
+	static constexpr size_t ENTRIES = 1 << 18; // 2 MB
+
+	EvalCache() : mEntries(ENTRIES) {}
+
+	/**
+	 * @brief	Look up the static evaluation of the position.
+	 * @return	true if the position is cached, score is only written then.
+	 */
+	bool probe(uint64_t hash, int &score)
+	{
+		hash		   = keyOf(hash);
+		uint64_t entry = mEntries[hash & (ENTRIES - 1)].load(std::memory_order_relaxed);
+		mProbes.fetch_add(1, std::memory_order_relaxed);
+
+		if ((entry ^ hash) & KEY_MASK)
+			return false;
+
+		mHits.fetch_add(1, std::memory_order_relaxed);
+		score = static_cast<int16_t>(entry & SCORE_MASK);
+		return true;
+	}
+
+	void store(uint64_t hash, int score)
+	{
+		if (score < std::numeric_limits<int16_t>::min() || score > std::numeric_limits<int16_t>::max())
+			return;
+
+		hash		   = keyOf(hash);
+		uint64_t entry = (hash & KEY_MASK) | (static_cast<uint16_t>(score) & SCORE_MASK);
+		mEntries[hash & (ENTRIES - 1)].store(entry, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief	Drop all entries (the evaluation changed) and reset the statistics.
+	 */
+	void clear()
+	{
+		for (auto &entry : mEntries)
+			entry.store(0, std::memory_order_relaxed);
+
+		resetStatistics();
+	}
+
+	void resetStatistics()
+	{
+		mProbes.store(0, std::memory_order_relaxed);
+		mHits.store(0, std::memory_order_relaxed);
+	}
+
+	uint64_t getProbes() const { return mProbes.load(std::memory_order_relaxed); }
+	uint64_t getHits() const { return mHits.load(std::memory_order_relaxed); }
+	double	 hitRate() const { return getProbes() > 0 ? static_cast<double>(getHits()) / getProbes() : 0.0; }
+
+private:
+	static constexpr uint64_t		   SCORE_MASK	  = 0xFFFF;
+	static constexpr uint64_t		   KEY_MASK		  = ~SCORE_MASK;
+	static constexpr uint64_t		   EVALUATOR_SALT = 0x9E3779B97F4A7C15; // spreads the generation over all bits
+
+	static uint64_t					   keyOf(uint64_t hash) { return hash ^ (NNUE::activeGeneration() * EVALUATOR_SALT); }
+
+	std::vector<std::atomic<uint64_t>> mEntries;
+	std::atomic<uint64_t>			   mProbes{0};
+	std::atomic<uint64_t>			   mHits{0};
+};
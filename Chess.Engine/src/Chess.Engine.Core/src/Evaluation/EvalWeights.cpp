@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+	Module:         EvalWeights
+	Description:    Evaluation weights and the policies providing them at compile time or at runtime
+  ==============================================================================
+*/
+
+#include "EvalWeights.h"
+
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+#include <nlohmann/json.hpp>
+
+#include "Logging.h"
+
+
+using json = nlohmann::json;
+
+
+namespace
+{
+
+// PieceType order of the white pieces
+constexpr const char *PIECE_NAMES[EvalWeights::PIECE_TYPES] = {"king", "queen", "pawn", "knight", "bishop", "rook"};
+
+// Knight, Bishop, Rook, Queen
+constexpr const char *KIND_NAMES[EvalWeights::MOBILE_KINDS] = {"knight", "bishop", "rook", "queen"};
+
+
+int readHalf(const json &j)
+{
+	int value = j.get<int>();
+
+	if (value < std::numeric_limits<int16_t>::min() || value > std::numeric_limits<int16_t>::max())
+		throw std::out_of_range("Weight " + std::to_string(value) + " exceeds the 16 bit range");
+
+	return value;
+}
+
+
+json writeScore(Score score)
+{
+	return json::array({mgScore(score), egScore(score)});
+}
+
+
+/**
+ * @brief	Read a [midgame, endgame] pair if the key exists.
+ */
+void readScore(const json &j, const char *key, Score &score)
+{
+	if (!j.contains(key))
+		return;
+
+	const json &pair = j.at(key);
+
+	if (!pair.is_array() || pair.size() != 2)
+		throw std::invalid_argument(std::string(key) + " must be a [midgame, endgame] pair");
+
+	score = makeScore(readHalf(pair[0]), readHalf(pair[1]));
+}
+
+
+template <typename T>
+void readValue(const json &j, const char *key, T &value)
+{
+	if (j.contains(key))
+		value = j.at(key).get<T>();
+}
+
+
+json toJsonObject(const EvalWeights &weights)
+{
+	json root;
+
+	for (int type = 0; type < EvalWeights::PIECE_TYPES; ++type)
+	{
+		const char *name = PIECE_NAMES[type];
+
+		// Kings carry no material
+		if (type != 0)
+			root["material"][name] = writeScore(weights.material[type]);
+
+		json mg = json::array();
+		json eg = json::array();
+
+		for (Score value : weights.pst[type])
+		{
+			mg.push_back(mgScore(value));
+			eg.push_back(egScore(value));
+		}
+
+		root["pst"][name] = json{{"mg", mg}, {"eg", eg}};
+	}
+
+	for (int kind = 0; kind < EvalWeights::MOBILE_KINDS; ++kind)
+	{
+		const char *name						 = KIND_NAMES[kind];
+
+		root["mobility"][name]					 = json{{"weight", writeScore(weights.mobility[kind])}, {"base", weights.mobilityBase[kind]}};
+		root["kingSafety"]["attackWeight"][name] = weights.attackWeight[kind];
+	}
+
+	json &king			 = root["kingSafety"];
+	king["shieldNear"]	 = writeScore(weights.shieldNear);
+	king["shieldFar"]	 = writeScore(weights.shieldFar);
+	king["semiOpenFile"] = writeScore(weights.semiOpenFile);
+	king["openFile"]	 = writeScore(weights.openFile);
+	king["dangerMax"]	 = weights.kingDangerMax;
+
+	return root;
+}
+
+
+/**
+ * @brief	Production weights overridden by every term present in the JSON object.
+ *			Throws on malformed terms.
+ */
+EvalWeights fromJsonObject(const json &root)
+{
+	EvalWeights weights = EvalWeights::defaults();
+
+	if (!root.is_object())
+		throw std::invalid_argument("Weights must be a JSON object");
+
+	for (int type = 0; type < EvalWeights::PIECE_TYPES; ++type)
+	{
+		const char *name = PIECE_NAMES[type];
+
+		if (type != 0 && root.contains("material"))
+			readScore(root.at("material"), name, weights.material[type]);
+
+		if (!root.contains("pst") || !root.at("pst").contains(name))
+			continue;
+
+		const json &table = root.at("pst").at(name);
+
+		for (const char *phase : {"mg", "eg"})
+		{
+			if (!table.contains(phase))
+				continue;
+
+			const json &values = table.at(phase);
+
+			if (!values.is_array() || values.size() != 64)
+				throw std::invalid_argument(std::string("pst.") + name + "." + phase + " must have 64 values");
+
+			for (int sq = 0; sq < 64; ++sq)
+			{
+				Score &score = weights.pst[type][sq];
+				int	   value = readHalf(values[sq]);
+				score		 = phase[0] == 'm' ? makeScore(value, egScore(score)) : makeScore(mgScore(score), value);
+			}
+		}
+	}
+
+	for (int kind = 0; kind < EvalWeights::MOBILE_KINDS; ++kind)
+	{
+		const char *name = KIND_NAMES[kind];
+
+		if (root.contains("mobility") && root.at("mobility").contains(name))
+		{
+			const json &mobility = root.at("mobility").at(name);
+			readScore(mobility, "weight", weights.mobility[kind]);
+			readValue(mobility, "base", weights.mobilityBase[kind]);
+		}
+
+		if (root.contains("kingSafety") && root.at("kingSafety").contains("attackWeight"))
+			readValue(root.at("kingSafety").at("attackWeight"), name, weights.attackWeight[kind]);
+	}
+
+	if (root.contains("kingSafety"))
+	{
+		const json &king = root.at("kingSafety");
+		readScore(king, "shieldNear", weights.shieldNear);
+		readScore(king, "shieldFar", weights.shieldFar);
+		readScore(king, "semiOpenFile", weights.semiOpenFile);
+		readScore(king, "openFile", weights.openFile);
+		readValue(king, "dangerMax", weights.kingDangerMax);
+	}
+
+	return weights;
+}
+
+} // namespace
+
+
+bool RuntimeWeights::load(const std::string &path)
+{
+	std::ifstream file(path);
+
+	if (!file)
+	{
+		LOG_ERROR("Could not open evaluation weights {}", path);
+		return false;
+	}
+
+	std::stringstream text;
+	text << file.rdbuf();
+
+	if (!fromJson(text.str()))
+	{
+		LOG_ERROR("Evaluation weights {} were not loaded", path);
+		return false;
+	}
+
+	LOG_INFO("Loaded evaluation weights from {}", path);
+	return true;
+}
+
+
+bool RuntimeWeights::save(const std::string &path)
+{
+	std::ofstream file(path);
+
+	if (!file)
+	{
+		LOG_ERROR("Could not create {}", path);
+		return false;
+	}
+
+	file << toJson();
+	return static_cast<bool>(file);
+}
+
+
+bool RuntimeWeights::fromJson(const std::string &text)
+{
+	try
+	{
+		sWeights = fromJsonObject(json::parse(text));
+		return true;
+	}
+	catch (const std::exception &e)
+	{
+		LOG_WARNING("Invalid evaluation weights: {}", e.what());
+		return false;
+	}
+}
+
+
+std::string RuntimeWeights::toJson()
+{
+	return toJsonObject(sWeights).dump(4);
+}
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+	Module:         EvalWeights
+	Description:    Evaluation weights and the policies providing them at compile time or at runtime
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <string>
+
+#include "PieceSquareTables.h"
+#include "Score.h"
+
+
+/**
+ * @brief	Weights of the classical evaluation terms as packed midgame/endgame scores.
+ *			Piece types follow the PieceType order of the white pieces (King, Queen, Pawn, Knight, Bishop, Rook),
+ *			piece-square values are from white's perspective (a8 = 0). Mobility and king attack weights are
+ *			indexed by Knight, Bishop, Rook, Queen.
+ *			The pawn structure weights are not part of it: their score is cached in the pawn hash table.
+ */
+struct EvalWeights
+{
+	static constexpr int PIECE_TYPES	  = 6;
+	static constexpr int MOBILE_KINDS	  = 4;
+
+	Score				 material[PIECE_TYPES]{};
+	Score				 pst[PIECE_TYPES][64]{};
+
+	// Score per safe square relative to an average mobility
+	Score				 mobility[MOBILE_KINDS]{};
+	int					 mobilityBase[MOBILE_KINDS]{};
+
+	Score				 shieldNear	  = 0; // own pawn directly in front of the king
+	Score				 shieldFar	  = 0; // own pawn two ranks in front of the king
+	Score				 semiOpenFile = 0; // no own pawn on a file next to the king
+	Score				 openFile	  = 0; // additionally no enemy pawn on it
+
+	// Attack units per attacked king zone square, the squared units are capped by kingDangerMax
+	int					 attackWeight[MOBILE_KINDS]{};
+	int					 kingDangerMax = 0;
+
+	/**
+	 * @brief	The weights the engine ships with.
+	 */
+	static constexpr EvalWeights defaults();
+
+	/**
+	 * @brief	Largest absolute mobility score of one piece (0 to 8/13/14/27 safe squares), in either phase.
+	 */
+	constexpr int				 mobilityBound(int kind) const
+	{
+		constexpr int maxSquares[MOBILE_KINDS] = {8, 13, 14, 27};
+
+		int			  weight				   = std::max(magnitude(mgScore(mobility[kind])), magnitude(egScore(mobility[kind])));
+		int			  squares				   = std::max(mobilityBase[kind], maxSquares[kind] - mobilityBase[kind]);
+		return weight * squares;
+	}
+
+	/**
+	 * @brief	Range of one king's shield and file score (3 near and far shield pawns to 3 open files).
+	 */
+	constexpr Score kingFilesRange() const
+	{
+		auto range = [](Score weight) { return makeScore(3 * magnitude(mgScore(weight)), 3 * magnitude(egScore(weight))); };
+		return range(shieldNear) + range(shieldFar) + range(semiOpenFile) + range(openFile);
+	}
+
+	bool operator==(const EvalWeights &other) const = default;
+
+private:
+	static constexpr int magnitude(int value) { return value < 0 ? -value : value; }
+};
+
+
+constexpr EvalWeights EvalWeights::defaults()
+{
+	using namespace PieceSquareTables;
+
+	EvalWeights weights;
+
+	const int  *midgame[PIECE_TYPES]   = {PST_KING_MIDDLEGAME, PST_QUEEN, PST_PAWN, PST_KNIGHT, PST_BISHOP, PST_ROOK};
+	const int  *endgame[PIECE_TYPES]   = {PST_KING_ENDGAME, PST_QUEEN, PST_PAWN_ENDGAME, PST_KNIGHT, PST_BISHOP, PST_ROOK};
+	const int	materials[PIECE_TYPES] = {0, PieceValues::QUEEN, PieceValues::PAWN, PieceValues::KNIGHT, PieceValues::BISHOP, PieceValues::ROOK};
+
+	for (int type = 0; type < PIECE_TYPES; ++type)
+	{
+		// Material is worth the same in both phases
+		weights.material[type] = makeScore(materials[type], materials[type]);
+
+		for (int sq = 0; sq < 64; ++sq)
+			weights.pst[type][sq] = makeScore(midgame[type][sq], endgame[type][sq]);
+	}
+
+	const Score mobility[MOBILE_KINDS]	   = {makeScore(4, 4), makeScore(5, 5), makeScore(2, 4), makeScore(1, 2)};
+	const int	mobilityBase[MOBILE_KINDS] = {4, 6, 7, 13};
+	const int	attackWeight[MOBILE_KINDS] = {2, 2, 3, 5};
+
+	for (int kind = 0; kind < MOBILE_KINDS; ++kind)
+	{
+		weights.mobility[kind]	   = mobility[kind];
+		weights.mobilityBase[kind] = mobilityBase[kind];
+		weights.attackWeight[kind] = attackWeight[kind];
+	}
+
+	weights.shieldNear	  = makeScore(12, 0);
+	weights.shieldFar	  = makeScore(6, 0);
+	weights.semiOpenFile  = makeScore(-12, 0);
+	weights.openFile	  = makeScore(-10, 0);
+	weights.kingDangerMax = 500;
+
+	return weights;
+}
+
+
+/**
+ * @brief	Production weights: compile-time constants, so every weight folds into the evaluation code.
+ *			Material and piece-square values are read from the board's incremental score (built from
+ *			the same tables), and the NNUE network is used when it is active.
+ */
+struct ConstexprWeights
+{
+	static constexpr bool				INCREMENTAL = true;
+
+	static constexpr EvalWeights		VALUES		= EvalWeights::defaults();
+
+	static constexpr const EvalWeights &get() { return VALUES; }
+};
+
+
+/**
+ * @brief	Mutable weights for tuning and A/B experiments without recompiling, loaded from JSON.
+ *			Material and piece-square values are summed from the weights on every evaluation, the NNUE
+ *			network is never used. The weights are shared by all threads and must not be changed while
+ *			a search is running.
+ */
+struct RuntimeWeights
+{
+	static constexpr bool	  INCREMENTAL = false;
+
+	static const EvalWeights &get() { return sWeights; }
+
+	/**
+	 * @brief	Replace the weights (e.g. with a tuned or modified set).
+	 */
+	static void				  set(const EvalWeights &weights) { sWeights = weights; }
+
+	/**
+	 * @brief	Back to the production weights.
+	 */
+	static void				  reset() { sWeights = EvalWeights::defaults(); }
+
+	/**
+	 * @brief	Load weights from a JSON file. Terms missing in the file keep the production values,
+	 *			so an experiment only needs to list the weights it changes.
+	 *			The weights are left untouched if the file cannot be read or is malformed.
+	 */
+	static bool				  load(const std::string &path);
+
+	/**
+	 * @brief	Write the current weights as JSON (the format load() reads).
+	 */
+	static bool				  save(const std::string &path);
+
+	/**
+	 * @brief	Same as load()/save() on a JSON string.
+	 */
+	static bool				  fromJson(const std::string &text);
+	[[nodiscard]] static std::string toJson();
+
+private:
+	static inline EvalWeights sWeights = EvalWeights::defaults();
+};
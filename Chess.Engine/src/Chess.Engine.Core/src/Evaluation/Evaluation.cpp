@@ -7,95 +7,389 @@
 
 #include "Evaluation.h"
 
+#include <algorithm>
+#include <cassert>
+#include <limits>
 
-int Evaluation::evaluate(const Chessboard &board)
+
+namespace
 {
-	int score = 0;
+thread_local PawnHashTable pawnTable;
+thread_local uint64_t	   lazyEvaluations = 0;
+thread_local uint64_t	   lazyExits	   = 0;
+} // namespace
+
+
+template <typename Weights>
+int BasicEvaluation<Weights>::evaluate(const Chessboard &board)
+{
+	bool exact;
+	return evaluate(board, std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), exact);
+}
+
+
+template <typename Weights>
+int BasicEvaluation<Weights>::evaluate(const Chessboard &board, int alpha, int beta, bool &exact)
+{
+	exact = true;
+
+	// Known endgames are dispatched by the material key
+	int endgame;
+
+	if (Endgames::probe(board, endgame))
+		return (board.getCurrentSide() == Side::White) ? endgame : -endgame;
+
+	Score score;
+
+	if constexpr (Weights::INCREMENTAL)
+	{
+		assert(verifyPieceScore(board) && "Incremental material/PST score out of sync");
+
+		if (NNUE::isActive())
+			return NNUE::evaluate(board);
+
+		// Material and piece-square tables are kept up to date by the board on every piece change
+		score = board.getPieceScore();
+	}
+	else
+	{
+		score = evaluateMaterial(board) + evaluatePieceSquareTables(board);
+	}
 
-	score += evaluateMaterial(board);
-	score += evaluatePieceSquareTables(board);
+	// The pawn structure is a pawn hash table lookup most of the time
 	score += evaluatePawnStructure(board);
-	score += evaluateKingSafety(board);
-	score += evaluateMobility(board);
+
+	if (alpha != std::numeric_limits<int>::min() || beta != std::numeric_limits<int>::max())
+	{
+		++lazyEvaluations;
+
+		int lazy   = GamePhase::interpolate(score, board.getPhase());
+		lazy	   = (board.getCurrentSide() == Side::White) ? lazy : -lazy;
+
+		int margin = lazyMargin(board);
+
+		if (lazy - margin >= beta || lazy + margin <= alpha)
+		{
+			++lazyExits;
+			exact = false;
+			return lazy;
+		}
+	}
+
+	SideAttacks white;
+	SideAttacks black;
+	collectAttacks(board, Side::White, white);
+	collectAttacks(board, Side::Black, black);
+
+	score += evaluateKingSafety(board, white, black);
+	score += evaluateMobility(board, white, black);
+
+	int value = GamePhase::interpolate(score, board.getPhase());
 
 	// Return score relative to side to move
-	return (board.getCurrentSide() == Side::White) ? score : -score;
+	return (board.getCurrentSide() == Side::White) ? value : -value;
 }
 
 
-int Evaluation::evaluateMaterial(const Chessboard &board)
+template <typename Weights>
+bool BasicEvaluation<Weights>::verifyPieceScore(const Chessboard &board)
 {
-	const auto &pieces = board.pieces();
+	uint64_t materialKey = 0;
+
+	for (int piece = 0; piece < 12; ++piece)
+		materialKey += BitUtils::popCount(board.pieces()[piece]) * MaterialKey::unit(static_cast<PieceType>(piece));
+
+	return board.getPieceScore() == evaluateMaterial(board) + evaluatePieceSquareTables(board) && board.getPhase() == computePhase(board)
+		&& board.getMaterialKey() == materialKey;
+}
+
+
+template <typename Weights>
+Score BasicEvaluation<Weights>::evaluateMaterial(const Chessboard &board)
+{
+	const auto &pieces	= board.pieces();
+	const auto &weights = Weights::get();
+
+	Score		score	= 0;
 
-	int			white  = 0;
-	int			black  = 0;
+	// Kings carry no material, both always stand on the board
+	for (int type = WQueen; type < EvalWeights::PIECE_TYPES; ++type)
+		score += scaleScore(weights.material[type], BitUtils::popCount(pieces[type]) - BitUtils::popCount(pieces[type + BKing]));
 
-	white += BitUtils::popCount(pieces[PieceType::WPawn]) * PieceValues::PAWN;
-	white += BitUtils::popCount(pieces[PieceType::WKnight]) * PieceValues::KNIGHT;
-	white += BitUtils::popCount(pieces[PieceType::WBishop]) * PieceValues::BISHOP;
-	white += BitUtils::popCount(pieces[PieceType::WRook]) * PieceValues::ROOK;
-	white += BitUtils::popCount(pieces[PieceType::WQueen]) * PieceValues::QUEEN;
+	return score;
+}
+
+
+template <typename Weights>
+Score BasicEvaluation<Weights>::evaluatePieceSquareTables(const Chessboard &board)
+{
+	const auto &pieces	= board.pieces();
+	const auto &weights = Weights::get();
 
-	black += BitUtils::popCount(pieces[PieceType::BPawn]) * PieceValues::PAWN;
-	black += BitUtils::popCount(pieces[PieceType::BKnight]) * PieceValues::KNIGHT;
-	black += BitUtils::popCount(pieces[PieceType::BBishop]) * PieceValues::BISHOP;
-	black += BitUtils::popCount(pieces[PieceType::BRook]) * PieceValues::ROOK;
-	black += BitUtils::popCount(pieces[PieceType::BQueen]) * PieceValues::QUEEN;
+	Score		score	= 0;
 
-	return white - black;
+	for (int type = 0; type < EvalWeights::PIECE_TYPES; ++type)
+	{
+		// Tables are from white's perspective, black mirrors the square index
+		score += scorePieceSquare(pieces[type], weights.pst[type], true);
+		score -= scorePieceSquare(pieces[type + BKing], weights.pst[type], false);
+	}
+
+	return score;
 }
 
 
-int Evaluation::evaluatePieceSquareTables(const Chessboard &board)
+template <typename Weights>
+int BasicEvaluation<Weights>::lazyMargin(const Chessboard &board)
+{
+	using namespace BitUtils;
+
+	const auto &pieces	 = board.pieces();
+	const auto &weights	 = Weights::get();
+
+	int			white[4] = {popCount(pieces[WKnight]), popCount(pieces[WBishop]), popCount(pieces[WRook]), popCount(pieces[WQueen])};
+	int			black[4] = {popCount(pieces[BKnight]), popCount(pieces[BBishop]), popCount(pieces[BRook]), popCount(pieces[BQueen])};
+
+	int			mobility = 0;
+
+	for (int kind = 0; kind < 4; ++kind)
+		mobility += (white[kind] + black[kind]) * weights.mobilityBound(kind);
+
+	// King danger needs two attacking pieces and has no endgame weight
+	int	  whiteDanger = black[0] + black[1] + black[2] + black[3] >= 2 ? weights.kingDangerMax : 0;
+	int	  blackDanger = white[0] + white[1] + white[2] + white[3] >= 2 ? weights.kingDangerMax : 0;
+	Score kingSafety  = makeScore(std::max(whiteDanger, blackDanger), 0) + weights.kingFilesRange();
+	int	  mgPhase	  = std::min(board.getPhase(), GamePhase::MAX);
+	int	  blended	  = mgScore(kingSafety) * mgPhase + egScore(kingSafety) * (GamePhase::MAX - mgPhase);
+
+	// +2 for the rounding of blending the terms separately
+	return mobility + (blended + GamePhase::MAX - 1) / GamePhase::MAX + 2;
+}
+
+
+template <typename Weights>
+int BasicEvaluation<Weights>::computePhase(const Chessboard &board)
 {
 	const auto &pieces = board.pieces();
 
-	int			score  = 0;
+	int			phase  = 0;
 
-	// White pieces (tables are from white's perspective)
-	score += scorePieceSquare(pieces[PieceType::WPawn], PST_PAWN, true);
-	score += scorePieceSquare(pieces[PieceType::WKnight], PST_KNIGHT, true);
-	score += scorePieceSquare(pieces[PieceType::WBishop], PST_BISHOP, true);
-	score += scorePieceSquare(pieces[PieceType::WRook], PST_ROOK, true);
-	score += scorePieceSquare(pieces[PieceType::WQueen], PST_QUEEN, true);
-	score += scorePieceSquare(pieces[PieceType::WKing], PST_KING_MIDDLEGAME, true);
+	for (int piece = 0; piece < 12; ++piece)
+		phase += BitUtils::popCount(pieces[piece]) * GamePhase::BY_TYPE[piece];
 
-	// Black pieces (mirror the square index)
-	score -= scorePieceSquare(pieces[PieceType::BPawn], PST_PAWN, false);
-	score -= scorePieceSquare(pieces[PieceType::BKnight], PST_KNIGHT, false);
-	score -= scorePieceSquare(pieces[PieceType::BBishop], PST_BISHOP, false);
-	score -= scorePieceSquare(pieces[PieceType::BRook], PST_ROOK, false);
-	score -= scorePieceSquare(pieces[PieceType::BQueen], PST_QUEEN, false);
-	score -= scorePieceSquare(pieces[PieceType::BKing], PST_KING_MIDDLEGAME, false);
+	return phase;
+}
 
-	return score;
+
+template <typename Weights>
+Score BasicEvaluation<Weights>::evaluatePawnStructure(const Chessboard &board)
+{
+	const auto &pieces = board.pieces();
+
+	return pawnTable.probe(board.getPawnHash(), pieces[PieceType::WPawn], pieces[PieceType::BPawn]).score;
 }
 
 
-int Evaluation::evaluatePawnStructure(const Chessboard &board)
+template <typename Weights>
+uint64_t BasicEvaluation<Weights>::getPawnTableProbes()
 {
-	// TODO: Evaluate doubled, isolated, and passed pawns
-	return 0;
+	return pawnTable.getProbes();
 }
 
 
-int Evaluation::evaluateKingSafety(const Chessboard &board)
+template <typename Weights>
+uint64_t BasicEvaluation<Weights>::getPawnTableHits()
 {
-	// TODO: Evaluate king pawn shield, open files near king,...
-	return 0;
+	return pawnTable.getHits();
 }
 
 
-int Evaluation::evaluateMobility(const Chessboard &board)
+template <typename Weights>
+void BasicEvaluation<Weights>::clearPawnTable()
 {
-	// Evaluate piece mobility
-	return 0;
+	pawnTable.clear();
 }
 
 
-int Evaluation::scorePieceSquare(U64 bitboard, const int table[64], bool isWhite)
+template <typename Weights>
+uint64_t BasicEvaluation<Weights>::getLazyEvaluations()
 {
-	int score = 0;
+	return lazyEvaluations;
+}
+
+
+template <typename Weights>
+uint64_t BasicEvaluation<Weights>::getLazyExits()
+{
+	return lazyExits;
+}
+
+
+template <typename Weights>
+void BasicEvaluation<Weights>::resetLazyStatistics()
+{
+	lazyEvaluations = 0;
+	lazyExits		= 0;
+}
+
+
+template <typename Weights>
+Score BasicEvaluation<Weights>::evaluateKingSafety(const Chessboard &board, const SideAttacks &white, const SideAttacks &black)
+{
+	return scoreKingSafety(board, Side::White, white, black) - scoreKingSafety(board, Side::Black, black, white);
+}
+
+
+template <typename Weights>
+Score BasicEvaluation<Weights>::evaluateMobility(const Chessboard &board, const SideAttacks &white, const SideAttacks &black)
+{
+	const auto &occ = board.occ();
+
+	return scoreMobility(white, black, occ[to_index(Side::White)]) - scoreMobility(black, white, occ[to_index(Side::Black)]);
+}
+
+
+template <typename Weights>
+void BasicEvaluation<Weights>::collectAttacks(const Chessboard &board, Side side, SideAttacks &attacks)
+{
+	using namespace BitUtils;
+
+	const auto &at		= AttackTables::instance();
+	const auto &pieces	= board.pieces();
+	const U64	occ		= board.occ()[to_index(Side::Both)];
+	const bool	isWhite = side == Side::White;
+
+	auto		add		= [&attacks](PieceKind kind, U64 bb)
+	{
+		// Boards from validated FENs and legal games never have more, anything beyond is left out
+		assert(attacks.count < SideAttacks::MAX_PIECES && "More pieces than a legal position can have");
+
+		if (attacks.count >= SideAttacks::MAX_PIECES)
+			return;
+
+		attacks.kind[attacks.count]		 = kind;
+		attacks.attacks[attacks.count++] = bb;
+	};
+
+	for (U64 bb = pieces[isWhite ? WKnight : BKnight]; bb; bb &= bb - 1)
+		add(Knight, at.knightAttacks(Square(lsb(bb))));
+
+	for (U64 bb = pieces[isWhite ? WBishop : BBishop]; bb; bb &= bb - 1)
+		add(Bishop, at.bishopAttacks(Square(lsb(bb)), occ));
+
+	for (U64 bb = pieces[isWhite ? WRook : BRook]; bb; bb &= bb - 1)
+		add(Rook, at.rookAttacks(Square(lsb(bb)), occ));
+
+	for (U64 bb = pieces[isWhite ? WQueen : BQueen]; bb; bb &= bb - 1)
+		add(Queen, at.queenAttacks(Square(lsb(bb)), occ));
+
+	// Pad to the kernel width so the batched kernels never read past the pieces
+	attacks.padded = (attacks.count + BitKernels::LANES - 1) & ~(BitKernels::LANES - 1);
+
+	for (int i = attacks.count; i < attacks.padded; ++i)
+		attacks.attacks[i] = 0;
+
+	U64	pawns			= pieces[isWhite ? WPawn : BPawn];
+	U64	pawnSides		= east(pawns) | west(pawns);
+
+	attacks.pawnAttacks	= isWhite ? north(pawnSides) : south(pawnSides);
+	attacks.all			= BitKernels::unionAll(attacks.attacks, attacks.padded) | attacks.pawnAttacks;
+}
+
+
+template <typename Weights>
+Score BasicEvaluation<Weights>::scoreMobility(const SideAttacks &own, const SideAttacks &enemy, U64 ownPieces)
+{
+	const auto &weights = Weights::get();
+
+	U64			safe	= ~ownPieces & ~enemy.pawnAttacks;
+
+	int	counts[SideAttacks::MAX_PIECES];
+	BitKernels::popCountMasked(own.attacks, own.padded, safe, counts);
+
+	Score score = 0;
+
+	for (int i = 0; i < own.count; ++i)
+		score += scaleScore(weights.mobility[own.kind[i]], counts[i] - weights.mobilityBase[own.kind[i]]);
+
+	return score;
+}
+
+
+template <typename Weights>
+Score BasicEvaluation<Weights>::scoreKingSafety(const Chessboard &board, Side side, const SideAttacks &own, const SideAttacks &enemy)
+{
+	using namespace BitUtils;
+
+	const auto &pieces	= board.pieces();
+	const auto &weights = Weights::get();
+	const bool	isWhite	= side == Side::White;
+
+	U64			king	= pieces[isWhite ? WKing : BKing];
+
+	if (!king)
+		return 0;
+
+	U64	zone	   = AttackTables::instance().kingAttacks(Square(lsb(king))) | king;
+
+	// Shield and files from white's point of view
+	U64	ownPawns   = pieces[isWhite ? WPawn : BPawn];
+	U64	enemyPawns = pieces[isWhite ? BPawn : WPawn];
+
+	if (!isWhite)
+	{
+		king	   = flipVertical(king);
+		ownPawns   = flipVertical(ownPawns);
+		enemyPawns = flipVertical(enemyPawns);
+	}
+
+	Score score		= 0;
+	U64	  kingSides	= king | east(king) | west(king);
+
+	if (king & FIRST_TWO_RANKS)
+	{
+		U64 near = north(kingSides);
+		score += scaleScore(weights.shieldNear, popCount(ownPawns & near));
+		score += scaleScore(weights.shieldFar, popCount(ownPawns & north(near) & ~fileFill(ownPawns & near)));
+	}
+
+	U64 kingFiles = fileFill(kingSides);
+	U64 semiOpen  = kingFiles & ~fileFill(ownPawns);
+	U64 open	  = semiOpen & ~fileFill(enemyPawns);
+
+	score += scaleScore(weights.semiOpenFile, popCount(semiOpen & RANK_8));
+	score += scaleScore(weights.openFile, popCount(open & RANK_8));
+
+	// Attack units on the king zone, only dangerous with at least two attackers
+	int counts[SideAttacks::MAX_PIECES];
+	BitKernels::popCountMasked(enemy.attacks, enemy.padded, zone, counts);
+
+	int attackers = 0;
+	int units	  = 0;
+
+	for (int i = 0; i < enemy.count; ++i)
+	{
+		if (counts[i] == 0)
+			continue;
+
+		++attackers;
+		units += weights.attackWeight[enemy.kind[i]] * counts[i];
+	}
+
+	if (attackers >= 2)
+	{
+		units += popCount(zone & enemy.all & ~own.all); // attacked and undefended
+		score -= makeScore(std::min(units * units / 4, weights.kingDangerMax), 0);
+	}
+
+	return score;
+}
+
+
+template <typename Weights>
+Score BasicEvaluation<Weights>::scorePieceSquare(U64 bitboard, const Score table[64], bool isWhite)
+{
+	Score score = 0;
 
 	while (bitboard)
 	{
@@ -106,3 +400,7 @@ int Evaluation::scorePieceSquare(U64 bitboard, const int table[64], bool isWhite
 
 	return score;
 }
+
+
+template class BasicEvaluation<ConstexprWeights>;
+template class BasicEvaluation<RuntimeWeights>;
@@ -11,150 +11,192 @@
 #include "Chessboard.h"
 #include "BitboardUtils.h"
 #include "PieceValues.h"
+#include "PieceSquareTables.h"
+#include "PawnStructure.h"
+#include "BitboardKernels.h"
+#include "NNUE.h"
+#include "EvalWeights.h"
+#include "Endgame.h"
+
+
+/**
+ * @brief	Attacks of one side, gathered once per evaluation and shared by mobility and king safety.
+ *			Piece attacks are padded with empty bitboards to a multiple of BitKernels::LANES.
+ */
+struct SideAttacks
+{
+	static constexpr int MAX_PIECES	 = 16;	  // 15 pieces besides king and pawns (Fen::validate), rounded up to the kernel width
+
+	U64					 attacks[MAX_PIECES]; // knight, bishop, rook and queen attacks
+	int					 kind[MAX_PIECES];	  // BasicEvaluation::PieceKind of each entry
+	int					 count		 = 0;	  // number of pieces
+	int					 padded		 = 0;	  // count rounded up to the kernel width
+	U64					 pawnAttacks = 0;
+	U64					 all		 = 0;	  // every square attacked by the pieces and pawns (not the king)
+};
 
 
 /**
  * @brief	Static board evaluation.
  *			Returns score relative to the side to move (positive = good).
  *			Designed as a stateless utility — all methods are static.
+ *			The weights come from the policy: ConstexprWeights for the engine (see Evaluation),
+ *			RuntimeWeights for tuning and experiments (see TunableEvaluation).
  */
-class Evaluation
+template <typename Weights>
+class BasicEvaluation
 {
 public:
-	Evaluation()  = delete;
-	~Evaluation() = delete;
+	BasicEvaluation()  = delete;
+	~BasicEvaluation() = delete;
 
 	/**
 	 * @brief	Evaluate the current board position.
+	 *			Endgames with a specialized evaluation (see Endgames) are scored by it. Otherwise,
+	 *			with incremental weights the NNUE network is used when one is loaded and enabled,
+	 *			the classical terms otherwise.
 	 * @param	board	The board to evaluate.
 	 * @return	Score in centipawns, positive favoring side to move.
 	 */
 	[[nodiscard]] static int evaluate(const Chessboard &board);
 
+	/**
+	 * @brief	Lazy evaluation for a search window (relative to the side to move).
+	 *			Material, piece-square tables and pawn structure are scored first. If that score lies
+	 *			outside the window by more than the largest possible mobility and king safety score,
+	 *			it is returned without computing them: it is then on the same side of the window as
+	 *			the full evaluation, but not exact.
+	 * @param	exact	Set to false if the early exit was taken.
+	 * @return	Score in centipawns, positive favoring side to move.
+	 */
+	[[nodiscard]] static int evaluate(const Chessboard &board, int alpha, int beta, bool &exact);
+
+	/**
+	 * @brief	Recompute material, piece-square scores, game phase and material key from scratch and
+	 *			compare them with the board's incrementally updated values (debug check).
+	 */
+	[[nodiscard]] static bool verifyPieceScore(const Chessboard &board);
+
+	/**
+	 * @brief	Pawn hash table statistics of the calling thread (each search thread has its own table,
+	 *			shared by both weight policies).
+	 */
+	[[nodiscard]] static uint64_t getPawnTableProbes();
+	[[nodiscard]] static uint64_t getPawnTableHits();
+	static void					  clearPawnTable();
+
+	/**
+	 * @brief	Windowed evaluations and early exits taken by them on the calling thread.
+	 */
+	[[nodiscard]] static uint64_t getLazyEvaluations();
+	[[nodiscard]] static uint64_t getLazyExits();
+	static void					  resetLazyStatistics();
+
 private:
 	//=========================================================================
 	// Evaluation Components
+	// Components return packed midgame/endgame scores (white - black),
+	// evaluate() blends their sum by the game phase once.
 	//=========================================================================
 
 	/**
 	 * @brief	Count raw material balance (white - black).
+	 *			Full recomputation, evaluate() reads the board's incremental score instead for incremental weights.
 	 */
-	[[nodiscard]] static int		   evaluateMaterial(const Chessboard &board);
+	[[nodiscard]] static Score		   evaluateMaterial(const Chessboard &board);
 
 	/**
 	 * @brief	Evaluate piece placement using piece-square tables.
 	 */
-	[[nodiscard]] static int		   evaluatePieceSquareTables(const Chessboard &board);
+	[[nodiscard]] static Score		   evaluatePieceSquareTables(const Chessboard &board);
+
+	/**
+	 * @brief	Evaluate pawn structure (doubled, isolated, backward, passed, candidate, connected).
+	 *			Looked up in the pawn hash table by the board's pawn key.
+	 */
+	[[nodiscard]] static Score		   evaluatePawnStructure(const Chessboard &board);
+
+	/**
+	 * @brief	Evaluate king safety: pawn shield, (half-)open files next to the king
+	 *			and weighted attack units on the king zone.
+	 */
+	[[nodiscard]] static Score		   evaluateKingSafety(const Chessboard &board, const SideAttacks &white, const SideAttacks &black);
 
 	/**
-	 * @brief	Evaluate pawn structure (doubled, isolated, passed).
+	 * @brief	Evaluate mobility (attacked squares not occupied by own pieces or attacked by enemy pawns).
 	 */
-	[[nodiscard]] static int		   evaluatePawnStructure(const Chessboard &board);
+	[[nodiscard]] static Score		   evaluateMobility(const Chessboard &board, const SideAttacks &white, const SideAttacks &black);
 
 	/**
-	 * @brief	Evaluate king safety.
+	 * @brief	Upper bound of the absolute (phase blended) mobility and king safety score of the position.
 	 */
-	[[nodiscard]] static int		   evaluateKingSafety(const Chessboard &board);
+	[[nodiscard]] static int		   lazyMargin(const Chessboard &board);
 
 	/**
-	 * @brief	Evaluate mobility (number of legal moves available).
+	 * @brief	Count the game phase from the non-pawn material on the board.
 	 */
-	[[nodiscard]] static int		   evaluateMobility(const Chessboard &board);
+	[[nodiscard]] static int		   computePhase(const Chessboard &board);
 
 
 	//=========================================================================
 	// Helpers
 	//=========================================================================
 
+	/**
+	 * @brief	Collect the attacks of every piece of one side from the attack tables.
+	 */
+	static void						   collectAttacks(const Chessboard &board, Side side, SideAttacks &attacks);
+
+	/**
+	 * @brief	Mobility of one side.
+	 */
+	[[nodiscard]] static Score		   scoreMobility(const SideAttacks &own, const SideAttacks &enemy, U64 ownPieces);
+
+	/**
+	 * @brief	King safety of one side (shield and files are scored from white's view, black is flipped).
+	 */
+	[[nodiscard]] static Score		   scoreKingSafety(const Chessboard &board, Side side, const SideAttacks &own, const SideAttacks &enemy);
+
 	/**
 	 * @brief	Sum piece-square values for a given piece bitboard.
 	 * @param	bitboard	Bitboard of the piece.
-	 * @param	table		Piece-square table (from white's perspective).
+	 * @param	table		Packed piece-square table (from white's perspective).
 	 * @param	isWhite		If false, the square index is mirrored.
 	 */
-	[[nodiscard]] static int		   scorePieceSquare(U64 bitboard, const int table[64], bool isWhite);
+	[[nodiscard]] static Score		   scorePieceSquare(U64 bitboard, const Score table[64], bool isWhite);
 
 	/**
 	 * @brief	Mirror a square index vertically (for black's perspective).
 	 */
-	[[nodiscard]] static constexpr int mirrorSquare(int sq) { return sq ^ 56; }
+	[[nodiscard]] static constexpr int mirrorSquare(int sq) { return PieceSquareTables::mirrorSquare(sq); }
 
 
 	//=========================================================================
-	// Piece-Square Tables (from white's perspective, a8 = index 0)
+	// Mobility and king safety
 	//=========================================================================
 
-	// clang-format off
-	static constexpr int PST_PAWN[64] =
+	enum PieceKind
 	{
-		 0,   0,   0,   0,   0,   0,   0,   0,
-		50,  50,  50,  50,  50,  50,  50,  50,
-		10,  10,  20,  30,  30,  20,  10,  10,
-		 5,   5,  10,  25,  25,  10,   5,   5,
-		 0,   0,   0,  20,  20,   0,   0,   0,
-		 5,  -5, -10,   0,   0, -10,  -5,   5,
-		 5,  10,  10, -20, -20,  10,  10,   5,
-		 0,   0,   0,   0,   0,   0,   0,   0,
+		Knight = 0,
+		Bishop,
+		Rook,
+		Queen
 	};
 
-	static constexpr int PST_KNIGHT[64] =
-	{
-		-50, -40, -30, -30, -30, -30, -40, -50,
-		-40, -20,   0,   0,   0,   0, -20, -40,
-		-30,   0,  10,  15,  15,  10,   0, -30,
-		-30,   5,  15,  20,  20,  15,   5, -30,
-		-30,   0,  15,  20,  20,  15,   0, -30,
-		-30,   5,  10,  15,  15,  10,   5, -30,
-		-40, -20,   0,   5,   5,   0, -20, -40,
-		-50, -40, -30, -30, -30, -30, -40, -50,
-	};
+	static constexpr U64 RANK_8			 = 0x00000000000000FFULL;
+	static constexpr U64 FIRST_TWO_RANKS = 0xFFFF000000000000ULL;
+};
 
-	static constexpr int PST_BISHOP[64] =
-	{
-		-20, -10, -10, -10, -10, -10, -10, -20,
-		-10,   0,   0,   0,   0,   0,   0, -10,
-		-10,   0,  10,  10,  10,  10,   0, -10,
-		-10,   5,   5,  10,  10,   5,   5, -10,
-		-10,   0,   5,  10,  10,   5,   0, -10,
-		-10,  10,  10,  10,  10,  10,  10, -10,
-		-10,   5,   0,   0,   0,   0,   5, -10,
-		-20, -10, -10, -10, -10, -10, -10, -20,
-	};
 
-	static constexpr int PST_ROOK[64] =
-	{
-		 0,   0,   0,   0,   0,   0,   0,   0,
-		 5,  10,  10,  10,  10,  10,  10,   5,
-		-5,   0,   0,   0,   0,   0,   0,  -5,
-		-5,   0,   0,   0,   0,   0,   0,  -5,
-		-5,   0,   0,   0,   0,   0,   0,  -5,
-		-5,   0,   0,   0,   0,   0,   0,  -5,
-		-5,   0,   0,   0,   0,   0,   0,  -5,
-		 0,   0,   0,   5,   5,   0,   0,   0,
-	};
+/**
+ * @brief	The engine's evaluation, every weight is a compile-time constant.
+ */
+using Evaluation		= BasicEvaluation<ConstexprWeights>;
 
-	static constexpr int PST_QUEEN[64] =
-	{
-		-20, -10, -10,  -5,  -5, -10, -10, -20,
-		-10,   0,   0,   0,   0,   0,   0, -10,
-		-10,   0,   5,   5,   5,   5,   0, -10,
-		 -5,   0,   5,   5,   5,   5,   0,  -5,
-		  0,   0,   5,   5,   5,   5,   0,  -5,
-		-10,   5,   5,   5,   5,   5,   0, -10,
-		-10,   0,   5,   0,   0,   0,   0, -10,
-		-20, -10, -10,  -5,  -5, -10, -10, -20,
-	};
+/**
+ * @brief	Same evaluation with the weights of RuntimeWeights, for tuning and A/B experiments.
+ */
+using TunableEvaluation = BasicEvaluation<RuntimeWeights>;
 
-	static constexpr int PST_KING_MIDDLEGAME[64] =
-	{
-		-30, -40, -40, -50, -50, -40, -40, -30,
-		-30, -40, -40, -50, -50, -40, -40, -30,
-		-30, -40, -40, -50, -50, -40, -40, -30,
-		-30, -40, -40, -50, -50, -40, -40, -30,
-		-20, -30, -30, -40, -40, -30, -30, -20,
-		-10, -20, -20, -20, -20, -20, -20, -10,
-		 20,  20,   0,   0,   0,   0,  20,  20,
-		 20,  30,  10,   0,   0,  10,  30,  20,
-	};
-	// clang-format on
-};
+extern template class BasicEvaluation<ConstexprWeights>;
+extern template class BasicEvaluation<RuntimeWeights>;
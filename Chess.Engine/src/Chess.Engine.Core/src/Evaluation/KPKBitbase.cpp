@@ -0,0 +1,289 @@
+/*
+  ==============================================================================
+	Module:         KPKBitbase
+	Description:    Win/draw bitbase of king and pawn against king
+  ==============================================================================
+*/
+
+#include "KPKBitbase.h"
+
+#include <array>
+#include <cassert>
+#include <vector>
+
+#include "BitboardUtils.h"
+
+
+namespace
+{
+
+// Pawn on files a-d and ranks 2-7, side to move, black king, white king
+constexpr int PAWN_SQUARES = 24;
+constexpr int POSITIONS	   = PAWN_SQUARES * 2 * 64 * 64;
+
+enum Result : uint8_t
+{
+	Invalid = 0,
+	Unknown = 1,
+	Draw	= 2,
+	Win		= 4
+};
+
+
+constexpr std::array<U64, 64> buildKingAttacks()
+{
+	std::array<U64, 64> attacks{};
+
+	for (int sq = 0; sq < 64; ++sq)
+	{
+		int file = sq % 8;
+		int row	 = sq / 8;
+
+		for (int dr = -1; dr <= 1; ++dr)
+		{
+			for (int df = -1; df <= 1; ++df)
+			{
+				int r = row + dr;
+				int f = file + df;
+
+				if ((dr || df) && r >= 0 && r < 8 && f >= 0 && f < 8)
+					attacks[sq] |= 1ULL << (r * 8 + f);
+			}
+		}
+	}
+
+	return attacks;
+}
+
+constexpr std::array<U64, 64> KING_ATTACKS = buildKingAttacks();
+
+
+/**
+ * @brief	Squares attacked by a white pawn (white moves towards lower square indices).
+ */
+constexpr U64				  pawnAttacks(int sq)
+{
+	U64 bb	 = 1ULL << sq;
+	U64 west = (bb & not_A_file) >> 9;
+	U64 east = (bb & not_H_file) >> 7;
+	return west | east;
+}
+
+
+constexpr int index(int whiteKing, int blackKing, int sideToMove, int pawn)
+{
+	// Pawn rows 1-6 (ranks 7-2) and files a-d
+	int pawnIndex = (pawn / 8 - 1) * 4 + pawn % 8;
+	return ((pawnIndex * 2 + sideToMove) * 64 + blackKing) * 64 + whiteKing;
+}
+
+
+struct Position
+{
+	int whiteKing;
+	int blackKing;
+	int sideToMove;
+	int pawn;
+};
+
+
+constexpr Position decode(int idx)
+{
+	Position pos;
+	pos.whiteKing  = idx % 64;
+	pos.blackKing  = (idx / 64) % 64;
+	pos.sideToMove = (idx / 4096) % 2;
+
+	int pawnIndex  = idx / 8192;
+	pos.pawn	   = (pawnIndex / 4 + 1) * 8 + pawnIndex % 4;
+	return pos;
+}
+
+
+/**
+ * @brief	Result that follows from the position alone, Unknown if it depends on the successors.
+ */
+Result classifyInitial(const Position &pos)
+{
+	const U64 whiteKing = 1ULL << pos.whiteKing;
+	const U64 blackKing = 1ULL << pos.blackKing;
+	const U64 pawn		= 1ULL << pos.pawn;
+
+	if ((whiteKing | pawn) & blackKing || whiteKing & pawn || KING_ATTACKS[pos.whiteKing] & blackKing)
+		return Invalid;
+
+	if (pos.sideToMove == 0)
+	{
+		// The side not to move must not be in check
+		if (pawnAttacks(pos.pawn) & blackKing)
+			return Invalid;
+
+		// Promotion on a free square that the black king can't take (or the white king protects)
+		if (pos.pawn / 8 == 1)
+		{
+			int promotion = pos.pawn - 8;
+			U64 square	  = 1ULL << promotion;
+
+			if (!((whiteKing | blackKing) & square) && (!(KING_ATTACKS[pos.blackKing] & square) || KING_ATTACKS[pos.whiteKing] & square))
+				return Win;
+		}
+
+		return Unknown;
+	}
+
+	U64 moves = KING_ATTACKS[pos.blackKing] & ~(KING_ATTACKS[pos.whiteKing] | pawnAttacks(pos.pawn));
+
+	// Stalemate, or mate by the pawn
+	if (!moves)
+		return pawnAttacks(pos.pawn) & blackKing ? Win : Draw;
+
+	// The pawn can be taken
+	if (moves & pawn)
+		return Draw;
+
+	return Unknown;
+}
+
+
+/**
+ * @brief	Result from the successors: a side that can reach its own result gets it,
+ *			a side whose moves all lead to the opponent's result gets that.
+ */
+Result classify(const Position &pos, const std::vector<uint8_t> &results)
+{
+	const U64 pawn	   = 1ULL << pos.pawn;
+
+	uint8_t	  combined = 0;
+
+	if (pos.sideToMove == 0)
+	{
+		U64 moves = KING_ATTACKS[pos.whiteKing] & ~KING_ATTACKS[pos.blackKing] & ~pawn;
+
+		for (; moves; moves &= moves - 1)
+			combined |= results[index(BitUtils::lsb(moves), pos.blackKing, 1, pos.pawn)];
+
+		// Pushes that stay on the board of the bitbase (promotions are classified initially)
+		if (pos.pawn / 8 > 1)
+		{
+			int push = pos.pawn - 8;
+
+			if (push != pos.whiteKing && push != pos.blackKing)
+			{
+				combined |= results[index(pos.whiteKing, pos.blackKing, 1, push)];
+
+				int doublePush = push - 8;
+
+				if (pos.pawn / 8 == 6 && doublePush != pos.whiteKing && doublePush != pos.blackKing)
+					combined |= results[index(pos.whiteKing, pos.blackKing, 1, doublePush)];
+			}
+		}
+
+		if (combined & Win)
+			return Win;
+
+		return combined & Unknown ? Unknown : Draw;
+	}
+
+	U64 moves = KING_ATTACKS[pos.blackKing] & ~(KING_ATTACKS[pos.whiteKing] | pawnAttacks(pos.pawn)) & ~pawn;
+
+	for (; moves; moves &= moves - 1)
+		combined |= results[index(pos.whiteKing, BitUtils::lsb(moves), 0, pos.pawn)];
+
+	if (combined & Draw)
+		return Draw;
+
+	return combined & Unknown ? Unknown : Win;
+}
+
+
+struct Bitbase
+{
+	std::array<uint64_t, POSITIONS / 64> bits{};
+
+	Bitbase()
+	{
+		std::vector<uint8_t> results(POSITIONS);
+		std::vector<int>	 unknown;
+
+		for (int idx = 0; idx < POSITIONS; ++idx)
+		{
+			results[idx] = classifyInitial(decode(idx));
+
+			if (results[idx] == Unknown)
+				unknown.push_back(idx);
+		}
+
+		// Resolve until a pass changes nothing, the rest can't be forced either way and is drawn
+		bool changed = true;
+
+		while (changed)
+		{
+			changed	   = false;
+			size_t out = 0;
+
+			for (int idx : unknown)
+			{
+				Result result = classify(decode(idx), results);
+
+				if (result == Unknown)
+				{
+					unknown[out++] = idx;
+					continue;
+				}
+
+				results[idx] = result;
+				changed		 = true;
+			}
+
+			unknown.resize(out);
+		}
+
+		for (int idx = 0; idx < POSITIONS; ++idx)
+		{
+			if (results[idx] == Win)
+				bits[idx / 64] |= 1ULL << (idx % 64);
+		}
+	}
+
+	bool won(int idx) const { return bits[idx / 64] >> (idx % 64) & 1; }
+};
+
+
+const Bitbase &bitbase()
+{
+	static const Bitbase instance;
+	return instance;
+}
+
+} // namespace
+
+
+namespace KPKBitbase
+{
+
+bool probe(Square whiteKing, Square whitePawn, Square blackKing, Side sideToMove)
+{
+	int pawn = to_index(whitePawn);
+	assert(pawn % 8 < 4 && pawn / 8 >= 1 && pawn / 8 <= 6 && "Pawn must be normalized to files a-d, ranks 2-7");
+
+	return bitbase().won(index(to_index(whiteKing), to_index(blackKing), sideToMove == Side::White ? 0 : 1, pawn));
+}
+
+
+void initialize()
+{
+	(void)bitbase();
+}
+
+
+size_t countWins()
+{
+	size_t wins = 0;
+
+	for (uint64_t word : bitbase().bits)
+		wins += BitUtils::popCount(word);
+
+	return wins;
+}
+
+} // namespace KPKBitbase
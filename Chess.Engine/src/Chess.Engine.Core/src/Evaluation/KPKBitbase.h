@@ -0,0 +1,40 @@
+/*
+  ==============================================================================
+	Module:         KPKBitbase
+	Description:    Win/draw bitbase of king and pawn against king
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+
+#include "BitboardTypes.h"
+
+
+/**
+ * @brief	Exact result of every king and pawn against king position, one bit each (24 KB).
+ *			Generated by retrograde analysis on first use: positions with an immediate result
+ *			(safe promotion, pawn capture, stalemate) are classified first, then the remaining ones
+ *			are resolved from their successors until nothing changes.
+ */
+namespace KPKBitbase
+{
+
+/**
+ * @brief	Whether the pawn side wins, with the pawn side normalized to white.
+ *			Squares use the board's indexing, the pawn must stand on files a-d, ranks 2-7.
+ */
+[[nodiscard]] bool	 probe(Square whiteKing, Square whitePawn, Square blackKing, Side sideToMove);
+
+/**
+ * @brief	Generate the bitbase now instead of on the first probe.
+ */
+void				 initialize();
+
+/**
+ * @brief	Number of won positions (for testing the generation).
+ */
+[[nodiscard]] size_t countWins();
+
+} // namespace KPKBitbase
@@ -0,0 +1,340 @@
+/*
+  ==============================================================================
+	Module:         NNUE
+	Description:    Efficiently updatable neural network evaluation (HalfKP)
+  ==============================================================================
+*/
+
+#include "NNUE.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <random>
+
+#include "Chessboard.h"
+#include "Logging.h"
+
+
+namespace
+{
+
+template <typename T>
+bool readValues(std::ifstream &file, std::vector<T> &values)
+{
+	file.read(reinterpret_cast<char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+	return static_cast<bool>(file);
+}
+
+
+template <typename T>
+void writeValues(std::ofstream &file, const std::vector<T> &values)
+{
+	file.write(reinterpret_cast<const char *>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(T)));
+}
+
+
+template <typename T>
+void fillRandom(std::vector<T> &values, std::mt19937 &random, int low, int high)
+{
+	std::uniform_int_distribution<int> distribution(low, high);
+
+	for (T &value : values)
+		value = static_cast<T>(distribution(random));
+}
+
+
+/**
+ * @brief	Clipped ReLU of the hidden layer sums into the next layer's uint8 input.
+ */
+void activate(const int32_t *sums, uint8_t *output, int size, int shift)
+{
+	for (int i = 0; i < size; ++i)
+		output[i] = static_cast<uint8_t>(std::clamp(sums[i] >> shift, 0, NNUE::ACTIVATION_MAX));
+}
+
+} // namespace
+
+
+void NNUE::Network::allocate()
+{
+	featureBias.resize(L1);
+	featureWeights.resize(static_cast<size_t>(INPUTS) * L1);
+	l1Bias.resize(L2);
+	l1Weights.resize(L2 * 2 * L1);
+	l2Bias.resize(L3);
+	l2Weights.resize(L3 * L2);
+	outputBias.resize(1);
+	outputWeights.resize(L3);
+}
+
+
+bool NNUE::load(const std::string &path)
+{
+	std::ifstream file(path, std::ios::binary);
+
+	if (!file)
+	{
+		LOG_ERROR("Could not open NNUE file {}", path);
+		return false;
+	}
+
+	// Header: magic, version and the layer sizes the file was trained for
+	uint32_t header[6] = {};
+	file.read(reinterpret_cast<char *>(header), sizeof(header));
+
+	const uint32_t expected[6] = {FILE_MAGIC, FILE_VERSION, INPUTS, L1, L2, L3};
+
+	if (!file || std::memcmp(header, expected, sizeof(header)) != 0)
+	{
+		LOG_ERROR("{} is not a compatible NNUE file (HalfKP {}x{}-{}-{}-1)", path, INPUTS, L1, L2, L3);
+		return false;
+	}
+
+	auto network = std::make_unique<Network>();
+	network->allocate();
+
+	bool valid = readValues(file, network->featureBias) && readValues(file, network->featureWeights) && readValues(file, network->l1Bias) && readValues(file, network->l1Weights)
+			  && readValues(file, network->l2Bias) && readValues(file, network->l2Weights) && readValues(file, network->outputBias) && readValues(file, network->outputWeights);
+
+	if (!valid)
+	{
+		LOG_ERROR("NNUE file {} is truncated", path);
+		return false;
+	}
+
+	install(std::move(network));
+	LOG_INFO("Loaded NNUE {} (kernel {})", path, NNUEKernels::name(sKernel));
+	return true;
+}
+
+
+bool NNUE::save(const std::string &path)
+{
+	if (!sNetwork)
+		return false;
+
+	std::ofstream file(path, std::ios::binary);
+
+	if (!file)
+	{
+		LOG_ERROR("Could not create NNUE file {}", path);
+		return false;
+	}
+
+	const uint32_t header[6] = {FILE_MAGIC, FILE_VERSION, INPUTS, L1, L2, L3};
+	file.write(reinterpret_cast<const char *>(header), sizeof(header));
+
+	writeValues(file, sNetwork->featureBias);
+	writeValues(file, sNetwork->featureWeights);
+	writeValues(file, sNetwork->l1Bias);
+	writeValues(file, sNetwork->l1Weights);
+	writeValues(file, sNetwork->l2Bias);
+	writeValues(file, sNetwork->l2Weights);
+	writeValues(file, sNetwork->outputBias);
+	writeValues(file, sNetwork->outputWeights);
+
+	return static_cast<bool>(file);
+}
+
+
+void NNUE::initRandom(uint32_t seed)
+{
+	std::mt19937 random(seed);
+
+	auto		 network = std::make_unique<Network>();
+	network->allocate();
+
+	// Small weights keep the accumulator far from the int16 limits with all 30 pieces on the board
+	fillRandom(network->featureBias, random, 0, 32);
+	fillRandom(network->featureWeights, random, -32, 32);
+	fillRandom(network->l1Bias, random, -512, 512);
+	fillRandom(network->l1Weights, random, -64, 64);
+	fillRandom(network->l2Bias, random, -512, 512);
+	fillRandom(network->l2Weights, random, -64, 64);
+	fillRandom(network->outputBias, random, -256, 256);
+	fillRandom(network->outputWeights, random, -64, 64);
+
+	install(std::move(network));
+}
+
+
+void NNUE::unload()
+{
+	sGeneration.store(0, std::memory_order_relaxed);
+	sNetwork.reset();
+}
+
+
+bool NNUE::setKernel(NNUEKernel kernel)
+{
+	if (!NNUEKernels::isSupported(kernel))
+	{
+		LOG_WARNING("NNUE kernel {} is not supported by this CPU", NNUEKernels::name(kernel));
+		return false;
+	}
+
+	sKernel = kernel;
+	return true;
+}
+
+
+int NNUE::evaluate(const Chessboard &board)
+{
+	NNUEAccumulator &accumulator = board.accumulator();
+	applyPending(accumulator, board);
+
+	// Side to move's half first
+	int							us = board.getCurrentSide() == Side::White ? 0 : 1;
+
+	alignas(32) uint8_t		   input[2 * L1];
+	alignas(32) uint8_t		   hidden1[L2];
+	alignas(32) uint8_t		   hidden2[L3];
+	alignas(32) int32_t		   sums[L2];
+	int32_t					   output = 0;
+
+	NNUEKernels::AffineFunction affine = NNUEKernels::affineFor(sKernel);
+
+	for (int i = 0; i < L1; ++i)
+	{
+		input[i]	  = static_cast<uint8_t>(std::clamp<int>(accumulator.values[us][i], 0, ACTIVATION_MAX));
+		input[L1 + i] = static_cast<uint8_t>(std::clamp<int>(accumulator.values[us ^ 1][i], 0, ACTIVATION_MAX));
+	}
+
+	affine(input, 2 * L1, sNetwork->l1Weights.data(), sNetwork->l1Bias.data(), sums, L2);
+	activate(sums, hidden1, L2, HIDDEN_SHIFT);
+
+	affine(hidden1, L2, sNetwork->l2Weights.data(), sNetwork->l2Bias.data(), sums, L3);
+	activate(sums, hidden2, L3, HIDDEN_SHIFT);
+
+	affine(hidden2, L3, sNetwork->outputWeights.data(), sNetwork->outputBias.data(), &output, 1);
+
+	return output / OUTPUT_SCALE;
+}
+
+
+bool NNUE::verifyAccumulator(const Chessboard &board)
+{
+	if (!isLoaded() || board.accumulator().generation != sGeneration.load(std::memory_order_relaxed))
+		return true; // nothing incremental to check yet
+
+	// Replay the pending changes on a copy, so checking doesn't change what evaluate() does
+	NNUEAccumulator updated = board.accumulator();
+	applyPending(updated, board);
+
+	NNUEAccumulator fresh;
+
+	for (int perspective = 0; perspective < 2; ++perspective)
+	{
+		refresh(fresh, board, perspective);
+
+		if (!std::equal(std::begin(fresh.values[perspective]), std::end(fresh.values[perspective]), std::begin(updated.values[perspective])))
+			return false;
+	}
+
+	return true;
+}
+
+
+void NNUE::applyPending(NNUEAccumulator &accumulator, const Chessboard &board)
+{
+	uint32_t generation = sGeneration.load(std::memory_order_relaxed);
+
+	if (accumulator.generation != generation)
+	{
+		accumulator.generation	 = generation;
+		accumulator.computed[0]	 = false;
+		accumulator.computed[1]	 = false;
+		accumulator.pendingCount = 0;
+	}
+
+	// A king that moved changes every feature of its perspective
+	for (int i = 0; i < accumulator.pendingCount; ++i)
+	{
+		PieceType piece = PieceType((accumulator.pending[i] >> 6) & 0xF);
+
+		if (piece == PieceType::WKing || piece == PieceType::BKing)
+			accumulator.computed[piece == PieceType::WKing ? 0 : 1] = false;
+	}
+
+	const auto &pieces = board.pieces();
+
+	for (int perspective = 0; perspective < 2; ++perspective)
+	{
+		if (!accumulator.computed[perspective])
+		{
+			refresh(accumulator, board, perspective);
+			continue;
+		}
+
+		int		 kingSquare = BitUtils::lsb(pieces[perspective == 0 ? PieceType::WKing : PieceType::BKing]);
+		int16_t *values		= accumulator.values[perspective];
+
+		for (int i = 0; i < accumulator.pendingCount; ++i)
+		{
+			uint16_t	   change = accumulator.pending[i];
+			PieceType	   piece  = PieceType((change >> 6) & 0xF);
+
+			if (piece == PieceType::WKing || piece == PieceType::BKing)
+				continue; // kings are not features, only the king of the perspective matters
+
+			const int16_t *column = &sNetwork->featureWeights[static_cast<size_t>(featureIndex(perspective, kingSquare, piece, change & 0x3F)) * L1];
+
+			if (change & CHANGE_ADD)
+			{
+				for (int n = 0; n < L1; ++n)
+					values[n] += column[n];
+			}
+			else
+			{
+				for (int n = 0; n < L1; ++n)
+					values[n] -= column[n];
+			}
+		}
+	}
+
+	accumulator.pendingCount = 0;
+}
+
+
+void NNUE::refresh(NNUEAccumulator &accumulator, const Chessboard &board, int perspective)
+{
+	const auto &pieces = board.pieces();
+	U64			king   = pieces[perspective == 0 ? PieceType::WKing : PieceType::BKing];
+	int16_t	   *values = accumulator.values[perspective];
+
+	std::copy(sNetwork->featureBias.begin(), sNetwork->featureBias.end(), values);
+
+	if (!king)
+	{
+		accumulator.computed[perspective] = false; // incomplete position, refreshed again once the king is placed
+		return;
+	}
+
+	int kingSquare = BitUtils::lsb(king);
+
+	for (int piece = 0; piece < 12; ++piece)
+	{
+		if (piece == PieceType::WKing || piece == PieceType::BKing)
+			continue;
+
+		for (U64 bb = pieces[piece]; bb; bb &= bb - 1)
+		{
+			const int16_t *column = &sNetwork->featureWeights[static_cast<size_t>(featureIndex(perspective, kingSquare, PieceType(piece), BitUtils::lsb(bb))) * L1];
+
+			for (int i = 0; i < L1; ++i)
+				values[i] += column[i];
+		}
+	}
+
+	accumulator.computed[perspective] = true;
+}
+
+
+void NNUE::install(std::unique_ptr<Network> network)
+{
+	sNetwork = std::move(network);
+
+	// A new generation invalidates every accumulator computed with the previous network
+	sGeneration.store(++sLastGeneration, std::memory_order_relaxed);
+}
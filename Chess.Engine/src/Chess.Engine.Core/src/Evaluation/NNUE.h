@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+	Module:         NNUE
+	Description:    Efficiently updatable neural network evaluation (HalfKP)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "BitboardTypes.h"
+#include "BitboardUtils.h"
+#include "NNUEKernels.h"
+
+
+class Chessboard;
+
+
+/**
+ * @brief	First layer output of both perspectives, owned by the Chessboard.
+ *			Piece changes are recorded as pending feature changes (a change and its inverse cancel,
+ *			so a make/unmake pair used for a legality check costs nothing) and applied on the next
+ *			evaluation. A pending king change forces a refresh of that king's perspective.
+ */
+struct NNUEAccumulator
+{
+	static constexpr int SIZE			= 128;
+	static constexpr int MAX_PENDING	= 32;
+
+	alignas(32) int16_t	 values[2][SIZE];		 // [perspective][neuron], white = 0
+	bool				 computed[2]	= {false, false};
+	uint32_t			 generation		= 0;	 // network the values were computed with, 0 = never evaluated
+	uint16_t			 pending[MAX_PENDING];	 // NNUE::encodeChange() of each change not applied yet
+	int					 pendingCount	= 0;
+};
+
+
+/**
+ * @brief	HalfKP network: 2 x (king square x 10 piece types x 64 squares) -> 2 x 128 -> 32 -> 32 -> 1.
+ *			The first layer is int16, the hidden layers int8 with int32 sums and clipped ReLU activations.
+ *			The network is optional: until one is loaded the classical evaluation is used.
+ */
+class NNUE
+{
+public:
+	NNUE()								   = delete;
+	~NNUE()								   = delete;
+
+	static constexpr int PIECE_INPUTS	   = 10 * 64;
+	static constexpr int INPUTS			   = 64 * PIECE_INPUTS;
+	static constexpr int L1				   = NNUEAccumulator::SIZE;
+	static constexpr int L2				   = 32;
+	static constexpr int L3				   = 32;
+
+	static constexpr int ACTIVATION_MAX	   = 127; // clipped ReLU range of all layer outputs
+	static constexpr int HIDDEN_SHIFT	   = 6;	  // hidden layer sums are scaled by 2^6
+	static constexpr int OUTPUT_SCALE	   = 16;  // network output units per centipawn
+
+	/**
+	 * @brief	Load a network file. Keeps the previous network (if any) when the file is invalid.
+	 */
+	static bool							   load(const std::string &path);
+
+	/**
+	 * @brief	Write the current network in the format load() reads.
+	 */
+	static bool							   save(const std::string &path);
+
+	/**
+	 * @brief	Install a network with small random weights (tests and benchmarks without a trained net).
+	 */
+	static void							   initRandom(uint32_t seed);
+
+	static void							   unload();
+
+	[[nodiscard]] static bool			   isLoaded() { return sGeneration.load(std::memory_order_relaxed) != 0; }
+
+	/**
+	 * @brief	Use the network in Evaluation::evaluate() (only takes effect once a network is loaded).
+	 */
+	static void							   setEnabled(bool enabled) { sEnabled.store(enabled, std::memory_order_relaxed); }
+	[[nodiscard]] static bool			   isEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+	[[nodiscard]] static bool			   isActive() { return isEnabled() && isLoaded(); }
+
+	/**
+	 * @brief	Generation of the network Evaluation::evaluate() uses, 0 while it uses the classical evaluation.
+	 *			Changes with every loaded network and every switch between the two evaluations.
+	 */
+	[[nodiscard]] static uint32_t		   activeGeneration() { return isEnabled() ? sGeneration.load(std::memory_order_relaxed) : 0; }
+
+	/**
+	 * @brief	Select the hidden layer kernel. Fails if the CPU doesn't support it.
+	 */
+	static bool							   setKernel(NNUEKernel kernel);
+	[[nodiscard]] static NNUEKernel		   getKernel() { return sKernel; }
+
+	/**
+	 * @brief	Evaluate the position with the network.
+	 * @return	Score in centipawns, positive favoring side to move.
+	 */
+	[[nodiscard]] static int			   evaluate(const Chessboard &board);
+
+	/**
+	 * @brief	Record a piece change in the accumulator (called by the Chessboard on every add and remove).
+	 */
+	static void							   updateAccumulator(NNUEAccumulator &accumulator, PieceType piece, Square sq, int sign);
+
+	/**
+	 * @brief	Recompute the computed perspectives of the board's accumulator and compare (debug check).
+	 */
+	[[nodiscard]] static bool			   verifyAccumulator(const Chessboard &board);
+
+private:
+	struct Network
+	{
+		std::vector<int16_t> featureBias;	 // [L1]
+		std::vector<int16_t> featureWeights; // [INPUTS][L1]
+		std::vector<int32_t> l1Bias;		 // [L2]
+		std::vector<int8_t>	 l1Weights;		 // [L2][2 * L1]
+		std::vector<int32_t> l2Bias;		 // [L3]
+		std::vector<int8_t>	 l2Weights;		 // [L3][L2]
+		std::vector<int32_t> outputBias;	 // [1]
+		std::vector<int8_t>	 outputWeights;	 // [L3]
+
+		void				 allocate();
+	};
+
+	/**
+	 * @brief	Feature index of a piece seen from one perspective (squares flipped for black).
+	 */
+	[[nodiscard]] static int			   featureIndex(int perspective, int kingSquare, PieceType piece, int sq);
+
+	static void							   refresh(NNUEAccumulator &accumulator, const Chessboard &board, int perspective);
+
+	/**
+	 * @brief	Bring both perspectives up to date: apply the pending changes or refresh.
+	 */
+	static void							   applyPending(NNUEAccumulator &accumulator, const Chessboard &board);
+
+	// Pending change encoding: square in bits 0-5, piece in bits 6-9, bit 10 set for an added piece
+	static constexpr uint16_t			   CHANGE_ADD = 1 << 10;
+
+	static constexpr uint16_t			   encodeChange(PieceType piece, Square sq, int sign) { return static_cast<uint16_t>(to_index(sq) | (piece << 6) | (sign > 0 ? CHANGE_ADD : 0)); }
+
+	static void							   install(std::unique_ptr<Network> network);
+
+
+	static constexpr uint32_t			   FILE_MAGIC	= 0x45554E43; // "CNUE"
+	static constexpr uint32_t			   FILE_VERSION = 1;
+
+	static inline std::unique_ptr<Network> sNetwork;
+	static inline std::atomic<uint32_t>	   sGeneration{0}; // 0 while no network is loaded
+	static inline uint32_t				   sLastGeneration = 0;
+	static inline std::atomic<bool>		   sEnabled{true};
+	static inline NNUEKernel			   sKernel = NNUEKernels::bestSupported();
+};
+
+
+inline void NNUE::updateAccumulator(NNUEAccumulator &accumulator, PieceType piece, Square sq, int sign)
+{
+	// Boards that were never evaluated by a network have nothing to keep up to date
+	if (accumulator.generation == 0)
+		return;
+
+	uint16_t change	 = encodeChange(piece, sq, sign);
+	uint16_t inverse = change ^ CHANGE_ADD;
+
+	for (int i = 0; i < accumulator.pendingCount; ++i)
+	{
+		if (accumulator.pending[i] == inverse)
+		{
+			accumulator.pending[i] = accumulator.pending[--accumulator.pendingCount];
+			return;
+		}
+	}
+
+	if (accumulator.pendingCount == NNUEAccumulator::MAX_PENDING)
+	{
+		// Too far from the last evaluation, recomputing is cheaper than replaying
+		accumulator.computed[0]	 = false;
+		accumulator.computed[1]	 = false;
+		accumulator.pendingCount = 0;
+		return;
+	}
+
+	accumulator.pending[accumulator.pendingCount++] = change;
+}
+
+
+inline int NNUE::featureIndex(int perspective, int kingSquare, PieceType piece, int sq)
+{
+	// Squares are seen from the perspective's side of the board (a8 = 0, so flipping ranks is ^ 56)
+	int	 flip	 = perspective == 0 ? 0 : 56;
+
+	// Piece order: WKing, WQueen, WPawn, WKnight, WBishop, WRook, BKing, ... -> type 0..4, own pieces first
+	bool isWhite = piece < PieceType::BKing;
+	int	 type	 = (isWhite ? piece : piece - PieceType::BKing) - 1;
+	int	 own	 = isWhite == (perspective == 0) ? 0 : 1;
+
+	return (kingSquare ^ flip) * PIECE_INPUTS + (type * 2 + own) * 64 + (sq ^ flip);
+}
@@ -0,0 +1,177 @@
+/*
+  ==============================================================================
+	Module:         NNUEKernels
+	Description:    Quantized dense layer kernels for the NNUE evaluation
+  ==============================================================================
+*/
+
+#include "NNUEKernels.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define NNUE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC accepts any intrinsic, GCC and Clang need the instruction set enabled per function
+#if defined(NNUE_X86) && !defined(_MSC_VER)
+#define TARGET_SSE4 __attribute__((target("ssse3,sse4.1")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define TARGET_SSE4
+#define TARGET_AVX2
+#endif
+
+
+namespace NNUEKernels
+{
+
+void affineScalar(const uint8_t *input, int inputs, const int8_t *weights, const int32_t *bias, int32_t *output, int outputs)
+{
+	for (int o = 0; o < outputs; ++o)
+	{
+		const int8_t *row = weights + o * inputs;
+		int32_t		  sum = bias[o];
+
+		for (int i = 0; i < inputs; ++i)
+			sum += row[i] * input[i];
+
+		output[o] = sum;
+	}
+}
+
+
+#if defined(NNUE_X86)
+
+TARGET_SSE4 void affineSSE4(const uint8_t *input, int inputs, const int8_t *weights, const int32_t *bias, int32_t *output, int outputs)
+{
+	const __m128i ones = _mm_set1_epi16(1);
+
+	for (int o = 0; o < outputs; ++o)
+	{
+		const int8_t *row = weights + o * inputs;
+		__m128i		  sum = _mm_setzero_si128();
+
+		for (int i = 0; i < inputs; i += 16)
+		{
+			__m128i in		= _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+			__m128i w		= _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + i));
+
+			// uint8 x int8 -> pairwise int16 sums -> int32 sums
+			__m128i product = _mm_maddubs_epi16(in, w);
+			sum				= _mm_add_epi32(sum, _mm_madd_epi16(product, ones));
+		}
+
+		sum		  = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+		sum		  = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+		output[o] = bias[o] + _mm_cvtsi128_si32(sum);
+	}
+}
+
+
+TARGET_AVX2 void affineAVX2(const uint8_t *input, int inputs, const int8_t *weights, const int32_t *bias, int32_t *output, int outputs)
+{
+	const __m256i ones = _mm256_set1_epi16(1);
+
+	for (int o = 0; o < outputs; ++o)
+	{
+		const int8_t *row = weights + o * inputs;
+		__m256i		  sum = _mm256_setzero_si256();
+
+		for (int i = 0; i < inputs; i += 32)
+		{
+			__m256i in		= _mm256_loadu_si256(reinterpret_cast<const __m256i *>(input + i));
+			__m256i w		= _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + i));
+
+			__m256i product = _mm256_maddubs_epi16(in, w);
+			sum				= _mm256_add_epi32(sum, _mm256_madd_epi16(product, ones));
+		}
+
+		__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+		half		 = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0x4E));
+		half		 = _mm_add_epi32(half, _mm_shuffle_epi32(half, 0xB1));
+		output[o]	 = bias[o] + _mm_cvtsi128_si32(half);
+	}
+}
+
+#else
+
+// Not an x86 build: isSupported() never reports the SIMD kernels, keep the symbols for affineFor()
+void affineSSE4(const uint8_t *input, int inputs, const int8_t *weights, const int32_t *bias, int32_t *output, int outputs)
+{
+	affineScalar(input, inputs, weights, bias, output, outputs);
+}
+
+
+void affineAVX2(const uint8_t *input, int inputs, const int8_t *weights, const int32_t *bias, int32_t *output, int outputs)
+{
+	affineScalar(input, inputs, weights, bias, output, outputs);
+}
+
+#endif
+
+
+AffineFunction affineFor(NNUEKernel kernel)
+{
+	switch (kernel)
+	{
+	case NNUEKernel::AVX2: return affineAVX2;
+	case NNUEKernel::SSE4: return affineSSE4;
+	default: return affineScalar;
+	}
+}
+
+
+bool isSupported(NNUEKernel kernel)
+{
+	if (kernel == NNUEKernel::Scalar)
+		return true;
+
+#if defined(NNUE_X86)
+#if defined(_MSC_VER) && !defined(__clang__)
+	int info[4];
+
+	__cpuid(info, 1);
+	bool sse4	 = (info[2] & (1 << 19)) != 0 && (info[2] & (1 << 9)) != 0; // SSE4.1 and SSSE3
+	bool osxsave = (info[2] & (1 << 27)) != 0;
+
+	__cpuidex(info, 7, 0);
+	bool avx2 = osxsave && (info[1] & (1 << 5)) != 0 && (_xgetbv(0) & 0x6) == 0x6; // OS saves the YMM registers
+#else
+	__builtin_cpu_init();
+	bool sse4 = __builtin_cpu_supports("sse4.1") && __builtin_cpu_supports("ssse3");
+	bool avx2 = __builtin_cpu_supports("avx2");
+#endif
+
+	return kernel == NNUEKernel::AVX2 ? avx2 : sse4;
+#else
+	return false;
+#endif
+}
+
+
+NNUEKernel bestSupported()
+{
+	if (isSupported(NNUEKernel::AVX2))
+		return NNUEKernel::AVX2;
+
+	if (isSupported(NNUEKernel::SSE4))
+		return NNUEKernel::SSE4;
+
+	return NNUEKernel::Scalar;
+}
+
+
+const char *name(NNUEKernel kernel)
+{
+	switch (kernel)
+	{
+	case NNUEKernel::AVX2: return "AVX2";
+	case NNUEKernel::SSE4: return "SSE4";
+	default: return "Scalar";
+	}
+}
+
+} // namespace NNUEKernels
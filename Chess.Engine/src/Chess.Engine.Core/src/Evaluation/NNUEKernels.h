@@ -0,0 +1,56 @@
+/*
+  ==============================================================================
+	Module:         NNUEKernels
+	Description:    Quantized dense layer kernels for the NNUE evaluation
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+
+/**
+ * @brief	Instruction set used for the NNUE hidden layers.
+ */
+enum class NNUEKernel
+{
+	Scalar = 0,
+	SSE4,
+	AVX2,
+};
+
+
+/**
+ * @brief	int8 x uint8 dense layer kernels. All kernels produce bit-identical results.
+ *			SIMD kernels are compiled regardless of the build's target flags and selected at runtime,
+ *			so they must only be called when isSupported() reports the CPU can run them.
+ */
+namespace NNUEKernels
+{
+
+/**
+ * @brief	output[o] = bias[o] + sum(weights[o * inputs + i] * input[i]).
+ *			Inputs must be a multiple of 32 and in [0, 127] so the int16 pair sums cannot saturate.
+ */
+using AffineFunction = void (*)(const uint8_t *input, int inputs, const int8_t *weights, const int32_t *bias, int32_t *output, int outputs);
+
+void						 affineScalar(const uint8_t *input, int inputs, const int8_t *weights, const int32_t *bias, int32_t *output, int outputs);
+void						 affineSSE4(const uint8_t *input, int inputs, const int8_t *weights, const int32_t *bias, int32_t *output, int outputs);
+void						 affineAVX2(const uint8_t *input, int inputs, const int8_t *weights, const int32_t *bias, int32_t *output, int outputs);
+
+[[nodiscard]] AffineFunction affineFor(NNUEKernel kernel);
+
+/**
+ * @brief	Whether the CPU (and OS) support the kernel's instruction set.
+ */
+[[nodiscard]] bool			 isSupported(NNUEKernel kernel);
+
+/**
+ * @brief	Fastest kernel supported by the CPU.
+ */
+[[nodiscard]] NNUEKernel	 bestSupported();
+
+[[nodiscard]] const char	*name(NNUEKernel kernel);
+
+} // namespace NNUEKernels
@@ -0,0 +1,87 @@
+/*
+  ==============================================================================
+	Module:         PawnStructure
+	Description:    Pawn structure evaluation and the pawn hash table
+  ==============================================================================
+*/
+
+#include "PawnStructure.h"
+
+
+using namespace BitUtils;
+
+
+PawnEntry PawnStructure::evaluate(U64 whitePawns, U64 blackPawns)
+{
+	PawnEntry entry;
+
+	U64		  whitePassed = 0;
+	U64		  blackPassed = 0;
+
+	// Black is scored from its own point of view by mirroring both pawn sets
+	Score	  white		  = evaluateSide(whitePawns, blackPawns, whitePassed);
+	Score	  black		  = evaluateSide(flipVertical(blackPawns), flipVertical(whitePawns), blackPassed);
+
+	entry.score			  = white - black;
+	entry.passed		  = whitePassed | flipVertical(blackPassed);
+
+	return entry;
+}
+
+
+Score PawnStructure::evaluateSide(U64 own, U64 enemy, U64 &passed)
+{
+	Score score			 = 0;
+
+	U64	  ownRearSpans	 = south(southFill(own));	 // squares behind own pawns
+	U64	  enemyFrontSpan = south(southFill(enemy)); // squares in front of enemy pawns
+	U64	  enemyAttacks	 = PawnStructure::enemyAttacks(enemy);
+	U64	  ownAttackSpans = northFill(attacks(own));	 // squares own pawns can defend now or after advancing
+
+	// Doubled: every pawn with another own pawn in front of it
+	U64	  doubled		 = own & ownRearSpans;
+
+	// Isolated: no own pawn on an adjacent file
+	U64	  isolated		 = own & ~adjacentFiles(own);
+
+	// Passed: no enemy pawn ahead on the same or an adjacent file
+	U64	  blockers		 = enemyFrontSpan | east(enemyFrontSpan) | west(enemyFrontSpan);
+	passed				 = own & ~blockers;
+
+	// Backward: the stop square can never be defended by an own pawn and is attacked by an enemy pawn
+	U64	  stops			 = north(own);
+	U64	  backward		 = south(stops & ~ownAttackSpans & enemyAttacks) & ~isolated;
+
+	// Connected: defended by an own pawn or standing next to one
+	U64	  connected		 = own & (attacks(own) | east(own) | west(own));
+
+	score += scaleScore(DOUBLED, popCount(doubled));
+	score += scaleScore(ISOLATED, popCount(isolated));
+	score += scaleScore(BACKWARD, popCount(backward));
+	score += scaleScore(CONNECTED, popCount(connected));
+
+	for (U64 bb = passed; bb; bb &= bb - 1)
+	{
+		int sq = lsb(bb);
+		score += PASSED[7 - sq / 8];
+	}
+
+	// Candidate: not passed yet, nothing in front on its own file, and at least as many
+	// own pawns able to support its advance as enemy pawns guarding its path
+	U64 candidates = own & ~passed & ~enemyFrontSpan & ~ownRearSpans;
+
+	for (U64 bb = candidates; bb; bb &= bb - 1)
+	{
+		int sq		   = lsb(bb);
+		U64 pawn	   = 1ULL << sq;
+		U64 sides	   = east(pawn) | west(pawn);
+
+		U64 supporters = own & southFill(sides);
+		U64 sentries   = enemy & north(northFill(sides));
+
+		if (popCount(supporters) >= popCount(sentries))
+			score += CANDIDATE;
+	}
+
+	return score;
+}
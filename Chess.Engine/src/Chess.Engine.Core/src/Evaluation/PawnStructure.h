@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+	Module:         PawnStructure
+	Description:    Pawn structure evaluation and the pawn hash table
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "BitboardUtils.h"
+#include "Score.h"
+
+
+/**
+ * @brief	Result of a pawn structure evaluation.
+ */
+struct PawnEntry
+{
+	uint64_t key	= 0;
+	Score	 score	= 0; // white - black
+	U64		 passed = 0; // passed pawns of both sides
+};
+
+
+/**
+ * @brief	Pawn structure terms computed set-wise from the two pawn bitboards.
+ *			Doubled, isolated, backward, passed, candidate and connected pawns.
+ */
+class PawnStructure
+{
+public:
+	PawnStructure()	 = delete;
+	~PawnStructure() = delete;
+
+	/**
+	 * @brief	Evaluate the pawn structure (white - black).
+	 */
+	[[nodiscard]] static PawnEntry evaluate(U64 whitePawns, U64 blackPawns);
+
+private:
+	/**
+	 * @brief	Score the pawns of one side as if it were white (black is flipped vertically beforehand).
+	 */
+	[[nodiscard]] static Score	   evaluateSide(U64 own, U64 enemy, U64 &passed);
+
+	// Pawn attacks from white's point of view
+	static constexpr U64		   attacks(U64 pawns) { return BitUtils::north(BitUtils::east(pawns) | BitUtils::west(pawns)); }
+	static constexpr U64		   enemyAttacks(U64 pawns) { return BitUtils::south(BitUtils::east(pawns) | BitUtils::west(pawns)); }
+	static constexpr U64		   adjacentFiles(U64 pawns) { return BitUtils::fileFill(BitUtils::east(pawns) | BitUtils::west(pawns)); }
+
+
+	//=========================================================================
+	// Weights (midgame, endgame)
+	//=========================================================================
+
+	static constexpr Score		   DOUBLED	 = makeScore(-10, -20);
+	static constexpr Score		   ISOLATED	 = makeScore(-10, -15);
+	static constexpr Score		   BACKWARD	 = makeScore(-8, -10);
+	static constexpr Score		   CONNECTED = makeScore(7, 5);
+	static constexpr Score		   CANDIDATE = makeScore(5, 15);
+
+	// Passed pawn bonus by relative rank (rank 1 .. rank 8)
+	static constexpr Score		   PASSED[8] = {
+		  makeScore(0, 0),	makeScore(5, 10),  makeScore(10, 15),	makeScore(15, 25),
+		  makeScore(30, 50), makeScore(50, 90), makeScore(80, 140), makeScore(0, 0),
+	  };
+};
+
+
+/**
+ * @brief	Direct-mapped cache of pawn structure results keyed by the board's pawn hash.
+ *			Pawn structure changes rarely within a search, so almost every probe hits.
+ *			One table per thread (see Evaluation), so no synchronisation is needed.
+ *			Empty slots hold key 0 with a zero score, which is the correct entry for "no pawns".
+ */
+class PawnHashTable
+{
+public:
+	static constexpr size_t ENTRIES = 1 << 14; // 384 KB
+
+	PawnHashTable() : mEntries(ENTRIES) {}
+
+	/**
+	 * @brief	Cached entry for the pawn key, computed and stored on a miss.
+	 */
+	const PawnEntry		   &probe(uint64_t pawnKey, U64 whitePawns, U64 blackPawns)
+	{
+		PawnEntry &entry = mEntries[pawnKey & (ENTRIES - 1)];
+		++mProbes;
+
+		if (entry.key == pawnKey)
+		{
+			++mHits;
+			return entry;
+		}
+
+		entry	  = PawnStructure::evaluate(whitePawns, blackPawns);
+		entry.key = pawnKey;
+		return entry;
+	}
+
+	void clear()
+	{
+		std::fill(mEntries.begin(), mEntries.end(), PawnEntry{});
+		mProbes = 0;
+		mHits	= 0;
+	}
+
+	uint64_t getProbes() const { return mProbes; }
+	uint64_t getHits() const { return mHits; }
+
+private:
+	std::vector<PawnEntry> mEntries;
+	uint64_t			   mProbes = 0;
+	uint64_t			   mHits   = 0;
+};
@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+	Module:         PieceSquareTables
+	Description:    Piece placement tables and the combined material + placement scores
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+
+#include "BitboardTypes.h"
+#include "PieceValues.h"
+#include "Score.h"
+
+
+namespace PieceSquareTables
+{
+
+//=========================================================================
+// Piece-Square Tables (from white's perspective, a8 = index 0)
+//=========================================================================
+
+// clang-format off
+constexpr int PST_PAWN[64] =
+{
+	 0,   0,   0,   0,   0,   0,   0,   0,
+	50,  50,  50,  50,  50,  50,  50,  50,
+	10,  10,  20,  30,  30,  20,  10,  10,
+	 5,   5,  10,  25,  25,  10,   5,   5,
+	 0,   0,   0,  20,  20,   0,   0,   0,
+	 5,  -5, -10,   0,   0, -10,  -5,   5,
+	 5,  10,  10, -20, -20,  10,  10,   5,
+	 0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+constexpr int PST_KNIGHT[64] =
+{
+	-50, -40, -30, -30, -30, -30, -40, -50,
+	-40, -20,   0,   0,   0,   0, -20, -40,
+	-30,   0,  10,  15,  15,  10,   0, -30,
+	-30,   5,  15,  20,  20,  15,   5, -30,
+	-30,   0,  15,  20,  20,  15,   0, -30,
+	-30,   5,  10,  15,  15,  10,   5, -30,
+	-40, -20,   0,   5,   5,   0, -20, -40,
+	-50, -40, -30, -30, -30, -30, -40, -50,
+};
+
+constexpr int PST_BISHOP[64] =
+{
+	-20, -10, -10, -10, -10, -10, -10, -20,
+	-10,   0,   0,   0,   0,   0,   0, -10,
+	-10,   0,  10,  10,  10,  10,   0, -10,
+	-10,   5,   5,  10,  10,   5,   5, -10,
+	-10,   0,   5,  10,  10,   5,   0, -10,
+	-10,  10,  10,  10,  10,  10,  10, -10,
+	-10,   5,   0,   0,   0,   0,   5, -10,
+	-20, -10, -10, -10, -10, -10, -10, -20,
+};
+
+constexpr int PST_ROOK[64] =
+{
+	 0,   0,   0,   0,   0,   0,   0,   0,
+	 5,  10,  10,  10,  10,  10,  10,   5,
+	-5,   0,   0,   0,   0,   0,   0,  -5,
+	-5,   0,   0,   0,   0,   0,   0,  -5,
+	-5,   0,   0,   0,   0,   0,   0,  -5,
+	-5,   0,   0,   0,   0,   0,   0,  -5,
+	-5,   0,   0,   0,   0,   0,   0,  -5,
+	 0,   0,   0,   5,   5,   0,   0,   0,
+};
+
+constexpr int PST_QUEEN[64] =
+{
+	-20, -10, -10,  -5,  -5, -10, -10, -20,
+	-10,   0,   0,   0,   0,   0,   0, -10,
+	-10,   0,   5,   5,   5,   5,   0, -10,
+	 -5,   0,   5,   5,   5,   5,   0,  -5,
+	  0,   0,   5,   5,   5,   5,   0,  -5,
+	-10,   5,   5,   5,   5,   5,   0, -10,
+	-10,   0,   5,   0,   0,   0,   0, -10,
+	-20, -10, -10,  -5,  -5, -10, -10, -20,
+};
+
+constexpr int PST_KING_MIDDLEGAME[64] =
+{
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-30, -40, -40, -50, -50, -40, -40, -30,
+	-20, -30, -30, -40, -40, -30, -30, -20,
+	-10, -20, -20, -20, -20, -20, -20, -10,
+	 20,  20,   0,   0,   0,   0,  20,  20,
+	 20,  30,  10,   0,   0,  10,  30,  20,
+};
+
+// Endgame tables for the pieces whose placement changes once the queens and most pieces are gone
+constexpr int PST_PAWN_ENDGAME[64] =
+{
+	 0,   0,   0,   0,   0,   0,   0,   0,
+	80,  80,  80,  80,  80,  80,  80,  80,
+	50,  50,  50,  50,  50,  50,  50,  50,
+	30,  30,  30,  30,  30,  30,  30,  30,
+	20,  20,  20,  20,  20,  20,  20,  20,
+	10,  10,  10,  10,  10,  10,  10,  10,
+	10,  10,  10,  10,  10,  10,  10,  10,
+	 0,   0,   0,   0,   0,   0,   0,   0,
+};
+
+constexpr int PST_KING_ENDGAME[64] =
+{
+	-50, -40, -30, -20, -20, -30, -40, -50,
+	-30, -20, -10,   0,   0, -10, -20, -30,
+	-30, -10,  20,  30,  30,  20, -10, -30,
+	-30, -10,  30,  40,  40,  30, -10, -30,
+	-30, -10,  30,  40,  40,  30, -10, -30,
+	-30, -10,  20,  30,  30,  20, -10, -30,
+	-30, -30,   0,   0,   0,   0, -30, -30,
+	-50, -30, -30, -30, -30, -30, -30, -50,
+};
+// clang-format on
+
+
+constexpr int mirrorSquare(int sq)
+{
+	return sq ^ 56;
+}
+
+
+using ScoreTable = std::array<std::array<Score, 64>, 12>;
+
+constexpr ScoreTable buildScores()
+{
+	// PieceType order
+	const int *midgame[6]	= {PST_KING_MIDDLEGAME, PST_QUEEN, PST_PAWN, PST_KNIGHT, PST_BISHOP, PST_ROOK};
+	const int *endgame[6]	= {PST_KING_ENDGAME, PST_QUEEN, PST_PAWN_ENDGAME, PST_KNIGHT, PST_BISHOP, PST_ROOK};
+	const int  materials[6] = {0, PieceValues::QUEEN, PieceValues::PAWN, PieceValues::KNIGHT, PieceValues::BISHOP, PieceValues::ROOK};
+
+	ScoreTable scores{};
+
+	for (int type = 0; type < 6; ++type)
+	{
+		for (int sq = 0; sq < 64; ++sq)
+		{
+			int mirrored		 = mirrorSquare(sq);
+
+			scores[type][sq]	 = makeScore(materials[type] + midgame[type][sq], materials[type] + endgame[type][sq]);
+			scores[type + 6][sq] = makeScore(-(materials[type] + midgame[type][mirrored]), -(materials[type] + endgame[type][mirrored]));
+		}
+	}
+
+	return scores;
+}
+
+/**
+ * @brief	Packed midgame/endgame material plus placement value of a piece on a square,
+ *			signed from white's point of view. Kings carry no material, both always stand on the board.
+ */
+inline constexpr ScoreTable SCORES = buildScores();
+
+
+constexpr Score score(PieceType piece, Square sq)
+{
+	return SCORES[piece][to_index(sq)];
+}
+
+} // namespace PieceSquareTables
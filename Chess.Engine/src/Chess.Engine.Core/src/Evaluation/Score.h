@@ -0,0 +1,75 @@
+/*
+  ==============================================================================
+	Module:         Score
+	Description:    Packed midgame/endgame evaluation scores
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+
+
+/**
+ * @brief	Midgame and endgame value packed into one 32-bit integer.
+ *			The endgame value lives in the upper 16 bits, the midgame value in the lower 16 bits,
+ *			so both are added and subtracted with a single integer operation.
+ *			Each half must stay within the int16 range.
+ */
+using Score = int32_t;
+
+
+constexpr Score makeScore(int mg, int eg)
+{
+	return static_cast<Score>(static_cast<uint32_t>(eg) << 16) + mg;
+}
+
+
+constexpr int mgScore(Score score)
+{
+	return static_cast<int16_t>(static_cast<uint16_t>(static_cast<uint32_t>(score)));
+}
+
+
+constexpr int egScore(Score score)
+{
+	// The rounding offset undoes the borrow a negative midgame half takes from the endgame half
+	return static_cast<int16_t>(static_cast<uint16_t>((static_cast<uint32_t>(score) + 0x8000) >> 16));
+}
+
+
+/**
+ * @brief	Multiply both halves (e.g. a per-pawn penalty by the pawn count).
+ */
+constexpr Score scaleScore(Score score, int factor)
+{
+	return makeScore(mgScore(score) * factor, egScore(score) * factor);
+}
+
+
+namespace GamePhase
+{
+
+// Non-pawn material weights, the phase runs from MAX (all pieces on the board) to 0 (pawn endgame)
+constexpr int KNIGHT = 1;
+constexpr int BISHOP = 1;
+constexpr int ROOK	 = 2;
+constexpr int QUEEN	 = 4;
+constexpr int MAX	 = 4 * KNIGHT + 4 * BISHOP + 4 * ROOK + 2 * QUEEN;
+
+// Indexed by PieceType enum
+// Order: WKing, WQueen, WPawn, WKnight, WBishop, WRook, BKing, BQueen, BPawn, BKnight, BBishop, BRook
+constexpr int BY_TYPE[12] = {0, QUEEN, 0, KNIGHT, BISHOP, ROOK, 0, QUEEN, 0, KNIGHT, BISHOP, ROOK};
+
+
+/**
+ * @brief	Blend midgame and endgame value by the game phase (done once per evaluation).
+ */
+constexpr int interpolate(Score score, int phase)
+{
+	int mgPhase = phase < MAX ? phase : MAX; // promotions can push the count above the start position
+
+	return (mgScore(score) * mgPhase + egScore(score) * (MAX - mgPhase)) / MAX;
+}
+
+} // namespace GamePhase
@@ -8,7 +8,14 @@
 #include "GameController.h"
 
 
-GameController::GameController() : mCPUPlayer(mEngine) {}
+GameController::GameController() : mCPUPlayer(mEngine), mSearchInfoDispatcher(mCPUPlayer.getSearchInfoChannel(), SEARCH_INFO_INTERVAL_MS) {}
+
+
+GameController::~GameController()
+{
+	mSearchInfoDispatcher.stop();
+	mCPUPlayer.cancelCalculation();
+}
 
 
 bool GameController::initializeGame(GameConfiguration config)
@@ -73,6 +80,7 @@ bool GameController::initializeGame(GameConfiguration config)
 
 void GameController::resetGame()
 {
+	mCPUPlayer.resetPonder();
 	mEngine.resetGame();
 
 	mWhitePlayer.reset();
@@ -255,18 +263,45 @@ bool GameController::isCPUTurn() const
 
 void GameController::requestCPUMoveAsync()
 {
-	mCPUPlayer.calculateMoveAsync(
-		[this](Move move)
-		{
-			if (mOnCPUMove)
-				mOnCPUMove(move);
-		});
+	mCPUPlayer.calculateMoveAsync([this](Move move) { onCPUMoveReady(move); });
+	mSearchInfoDispatcher.onSearchStarted();
 }
 
 
 void GameController::cancelCPUCalculation()
 {
-	// TODO
+	mCPUPlayer.cancelCalculation();
+}
+
+
+void GameController::startCPUPonder()
+{
+	if (mConfig.mode != GameModeSelection::SinglePlayer || isCPUTurn())
+		return;
+
+	if (mCPUPlayer.startPondering())
+		mSearchInfoDispatcher.onSearchStarted();
+}
+
+
+bool GameController::tryCPUPonderHit(Move opponentMove)
+{
+	if (!isCPUTurn())
+		return false;
+
+	return mCPUPlayer.ponderHit(opponentMove, [this](Move move) { onCPUMoveReady(move); });
+}
+
+
+void GameController::stopCPUPonder()
+{
+	mCPUPlayer.stopPondering();
+}
+
+
+void GameController::resetCPUPonder()
+{
+	mCPUPlayer.resetPonder();
 }
 
 
@@ -276,6 +311,21 @@ void GameController::setCPUMoveCallback(std::function<void(Move)> callback)
 }
 
 
+void GameController::setSearchInfoCallback(std::function<void(const SearchInfo &)> callback)
+{
+	mSearchInfoDispatcher.stop();
+	mSearchInfoDispatcher.setCallback(std::move(callback));
+	mSearchInfoDispatcher.start();
+}
+
+
+void GameController::onCPUMoveReady(Move move)
+{
+	if (mOnCPUMove)
+		mOnCPUMove(move);
+}
+
+
 void GameController::ensureCacheValid() const
 {
 	if (!mCacheValid)
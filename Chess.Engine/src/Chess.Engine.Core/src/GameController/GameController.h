@@ -10,6 +10,7 @@
 #include "IGameController.h"
 #include "GameEngine.h"
 #include "CPUPlayer.h"
+#include "SearchInfoDispatcher.h"
 #include "GameConfiguration.h"
 #include "Player.h"
 
@@ -18,7 +19,7 @@ class GameController : public IGameController
 {
 public:
 	GameController();
-	~GameController() override = default;
+	~GameController() override;
 
 	//=========================================================================
 	// Game Lifecycle
@@ -64,6 +65,15 @@ public:
 	void								 requestCPUMoveAsync() override;
 	void								 cancelCPUCalculation();
 
+	//=========================================================================
+	// CPU Pondering
+	//=========================================================================
+
+	void								 startCPUPonder() override;
+	bool								 tryCPUPonderHit(Move opponentMove) override;
+	void								 stopCPUPonder() override;
+	void								 resetCPUPonder() override;
+
 	//=========================================================================
 	// Accessors (for UI board state queries)
 	//=========================================================================
@@ -76,9 +86,18 @@ public:
 
 	void								 setCPUMoveCallback(std::function<void(Move)> callback);
 
+	/**
+	 * @brief	Receive search progress of the CPU player (depth, score, nodes, PV).
+	 *			Called on the dispatcher thread, never on the search thread.
+	 */
+	void								 setSearchInfoCallback(std::function<void(const SearchInfo &)> callback);
+
 private:
+	static constexpr unsigned long SEARCH_INFO_INTERVAL_MS = 100;
+
 	GameEngine				  mEngine;
 	CPUPlayer				  mCPUPlayer;
+	SearchInfoDispatcher	  mSearchInfoDispatcher; // declared after mCPUPlayer: stops before the channel goes away
 
 	Side					  mLocalPlayer{Side::White};
 	GameConfiguration		  mConfig{};
@@ -96,4 +115,5 @@ private:
 
 	void					  invalidateCache() { mCacheValid = false; }
 	void					  ensureCacheValid() const;
+	void					  onCPUMoveReady(Move move);
 };
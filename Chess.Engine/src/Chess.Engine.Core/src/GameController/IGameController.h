@@ -58,4 +58,13 @@ public:
 
 	virtual bool				isCPUTurn() const															  = 0;
 	virtual void				requestCPUMoveAsync()														  = 0;
+
+	//=========================================================================
+	// CPU Pondering
+	//=========================================================================
+
+	virtual void				startCPUPonder()															  = 0;
+	virtual bool				tryCPUPonderHit(Move opponentMove)											  = 0;
+	virtual void				stopCPUPonder()																  = 0;
+	virtual void				resetCPUPonder()															  = 0;
 };
@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+	Module:         SearchInfoDispatcher
+	Description:    Forwards search info of the CPU player to the UI
+  ==============================================================================
+*/
+
+#include "SearchInfoDispatcher.h"
+
+
+SearchInfoDispatcher::SearchInfoDispatcher(SearchInfoChannel &channel, unsigned long intervalMs) : mChannel(channel), mIntervalMs(intervalMs) {}
+
+
+SearchInfoDispatcher::~SearchInfoDispatcher()
+{
+	stop();
+}
+
+
+void SearchInfoDispatcher::run()
+{
+	while (isRunning())
+	{
+		// Sleep until a search is requested
+		if (!waitForEvent())
+			continue;
+
+		while (isRunning() && mChannel.isActive())
+		{
+			waitForEvent(mIntervalMs);
+			deliverLatest();
+		}
+
+		// The final report may have been published right before the search went inactive
+		deliverLatest();
+	}
+}
+
+
+void SearchInfoDispatcher::deliverLatest()
+{
+	SearchInfo info;
+
+	if (mChannel.tryRead(info, mLastSequence) && mCallback)
+		mCallback(info);
+}
@@ -0,0 +1,54 @@
+/*
+  ==============================================================================
+	Module:         SearchInfoDispatcher
+	Description:    Forwards search info of the CPU player to the UI
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <functional>
+
+#include "ThreadBase.h"
+#include "SearchInfo.h"
+
+
+/**
+ * @brief	Polls the CPU player's search info channel while a search is running and
+ *			hands new values to the UI callback on its own thread.
+ *
+ * The search thread only writes to the lock-free channel. All UI delivery (which may
+ * lock and call into managed code) happens here, so the search never waits on the UI.
+ * Values published faster than the polling interval are coalesced to the newest one.
+ */
+class SearchInfoDispatcher : public ThreadBase
+{
+public:
+	using Callback = std::function<void(const SearchInfo &)>;
+
+	SearchInfoDispatcher(SearchInfoChannel &channel, unsigned long intervalMs);
+	~SearchInfoDispatcher() override;
+
+	/**
+	 * @brief	Set the receiver. Must be called before start().
+	 */
+	void setCallback(Callback callback) { mCallback = std::move(callback); }
+
+	/**
+	 * @brief	Wake the dispatcher after a search has been requested.
+	 */
+	void onSearchStarted() { triggerEvent(); }
+
+
+protected:
+	void run() override;
+
+
+private:
+	void			   deliverLatest();
+
+	SearchInfoChannel &mChannel;
+	Callback		   mCallback;
+	unsigned long	   mIntervalMs;
+	uint64_t		   mLastSequence{0};
+};
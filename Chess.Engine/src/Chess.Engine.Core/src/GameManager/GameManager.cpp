@@ -264,6 +264,9 @@ void GameManager::wireComponents()
 	// CPU moves flow back through StateMachine
 	mGameController->setCPUMoveCallback([this](Move move) { mStateMachine->onCPUMoveCalculated(move); });
 
+	// CPU search progress goes straight to the UI (delivered off the search thread)
+	mGameController->setSearchInfoCallback([this](const SearchInfo &info) { mInputSource->onSearchInfo(info); });
+
 	mStateMachine->start();
 }
 
@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+	Module:         MappedFile
+	Description:    Read-only memory mapping of a file
+  ==============================================================================
+*/
+
+#include "MappedFile.h"
+
+#include <filesystem>
+#include <utility>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "Logging.h"
+
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept
+{
+	if (this == &other)
+		return *this;
+
+	close();
+
+	mData = std::exchange(other.mData, nullptr);
+	mSize = std::exchange(other.mSize, 0);
+	mOpen = std::exchange(other.mOpen, false);
+
+#ifdef _WIN32
+	mFile	 = std::exchange(other.mFile, nullptr);
+	mMapping = std::exchange(other.mMapping, nullptr);
+#else
+	mDescriptor = std::exchange(other.mDescriptor, -1);
+#endif
+
+	return *this;
+}
+
+
+#ifdef _WIN32
+
+bool MappedFile::open(const std::string &path)
+{
+	close();
+
+	HANDLE file = CreateFileW(std::filesystem::path(path).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		LOG_ERROR("Could not open {} for mapping (error {})", path, GetLastError());
+		return false;
+	}
+
+	LARGE_INTEGER size{};
+
+	if (!GetFileSizeEx(file, &size))
+	{
+		LOG_ERROR("Could not read the size of {} (error {})", path, GetLastError());
+		CloseHandle(file);
+		return false;
+	}
+
+	mFile = file;
+	mOpen = true;
+
+	// Empty files can't be mapped
+	if (size.QuadPart == 0)
+		return true;
+
+	HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	void  *view	   = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+
+	if (!view)
+	{
+		LOG_ERROR("Could not map {} (error {})", path, GetLastError());
+
+		if (mapping)
+			CloseHandle(mapping);
+
+		close();
+		return false;
+	}
+
+	mMapping = mapping;
+	mData	 = static_cast<const char *>(view);
+	mSize	 = static_cast<size_t>(size.QuadPart);
+	return true;
+}
+
+
+void MappedFile::close()
+{
+	if (mData)
+		UnmapViewOfFile(mData);
+
+	if (mMapping)
+		CloseHandle(mMapping);
+
+	if (mFile)
+		CloseHandle(mFile);
+
+	mData	 = nullptr;
+	mSize	 = 0;
+	mOpen	 = false;
+	mMapping = nullptr;
+	mFile	 = nullptr;
+}
+
+#else
+
+bool MappedFile::open(const std::string &path)
+{
+	close();
+
+	int descriptor = ::open(path.c_str(), O_RDONLY);
+
+	if (descriptor < 0)
+	{
+		LOG_ERROR("Could not open {} for mapping", path);
+		return false;
+	}
+
+	struct stat status{};
+
+	if (fstat(descriptor, &status) != 0)
+	{
+		LOG_ERROR("Could not read the size of {}", path);
+		::close(descriptor);
+		return false;
+	}
+
+	mDescriptor = descriptor;
+	mOpen		= true;
+
+	// Empty files can't be mapped
+	if (status.st_size == 0)
+		return true;
+
+	void *view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_PRIVATE, descriptor, 0);
+
+	if (view == MAP_FAILED)
+	{
+		LOG_ERROR("Could not map {}", path);
+		close();
+		return false;
+	}
+
+	mData = static_cast<const char *>(view);
+	mSize = static_cast<size_t>(status.st_size);
+	return true;
+}
+
+
+void MappedFile::close()
+{
+	if (mData)
+		munmap(const_cast<char *>(mData), mSize);
+
+	if (mDescriptor >= 0)
+		::close(mDescriptor);
+
+	mData		= nullptr;
+	mSize		= 0;
+	mOpen		= false;
+	mDescriptor = -1;
+}
+
+#endif
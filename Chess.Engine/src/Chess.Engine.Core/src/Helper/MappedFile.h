@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+	Module:         MappedFile
+	Description:    Read-only memory mapping of a file
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+
+/**
+ * @brief	Maps a whole file read-only into the address space. The pages are loaded on first access
+ *			and shared with the OS file cache, so large files are neither copied nor read up front.
+ */
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	~MappedFile() { close(); }
+
+	MappedFile(const MappedFile &)			  = delete;
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	MappedFile(MappedFile &&other) noexcept { *this = std::move(other); }
+	MappedFile &operator=(MappedFile &&other) noexcept;
+
+	/**
+	 * @brief	Map the file, replacing any file mapped before. An empty file opens with size 0.
+	 * @return	false (logged) if the file can't be opened or mapped.
+	 */
+	bool		open(const std::string &path);
+
+	void		close();
+
+	[[nodiscard]] bool				isOpen() const { return mOpen; }
+	[[nodiscard]] const char	   *data() const { return mData; }
+	[[nodiscard]] size_t			size() const { return mSize; }
+	[[nodiscard]] std::string_view	view() const { return {mData, mSize}; }
+
+private:
+	const char *mData = nullptr;
+	size_t		mSize = 0;
+	bool		mOpen = false;
+
+#ifdef _WIN32
+	void	   *mFile	 = nullptr; // HANDLE
+	void	   *mMapping = nullptr; // HANDLE
+#else
+	int			mDescriptor = -1;
+#endif
+};
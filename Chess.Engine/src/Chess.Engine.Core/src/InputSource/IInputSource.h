@@ -10,6 +10,7 @@
 #include "BitboardTypes.h"
 #include "Move.h"
 #include "Parameters.h"
+#include "SearchInfo.h"
 
 
 class StateMachine;
@@ -61,4 +62,10 @@ public:
 	 * @brief	Called when current player changes.
 	 */
 	virtual void onPlayerChanged(Side playersTurn)						   = 0;
+
+	/**
+	 * @brief	Called with progress of the running CPU search (depth, score, nodes, PV).
+	 *			Delivered from the search info dispatcher thread at a bounded rate.
+	 */
+	virtual void onSearchInfo(const SearchInfo &info)					   = 0;
 };
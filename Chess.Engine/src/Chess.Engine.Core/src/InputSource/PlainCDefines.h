@@ -102,6 +102,25 @@ extern "C"
 		char errorMessage[MAX_STRING_LENGTH];
 	} CConnectionEvent;
 
+
+	/**
+	 * @brief	Progress of the CPU search for UI display
+	 */
+	typedef struct
+	{
+		int		 depth;					// Completed search depth
+		int		 selDepth;				// Deepest ply reached including quiescence
+		int		 score;					// Centipawns from the CPU's point of view
+		int		 mateIn;				// Moves to mate (negative if the CPU gets mated), 0 if none
+		uint64_t nodes;
+		uint64_t nps;
+		int		 hashFull;				// Transposition table usage in permille
+		int		 timeMs;
+		int		 pondering;				// 1 while searching on the opponent's time
+		int		 pvLength;
+		char	 pv[MAX_STRING_LENGTH]; // Principal variation in UCI notation, space separated
+	} CSearchInfo;
+
 #ifdef __cplusplus
 }
 #endif
@@ -96,6 +96,34 @@ void WinUIInputSource::onPlayerChanged(Side playersTurn)
 }
 
 
+void WinUIInputSource::onSearchInfo(const SearchInfo &info)
+{
+	CSearchInfo event{};
+	event.depth		= info.depth;
+	event.selDepth	= info.selDepth;
+	event.score		= info.score;
+	event.mateIn	= info.mateIn;
+	event.nodes		= info.nodes;
+	event.nps		= info.nps;
+	event.hashFull	= info.hashFull;
+	event.timeMs	= static_cast<int>(info.timeMs);
+	event.pondering = info.pondering ? 1 : 0;
+	event.pvLength	= info.pvLength;
+
+	std::string pv;
+	for (int i = 0; i < info.pvLength; ++i)
+	{
+		if (i > 0)
+			pv += ' ';
+		pv += MoveNotation::toUCI(info.pv[i]);
+	}
+
+	HRESULT hr = StringCbCopyA(event.pv, MAX_STRING_LENGTH, pv.c_str());
+
+	sendToUI(MessageType::SearchInfo, &event);
+}
+
+
 void WinUIInputSource::onConnectionStateChanged(const ConnectionStatusEvent event)
 {
 	CConnectionEvent tmpEvent = convertToCStyleConnectionStateEvent(event);
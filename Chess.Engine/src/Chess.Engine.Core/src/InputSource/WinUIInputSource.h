@@ -34,6 +34,7 @@ enum class MessageType
 	BoardStateChanged		= 9,
 	PawnPromotion			= 10,
 	LegalMovesCalculated	= 11,
+	SearchInfo				= 12,
 };
 
 
@@ -91,6 +92,7 @@ public:
 	void onGameEnded(EndGameState state, Side winner) override;
 	void onBoardStateChanged() override;
 	void onPlayerChanged(Side playersTurn) override;
+	void onSearchInfo(const SearchInfo &info) override;
 
 	//=========================================================================
 	// IPlayerObserver (scores, captured pieces)
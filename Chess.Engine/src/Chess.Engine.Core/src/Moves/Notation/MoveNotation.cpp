@@ -81,4 +81,93 @@ std::string MoveNotation::toUCI(Move move)
 	}
 
 	return uci;
-}
\ No newline at end of file
+}
+
+
+Move MoveNotation::fromSAN(std::string_view san, const Chessboard &board, const MoveList &legalMoves)
+{
+	while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' || san.back() == '?'))
+		san.remove_suffix(1);
+
+	if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0")
+	{
+		MoveFlag castle = san.size() == 3 ? MoveFlag::KingCastle : MoveFlag::QueenCastle;
+
+		for (Move move : legalMoves)
+		{
+			if (move.flags() == castle)
+				return move;
+		}
+
+		return Move::none();
+	}
+
+	// Moving piece, no letter for pawns
+	char pieceChar = '\0';
+
+	if (!san.empty() && std::string_view("KQRBN").find(san.front()) != std::string_view::npos)
+	{
+		pieceChar = san.front();
+		san.remove_prefix(1);
+	}
+
+	// Promotion piece, "e8=Q" or "e8Q"
+	int promotion = -1;
+
+	if (!san.empty() && std::string_view("NBRQ").find(san.back()) != std::string_view::npos)
+	{
+		promotion = static_cast<int>(std::string_view("NBRQ").find(san.back()));
+		san.remove_suffix(1);
+
+		if (!san.empty() && san.back() == '=')
+			san.remove_suffix(1);
+	}
+
+	if (san.size() < 2)
+		return Move::none();
+
+	char toFile = san[san.size() - 2];
+	char toRank = san[san.size() - 1];
+
+	if (toFile < 'a' || toFile > 'h' || toRank < '1' || toRank > '8')
+		return Move::none();
+
+	san.remove_suffix(2);
+
+	// Whatever is left is the disambiguation and the capture mark
+	char fromFile = '\0';
+	char fromRank = '\0';
+
+	for (char c : san)
+	{
+		if (c >= 'a' && c <= 'h')
+			fromFile = c;
+		else if (c >= '1' && c <= '8')
+			fromRank = c;
+		else if (c != 'x' && c != ':' && c != '-')
+			return Move::none();
+	}
+
+	Move match	 = Move::none();
+	int	 matches = 0;
+
+	for (Move move : legalMoves)
+	{
+		if (move.isCastle() || getFile(move.to()) != toFile || getRank(move.to()) != toRank)
+			continue;
+
+		if (pieceToSANChar(board.pieceAt(move.from())) != pieceChar)
+			continue;
+
+		if ((fromFile && getFile(move.from()) != fromFile) || (fromRank && getRank(move.from()) != fromRank))
+			continue;
+
+		if (move.isPromotion() != (promotion >= 0) || (move.isPromotion() && move.promotionPieceOffset() != promotion))
+			continue;
+
+		match = move;
+		++matches;
+	}
+
+	return matches == 1 ? match : Move::none();
+}
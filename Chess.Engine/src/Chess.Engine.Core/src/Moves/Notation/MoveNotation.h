@@ -8,6 +8,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 
 #include "Move.h"
 #include "BitboardTypes.h"
@@ -29,6 +30,13 @@ public:
 	 */
 	static std::string toUCI(Move move);
 
+	/**
+	 * @brief	Find the legal move written in SAN ("Nbd7", "exd6", "e8=Q+", "O-O"). Check marks and
+	 *			annotations ("+", "#", "!", "?") are ignored, a missing disambiguation is fine as long as one move fits.
+	 * @return	Move::none() if no legal move or more than one fits.
+	 */
+	static Move		   fromSAN(std::string_view san, const Chessboard &board, const MoveList &legalMoves);
+
 
 private:
 	static inline std::string squareToString(Square sq) noexcept
@@ -7,6 +7,8 @@
 
 #include "MoveValidation.h"
 
+#include "Endgame.h"
+
 
 MoveValidation::MoveValidation(Chessboard &board, MoveGeneration &generation, MoveExecution &execution) : mBoard(board), mGeneration(generation), mExecution(execution) {}
 
@@ -129,13 +131,5 @@ Square MoveValidation::getKingSquare(Side side) const
 
 bool MoveValidation::hasInsufficientMaterial() const
 {
-	const auto &pieces = mBoard.pieces();
-
-	// Any pawns, rooks or queens -> sufficient material
-	if (pieces[WPawn] || pieces[BPawn] || pieces[WRook] || pieces[BRook] || pieces[WQueen] || pieces[BQueen])
-		return false;
-
-	// TODO: Check for insufficient material
-
-	return false;
+	return Endgames::isInsufficientMaterial(mBoard);
 }
@@ -0,0 +1,387 @@
+/*
+  ==============================================================================
+	Module:         Perft
+	Description:    Move generation node counting for correctness and throughput checks
+  ==============================================================================
+*/
+
+#include "Perft.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+#include "GameEngine.h"
+#include "Logging.h"
+
+
+namespace
+{
+
+constexpr uint64_t DEPTH_MASK = 0xFF;
+
+
+int resolveThreads(int threads)
+{
+	if (threads > 0)
+		return threads;
+
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+std::string_view trim(std::string_view text)
+{
+	size_t start = text.find_first_not_of(" \t\r\n");
+
+	if (start == std::string_view::npos)
+		return {};
+
+	size_t end = text.find_last_not_of(" \t\r\n");
+	return text.substr(start, end - start + 1);
+}
+
+
+/**
+ * @brief	Leaf nodes below the engine's position. The last ply is bulk counted.
+ */
+uint64_t countNodes(GameEngine &engine, PerftHashTable &hash, int depth, uint64_t &hits)
+{
+	uint64_t key = engine.getBoard().getHash();
+	uint64_t nodes;
+
+	if (depth >= 2 && hash.probe(key, depth, nodes))
+	{
+		++hits;
+		return nodes;
+	}
+
+	MoveList moves;
+	engine.generateLegalMoves(moves);
+
+	if (depth == 1)
+		return moves.size();
+
+	nodes = 0;
+
+	for (size_t i = 0; i < moves.size(); ++i)
+	{
+		if (!engine.makeMoveUnchecked(moves[i]))
+			continue;
+
+		nodes += countNodes(engine, hash, depth - 1, hits);
+		engine.undoMoveUnchecked();
+	}
+
+	hash.store(key, depth, nodes);
+	return nodes;
+}
+
+} // namespace
+
+
+//=========================================================================
+// Hash table
+//=========================================================================
+
+PerftHashTable::PerftHashTable(size_t megabytes)
+{
+	size_t entries = megabytes * 1024 * 1024 / sizeof(Entry);
+
+	if (entries == 0)
+		return;
+
+	// Largest power of two that fits
+	size_t size = 1;
+	while (size * 2 <= entries)
+		size *= 2;
+
+	mEntries = std::vector<Entry>(size);
+	mMask	 = size - 1;
+}
+
+
+bool PerftHashTable::probe(uint64_t hash, int depth, uint64_t &nodes) const
+{
+	if (mEntries.empty())
+		return false;
+
+	const Entry &entry = mEntries[hash & mMask];
+	uint64_t	 data  = entry.data.load(std::memory_order_relaxed);
+	uint64_t	 check = entry.check.load(std::memory_order_relaxed);
+
+	if ((check ^ data) != hash || (data & DEPTH_MASK) != static_cast<uint64_t>(depth))
+		return false;
+
+	nodes = data >> 8;
+	return true;
+}
+
+
+void PerftHashTable::store(uint64_t hash, int depth, uint64_t nodes)
+{
+	if (mEntries.empty())
+		return;
+
+	Entry	&entry = mEntries[hash & mMask];
+	uint64_t data  = nodes << 8 | static_cast<uint64_t>(depth);
+
+	entry.data.store(data, std::memory_order_relaxed);
+	entry.check.store(hash ^ data, std::memory_order_relaxed);
+}
+
+
+void PerftHashTable::clear()
+{
+	for (auto &entry : mEntries)
+	{
+		entry.check.store(0, std::memory_order_relaxed);
+		entry.data.store(0, std::memory_order_relaxed);
+	}
+}
+
+
+//=========================================================================
+// Perft
+//=========================================================================
+
+Perft::Perft(int threads, size_t hashMegabytes) : mThreads(resolveThreads(threads)), mHash(hashMegabytes) {}
+
+
+PerftResult Perft::run(std::string_view fen, int depth)
+{
+	return count(fen, depth, nullptr);
+}
+
+
+PerftResult Perft::divide(std::string_view fen, int depth, std::vector<PerftDivideEntry> &entries)
+{
+	return count(fen, depth, &entries);
+}
+
+
+PerftResult Perft::count(std::string_view fen, int depth, std::vector<PerftDivideEntry> *entries)
+{
+	using Clock = std::chrono::steady_clock;
+
+	auto	   start = Clock::now();
+
+	GameEngine root;
+	root.init();
+
+	PerftResult result;
+
+	if (!root.getBoard().parseFEN(fen))
+	{
+		result.valid = false;
+		return result;
+	}
+
+	MoveList moves;
+	root.generateLegalMoves(moves);
+
+	std::vector<uint64_t> nodes(moves.size(), depth > 1 ? 0 : 1);
+
+	if (depth <= 0)
+	{
+		result.nodes = 1;
+		nodes.clear();
+	}
+	else if (depth == 1)
+	{
+		result.nodes = moves.size();
+	}
+	else
+	{
+		// Root moves are handed out one at a time, so a thread that finishes a small subtree takes the next one
+		std::atomic<size_t>	  next{0};
+		std::atomic<uint64_t> hits{0};
+
+		int					  threads = std::min<int>(mThreads, static_cast<int>(moves.size()));
+
+		auto				  worker  = [&]
+		{
+			GameEngine engine;
+			engine.snapshotFrom(root);
+
+			uint64_t localHits = 0;
+
+			for (size_t i = next.fetch_add(1); i < moves.size(); i = next.fetch_add(1))
+			{
+				if (!engine.makeMoveUnchecked(moves[i]))
+					continue;
+
+				nodes[i] = countNodes(engine, mHash, depth - 1, localHits);
+				engine.undoMoveUnchecked();
+			}
+
+			hits.fetch_add(localHits);
+		};
+
+		std::vector<std::thread> workers;
+
+		for (int t = 1; t < threads; ++t)
+			workers.emplace_back(worker);
+
+		worker();
+
+		for (auto &thread : workers)
+			thread.join();
+
+		for (uint64_t count : nodes)
+			result.nodes += count;
+
+		result.hashHits = hits.load();
+	}
+
+	result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+	if (entries)
+	{
+		entries->clear();
+
+		for (size_t i = 0; i < nodes.size(); ++i)
+			entries->push_back({moves[i], nodes[i]});
+	}
+
+	return result;
+}
+
+
+bool Perft::runSuite(const std::string &path, int maxDepth, std::vector<PerftCheck> &checks, const std::function<void(const PerftCheck &)> &onCheck)
+{
+	std::ifstream file(path);
+
+	if (!file)
+	{
+		LOG_ERROR("Could not open perft suite {}", path);
+		return false;
+	}
+
+	checks.clear();
+
+	std::string							  line;
+	std::string							  fen;
+	std::vector<std::pair<int, uint64_t>> counts;
+	bool								  passed	 = true;
+	int									  lineNumber = 0;
+
+	while (std::getline(file, line))
+	{
+		++lineNumber;
+
+		std::string_view text = trim(line);
+
+		if (text.empty() || text.front() == '#')
+			continue;
+
+		// A mistyped line must not shrink the suite unnoticed
+		if (!parseSuiteLine(line, fen, counts))
+		{
+			LOG_ERROR("Perft suite {} line {} is no perft entry: {}", path, lineNumber, text);
+
+			PerftCheck check;
+			check.fen		   = std::string(text);
+			check.line		   = lineNumber;
+			check.parsed	   = false;
+			check.result.valid = false;
+			passed			   = false;
+
+			if (onCheck)
+				onCheck(check);
+
+			checks.push_back(std::move(check));
+			continue;
+		}
+
+		for (const auto &[depth, expected] : counts)
+		{
+			if (maxDepth > 0 && depth > maxDepth)
+				continue;
+
+			PerftCheck check;
+			check.fen	   = fen;
+			check.line	   = lineNumber;
+			check.depth	   = depth;
+			check.expected = expected;
+			check.result   = run(fen, depth);
+
+			if (!check.result.valid)
+				LOG_ERROR("Perft suite position {} is invalid", fen);
+			else if (!check.passed())
+				LOG_ERROR("Perft mismatch at depth {} of {}: expected {}, counted {}", depth, fen, expected, check.result.nodes);
+
+			passed &= check.passed();
+
+			if (onCheck)
+				onCheck(check);
+
+			bool invalid = !check.result.valid;
+			checks.push_back(std::move(check));
+
+			// The other depths of the line can't be counted either, it is reported once
+			if (invalid)
+				break;
+		}
+	}
+
+	if (checks.empty())
+	{
+		LOG_ERROR("Perft suite {} has no node counts to check", path);
+		return false;
+	}
+
+	return passed;
+}
+
+
+bool Perft::parseSuiteLine(std::string_view line, std::string &fen, std::vector<std::pair<int, uint64_t>> &counts)
+{
+	counts.clear();
+
+	size_t separator = line.find(';');
+
+	if (separator == std::string_view::npos)
+		return false;
+
+	std::string_view position = trim(line.substr(0, separator));
+
+	if (position.empty() || position.front() == '#')
+		return false;
+
+	fen.assign(position);
+
+	while (separator != std::string_view::npos)
+	{
+		size_t			 end   = line.find(';', separator + 1);
+		std::string_view field = trim(line.substr(separator + 1, end == std::string_view::npos ? std::string_view::npos : end - separator - 1));
+		separator			   = end;
+
+		// "D<depth> <nodes>"
+		size_t			 space = field.find(' ');
+
+		if (field.empty() || field.front() != 'D' || space == std::string_view::npos)
+			return false;
+
+		std::string_view depthText = field.substr(1, space - 1);
+		std::string_view nodesText = trim(field.substr(space));
+
+		int				 depth	   = 0;
+		uint64_t		 nodes	   = 0;
+
+		auto			 parsedDepth = std::from_chars(depthText.data(), depthText.data() + depthText.size(), depth);
+		auto			 parsedNodes = std::from_chars(nodesText.data(), nodesText.data() + nodesText.size(), nodes);
+
+		if (parsedDepth.ec != std::errc() || parsedDepth.ptr != depthText.data() + depthText.size() || depth <= 0)
+			return false;
+
+		if (parsedNodes.ec != std::errc() || parsedNodes.ptr != nodesText.data() + nodesText.size())
+			return false;
+
+		counts.emplace_back(depth, nodes);
+	}
+
+	return !counts.empty();
+}
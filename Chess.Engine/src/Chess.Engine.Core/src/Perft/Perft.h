@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+	Module:         Perft
+	Description:    Move generation node counting for correctness and throughput checks
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Move.h"
+
+
+/**
+ * @brief	Shared table of subtree node counts keyed by the Zobrist hash and the depth.
+ *
+ * Every slot holds two words: the node count with the depth in its low byte, and the position hash
+ * XORed with that data word. A slot torn by racing writers fails the verification and reads as a miss,
+ * so the table is shared by all perft threads without a lock.
+ */
+class PerftHashTable
+{
+public:
+	/**
+	 * @param	megabytes	Table size, rounded down to a power of two entries. 0 disables the table.
+	 */
+	explicit PerftHashTable(size_t megabytes);
+
+	/**
+	 * @return	true if the node count of the position at this depth is stored, nodes is only written then.
+	 */
+	bool						   probe(uint64_t hash, int depth, uint64_t &nodes) const;
+
+	void						   store(uint64_t hash, int depth, uint64_t nodes);
+
+	void						   clear();
+
+	[[nodiscard]] bool			   enabled() const { return !mEntries.empty(); }
+	[[nodiscard]] size_t		   size() const { return mEntries.size(); }
+
+private:
+	struct Entry
+	{
+		std::atomic<uint64_t> check{0}; // hash ^ data
+		std::atomic<uint64_t> data{0};	// nodes << 8 | depth
+	};
+
+	std::vector<Entry> mEntries;
+	uint64_t		   mMask = 0;
+};
+
+
+struct PerftResult
+{
+	uint64_t nodes	 = 0;
+	uint64_t hashHits = 0;
+	double	 seconds = 0.0;
+	bool	 valid	 = true; // false if the FEN was rejected, nothing was counted
+
+	double	 nodesPerSecond() const { return seconds > 0.0 ? static_cast<double>(nodes) / seconds : 0.0; }
+};
+
+
+/**
+ * @brief	Node count below one root move.
+ */
+struct PerftDivideEntry
+{
+	Move	 move;
+	uint64_t nodes = 0;
+};
+
+
+/**
+ * @brief	One expected count of a perft suite, with the count that was found.
+ */
+struct PerftCheck
+{
+	std::string fen;			 // The whole line if it couldn't be parsed
+	int			line	 = 0;	 // Line of the suite file, from 1
+	int			depth	 = 0;
+	uint64_t	expected = 0;
+	bool		parsed	 = true; // false for a line that is no "<fen> ;D<depth> <nodes> ..." entry (nothing was counted)
+	PerftResult result;
+
+	bool		passed() const { return parsed && result.valid && result.nodes == expected; }
+};
+
+
+/**
+ * @brief	Counts the leaf nodes of the legal move tree to a fixed depth.
+ *
+ * The last ply is bulk counted (the size of the legal move list instead of making each move),
+ * interior subtrees are cached in a shared PerftHashTable, and the root moves are split across
+ * worker threads that each run on their own copy of the position.
+ */
+class Perft
+{
+public:
+	/**
+	 * @param	threads			Worker threads, 0 for all cores.
+	 * @param	hashMegabytes	Size of the node count cache, 0 to disable it.
+	 */
+	explicit Perft(int threads = 0, size_t hashMegabytes = 64);
+
+	/**
+	 * @brief	Number of leaf nodes of the position at the depth.
+	 *			An unreadable or illegal FEN gives a result that is not valid.
+	 */
+	PerftResult					 run(std::string_view fen, int depth);
+
+	/**
+	 * @brief	Like run(), with the node count of every root move (in move generation order).
+	 */
+	PerftResult					 divide(std::string_view fen, int depth, std::vector<PerftDivideEntry> &entries);
+
+	/**
+	 * @brief	Run an EPD perft suite, one position per line: "<fen> ;D1 <nodes> ;D2 <nodes> ...".
+	 *			Blank lines and lines starting with '#' are skipped. Mismatching counts, invalid positions
+	 *			and lines that can't be parsed are logged as errors and reported as failed checks.
+	 * @param	maxDepth	Skip the expected counts deeper than this, 0 for all.
+	 * @param	onCheck		Called after every checked count (optional).
+	 * @return	false if the file can't be read, has no counts, a malformed line, an invalid position, or any count mismatches.
+	 */
+	bool						 runSuite(const std::string &path, int maxDepth, std::vector<PerftCheck> &checks, const std::function<void(const PerftCheck &)> &onCheck = nullptr);
+
+	/**
+	 * @brief	Split an EPD suite line into its FEN and (depth, nodes) pairs.
+	 */
+	[[nodiscard]] static bool	 parseSuiteLine(std::string_view line, std::string &fen, std::vector<std::pair<int, uint64_t>> &counts);
+
+	void						 clearHash() { mHash.clear(); }
+
+	[[nodiscard]] int			 getThreadCount() const { return mThreads; }
+
+private:
+	PerftResult					 count(std::string_view fen, int depth, std::vector<PerftDivideEntry> *entries);
+
+	int							 mThreads = 1;
+	PerftHashTable				 mHash;
+};
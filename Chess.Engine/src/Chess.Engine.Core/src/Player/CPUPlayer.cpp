@@ -10,8 +10,32 @@
 constexpr int INF				  = std::numeric_limits<int>::max();
 constexpr int NEG_INF			  = std::numeric_limits<int>::min() + 1;
 constexpr int MAX_QUIESENCE_DEPTH = 8;
+constexpr int MATE_THRESHOLD	  = INF - SearchWorker::MAX_PLY;
+constexpr int PROGRESS_NODE_MASK  = 2047;  // check the info interval every 2048 nodes
+constexpr int SKILL_LINES		  = 4;	   // candidates scored exactly for the skill error model
+constexpr int SKILL_ERROR_STEP	  = 20;	   // centipawns of maximum error per skill level below the maximum
+constexpr int LIMITED_MAX_DEPTH	  = 32;	   // iterative deepening cap of budgeted levels
+constexpr int TABLEBASE_WIN		  = 20000; // above every evaluation (known endgame wins start at 10000), below mate scores
+constexpr int TABLEBASE_DEPTH	  = 6;	   // extra depth of stored table results, they are exact whatever the depth
+constexpr int FIFTY_MOVE_PLIES	  = 100;
 
-CPUPlayer::CPUPlayer(GameEngine &engine) : mEngine(engine), mRandomGenerator(mRandomDevice()) {}
+
+static int mateDistance(int score)
+{
+	if (score >= MATE_THRESHOLD)
+		return (INF - score + 1) / 2;
+
+	if (score <= -MATE_THRESHOLD)
+		return -((score - NEG_INF) / 2);
+
+	return 0;
+}
+
+
+CPUPlayer::CPUPlayer(GameEngine &engine)
+	: mEngine(engine), mRandomGenerator(mRandomDevice()), mWorker([this](std::stop_token stopToken) { runSearchTask(stopToken); })
+{
+}
 
 
 CPUPlayer::~CPUPlayer()
@@ -22,13 +46,39 @@ CPUPlayer::~CPUPlayer()
 
 void CPUPlayer::configure(const CPUConfiguration &config)
 {
-	mConfig = config;
+	cancelCalculation();
+
+	mConfig		= config;
+	mPonderMove = Move();
+	mRandomGenerator.seed(config.seed != 0 ? config.seed : mRandomDevice());
+
+	StrengthLevel strength = getStrengthLevel();
 	LOG_INFO("CPU player configured:");
 	LOG_INFO("\tDifficulty:\t{}", static_cast<int>(config.difficulty));
+	LOG_INFO("\tStrength:\tskill {}, {} nodes, {} ms, depth {}", strength.skill, strength.nodeLimit, strength.moveTimeMs, strength.maxDepth);
 	LOG_INFO("\tPlayer:\t{}", LoggingHelper::sideToString(config.cpuColor).c_str());
 	LOG_INFO("\tEnabled:\t{}", LoggingHelper::boolToString(config.enabled).c_str());
 
+	mTranspositionTable.setCapacity(config.hashMegabytes > 0 ? TranspositionTable::capacityForMegabytes(config.hashMegabytes) : TranspositionTable::DEFAULT_CAPACITY);
 	clearTranspositionTable();
+
+	if (config.openingBook != mBookPath)
+	{
+		mBook.close();
+		mBookPath = config.openingBook;
+
+		if (!mBookPath.empty() && !mBook.open(mBookPath))
+			LOG_WARNING("Opening book {} not available, the CPU searches every move", mBookPath);
+	}
+
+	if (config.tablebasePath != mTablebasePath)
+	{
+		mTablebase.close();
+		mTablebasePath = config.tablebasePath;
+
+		if (!mTablebasePath.empty() && !mTablebase.open(mTablebasePath))
+			LOG_WARNING("Endgame tables in {} not available, the CPU searches endgames without them", mTablebasePath);
+	}
 }
 
 
@@ -36,35 +86,182 @@ void CPUPlayer::calculateMoveAsync(std::function<void(Move)> callback)
 {
 	cancelCalculation();
 
-	mIsCalculating.store(true);
+	{
+		std::lock_guard<std::mutex> lock(mPonderMutex);
+		mCallback = std::move(callback);
+	}
 
-	mSearchThread = std::jthread(
-		[this, callback](std::stop_token stopToken)
-		{
-			Move bestMove = computeBestMove(stopToken);
-			mIsCalculating.store(false);
+	// Snapshot here while the worker is parked, the worker only has to start searching
+	mSearchEngine.snapshotFrom(mEngine);
+	mFinishRequested.store(false);
 
-			if (!stopToken.stop_requested() && callback)
-				callback(bestMove);
-		});
+	mIsCalculating.store(true);
+	mSearchInfo.setActive(true);
+	mWorker.post();
 }
 
 
 Move CPUPlayer::calculateMove()
 {
+	cancelCalculation();
+	mFinishRequested.store(false);
+
 	std::stop_source stopSource;
 	return computeBestMove(stopSource.get_token());
 }
 
 
+std::vector<SearchLine> CPUPlayer::analyzePosition(size_t lineCount)
+{
+	cancelCalculation();
+
+	mSearchEngine.snapshotFrom(mEngine);
+	mFinishRequested.store(false);
+
+	std::stop_source stopSource;
+	searchCurrentPosition(stopSource.get_token(), std::max<size_t>(lineCount, 1));
+
+	return getSearchLines();
+}
+
+
+std::vector<SearchLine> CPUPlayer::getSearchLines() const
+{
+	std::lock_guard<std::mutex> lock(mLinesMutex);
+	return mLines;
+}
+
+
 void CPUPlayer::cancelCalculation()
 {
-	if (mSearchThread.joinable())
+	mWorker.cancel();
+	mIsCalculating.store(false);
+	mSearchInfo.setActive(false);
+
+	std::lock_guard<std::mutex> lock(mPonderMutex);
+	mIsPondering.store(false);
+	mPonderFinished = false;
+	mCallback		= nullptr;
+}
+
+
+bool CPUPlayer::startPondering()
+{
+	if (!mConfig.enabled || !getStrengthLevel().ponder)
+		return false;
+
+	if (mIsPondering.load())
+		return true;
+
+	cancelCalculation();
+
+	Move expectedReply = mPonderMove;
+
+	if (!expectedReply.isValid())
+		return false;
+
+	// Snapshot the position after the CPU's move and play the expected reply on it
+	mSearchEngine.snapshotFrom(mEngine);
+
+	MoveList legalMoves;
+	mSearchEngine.generateLegalMoves(legalMoves);
+
+	if (std::find(legalMoves.begin(), legalMoves.end(), expectedReply) == legalMoves.end() || !mSearchEngine.makeMoveUnchecked(expectedReply))
 	{
-		mSearchThread.request_stop();
-		mSearchThread.join();
+		LOG_DEBUG("Ponder move {} is not playable, skipping ponder search", MoveNotation::toUCI(expectedReply));
+		return false;
 	}
-	mIsCalculating.store(false);
+
+	{
+		std::lock_guard<std::mutex> lock(mPonderMutex);
+		mPonderedMove	= expectedReply;
+		mPonderHash		= mSearchEngine.getHash();
+		mPonderFinished = false;
+		mPonderStart	= std::chrono::steady_clock::now();
+		mIsPondering.store(true);
+		++mPonderStats.started;
+	}
+
+	LOG_INFO("CPU pondering on expected reply {}", MoveNotation::toUCI(expectedReply));
+
+	mFinishRequested.store(false);
+	mIsCalculating.store(true);
+	mSearchInfo.setActive(true);
+	mWorker.post();
+
+	return true;
+}
+
+
+bool CPUPlayer::ponderHit(Move opponentMove, std::function<void(Move)> callback)
+{
+	if (!mIsPondering.load())
+		return false;
+
+	if (opponentMove != mPonderedMove || mEngine.getHash() != mPonderHash)
+	{
+		{
+			std::lock_guard<std::mutex> lock(mPonderMutex);
+			++mPonderStats.misses;
+		}
+
+		LOG_INFO("Ponder miss: expected {}, got {}", MoveNotation::toUCI(mPonderedMove), MoveNotation::toUCI(opponentMove));
+		cancelCalculation(); // keeps the warmed transposition table
+		return false;
+	}
+
+	bool finished = false;
+	Move result{};
+
+	{
+		std::lock_guard<std::mutex> lock(mPonderMutex);
+
+		double ponderMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - mPonderStart).count();
+
+		++mPonderStats.hits;
+		mPonderStats.searchedMs += ponderMs;
+
+		mIsPondering.store(false);
+		finished = mPonderFinished;
+		result	 = mPonderResult;
+
+		if (finished)
+			++mPonderStats.instantReplies;
+		else
+			mCallback = callback; // the running search is now the real search
+
+		LOG_INFO("Ponder hit ({} of {} predictions, {:.1f} ms already searched{})", mPonderStats.hits, mPonderStats.hits + mPonderStats.misses, ponderMs,
+				 finished ? ", replying instantly" : "");
+	}
+
+	if (finished && callback)
+		callback(result);
+
+	return true;
+}
+
+
+void CPUPlayer::stopPondering()
+{
+	if (!mIsPondering.load())
+		return;
+
+	LOG_DEBUG("Ponder search stopped");
+	cancelCalculation();
+}
+
+
+void CPUPlayer::resetPonder()
+{
+	cancelCalculation();
+	mPonderMove = Move();
+}
+
+
+PonderStatistics CPUPlayer::getPonderStatistics() const
+{
+	std::lock_guard<std::mutex> lock(mPonderMutex);
+	return mPonderStats;
 }
 
 
@@ -73,9 +270,197 @@ Move CPUPlayer::computeBestMove(std::stop_token stopToken)
 	// Snapshot the board so the search operates on an independent copy
 	mSearchEngine.snapshotFrom(mEngine);
 
+	Move bookMove = probeBook();
+
+	if (bookMove.isValid())
+		return bookMove;
+
+	return searchCurrentPosition(stopToken, getLineCount());
+}
+
+
+Move CPUPlayer::probeBook()
+{
+	if (!mBook.isOpen())
+		return Move::none();
+
 	MoveList legalMoves;
 	mSearchEngine.generateLegalMoves(legalMoves);
 
+	Move move = mBook.probe(mSearchEngine.getBoard(), legalMoves, mConfig.enableRandomization ? &mRandomGenerator : nullptr);
+
+	if (!move.isValid())
+		return Move::none();
+
+	LOG_INFO("CPU plays book move {}", MoveNotation::toUCI(move));
+
+	// No search ran, so there are no lines, nodes or expected reply to report
+	{
+		std::lock_guard<std::mutex> lock(mLinesMutex);
+		mLines.clear();
+	}
+
+	mNodesSearched = 0;
+	mPonderMove	   = Move();
+	return move;
+}
+
+
+bool CPUPlayer::filterTablebaseMoves(MoveList &moves)
+{
+	Chessboard &board = mSearchEngine.getBoard();
+
+	if (Tablebase::pieceCount(board) > mTablebase.maxPieces())
+		return false;
+
+	struct RankedMove
+	{
+		Move move;
+		Wdl	 wdl;
+		int	 dtz; // Plies to zeroing counted from the root
+	};
+
+	std::vector<RankedMove> ranked;
+	ranked.reserve(moves.size());
+
+	for (Move move : moves)
+	{
+		PieceType piece	  = board.pieceAt(move.from());
+		bool	  zeroing = move.isCapture() || piece == PieceType::WPawn || piece == PieceType::BPawn;
+
+		if (!mSearchEngine.makeMoveUnchecked(move))
+			continue;
+
+		Wdl	 reply = Wdl::Draw;
+		int	 dtz   = 0;
+		bool found = mTablebase.probeDTZ(mSearchEngine, reply, dtz);
+		mSearchEngine.undoMoveUnchecked();
+
+		if (!found)
+			return false;
+
+		ranked.push_back({move, static_cast<Wdl>(-static_cast<int>(reply)), zeroing ? 1 : dtz + 1});
+	}
+
+	if (ranked.empty())
+		return false;
+
+	Wdl best = std::max_element(ranked.begin(), ranked.end(), [](const RankedMove &a, const RankedMove &b) { return a.wdl < b.wdl; })->wdl;
+
+	// A win that needs more plies to zeroing than the 50 move rule leaves is none, prefer the ones that fit
+	int clock = board.getHalfMoveClock();
+	int limit = std::numeric_limits<int>::max();
+
+	if (best > Wdl::Draw)
+	{
+		int fastest = std::numeric_limits<int>::max();
+
+		for (const RankedMove &entry : ranked)
+		{
+			if (entry.wdl == best)
+				fastest = std::min(fastest, entry.dtz);
+		}
+
+		limit = clock + fastest <= FIFTY_MOVE_PLIES ? FIFTY_MOVE_PLIES - clock : fastest;
+	}
+
+	int longest = 0;
+
+	for (const RankedMove &entry : ranked)
+	{
+		if (entry.wdl == best)
+			longest = std::max(longest, entry.dtz);
+	}
+
+	MoveList kept;
+
+	for (const RankedMove &entry : ranked)
+	{
+		if (entry.wdl != best)
+			continue;
+
+		if ((best > Wdl::Draw && entry.dtz > limit) || (best < Wdl::Draw && entry.dtz < longest))
+			continue;
+
+		kept.push(entry.move);
+	}
+
+	LOG_INFO("Endgame tables: {} of {} moves keep the {}", kept.size(), moves.size(), best > Wdl::Draw ? "win" : best == Wdl::Draw ? "draw" : "longest resistance");
+
+	moves = kept;
+	return true;
+}
+
+
+bool CPUPlayer::probeTablebase(int depth, int &alpha, int &beta, int ply, int &score)
+{
+	const Chessboard &board	 = mSearchEngine.getBoard();
+	int				  pieces = Tablebase::pieceCount(board);
+
+	// The tables judge the 50 move rule from a fresh clock, so only positions right after a capture or pawn move are probed.
+	// Cursed wins and blessed losses are draws then.
+	if (pieces > mTablebase.maxPieces() || (pieces == mTablebase.maxPieces() && depth < mConfig.tablebaseProbeDepth) || board.getHalfMoveClock() != 0)
+		return false;
+
+	Wdl wdl = Wdl::Draw;
+
+	if (!mTablebase.probeWDL(mSearchEngine, wdl))
+		return false;
+
+	++mTablebaseHits;
+
+	int							 value = wdl == Wdl::Win ? TABLEBASE_WIN - ply : wdl == Wdl::Loss ? -TABLEBASE_WIN + ply : 0;
+	TranspositionEntry::NodeType type  = wdl == Wdl::Win	? TranspositionEntry::NodeType::LowerBound
+										 : wdl == Wdl::Loss ? TranspositionEntry::NodeType::UpperBound
+															: TranspositionEntry::NodeType::Exact;
+
+	// A win is worth at least the table score (a mate can still be better), a loss at most.
+	// If that doesn't decide the window, it still narrows it for the search below.
+	if (type == TranspositionEntry::NodeType::LowerBound && value < beta)
+	{
+		alpha = std::max(alpha, value);
+		return false;
+	}
+
+	if (type == TranspositionEntry::NodeType::UpperBound && value > alpha)
+	{
+		beta = std::min(beta, value);
+		return false;
+	}
+
+	mTranspositionTable.store(mSearchEngine.getHash(), std::min(depth + TABLEBASE_DEPTH, SearchWorker::MAX_PLY - 1), value, type, Move());
+	score = value;
+	return true;
+}
+
+
+void CPUPlayer::runSearchTask(std::stop_token stopToken)
+{
+	Move bestMove = probeBook();
+
+	if (!bestMove.isValid())
+		bestMove = searchCurrentPosition(stopToken, getLineCount());
+
+	mSearchInfo.setActive(false);
+
+	onSearchFinished(bestMove, stopToken);
+}
+
+
+Move CPUPlayer::searchCurrentPosition(std::stop_token stopToken, size_t lineCount)
+{
+	mWorker.markFirstNode();
+
+	MoveList legalMoves;
+	mSearchEngine.generateLegalMoves(legalMoves);
+
+	mPonderMove = Move();
+
+	{
+		std::lock_guard<std::mutex> lock(mLinesMutex);
+		mLines.clear();
+	}
+
 	if (legalMoves.size() == 0)
 	{
 		LOG_WARNING("CPU has no legal moves");
@@ -85,67 +470,212 @@ Move CPUPlayer::computeBestMove(std::stop_token stopToken)
 	if (legalMoves.size() == 1)
 	{
 		LOG_INFO("CPU has only one legal move.");
+
+		SearchLine onlyLine;
+		onlyLine.move	  = legalMoves[0];
+		onlyLine.pv[0]	  = legalMoves[0];
+		onlyLine.pvLength = 1;
+
+		{
+			std::lock_guard<std::mutex> lock(mLinesMutex);
+			mLines.push_back(onlyLine);
+		}
+
+		mPonderMove = extractPonderMove(legalMoves[0]);
 		return legalMoves[0];
 	}
 
+	mStrength		   = getStrengthLevel();
+	mLimitReached	   = false;
 	mNodesSearched	   = 0;
 	mTranspositionHits = 0;
+	mSelDepth		   = 0;
+	mEvalCache.resetStatistics();
+	Evaluation::resetLazyStatistics();
+	mSearchStart	   = std::chrono::steady_clock::now();
+	mLastInfoTime	   = mSearchStart;
+	mLastInfo		   = SearchInfo();
 	mMoveEvaluation.clearSearchState();
 
+	// A seeded (reproducible) search must not depend on what earlier searches left in the table,
+	// games and UCI keep it warm from move to move
+	if (mConfig.seed != 0)
+		clearTranspositionTable();
+
+	mTranspositionTable.newSearch();
+
+	mTablebaseHits	   = 0;
+
+	if (mTablebase.isOpen())
+		filterTablebaseMoves(legalMoves);
+
 	Move bestMove;
-	bestMove = searchAlphaBeta(legalMoves, getSearchDepth(), stopToken);
+	bestMove = searchAlphaBeta(legalMoves, mStrength.maxDepth, std::min(lineCount, legalMoves.size()), stopToken);
+
+	mLazyEvalExits = Evaluation::getLazyExits();
 
-	LOG_INFO("CPU searched {} nodes, {} TranspositionHits", mNodesSearched, mTranspositionHits);
+	LOG_INFO("CPU searched {} nodes, {} TranspositionHits, eval cache hit rate {:.1f}%, {} lazy eval exits (depth {}, seldepth {}, {} nps{})", mNodesSearched,
+			 mTranspositionHits, mEvalCache.hitRate() * 100.0, mLazyEvalExits, mLastInfo.depth, mLastInfo.selDepth, mLastInfo.nps, mLimitReached ? ", budget spent" : "");
+
+	if (!stopToken.stop_requested())
+		mPonderMove = extractPonderMove(bestMove);
 
 	return bestMove;
 }
 
 
-Move CPUPlayer::searchAlphaBeta(const MoveList &moves, int depth, std::stop_token stopToken)
+void CPUPlayer::onSearchFinished(Move bestMove, std::stop_token stopToken)
 {
-	std::vector<ScoredMove> scoredMoves;
-	scoredMoves.reserve(moves.size());
+	std::function<void(Move)> callback;
+
+	{
+		std::lock_guard<std::mutex> lock(mPonderMutex);
+		mIsCalculating.store(false);
+
+		if (stopToken.stop_requested())
+			return;
+
+		if (mIsPondering.load())
+		{
+			// Opponent has not moved yet - park the result until ponderHit()
+			mPonderResult	= bestMove;
+			mPonderFinished = true;
+			return;
+		}
+
+		callback = std::move(mCallback);
+		mCallback = nullptr;
+	}
+
+	if (callback)
+		callback(bestMove);
+}
+
+
+Move CPUPlayer::extractPonderMove(Move bestMove)
+{
+	if (!bestMove.isValid() || !mSearchEngine.makeMoveUnchecked(bestMove))
+		return Move();
+
+	int	 ttScoreUnused{0};
+	Move reply{};
+	mTranspositionTable.probe(mSearchEngine.getHash(), 0, NEG_INF, INF, ttScoreUnused, reply);
+
+	// TT moves may stem from hash collisions, only accept legal replies
+	if (reply.isValid())
+	{
+		MoveList replies;
+		mSearchEngine.generateLegalMoves(replies);
+
+		if (std::find(replies.begin(), replies.end(), reply) == replies.end())
+			reply = Move();
+	}
+
+	mSearchEngine.undoMoveUnchecked();
+	return reply;
+}
+
+
+Move CPUPlayer::searchAlphaBeta(const MoveList &moves, int depth, size_t lineCount, std::stop_token stopToken)
+{
+	std::vector<SearchLine> lines;			// ranked lines of the last completed iteration
+	std::vector<SearchLine> iterationLines; // lines of the running iteration
+	lines.reserve(lineCount);
+	iterationLines.reserve(lineCount);
 
-	// Check TT for a best-move hint for root ordering
 	uint64_t hash = mSearchEngine.getHash();
-	int		 ttScoreUnused{0};
-	Move	 ttMove{};
-	lookupTransposition(hash, 0, NEG_INF, INF, ttScoreUnused, ttMove);
 
-	// Copy and order moves
 	MoveList orderedMoves;
-	for (size_t i = 0; i < moves.size(); ++i)
-		orderedMoves.push(moves[i]);
 
-	mMoveEvaluation.orderMoves(orderedMoves, mSearchEngine.getBoard(), ttMove, 0);
+	for (int currentDepth = 1; currentDepth <= depth; ++currentDepth)
+	{
+		// Best move of the previous iteration is searched first
+		int		 ttScoreUnused{0};
+		Move	 ttMove{};
+		mTranspositionTable.probe(hash, 0, NEG_INF, INF, ttScoreUnused, ttMove);
 
-	int alpha = NEG_INF;
-	int beta  = INF;
+		MoveList candidates;
+		for (size_t i = 0; i < moves.size(); ++i)
+			candidates.push(moves[i]);
 
-	for (size_t i = 0; i < orderedMoves.size(); ++i)
-	{
-		if (isCancelled(stopToken))
-			break;
+		mMoveEvaluation.orderMoves(candidates, mSearchEngine.getBoard(), ttMove, 0);
 
-		Move move = orderedMoves[i];
+		// The remaining lines of the previous iteration follow in their rank order
+		orderedMoves.clear();
+		for (const SearchLine &line : lines)
+			orderedMoves.push(line.move);
 
-		if (!mSearchEngine.makeMoveUnchecked(move))
-			continue;
+		for (Move move : candidates)
+		{
+			if (std::find(orderedMoves.begin(), orderedMoves.end(), move) == orderedMoves.end())
+				orderedMoves.push(move);
+		}
 
-		int score = -alphaBeta(depth - 1, -beta, -alpha, 1, stopToken);
-		mSearchEngine.undoMoveUnchecked();
+		iterationLines.clear();
 
-		scoredMoves.push_back({move, score});
+		for (Move move : orderedMoves)
+		{
+			if (isCancelled(stopToken))
+				break;
 
-		if (score > alpha)
-			alpha = score;
+			if (!mSearchEngine.makeMoveUnchecked(move))
+				continue;
+
+			// Alpha is the weakest kept line: every move entering the top lines gets an exact score,
+			// all others only have to prove they are worse (one pass instead of one search per line)
+			int alpha = iterationLines.size() < lineCount ? NEG_INF : iterationLines.back().score;
+			int score = -alphaBeta(currentDepth - 1, -INF, -alpha, 1, stopToken);
+			mSearchEngine.undoMoveUnchecked();
+
+			if (score <= alpha || isCancelled(stopToken))
+				continue;
+
+			updatePV(0, move);
+
+			SearchLine line;
+			line.move	  = move;
+			line.score	  = score;
+			line.mateIn	  = mateDistance(score);
+			line.depth	  = currentDepth;
+			line.pvLength = collectPV(line.pv);
+
+			auto position = std::upper_bound(iterationLines.begin(), iterationLines.end(), score, [](int value, const SearchLine &other) { return value > other.score; });
+			iterationLines.insert(position, line);
+
+			if (iterationLines.size() > lineCount)
+				iterationLines.pop_back();
+		}
+
+		// An interrupted iteration is incomplete, keep the previous one
+		if (isCancelled(stopToken) || iterationLines.empty())
+			break;
+
+		lines.swap(iterationLines);
+
+		{
+			std::lock_guard<std::mutex> lock(mLinesMutex);
+			mLines = lines;
+		}
+
+		mTranspositionTable.store(hash, currentDepth, lines.front().score, TranspositionEntry::NodeType::Exact, lines.front().move);
+		publishSearchInfo(lines.front(), currentDepth == depth);
 	}
 
-	if (scoredMoves.empty())
+	if (lines.empty())
 		return Move();
 
-	if (mConfig.enableRandomization)
-		return selectWithRandomization(scoredMoves);
+	// A search stopped by its budget still reports its result as final
+	if (!mLastInfo.final && !stopToken.stop_requested())
+		publishSearchInfo(lines.front(), true);
+
+	std::vector<ScoredMove> scoredMoves;
+	scoredMoves.reserve(lines.size());
+
+	for (const SearchLine &line : lines)
+		scoredMoves.push_back({line.move, line.score});
+
+	if (mConfig.enableRandomization && mStrength.skill < StrengthLevel::MAX_SKILL)
+		return selectWithSkill(scoredMoves, mStrength.skill);
 
 	return selectBestMove(scoredMoves);
 }
@@ -157,22 +687,32 @@ int CPUPlayer::alphaBeta(int depth, int alpha, int beta, int ply, std::stop_toke
 		return 0;
 
 	++mNodesSearched;
+	mWorker.ply(ply).pvLength = 0;
+	checkSearchLimits();
+
+	if ((mNodesSearched & PROGRESS_NODE_MASK) == 0)
+		reportProgress(false);
 
 	// Check transposition table
 	uint64_t hash = mSearchEngine.getHash();
 	int		 ttScore{0};
 	Move	 ttMove{};
 
-	if (lookupTransposition(hash, depth, alpha, beta, ttScore, ttMove))
+	if (mTranspositionTable.probe(hash, depth, alpha, beta, ttScore, ttMove))
 	{
 		++mTranspositionHits;
 		return ttScore;
 	}
 
-	if (depth <= 0)
-		return quiescence(alpha, beta, stopToken, 0);
+	int tablebaseScore{0};
+
+	if (mTablebase.isOpen() && probeTablebase(depth, alpha, beta, ply, tablebaseScore))
+		return tablebaseScore;
+
+	if (depth <= 0 || ply >= SearchWorker::MAX_PLY - 1)
+		return quiescence(alpha, beta, ply, stopToken, 0);
 
-	MoveList moves;
+	MoveList &moves = mWorker.ply(ply).moves;
 	mSearchEngine.generateLegalMoves(moves);
 
 	// Checkmate/Stalemate
@@ -192,9 +732,6 @@ int CPUPlayer::alphaBeta(int depth, int alpha, int beta, int ply, std::stop_toke
 
 	for (size_t i = 0; i < moves.size(); ++i)
 	{
-		if (isCancelled(stopToken))
-			break;
-
 		Move move = moves[i];
 
 		if (!mSearchEngine.makeMoveUnchecked(move))
@@ -203,13 +740,17 @@ int CPUPlayer::alphaBeta(int depth, int alpha, int beta, int ply, std::stop_toke
 		int score = -alphaBeta(depth - 1, -beta, -alpha, ply + 1, stopToken);
 		mSearchEngine.undoMoveUnchecked();
 
+		// A cancelled child returns 0 instead of its score, nothing of this node may reach the table
+		if (isCancelled(stopToken))
+			return 0;
+
 		if (score >= beta)
 		{
 			// notify MoveEvaluation of the cutoff for killer/history updates
 			mMoveEvaluation.updateHistory(move, depth);
 			mMoveEvaluation.updateKillerMove(move, depth);
 
-			storeTransposition(hash, depth, beta, TranspositionEntry::NodeType::LowerBound, move);
+			mTranspositionTable.store(hash, depth, beta, TranspositionEntry::NodeType::LowerBound, move);
 			return beta; // beta cutoff
 		}
 		if (score > alpha)
@@ -217,23 +758,40 @@ int CPUPlayer::alphaBeta(int depth, int alpha, int beta, int ply, std::stop_toke
 			alpha	 = score;
 			bestMove = move;
 			nodeType = TranspositionEntry::NodeType::Exact;
+			updatePV(ply, move);
 		}
 	}
 
-	storeTransposition(hash, depth, alpha, nodeType, bestMove);
+	mTranspositionTable.store(hash, depth, alpha, nodeType, bestMove);
 
 	return alpha;
 }
 
 
-int CPUPlayer::quiescence(int alpha, int beta, std::stop_token stopToken, int qDepth)
+int CPUPlayer::quiescence(int alpha, int beta, int ply, std::stop_token stopToken, int qDepth)
 {
 	if (isCancelled(stopToken))
 		return 0;
 
 	++mNodesSearched;
+	mWorker.ply(ply).pvLength = 0;
+	mSelDepth				  = std::max(mSelDepth, ply);
+	checkSearchLimits();
+
+	// Transpositions reach the same stand-pat position many times
+	const Chessboard &board = mSearchEngine.getBoard();
+	uint64_t		  hash	= board.getHash();
+	int				  standPat;
 
-	int standPat = Evaluation::evaluate(mSearchEngine.getBoard());
+	if (!mEvalCache.probe(hash, standPat))
+	{
+		// Far outside the window only the side of the window matters, such scores are not exact and not cached
+		bool exact;
+		standPat = Evaluation::evaluate(board, alpha, beta, exact);
+
+		if (exact)
+			mEvalCache.store(hash, standPat);
+	}
 
 	if (standPat >= beta)
 		return beta;
@@ -242,14 +800,16 @@ int CPUPlayer::quiescence(int alpha, int beta, std::stop_token stopToken, int qD
 		alpha = standPat;
 
 	// depth limit prevents quiesence explosion
-	if (qDepth >= MAX_QUIESENCE_DEPTH)
+	if (qDepth >= MAX_QUIESENCE_DEPTH || ply >= SearchWorker::MAX_PLY - 1)
 		return alpha;
 
 	// generate only capture moves
-	MoveList moves{};
+	SearchPly &scratch	= mWorker.ply(ply);
+	MoveList  &moves	= scratch.moves;
+	MoveList  &captures = scratch.captures;
+	captures.clear();
 	mSearchEngine.generateLegalMoves(moves);
 
-	MoveList captures{};
 	for (size_t i = 0; i < moves.size(); ++i)
 	{
 		if (moves[i].isCapture())
@@ -266,9 +826,12 @@ int CPUPlayer::quiescence(int alpha, int beta, std::stop_token stopToken, int qD
 		if (!mSearchEngine.makeMoveUnchecked(move))
 			continue;
 
-		int score = -quiescence(-beta, -alpha, stopToken, qDepth + 1);
+		int score = -quiescence(-beta, -alpha, ply + 1, stopToken, qDepth + 1);
 		mSearchEngine.undoMoveUnchecked();
 
+		if (isCancelled(stopToken))
+			return 0;
+
 		if (score >= beta)
 			return beta;
 
@@ -291,134 +854,230 @@ Move CPUPlayer::selectBestMove(std::vector<ScoredMove> &scoredMoves)
 }
 
 
-Move CPUPlayer::selectWithRandomization(std::vector<ScoredMove> &scoredMoves)
+Move CPUPlayer::selectWithSkill(std::vector<ScoredMove> &scoredMoves, int skill)
 {
 	if (scoredMoves.empty())
 		return Move();
 
-	// sort descending by score
-	std::sort(scoredMoves.begin(), scoredMoves.end());
+	// A found mate is always played
+	auto best = std::max_element(scoredMoves.begin(), scoredMoves.end());
+
+	if (best->score >= MATE_THRESHOLD)
+		return best->move;
+
+	// Every ordinary line gets a random bonus of up to maxError, so a weaker level more often plays a line that
+	// is a little worse, but never one that is more than maxError behind. Decided scores (tablebase and known
+	// endgame results) get none, the error can't turn a win into another line. Raw generator output keeps the
+	// choice identical across standard libraries for a given seed.
+	uint32_t maxError = static_cast<uint32_t>((StrengthLevel::MAX_SKILL - std::clamp(skill, 0, StrengthLevel::MAX_SKILL)) * SKILL_ERROR_STEP);
+
+	Move	 chosen{};
+	int		 chosenScore = NEG_INF;
+
+	for (const ScoredMove &candidate : scoredMoves)
+	{
+		int score = candidate.score;
+
+		if (std::abs(score) < Endgames::KNOWN_WIN)
+			score += static_cast<int>(mRandomGenerator() % (maxError + 1));
+
+		if (score > chosenScore)
+		{
+			chosenScore = score;
+			chosen		= candidate.move;
+		}
+	}
+
+	return chosen;
+}
+
 
-	auto topMoves = filterTopCandidates(scoredMoves, 5);
+void CPUPlayer::clearTranspositionTable()
+{
+	mTranspositionTable.clear();
+	mEvalCache.clear();
+	mNodesSearched	   = 0;
+	mTranspositionHits = 0;
+}
 
-	if (topMoves.empty())
-		return scoredMoves[0].move;
 
-	std::uniform_int_distribution<size_t> dist(0, topMoves.size() - 1);
+void CPUPlayer::updatePV(int ply, Move move)
+{
+	SearchPly		&current = mWorker.ply(ply);
+	const SearchPly &child	 = mWorker.ply(ply + 1);
 
-	return topMoves[dist(mRandomGenerator)].move;
+	int				 length	 = std::min(child.pvLength, SearchPly::MAX_PV_LENGTH - 1);
+
+	current.pv[0]			 = move;
+	std::copy_n(child.pv.begin(), length, current.pv.begin() + 1);
+	current.pvLength = length + 1;
 }
 
 
-std::vector<ScoredMove> CPUPlayer::filterTopCandidates(std::vector<ScoredMove> &moves, size_t maxCount) const
+int CPUPlayer::collectPV(std::array<Move, SearchInfo::MAX_PV> &pv)
 {
-	if (moves.empty())
-		return {};
+	const SearchPly &root	= mWorker.ply(0);
+	int				 length = 0;
 
-	int						bestScore = moves[0].score;
-	int						threshold = 50;
+	for (int i = 0; i < root.pvLength && length < SearchInfo::MAX_PV; ++i)
+	{
+		if (!mSearchEngine.makeMoveUnchecked(root.pv[i]))
+			break;
 
-	std::vector<ScoredMove> filtered;
+		pv[length++] = root.pv[i];
+	}
 
-	for (const auto &sm : moves)
+	// The tree PV is cut where the search returned from the transposition table, continue it from there
+	while (length < SearchInfo::MAX_PV)
 	{
-		if (filtered.size() >= maxCount)
+		int	 ttScoreUnused{0};
+		Move ttMove{};
+		mTranspositionTable.probe(mSearchEngine.getHash(), 0, NEG_INF, INF, ttScoreUnused, ttMove);
+
+		if (!ttMove.isValid())
 			break;
 
-		if (bestScore - sm.score <= threshold)
-			filtered.push_back(sm);
+		MoveList legalMoves;
+		mSearchEngine.generateLegalMoves(legalMoves);
+
+		if (std::find(legalMoves.begin(), legalMoves.end(), ttMove) == legalMoves.end() || !mSearchEngine.makeMoveUnchecked(ttMove))
+			break;
+
+		pv[length++] = ttMove;
 	}
 
-	return filtered;
+	for (int i = 0; i < length; ++i)
+		mSearchEngine.undoMoveUnchecked();
+
+	return length;
 }
 
 
-void CPUPlayer::storeTransposition(uint64_t hash, int depth, int score, TranspositionEntry::NodeType type, Move bestMove)
+void CPUPlayer::publishSearchInfo(const SearchLine &best, bool final)
 {
-	auto it = mTranspositionTable.find(hash);
+	SearchInfo &info = mLastInfo;
 
-	if (it != mTranspositionTable.end() && it->second.depth > depth)
-		return; // keep deeper entry
+	info.depth		 = best.depth;
+	info.score		 = best.score;
+	info.mateIn		 = best.mateIn;
+	info.final		 = final;
+	info.pondering	 = mIsPondering.load();
+	info.pvLength	 = best.pvLength;
+	info.pv			 = best.pv;
 
-	if (mTranspositionTable.size() >= MAX_TRANSPOSITION_ENTRIES)
-	{
-		size_t toRemove = MAX_TRANSPOSITION_ENTRIES / 4;
-		auto   eraseIt	= mTranspositionTable.begin();
+	reportProgress(true);
 
-		while (toRemove > 0 && eraseIt != mTranspositionTable.end())
-		{
-			eraseIt = mTranspositionTable.erase(eraseIt);
-			--toRemove;
-		}
-	}
+	if (mIterationCallback)
+		mIterationCallback(info);
 
-	mTranspositionTable[hash] = {hash, depth, score, type, bestMove};
+	LOG_DEBUG("Search depth {} seldepth {} score {} nodes {} nps {} pv {}", info.depth, info.selDepth, info.score, info.nodes, info.nps,
+			  info.pvLength > 0 ? MoveNotation::toUCI(info.pv[0]) : "-");
 }
 
 
-bool CPUPlayer::lookupTransposition(uint64_t hash, int depth, int alpha, int beta, int &score, Move &bestMove)
+void CPUPlayer::reportProgress(bool force)
 {
-	auto it = mTranspositionTable.find(hash);
-	if (it == mTranspositionTable.end())
-		return false;
+	if (mLastInfo.depth == 0)
+		return; // nothing to report before the first iteration completed
 
-	const auto &entry = it->second;
+	auto now = std::chrono::steady_clock::now();
 
-	// Always extract best move for ordering, even if score isn't usable
-	bestMove		  = entry.bestMove;
+	// Completed iterations are always reported, node count refreshes in between are rate limited
+	if (!force && now - mLastInfoTime < std::chrono::milliseconds(mConfig.searchInfoIntervalMs))
+		return;
 
-	if (entry.depth < depth)
-		return false;
+	uint64_t elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(now - mSearchStart).count();
 
-	bestMove = entry.bestMove;
+	mLastInfo.selDepth = std::max(mSelDepth, mLastInfo.depth);
+	mLastInfo.nodes	   = mNodesSearched;
+	mLastInfo.timeMs   = static_cast<uint32_t>(elapsedUs / 1000);
+	mLastInfo.nps	   = elapsedUs > 0 ? mNodesSearched * 1'000'000 / elapsedUs : 0;
+	mLastInfo.hashFull = mTranspositionTable.hashFull();
+	mLastInfo.tbHits   = mTablebaseHits;
 
-	switch (entry.type)
-	{
-	case TranspositionEntry::NodeType::Exact:
+	mSearchInfo.publish(mLastInfo);
+	mLastInfoTime = now;
+}
+
+
+size_t CPUPlayer::getLineCount() const
+{
+	size_t lineCount = static_cast<size_t>(std::max(mConfig.multiPV, 1));
+
+	// The error model needs exact scores for every candidate it may pick
+	if (mConfig.enableRandomization && getStrengthLevel().skill < StrengthLevel::MAX_SKILL)
+		lineCount = std::max<size_t>(lineCount, SKILL_LINES);
+
+	return lineCount;
+}
+
+
+void CPUPlayer::checkSearchLimits()
+{
+	if (mLastInfo.depth == 0)
+		return; // always complete the first iteration so there is a move to play
+
+	if (mFinishRequested.load(std::memory_order_relaxed))
 	{
-		score = entry.score;
-		return true;
+		mLimitReached = true;
+		return;
 	}
-	case TranspositionEntry::NodeType::LowerBound:
-	{
-		if (entry.score >= beta)
-		{
-			score = entry.score;
-			return true;
-		}
 
-		break;
-	}
-	case TranspositionEntry::NodeType::UpperBound:
+	if (mStrength.nodeLimit > 0 && mNodesSearched >= mStrength.nodeLimit)
 	{
-		if (entry.score <= alpha)
-		{
-			score = entry.score;
-			return true;
-		}
-		break;
+		mLimitReached = true;
+		return;
 	}
+
+	// The clock is only read every few thousand nodes
+	if (mStrength.moveTimeMs > 0 && (mNodesSearched & PROGRESS_NODE_MASK) == 0)
+	{
+		if (std::chrono::steady_clock::now() - mSearchStart >= std::chrono::milliseconds(mStrength.moveTimeMs))
+			mLimitReached = true;
 	}
+}
+
 
-	return false;
+StrengthLevel CPUPlayer::strengthForDifficulty(CPUDifficulty difficulty, int maxDepth)
+{
+	// Weak levels stop on a fixed node budget alone (a clock would make their moves depend on the machine's load)
+	// and make deliberate errors, Hard searches to the configured depth without a budget and always plays its best line
+	switch (difficulty)
+	{
+	case CPUDifficulty::Easy: return {2, 1'500, 0, LIMITED_MAX_DEPTH};
+	case CPUDifficulty::Medium: return {10, 25'000, 0, LIMITED_MAX_DEPTH};
+	case CPUDifficulty::Hard: return {StrengthLevel::MAX_SKILL, 0, 0, maxDepth, true};
+	default: return {10, 25'000, 0, LIMITED_MAX_DEPTH};
+	}
 }
 
 
-void CPUPlayer::clearTranspositionTable()
+void CPUPlayer::setSearchLimits(int maxDepth, uint64_t nodeLimit, int moveTimeMs)
 {
-	mTranspositionTable.clear();
-	mNodesSearched	   = 0;
-	mTranspositionHits = 0;
+	cancelCalculation();
+
+	mConfig.maxDepth   = maxDepth;
+	mConfig.nodeLimit  = nodeLimit;
+	mConfig.moveTimeMs = moveTimeMs;
 }
 
 
-int CPUPlayer::getSearchDepth() const
+StrengthLevel CPUPlayer::getStrengthLevel() const
 {
-	switch (mConfig.difficulty)
-	{
-	case CPUDifficulty::Easy: return 2;
-	case CPUDifficulty::Medium: return 4;
-	case CPUDifficulty::Hard: return mConfig.maxDepth;
-	default: return 4;
-	}
+	StrengthLevel strength = strengthForDifficulty(mConfig.difficulty, mConfig.maxDepth);
+
+	if (mConfig.skillLevel >= 0)
+		strength.skill = std::min(mConfig.skillLevel, StrengthLevel::MAX_SKILL);
+
+	if (mConfig.nodeLimit > 0)
+		strength.nodeLimit = mConfig.nodeLimit;
+
+	if (mConfig.moveTimeMs > 0)
+		strength.moveTimeMs = mConfig.moveTimeMs;
+
+	if (mConfig.enablePondering.has_value())
+		strength.ponder = *mConfig.enablePondering;
+
+	return strength;
 }
+
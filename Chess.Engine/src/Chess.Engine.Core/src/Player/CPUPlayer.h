@@ -8,45 +8,50 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <random>
 #include <thread>
+#include <mutex>
+#include <chrono>
 #include <algorithm>
 
 #include "Parameters.h"
 #include "GameEngine.h"
 #include "Evaluation.h"
 #include "Evaluation/MoveEvaluation.h"
+#include "EvalCache.h"
+#include "SearchWorker.h"
+#include "SearchInfo.h"
+#include "TranspositionTable.h"
+#include "PolyglotBook.h"
+#include "Tablebase.h"
 
 
 /**
- * @brief	Transposition table entry for search optimization.
+ * @brief	Move with associated score for sorting/selection.
  */
-struct TranspositionEntry
+struct ScoredMove
 {
-	enum class NodeType
-	{
-		Exact,
-		LowerBound,
-		UpperBound,
-	};
-
-	uint64_t hash{};
-	int		 depth{};
-	int		 score{};
-	NodeType type{NodeType::Exact};
-	Move	 bestMove{};
+	Move move;
+	int	 score;
+
+	bool operator<(const ScoredMove &other) { return score < other.score; }
 };
 
 
 /**
- * @brief	Move with associated score for sorting/selection.
+ * @brief	Search budget and error model of a playing strength.
+ *			Budgeted levels stop on the node limit, so their cost per move is fixed and their play reproducible.
  */
-struct ScoredMove
+struct StrengthLevel
 {
-	Move move;
-	int	 score;
+	static constexpr int MAX_SKILL	= 20;
 
-	bool operator<(const ScoredMove &other) { return score < other.score; }
+	int					 skill		= MAX_SKILL; // 0 (weakest) .. MAX_SKILL (no deliberate errors)
+	uint64_t			 nodeLimit	= 0;		 // Nodes per move, 0 for unlimited
+	int					 moveTimeMs = 0;		 // Time limit per move of the levels without a budget, 0 for unlimited
+	int					 maxDepth	= 0;
+	bool				 ponder		= false;	 // Search the expected reply while the opponent thinks
 };
 
 
@@ -55,11 +60,37 @@ struct ScoredMove
  */
 struct CPUConfiguration
 {
-	bool		  enabled			  = false;
-	Side		  cpuColor			  = Side::Black; // Default to black
-	CPUDifficulty difficulty		  = CPUDifficulty::Medium;
-	bool		  enableRandomization = true;		 // Add some randomness to move selection
-	int			  maxDepth			  = 6;
+	bool				enabled				 = false;
+	Side				cpuColor			 = Side::Black;	// Default to black
+	CPUDifficulty		difficulty			 = CPUDifficulty::Medium;
+	bool				enableRandomization	 = true;		// Apply the skill error model to move selection
+	std::optional<bool>	enablePondering;					// Overrides the difficulty's pondering (only Hard ponders), empty keeps it
+	int					maxDepth			 = 6;
+	int					searchInfoIntervalMs = 100;			// Minimum spacing of progress reports between iterations
+	int					multiPV				 = 1;			// Ranked root lines searched with exact scores
+	int					skillLevel			 = -1;			// Overrides the difficulty's skill (0..20), -1 keeps it
+	uint64_t			nodeLimit			 = 0;			// Overrides the difficulty's node budget, 0 keeps it
+	int					moveTimeMs			 = 0;			// Overrides the difficulty's time limit, 0 keeps it
+	uint32_t			seed				 = 0;			// Seed of the move selection for reproducible games (every search starts from an empty table), 0 for random
+	size_t				hashMegabytes		 = 0;			// Transposition table size, 0 for the default capacity
+	std::string			openingBook;						// Polyglot book played from before searching, empty for none
+	std::string			tablebasePath;						// Directory of endgame tables probed by the search, empty for none
+	int					tablebaseProbeDepth	 = 1;			// Remaining depth a node with the tables' most pieces needs to be probed
+};
+
+
+/**
+ * @brief	Counters describing how well pondering predicted the opponent.
+ */
+struct PonderStatistics
+{
+	int	   started		  = 0; // Ponder searches launched
+	int	   hits			  = 0; // Opponent played the predicted move
+	int	   misses		  = 0; // Opponent played something else (search discarded)
+	int	   instantReplies = 0; // Hits where the ponder search had already finished
+	double searchedMs	  = 0; // Search time spent on the opponent's clock before the hits
+
+	double hitRate() const { return (hits + misses) > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0; }
 };
 
 
@@ -88,6 +119,22 @@ public:
 	bool			 isEnabled() const { return mConfig.enabled; }
 	bool			 isCPUPlayer(Side side) const { return mConfig.enabled && mConfig.cpuColor == side; }
 
+	/**
+	 * @brief	Strength of the configured difficulty with the configuration overrides applied.
+	 */
+	StrengthLevel		 getStrengthLevel() const;
+
+	/**
+	 * @brief	Built-in strength of a difficulty (Hard searches to maxDepth).
+	 */
+	static StrengthLevel strengthForDifficulty(CPUDifficulty difficulty, int maxDepth);
+
+	/**
+	 * @brief	Change the depth, node and time limits of the following searches (cancels a running search).
+	 *			Unlike configure() this keeps the transposition table, so limits can be set per move.
+	 */
+	void				 setSearchLimits(int maxDepth, uint64_t nodeLimit, int moveTimeMs);
+
 	//=========================================================================
 	// Move Calculation
 	//=========================================================================
@@ -109,11 +156,114 @@ public:
 	 */
 	void			 cancelCalculation();
 
+	/**
+	 * @brief	End the running search early. Unlike cancelCalculation() the search still completes its
+	 *			first iteration and hands the best move found so far to the waiting callback.
+	 */
+	void			 finishCalculation() { mFinishRequested.store(true, std::memory_order_relaxed); }
+
 	/**
 	 * @brief	Check if calculation is in progress.
 	 */
 	bool			 isCalculating() const { return mIsCalculating.load(); }
 
+	//=========================================================================
+	// Analysis
+	//=========================================================================
+
+	/**
+	 * @brief	Search the current position synchronously and rank the best root moves.
+	 * @param	lineCount	Number of lines (clamped to the legal move count).
+	 * @return	Lines ordered best first, each with an exact score and its PV.
+	 */
+	std::vector<SearchLine> analyzePosition(size_t lineCount);
+
+	/**
+	 * @brief	Ranked lines of the last completed search iteration.
+	 */
+	std::vector<SearchLine> getSearchLines() const;
+
+	//=========================================================================
+	// Pondering
+	//=========================================================================
+
+	/**
+	 * @brief	Start searching the position after the expected opponent reply.
+	 *			The reply is taken from the last search (TT move after the CPU's move).
+	 *			Must be called after the CPU's move has been executed on the engine.
+	 * @return	true if a ponder search is running (or was already running).
+	 */
+	bool			 startPondering();
+
+	/**
+	 * @brief	Resolve the running ponder search against the move the opponent played.
+	 *			On a hit the ponder search becomes the real search and the callback
+	 *			fires once it is done (immediately if it already finished).
+	 *			On a miss the search is cancelled; the transposition table is kept.
+	 * @param	opponentMove	Move that was just executed on the engine.
+	 * @param	callback		Called with the chosen move on a hit.
+	 * @return	true on a ponder hit, false if a regular search has to be started.
+	 */
+	bool			 ponderHit(Move opponentMove, std::function<void(Move)> callback);
+
+	/**
+	 * @brief	Discard any running ponder search (game over, a move the CPU has to answer otherwise).
+	 */
+	void			 stopPondering();
+
+	/**
+	 * @brief	Discard the running search and the expected reply (undo, reset): the reply belongs to a position
+	 *			that is no longer on the board, so startPondering() must not pick it up again.
+	 */
+	void			 resetPonder();
+
+	bool			 isPondering() const { return mIsPondering.load(); }
+	Move			 getPonderMove() const { return mPonderMove; }
+	PonderStatistics getPonderStatistics() const;
+
+	//=========================================================================
+	// Diagnostics
+	//=========================================================================
+
+	SearchWorkerStatistics getWorkerStatistics() const { return mWorker.getStatistics(); }
+
+	/**
+	 * @brief	Nodes visited by the last search.
+	 */
+	uint64_t			   getNodesSearched() const { return mNodesSearched; }
+
+	/**
+	 * @brief	Transposition table hits of the last search.
+	 */
+	uint64_t			   getTranspositionHits() const { return mTranspositionHits; }
+
+	/**
+	 * @brief	Static evaluation cache of the quiescence search (probes and hits of the last search).
+	 */
+	const EvalCache		  &getEvalCache() const { return mEvalCache; }
+
+	/**
+	 * @brief	Stand-pat evaluations of the last search that took the lazy early exit.
+	 */
+	uint64_t			   getLazyEvalExits() const { return mLazyEvalExits; }
+
+	/**
+	 * @brief	Positions of the last search found in the endgame tables.
+	 */
+	uint64_t			   getTablebaseHits() const { return mTablebaseHits; }
+
+	/**
+	 * @brief	Channel carrying depth, score, nodes and PV of the running search.
+	 *			Written by the search thread without blocking, read by the UI side.
+	 */
+	SearchInfoChannel	  &getSearchInfoChannel() { return mSearchInfo; }
+
+	/**
+	 * @brief	Observer of every completed search iteration, called on the searching thread with the
+	 *			iteration's info (nothing is skipped, unlike the channel). Set it while no search runs.
+	 */
+	void				   setIterationCallback(std::function<void(const SearchInfo &)> callback) { mIterationCallback = std::move(callback); }
+
 
 private:
 	//=========================================================================
@@ -121,14 +271,57 @@ private:
 	//=========================================================================
 
 	/**
-	 * @brief	Top-level search dispatcher based on difficulty.
+	 * @brief	Snapshot the main engine and search the current position.
 	 */
 	Move											 computeBestMove(std::stop_token stopToken);
 
 	/**
-	 * @brief	Minimax search with alpha-beta pruning.
+	 * @brief	Move of the opening book for the search engine's position (weighted random unless randomization
+	 *			is off, then the most played one). Move::none() without a book or if the position is not in it.
 	 */
-	Move											 searchAlphaBeta(const MoveList &moves, int depth, std::stop_token stopToken);
+	Move											 probeBook();
+
+	/**
+	 * @brief	Keep the root moves with the best endgame table result: winning moves whose distance to zeroing
+	 *			fits the 50 move rule (or the fastest ones), the longest resistance when lost.
+	 * @return	false (moves unchanged) if the position or one of its successors can't be probed.
+	 */
+	bool											 filterTablebaseMoves(MoveList &moves);
+
+	/**
+	 * @brief	Endgame table result of the search engine's position as a search score, if it decides the (alpha, beta) window,
+	 *			otherwise the window is narrowed to the table's bound. Only probed right after a capture or pawn move,
+	 *			and with the tables' most pieces only at probeDepth or more.
+	 */
+	bool											 probeTablebase(int depth, int &alpha, int &beta, int ply, int &score);
+
+	/**
+	 * @brief	Task executed by the search worker for every request.
+	 */
+	void											 runSearchTask(std::stop_token stopToken);
+
+	/**
+	 * @brief	Top-level search dispatcher based on difficulty.
+	 *			Searches the position currently held by the search engine.
+	 */
+	Move											 searchCurrentPosition(std::stop_token stopToken, size_t lineCount);
+
+	/**
+	 * @brief	Hand a finished search result to the waiting callback,
+	 *			or park it if the search is still an unresolved ponder search.
+	 */
+	void											 onSearchFinished(Move bestMove, std::stop_token stopToken);
+
+	/**
+	 * @brief	Expected opponent reply to bestMove (TT move of the resulting position).
+	 */
+	Move											 extractPonderMove(Move bestMove);
+
+	/**
+	 * @brief	Iterative deepening minimax search with alpha-beta pruning.
+	 *			Every iteration keeps the best lineCount root moves (MultiPV) with exact scores.
+	 */
+	Move											 searchAlphaBeta(const MoveList &moves, int depth, size_t lineCount, std::stop_token stopToken);
 
 	/**
 	 * @brief	Recursive alpha-beta implementation.
@@ -138,31 +331,64 @@ private:
 	/**
 	 * @brief	Quiescence search to avoid horizon effect.
 	 */
-	int												 quiescence(int alpha, int beta, std::stop_token stopToken, int qDepth);
+	int												 quiescence(int alpha, int beta, int ply, std::stop_token stopToken, int qDepth);
 
 	//=========================================================================
 	// Move Selection
 	//=========================================================================
 
 	Move											 selectBestMove(std::vector<ScoredMove> &scoredMoves);
-	Move											 selectWithRandomization(std::vector<ScoredMove> &scoredMoves);
-	std::vector<ScoredMove>							 filterTopCandidates(std::vector<ScoredMove> &moves, size_t maxCount) const;
+
+	/**
+	 * @brief	Play the best line after adding a random error of up to the skill's margin to every ordinary line score.
+	 *			A found mate is always played, tablebase and known endgame results get no error.
+	 */
+	Move											 selectWithSkill(std::vector<ScoredMove> &scoredMoves, int skill);
 
 
 	//=========================================================================
 	// Transposition Table
 	//=========================================================================
 
-	void											 storeTransposition(uint64_t hash, int depth, int score, TranspositionEntry::NodeType type, Move bestMove);
-	bool											 lookupTransposition(uint64_t hash, int depth, int alpha, int beta, int &score, Move &bestMove);
 	void											 clearTranspositionTable();
 
 	//=========================================================================
 	// Helpers
 	//=========================================================================
 
-	bool											 isCancelled(std::stop_token token) const { return token.stop_requested(); }
-	int												 getSearchDepth() const;
+	bool											 isCancelled(std::stop_token token) const { return mLimitReached || token.stop_requested(); }
+	size_t											 getLineCount() const;
+
+	/**
+	 * @brief	Stop the search once the node or time budget is spent (never before the first iteration completed).
+	 */
+	void											 checkSearchLimits();
+
+	//=========================================================================
+	// Search Info
+	//=========================================================================
+
+	/**
+	 * @brief	Append the child's principal variation behind move at the given ply.
+	 */
+	void											 updatePV(int ply, Move move);
+
+	/**
+	 * @brief	Copy the root PV, continued along the transposition table where it was cut.
+	 * @return	Length of the collected PV.
+	 */
+	int												 collectPV(std::array<Move, SearchInfo::MAX_PV> &pv);
+
+	/**
+	 * @brief	Publish a completed iteration (or the final result) to the info channel.
+	 */
+	void											 publishSearchInfo(const SearchLine &best, bool final);
+
+	/**
+	 * @brief	Refresh node count and timing of the last report and publish it.
+	 *			Unless forced, publishing is rate limited by searchInfoIntervalMs.
+	 */
+	void											 reportProgress(bool force);
 
 	//=========================================================================
 	// Members
@@ -173,19 +399,62 @@ private:
 	GameEngine										 mSearchEngine;	  // isolated copy for search
 	MoveEvaluation									 mMoveEvaluation; // Move ordering (stateful per search - owns killer/history tables)
 
-	// Search thread
-	std::jthread									 mSearchThread;
+	// Search state
 	std::atomic<bool>								 mIsCalculating{false};
+	std::function<void(Move)>						 mCallback; // Receiver of the running search (guarded by mPonderMutex)
+	std::function<void(const SearchInfo &)>			 mIterationCallback;
+
+	// Pondering
+	std::atomic<bool>								 mIsPondering{false};
+	Move											 mPonderMove{};			 // Expected opponent reply after the last search
+	Move											 mPonderedMove{};		 // Reply the running ponder search assumes
+	uint64_t										 mPonderHash{0};		 // Main engine hash the ponder search expects after the reply
+	bool											 mPonderFinished{false}; // Ponder search done before the hit
+	Move											 mPonderResult{};		 // Result parked until the hit
+	std::chrono::steady_clock::time_point			 mPonderStart{};
+	PonderStatistics								 mPonderStats;
+	mutable std::mutex								 mPonderMutex;
 
 	// Transposition Table
-	std::unordered_map<uint64_t, TranspositionEntry> mTranspositionTable;
-	static constexpr size_t							 MAX_TRANSPOSITION_ENTRIES = 1'000'000;
+	TranspositionTable								 mTranspositionTable;
+
+	// Opening book (mapped while configured)
+	PolyglotBook									 mBook;
+	std::string										 mBookPath;
+
+	// Endgame tables (mapped while configured)
+	Tablebase										 mTablebase;
+	std::string										 mTablebasePath;
+
+	// Stand-pat evaluations, cleared together with the transposition table
+	EvalCache										 mEvalCache;
 
 	// Statistics
-	int												 mNodesSearched			   = 0;
+	uint64_t										 mNodesSearched			   = 0;
 	int												 mTranspositionHits		   = 0;
+	int												 mSelDepth				   = 0;
+	uint64_t										 mLazyEvalExits			   = 0;
+	uint64_t										 mTablebaseHits			   = 0;
+
+	// Budget of the running search
+	StrengthLevel									 mStrength;
+	bool											 mLimitReached			   = false;
+	std::atomic<bool>								 mFinishRequested{false}; // Set by finishCalculation(), read by the search
+
+	// Search info (written by the search thread only, published through mSearchInfo)
+	std::chrono::steady_clock::time_point			 mSearchStart{};
+	std::chrono::steady_clock::time_point			 mLastInfoTime{};
+	SearchInfo										 mLastInfo;
+	SearchInfoChannel								 mSearchInfo;
+
+	// MultiPV lines of the last completed iteration
+	std::vector<SearchLine>							 mLines;
+	mutable std::mutex								 mLinesMutex;
 
 	// Randomization
 	std::random_device								 mRandomDevice;
 	std::mt19937									 mRandomGenerator;
+
+	// Search thread (declared last: it is stopped before the state it searches on is destroyed)
+	SearchWorker									 mWorker;
 };
@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+	Module:			SearchInfo
+	Description:    Search progress reported by the CPU player
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+#include "Move.h"
+
+
+/**
+ * @brief	Snapshot of the running search (one completed iteration or a progress update).
+ *			Plain data so it can be copied through the lock-free channel.
+ */
+struct SearchInfo
+{
+	static constexpr int	 MAX_PV	   = 32;
+
+	int						 depth	   = 0;		// Last completed iteration
+	int						 selDepth  = 0;		// Deepest ply reached including quiescence
+	int						 score	   = 0;		// Centipawns from the CPU's point of view
+	int						 mateIn	   = 0;		// Moves to mate (negative if the CPU gets mated), 0 if no mate found
+	uint64_t				 nodes	   = 0;
+	uint64_t				 nps	   = 0;
+	int						 hashFull  = 0;		// Transposition table usage in permille
+	uint64_t				 tbHits	   = 0;		// Positions found in the endgame tables
+	uint32_t				 timeMs	   = 0;
+	bool					 pondering = false;
+	bool					 final	   = false; // Last report of this search
+
+	int						 pvLength  = 0;
+	std::array<Move, MAX_PV> pv{};
+};
+
+static_assert(std::is_trivially_copyable_v<SearchInfo>, "SearchInfo is copied word-wise through the channel");
+
+
+/**
+ * @brief	One ranked root line of a MultiPV search, scored with an exact window.
+ */
+struct SearchLine
+{
+	Move								 move{};
+	int									 score	  = 0; // Centipawns from the CPU's point of view
+	int									 mateIn	  = 0;
+	int									 depth	  = 0;
+
+	int									 pvLength = 0;
+	std::array<Move, SearchInfo::MAX_PV> pv{};
+};
+
+
+/**
+ * @brief	Single producer / single consumer "latest value" channel for search info.
+ *
+ * Implemented as a sequence lock over atomic words:
+ *  - publish() is wait-free, the search thread never blocks on the reader.
+ *  - tryRead() retries only while a write is in progress and reports whether a newer
+ *    value than the last one seen is available. Intermediate values may be skipped,
+ *    which is what keeps the UI rate bounded by the reader's polling interval.
+ */
+class SearchInfoChannel
+{
+public:
+	/**
+	 * @brief	Store the newest search info (search thread).
+	 */
+	void publish(const SearchInfo &info)
+	{
+		std::array<uint64_t, WORDS> buffer{};
+		std::memcpy(buffer.data(), &info, sizeof(SearchInfo));
+
+		uint64_t sequence = mSequence.load(std::memory_order_relaxed);
+		mSequence.store(sequence + 1, std::memory_order_relaxed); // odd: write in progress
+		std::atomic_thread_fence(std::memory_order_release);
+
+		for (size_t i = 0; i < WORDS; ++i)
+			mWords[i].store(buffer[i], std::memory_order_relaxed);
+
+		mSequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	/**
+	 * @brief	Read the newest search info if it differs from the last one read (reader thread).
+	 * @param	info		Receives the search info.
+	 * @param	lastSequence	Sequence of the last value read, updated on success.
+	 * @return	true if a new consistent value was read.
+	 */
+	bool tryRead(SearchInfo &info, uint64_t &lastSequence) const
+	{
+		for (int attempt = 0; attempt < MAX_READ_ATTEMPTS; ++attempt)
+		{
+			uint64_t before = mSequence.load(std::memory_order_acquire);
+
+			if (before == lastSequence)
+				return false; // nothing new
+
+			if (before & 1)
+				continue;	  // writer is busy
+
+			std::array<uint64_t, WORDS> buffer{};
+			for (size_t i = 0; i < WORDS; ++i)
+				buffer[i] = mWords[i].load(std::memory_order_relaxed);
+
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (mSequence.load(std::memory_order_relaxed) != before)
+				continue;	  // torn read, try again
+
+			// Trivially copyable (see the static_assert), the member initializers only make it non-trivial to construct
+			std::memcpy(static_cast<void *>(&info), buffer.data(), sizeof(SearchInfo));
+			lastSequence = before;
+			return true;
+		}
+
+		return false;
+	}
+
+	/**
+	 * @brief	Mark a search as running or finished. The dispatcher stops polling once inactive.
+	 */
+	void setActive(bool active) { mActive.store(active, std::memory_order_release); }
+	bool isActive() const { return mActive.load(std::memory_order_acquire); }
+
+
+private:
+	static constexpr size_t					 WORDS			   = (sizeof(SearchInfo) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+	static constexpr int					 MAX_READ_ATTEMPTS = 8;
+
+	std::atomic<uint64_t>					 mSequence{0};
+	std::array<std::atomic<uint64_t>, WORDS> mWords{};
+	std::atomic<bool>						 mActive{false};
+};
@@ -0,0 +1,124 @@
+/*
+  ==============================================================================
+	Module:			SearchWorker
+	Description:    Long-lived search thread that is woken per move request
+  ==============================================================================
+*/
+
+#include "SearchWorker.h"
+
+#include <algorithm>
+
+
+using Clock = std::chrono::steady_clock;
+
+static double microsecondsSince(Clock::time_point start)
+{
+	return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+}
+
+
+SearchWorker::SearchWorker(Task task) : mTask(std::move(task)), mStack(std::make_unique<SearchPly[]>(MAX_PLY))
+{
+	mRunning.store(true);
+	mThread = std::thread(&SearchWorker::run, this, Clock::now());
+}
+
+
+SearchWorker::~SearchWorker()
+{
+	cancel();
+
+	mRunning.store(false, std::memory_order_release);
+	mGeneration.fetch_add(1, std::memory_order_release);
+	mGeneration.notify_one();
+
+	if (mThread.joinable())
+		mThread.join();
+}
+
+
+void SearchWorker::post()
+{
+	waitIdle();
+
+	mStopSource	   = std::stop_source();
+	mRequestTime   = Clock::now();
+	mFirstNodeSeen = false;
+	mBusy.store(true, std::memory_order_relaxed);
+
+	// The single handoff signal: the release publishes everything written above
+	mGeneration.fetch_add(1, std::memory_order_release);
+	mGeneration.notify_one();
+}
+
+
+void SearchWorker::cancel()
+{
+	mStopSource.request_stop();
+	waitIdle();
+}
+
+
+void SearchWorker::waitIdle() const
+{
+	if (isWorkerThread())
+		return; // the task itself cannot wait for its own completion
+
+	while (mBusy.load(std::memory_order_acquire))
+		mBusy.wait(true, std::memory_order_acquire);
+}
+
+
+void SearchWorker::markFirstNode()
+{
+	if (!isWorkerThread() || mFirstNodeSeen)
+		return; // synchronous searches are not handed over
+
+	mFirstNodeSeen	   = true;
+	double firstNodeUs = microsecondsSince(mRequestTime);
+
+	std::lock_guard<std::mutex> lock(mStatsMutex);
+	mStats.lastFirstNodeUs = firstNodeUs;
+	mStats.totalFirstNodeUs += firstNodeUs;
+	mStats.maxFirstNodeUs = std::max(mStats.maxFirstNodeUs, firstNodeUs);
+}
+
+
+SearchWorkerStatistics SearchWorker::getStatistics() const
+{
+	std::lock_guard<std::mutex> lock(mStatsMutex);
+	return mStats;
+}
+
+
+void SearchWorker::run(std::chrono::steady_clock::time_point createdAt)
+{
+	{
+		std::lock_guard<std::mutex> lock(mStatsMutex);
+		mStats.threadStartUs = microsecondsSince(createdAt);
+	}
+
+	// Start from the initial generation, a request may already have been posted before this thread ran
+	uint32_t seen = 0;
+
+	while (true)
+	{
+		mGeneration.wait(seen, std::memory_order_acquire);
+		seen = mGeneration.load(std::memory_order_acquire);
+
+		if (!mRunning.load(std::memory_order_acquire))
+			break;
+
+		{
+			std::lock_guard<std::mutex> lock(mStatsMutex);
+			++mStats.requests;
+			mStats.lastHandoffUs = microsecondsSince(mRequestTime);
+		}
+
+		mTask(mStopSource.get_token());
+
+		mBusy.store(false, std::memory_order_release);
+		mBusy.notify_all();
+	}
+}
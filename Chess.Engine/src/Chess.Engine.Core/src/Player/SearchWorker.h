@@ -0,0 +1,125 @@
+/*
+  ==============================================================================
+	Module:			SearchWorker
+	Description:    Long-lived search thread that is woken per move request
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+
+#include "Move.h"
+
+
+/**
+ * @brief	Per-ply scratch storage for the search.
+ *			Preallocated once so deep recursion does not grow the thread stack per node.
+ */
+struct SearchPly
+{
+	static constexpr int			MAX_PV_LENGTH = 128;
+
+	MoveList						moves;
+	MoveList						captures;
+
+	std::array<Move, MAX_PV_LENGTH> pv{};		  // Principal variation starting at this ply
+	int								pvLength = 0;
+};
+
+
+/**
+ * @brief	Latency counters of the search worker.
+ */
+struct SearchWorkerStatistics
+{
+	uint64_t requests		  = 0;
+	double	 threadStartUs	  = 0; // Thread creation until the worker loop ran (paid once)
+	double	 lastHandoffUs	  = 0; // Request until the worker picked it up
+	double	 lastFirstNodeUs  = 0; // Request until the search visited its root
+	double	 totalFirstNodeUs = 0;
+	double	 maxFirstNodeUs	  = 0;
+
+	double	 averageFirstNodeUs() const { return requests > 0 ? totalFirstNodeUs / static_cast<double>(requests) : 0.0; }
+};
+
+
+/**
+ * @brief	Single search thread created once and parked between moves.
+ *
+ * The worker runs a fixed task for every request. A request bumps one atomic generation
+ * counter which the parked thread waits on (std::atomic::wait), so no thread is created,
+ * no closure is allocated and no mutex is taken on the handoff.
+ *
+ * Threading contract:
+ *  - post() and cancel() are called from the owning (game) thread.
+ *  - Only one request is in flight at a time; post() waits for the previous one.
+ *  - cancel() and waitIdle() may be called from inside the task, they do not block there.
+ */
+class SearchWorker
+{
+public:
+	using Task					 = std::function<void(std::stop_token)>;
+	static constexpr int MAX_PLY = 128;
+
+	explicit SearchWorker(Task task);
+	~SearchWorker();
+
+	SearchWorker(const SearchWorker &)			  = delete;
+	SearchWorker		  &operator=(const SearchWorker &) = delete;
+
+	/**
+	 * @brief	Hand the next request to the parked thread.
+	 */
+	void				   post();
+
+	/**
+	 * @brief	Ask the running task to stop and wait until the worker is parked again.
+	 */
+	void				   cancel();
+
+	/**
+	 * @brief	Block until the current request has been processed.
+	 */
+	void				   waitIdle() const;
+
+	bool				   isBusy() const { return mBusy.load(std::memory_order_acquire); }
+	bool				   isWorkerThread() const { return std::this_thread::get_id() == mThread.get_id(); }
+
+	/**
+	 * @brief	Record that the search reached its first node (latency measurement).
+	 */
+	void				   markFirstNode();
+
+	/**
+	 * @brief	Scratch storage for the given ply. Valid while no other search runs.
+	 */
+	SearchPly			  &ply(int ply) { return mStack[ply]; }
+
+	SearchWorkerStatistics getStatistics() const;
+
+
+private:
+	void								  run(std::chrono::steady_clock::time_point createdAt);
+
+	Task								  mTask;
+	std::unique_ptr<SearchPly[]>		  mStack;
+
+	std::thread							  mThread;
+	std::atomic<uint32_t>				  mGeneration{0};	// Bumped once per request (the handoff signal)
+	std::atomic<bool>					  mBusy{false};
+	std::atomic<bool>					  mRunning{false};
+	std::stop_source					  mStopSource;		// Replaced per request while the worker is parked
+
+	std::chrono::steady_clock::time_point mRequestTime{};
+	bool								  mFirstNodeSeen{true};
+	SearchWorkerStatistics				  mStats;
+	mutable std::mutex					  mStatsMutex;
+};
@@ -0,0 +1,112 @@
+/*
+  ==============================================================================
+	Module:			TranspositionTable
+	Description:    Search results of visited positions keyed by the Zobrist hash
+  ==============================================================================
+*/
+
+#include "TranspositionTable.h"
+
+
+void TranspositionTable::store(uint64_t hash, int depth, int score, TranspositionEntry::NodeType type, Move bestMove)
+{
+	TranspositionEntry *bucket		= &mEntries[bucketOf(hash)];
+	TranspositionEntry *victim		= nullptr;
+	int					victimValue = 0;
+
+	for (size_t i = 0; i < BUCKET_SIZE; ++i)
+	{
+		TranspositionEntry &entry = bucket[i];
+
+		if (entry.generation != 0 && entry.hash == hash)
+		{
+			if (entry.depth > depth)
+				return; // keep deeper entry
+
+			victim = &entry;
+			break;
+		}
+
+		// Empty slots first, then the oldest search, then the shallowest entry
+		int value = entry.generation == 0 ? std::numeric_limits<int>::min() : entry.depth + (entry.generation == mGeneration ? CURRENT_SEARCH_BONUS : 0);
+
+		if (!victim || value < victimValue)
+		{
+			victim		= &entry;
+			victimValue = value;
+		}
+	}
+
+	if (victim->generation == 0)
+		++mUsed;
+
+	*victim = {hash, depth, score, type, bestMove, mGeneration};
+}
+
+
+void TranspositionTable::setCapacity(size_t entries)
+{
+	size_t buckets = std::max<size_t>((entries + BUCKET_SIZE - 1) / BUCKET_SIZE, 1);
+
+	if (buckets * BUCKET_SIZE == mEntries.size())
+		return;
+
+	mEntries.assign(buckets * BUCKET_SIZE, TranspositionEntry());
+	mUsed = 0;
+}
+
+
+void TranspositionTable::clear()
+{
+	std::fill(mEntries.begin(), mEntries.end(), TranspositionEntry());
+	mUsed		= 0;
+	mGeneration = 1;
+}
+
+
+bool TranspositionTable::probe(uint64_t hash, int depth, int alpha, int beta, int &score, Move &bestMove) const
+{
+	const TranspositionEntry *bucket = &mEntries[bucketOf(hash)];
+	const TranspositionEntry *found	 = std::find_if(bucket, bucket + BUCKET_SIZE, [hash](const TranspositionEntry &entry) { return entry.generation != 0 && entry.hash == hash; });
+
+	if (found == bucket + BUCKET_SIZE)
+		return false;
+
+	const auto &entry = *found;
+
+	// Always extract best move for ordering, even if score isn't usable
+	bestMove		  = entry.bestMove;
+
+	if (entry.depth < depth)
+		return false;
+
+	switch (entry.type)
+	{
+	case TranspositionEntry::NodeType::Exact:
+	{
+		score = entry.score;
+		return true;
+	}
+	case TranspositionEntry::NodeType::LowerBound:
+	{
+		if (entry.score >= beta)
+		{
+			score = entry.score;
+			return true;
+		}
+
+		break;
+	}
+	case TranspositionEntry::NodeType::UpperBound:
+	{
+		if (entry.score <= alpha)
+		{
+			score = entry.score;
+			return true;
+		}
+		break;
+	}
+	}
+
+	return false;
+}
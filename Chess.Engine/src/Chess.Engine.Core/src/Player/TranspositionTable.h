@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+	Module:			TranspositionTable
+	Description:    Search results of visited positions keyed by the Zobrist hash
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Move.h"
+
+
+/**
+ * @brief	Transposition table entry for search optimization.
+ */
+struct TranspositionEntry
+{
+	enum class NodeType
+	{
+		Exact,
+		LowerBound,
+		UpperBound,
+	};
+
+	uint64_t hash{};
+	int		 depth{};
+	int		 score{};
+	NodeType type{NodeType::Exact};
+	Move	 bestMove{};
+	uint8_t	 generation{}; // Search that stored the entry, 0 for an empty slot
+};
+
+
+/**
+ * @brief	Search results of visited positions, owned by one search thread.
+ *
+ * A fixed array of buckets of BUCKET_SIZE entries, a position is stored in the bucket its hash selects.
+ * A stored position keeps its deeper entry. A full bucket replaces the entry of the oldest search, the
+ * shallowest one among those, so what the table holds depends only on the stores (never on the order
+ * of a standard library container) and budgeted searches count the same nodes with every toolchain.
+ */
+class TranspositionTable
+{
+public:
+	static constexpr size_t DEFAULT_CAPACITY = 1'000'000;
+	static constexpr size_t BUCKET_SIZE		 = 4;
+	static constexpr size_t BYTES_PER_ENTRY	 = sizeof(TranspositionEntry);
+
+	TranspositionTable() { setCapacity(DEFAULT_CAPACITY); }
+
+	/**
+	 * @brief	Resize to the number of positions (rounded up to whole buckets). A new size drops every entry.
+	 */
+	void					setCapacity(size_t entries);
+
+	/**
+	 * @brief	Capacity that fits into the given memory size.
+	 */
+	[[nodiscard]] static size_t capacityForMegabytes(size_t megabytes) { return std::max<size_t>(megabytes * 1024 * 1024 / BYTES_PER_ENTRY, 1); }
+
+	void					store(uint64_t hash, int depth, int score, TranspositionEntry::NodeType type, Move bestMove);
+
+	/**
+	 * @brief	Look up the position. bestMove is set whenever the position is stored (for move ordering),
+	 *			score only if the entry is deep enough and its bound decides the (alpha, beta) window.
+	 * @return	true if score can be used as the search result.
+	 */
+	bool					probe(uint64_t hash, int depth, int alpha, int beta, int &score, Move &bestMove) const;
+
+	/**
+	 * @brief	Start a new search: the entries of earlier searches are still probed, but replaced first.
+	 */
+	void					newSearch() { mGeneration = mGeneration == UINT8_MAX ? 1 : mGeneration + 1; }
+
+	void					clear();
+
+	[[nodiscard]] size_t	size() const { return mUsed; }
+	[[nodiscard]] size_t	capacity() const { return mEntries.size(); }
+
+	/**
+	 * @brief	Table usage in permille.
+	 */
+	[[nodiscard]] int		hashFull() const { return static_cast<int>(std::min<size_t>(mUsed * 1000 / mEntries.size(), 1000)); }
+
+private:
+	// Above every depth: entries of the running search are replaced after all older ones
+	static constexpr int			CURRENT_SEARCH_BONUS = 1 << 16;
+
+	[[nodiscard]] size_t			bucketOf(uint64_t hash) const { return static_cast<size_t>(hash % (mEntries.size() / BUCKET_SIZE)) * BUCKET_SIZE; }
+
+	std::vector<TranspositionEntry> mEntries;
+	size_t							mUsed		= 0;
+	uint8_t							mGeneration = 1;
+};
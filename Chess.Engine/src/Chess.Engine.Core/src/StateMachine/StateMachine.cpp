@@ -173,6 +173,9 @@ GameState StateMachine::handleWaitingForInput(const InputEvent &event)
 	}
 	case InputEvent::Type::UndoRequested:
 	{
+		// The ponder search and its expected reply assume the current position
+		mController->resetCPUPonder();
+
 		if (mController->undoLastMove())
 		{
 			mInputSource->onMoveUndone();
@@ -182,6 +185,7 @@ GameState StateMachine::handleWaitingForInput(const InputEvent &event)
 	}
 	case InputEvent::Type::GameReset:
 	{
+		mController->resetCPUPonder();
 		mController->resetGame();
 		mMoveIntent.clear();
 		return GameState::Init;
@@ -295,6 +299,7 @@ GameState StateMachine::handleGameOver(const InputEvent &event)
 {
 	if (event.type == InputEvent::Type::GameReset)
 	{
+		mController->resetCPUPonder();
 		mController->resetGame();
 		mMoveIntent.clear();
 		mEndgameState = EndGameState::OnGoing;
@@ -322,9 +327,23 @@ void StateMachine::onStateEnter(GameState enteringState)
 {
 	switch (enteringState)
 	{
+	case GameState::WaitingForInput:
+	{
+		// Use the human's thinking time to search the expected reply (no-op if already pondering)
+		if (mIsVsCPU.load())
+			mController->startCPUPonder();
+		break;
+	}
 	case GameState::WaitingForCPUMove:
 	{
-		mController->requestCPUMoveAsync();
+		// On a ponder hit the running search already is the real search
+		if (!mController->tryCPUPonderHit(mLastExecutedMove))
+			mController->requestCPUMoveAsync();
+		break;
+	}
+	case GameState::GameOver:
+	{
+		mController->stopCPUPonder();
 		break;
 	}
 	default: break;
@@ -368,7 +387,8 @@ bool StateMachine::tryExecuteMove(Move move)
 	Side currentSide = mController->getCurrentSide();
 	mInputSource->onPlayerChanged(currentSide);
 
-	mEndgameState = mController->checkEndGame();
+	mEndgameState	  = mController->checkEndGame();
+	mLastExecutedMove = move;
 
 	mMoveIntent.clear();
 	return true;
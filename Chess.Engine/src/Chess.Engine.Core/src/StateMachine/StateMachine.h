@@ -108,6 +108,7 @@ private:
 	std::atomic<GameState> mState{GameState::Init};
 	MoveIntent			   mMoveIntent;
 	EndGameState		   mEndgameState{EndGameState::OnGoing};
+	Move				   mLastExecutedMove{}; // Needed to resolve the CPU ponder search
 
 	//=========================================================================
 	// Mode Flags
@@ -0,0 +1,767 @@
+/*
+  ==============================================================================
+	Module:         Tablebase
+	Description:    Memory-mapped Syzygy endgame tablebases (win/draw/loss and distance to zeroing)
+  ==============================================================================
+*/
+
+#include "Tablebase.h"
+
+#include <algorithm>
+#include <filesystem>
+
+#include "Chessboard.h"
+#include "GameEngine.h"
+#include "Logging.h"
+#include "TablebaseLayout.h"
+
+
+namespace
+{
+
+using namespace SyzygyFormat;
+
+constexpr int	   NO_DISTANCE	= 0xFFFF;
+
+constexpr uint64_t BARE_KINGS	= MaterialKey::unit(WKing) + MaterialKey::unit(BKing);
+
+
+inline uint64_t	   loadLE(const uint8_t *bytes, int count)
+{
+	uint64_t value = 0;
+
+	for (int i = count - 1; i >= 0; --i)
+		value = value << 8 | bytes[i];
+
+	return value;
+}
+
+
+inline uint64_t loadBE(const uint8_t *bytes, int count)
+{
+	uint64_t value = 0;
+
+	for (int i = 0; i < count; ++i)
+		value = value << 8 | bytes[i];
+
+	return value;
+}
+
+
+/**
+ * @brief	Symbols of a pair tree entry: 12 bits each, left first.
+ */
+inline int leftSymbol(const uint8_t *tree, int symbol)
+{
+	const uint8_t *entry = tree + 3 * symbol;
+	return (entry[1] & 0xF) << 8 | entry[0];
+}
+
+
+inline int rightSymbol(const uint8_t *tree, int symbol)
+{
+	const uint8_t *entry = tree + 3 * symbol;
+	return entry[2] << 4 | entry[1] >> 4;
+}
+
+
+/**
+ * @brief	Count the values a symbol expands to (minus one), its pairs first.
+ * @return	false if the tree refers to a symbol it doesn't have.
+ */
+bool setSymbolLength(const uint8_t *tree, std::vector<uint8_t> &lengths, std::vector<bool> &visited, int symbol)
+{
+	visited[symbol] = true;
+	int right		= rightSymbol(tree, symbol);
+
+	if (right == LEAF)
+		return true;
+
+	int left  = leftSymbol(tree, symbol);
+	int count = static_cast<int>(lengths.size());
+
+	if (left >= count || right >= count)
+		return false;
+
+	if ((!visited[left] && !setSymbolLength(tree, lengths, visited, left)) || (!visited[right] && !setSymbolLength(tree, lengths, visited, right)))
+		return false;
+
+	lengths[symbol] = static_cast<uint8_t>(lengths[left] + lengths[right] + 1);
+	return true;
+}
+
+
+inline Wdl negate(Wdl wdl)
+{
+	return static_cast<Wdl>(-static_cast<int>(wdl));
+}
+
+
+inline int signOf(Wdl wdl)
+{
+	return wdl > Wdl::Draw ? 1 : -1;
+}
+
+
+inline int signOf(int value)
+{
+	return (value > 0) - (value < 0);
+}
+
+
+/**
+ * @brief	Distance of a position whose best move zeroes, signed by the result.
+ */
+int zeroingDistance(Wdl wdl)
+{
+	switch (wdl)
+	{
+	case Wdl::Win: return 1;
+	case Wdl::CursedWin: return 101;
+	case Wdl::BlessedLoss: return -101;
+	case Wdl::Loss: return -1;
+	default: return 0;
+	}
+}
+
+
+bool isPawn(PieceType piece)
+{
+	return piece == PieceType::WPawn || piece == PieceType::BPawn;
+}
+
+
+/**
+ * @brief	Whether the pieces of a sub-table are the material of its table.
+ */
+bool matchesMaterial(const TablebaseIndex &index, const TablebaseIndex::Groups &groups)
+{
+	uint64_t key = 0;
+
+	for (int i = 0; i < index.pieceCount(); ++i)
+	{
+		PieceType type = TablebaseIndex::pieceType(groups.pieces[i]);
+
+		if (type == PieceType::None)
+			return false;
+
+		key += MaterialKey::unit(type);
+	}
+
+	return key == index.materialKey() && (!index.hasPawns() || (groups.pieces[0] & 7) == TablebaseIndex::Pawn);
+}
+
+
+/**
+ * @brief	Map a table file and check its magic and size.
+ */
+bool openTableFile(MappedFile &file, const std::string &path, const uint8_t *magic)
+{
+	if (!file.open(path))
+		return false;
+
+	if (file.size() % 64 != 16 || !std::equal(magic, magic + MAGIC_SIZE, reinterpret_cast<const uint8_t *>(file.data())))
+	{
+		LOG_ERROR("{} is no valid Syzygy table file", path);
+		file.close();
+		return false;
+	}
+
+	return true;
+}
+
+} // namespace
+
+
+bool Tablebase::open(const std::string &directory)
+{
+	close();
+
+	std::error_code error;
+
+	if (!std::filesystem::is_directory(directory, error))
+	{
+		LOG_ERROR("Tablebase directory {} not found", directory);
+		return false;
+	}
+
+	for (const auto &item : std::filesystem::directory_iterator(directory, error))
+	{
+		const std::filesystem::path &path = item.path();
+
+		if (path.extension() != WDL_EXTENSION)
+			continue;
+
+		std::string code = path.stem().string();
+		uint64_t	key	 = MaterialKey::fromCode(code);
+
+		if (!TablebaseLayout::isValid(key) || TablebaseLayout(key).code() != code)
+		{
+			LOG_WARNING("Skipping {}: {} is no material code of a table with up to {} pieces", path.string(), code, TablebaseIndex::MAX_PIECES);
+			continue;
+		}
+
+		Table table;
+		table.index = TablebaseIndex(key);
+
+		if (!openTableFile(table.wdl, path.string(), WDL_MAGIC))
+			continue;
+
+		if (!parse(table, false))
+		{
+			LOG_ERROR("{} doesn't hold the tables of {}", path.string(), code);
+			continue;
+		}
+
+		// Without its distance file a table still answers win/draw/loss probes
+		std::filesystem::path dtzPath = std::filesystem::path(path).replace_extension(DTZ_EXTENSION);
+
+		if (std::filesystem::exists(dtzPath, error) && openTableFile(table.dtz, dtzPath.string(), DTZ_MAGIC) && !parse(table, true))
+		{
+			LOG_ERROR("{} doesn't hold the distances of {}", dtzPath.string(), code);
+			table.dtz.close();
+		}
+
+		mMaxPieces = std::max(mMaxPieces, table.index.pieceCount());
+		mTables.push_back(std::move(table));
+	}
+
+	if (mTables.empty())
+	{
+		LOG_ERROR("No tablebase files in {}", directory);
+		return false;
+	}
+
+	std::sort(mTables.begin(), mTables.end(), [](const Table &a, const Table &b) { return a.index.materialKey() < b.index.materialKey(); });
+
+	LOG_INFO("Tablebases: {} tables with up to {} pieces in {}", mTables.size(), mMaxPieces, directory);
+	return true;
+}
+
+
+void Tablebase::close()
+{
+	mTables.clear();
+	mMaxPieces = 0;
+}
+
+
+bool Tablebase::hasTable(uint64_t materialKey) const
+{
+	bool flip = false;
+	return find(materialKey, flip) != nullptr;
+}
+
+
+int Tablebase::pieceCount(const Chessboard &board)
+{
+	return BitUtils::popCount(board.occ()[to_index(Side::Both)]);
+}
+
+
+bool Tablebase::probeWDL(GameEngine &position, Wdl &wdl) const
+{
+	const Chessboard &board = position.getBoard();
+
+	if (!isProbeable(board) || (board.getMaterialKey() != BARE_KINGS && !hasTable(board.getMaterialKey())))
+		return false;
+
+	ProbeState state = ProbeState::Ok;
+	wdl				 = search(position, false, state);
+	return state != ProbeState::Fail;
+}
+
+
+bool Tablebase::probeDTZ(GameEngine &position, Wdl &wdl, int &dtz) const
+{
+	const Chessboard &board = position.getBoard();
+
+	if (!isProbeable(board) || (board.getMaterialKey() != BARE_KINGS && !hasTable(board.getMaterialKey())))
+		return false;
+
+	ProbeState state	= ProbeState::Ok;
+	int		   distance = probeDistance(position, wdl, state);
+
+	if (state == ProbeState::Fail)
+		return false;
+
+	dtz = std::abs(distance);
+	return true;
+}
+
+
+bool Tablebase::probeWDL(const Bitboards &pieces, Side side, Wdl &wdl) const
+{
+	ProbeState state = ProbeState::Ok;
+	int		   value = probeTable(pieces, side, TablebaseLayout::keyOf(pieces), false, Wdl::Draw, state);
+
+	if (state == ProbeState::Fail)
+		return false;
+
+	wdl = static_cast<Wdl>(value);
+	return true;
+}
+
+
+const Tablebase::Table *Tablebase::find(uint64_t materialKey, bool &flip) const
+{
+	auto lookup = [this](uint64_t key) -> const Table *
+	{
+		auto it = std::lower_bound(mTables.begin(), mTables.end(), key, [](const Table &table, uint64_t value) { return table.index.materialKey() < value; });
+		return it != mTables.end() && it->index.materialKey() == key ? &*it : nullptr;
+	};
+
+	flip				= false;
+	const Table *direct = lookup(materialKey);
+
+	if (direct)
+		return direct;
+
+	flip = true;
+	return lookup(MaterialKey::mirror(materialKey));
+}
+
+
+bool Tablebase::parse(Table &table, bool distance)
+{
+	const MappedFile	 &file		= distance ? table.dtz : table.wdl;
+	const TablebaseIndex &index		= table.index;
+	const uint8_t		 *begin		= reinterpret_cast<const uint8_t *>(file.data());
+	const uint8_t		 *end		= begin + file.size();
+	const uint8_t		 *data		= begin + MAGIC_SIZE;
+
+	int					  sides		= !distance && !index.isSymmetric() ? 2 : 1;
+	int					  files		= index.files();
+	int					  bothPawns = index.hasPawns() && index.pawnCount(1) > 0 ? 1 : 0;
+
+	auto				  fits		= [&](uint64_t bytes) { return data <= end && static_cast<uint64_t>(end - data) >= bytes; };
+	auto				  align		= [&](int alignment) { data = begin + (data - begin + alignment - 1) / alignment * alignment; };
+	auto				  subTable	= [&](int side, int f) -> SubTable & { return distance ? table.dtzTables[f] : table.wdlTables[side][f]; };
+
+	if (!fits(1) || ((*data & HAS_PAWNS) != 0) != index.hasPawns() || ((*data & SPLIT) != 0) == index.isSymmetric())
+		return false;
+
+	++data;
+
+	// Per file: the position of the leading group (and of the other pawns) in the index, then the pieces in index order
+	for (int f = 0; f < files; ++f)
+	{
+		if (!fits(1 + bothPawns + index.pieceCount()))
+			return false;
+
+		int order[2][2] = {{data[0] & 0xF, bothPawns ? data[1] & 0xF : 0xF}, {data[0] >> 4, bothPawns ? data[1] >> 4 : 0xF}};
+		data += 1 + bothPawns;
+
+		for (int k = 0; k < index.pieceCount(); ++k, ++data)
+		{
+			for (int side = 0; side < sides; ++side)
+				subTable(side, f).groups.pieces[k] = side ? *data >> 4 : *data & 0xF;
+		}
+
+		for (int side = 0; side < sides; ++side)
+		{
+			SubTable &sub = subTable(side, f);
+
+			if (!matchesMaterial(index, sub.groups) || !index.setGroups(sub.groups, order[side][0], order[side][1], f))
+				return false;
+		}
+	}
+
+	align(2);
+
+	// Huffman code of every sub-table
+	for (int f = 0; f < files; ++f)
+	{
+		for (int side = 0; side < sides; ++side)
+		{
+			SubTable &sub = subTable(side, f);
+
+			if (!fits(2))
+				return false;
+
+			sub.flags = *data++;
+
+			if (sub.flags & SINGLE_VALUE)
+			{
+				sub.minSymbolLength = *data++;
+				continue;
+			}
+
+			if (!fits(9) || data[0] > 31 || data[1] > 31)
+				return false;
+
+			sub.blockSize		= 1ULL << data[0];
+			sub.span			= 1ULL << data[1];
+			sub.sparseCount		= (sub.groups.size() + sub.span - 1) / sub.span;
+			sub.blockCount		= static_cast<uint32_t>(loadLE(data + 3, 4));
+			sub.lengthCount		= sub.blockCount + data[2]; // Padded so the sparse index can't point past the end
+			sub.maxSymbolLength = data[7];
+			sub.minSymbolLength = data[8];
+			data += 9;
+
+			if (sub.minSymbolLength < 1 || sub.maxSymbolLength < sub.minSymbolLength || sub.maxSymbolLength > 32)
+				return false;
+
+			size_t lengths = sub.maxSymbolLength - sub.minSymbolLength + 1;
+
+			if (!fits(2 * lengths + 2))
+				return false;
+
+			// Longer codes have lower symbols: the codes of a length start where the longer ones end
+			sub.lowestSymbols = data;
+			sub.base.assign(lengths, 0);
+
+			for (int i = static_cast<int>(lengths) - 2; i >= 0; --i)
+				sub.base[i] = (sub.base[i + 1] + loadLE(data + 2 * i, 2) - loadLE(data + 2 * (i + 1), 2)) / 2;
+
+			for (size_t i = 0; i < lengths; ++i)
+				sub.base[i] <<= 64 - i - sub.minSymbolLength;
+
+			data += 2 * lengths;
+
+			size_t symbols = loadLE(data, 2);
+			data += 2;
+
+			if (!fits(3 * symbols + (symbols & 1)))
+				return false;
+
+			sub.tree = data;
+			sub.symbolLengths.assign(symbols, 0);
+			std::vector<bool> visited(symbols);
+
+			for (size_t symbol = 0; symbol < symbols; ++symbol)
+			{
+				if (!visited[symbol] && !setSymbolLength(sub.tree, sub.symbolLengths, visited, static_cast<int>(symbol)))
+					return false;
+			}
+
+			data += 3 * symbols + (symbols & 1);
+		}
+	}
+
+	// Distance maps by result, for sub-tables that don't store distances directly
+	if (distance)
+	{
+		table.dtzMap = data;
+
+		for (int f = 0; f < files; ++f)
+		{
+			SubTable &sub = table.dtzTables[f];
+
+			if (!(sub.flags & MAPPED))
+				continue;
+
+			if (sub.flags & WIDE)
+				align(2);
+
+			for (int i = 0; i < 4; ++i)
+			{
+				if (!fits(2))
+					return false;
+
+				if (sub.flags & WIDE)
+				{
+					sub.mapIndex[i] = static_cast<uint16_t>((data - table.dtzMap) / 2 + 1);
+					data += 2 * loadLE(data, 2) + 2;
+				}
+				else
+				{
+					sub.mapIndex[i] = static_cast<uint16_t>(data - table.dtzMap + 1);
+					data += *data + 1;
+				}
+			}
+		}
+
+		align(2);
+	}
+
+	for (int f = 0; f < files; ++f)
+	{
+		for (int side = 0; side < sides; ++side)
+		{
+			SubTable &sub	= subTable(side, f);
+			sub.sparseIndex = data;
+			data += 6 * sub.sparseCount;
+		}
+	}
+
+	for (int f = 0; f < files; ++f)
+	{
+		for (int side = 0; side < sides; ++side)
+		{
+			SubTable &sub	 = subTable(side, f);
+			sub.blockLengths = data;
+			data += 2 * sub.lengthCount;
+		}
+	}
+
+	for (int f = 0; f < files; ++f)
+	{
+		for (int side = 0; side < sides; ++side)
+		{
+			SubTable &sub = subTable(side, f);
+			align(64);
+
+			if (!fits(0))
+				return false;
+
+			sub.data = data;
+			data += sub.blockCount * sub.blockSize;
+		}
+	}
+
+	return fits(0);
+}
+
+
+int Tablebase::probeTable(const Bitboards &pieces, Side side, uint64_t materialKey, bool distance, Wdl wdl, ProbeState &state) const
+{
+	// A draw, and no distance
+	if (materialKey == BARE_KINGS)
+		return 0;
+
+	bool		 flip  = false;
+	const Table *table = find(materialKey, flip);
+
+	if (!table || (distance && !table->dtz.isOpen()))
+	{
+		state = ProbeState::Fail;
+		return 0;
+	}
+
+	// Symmetric tables store white to move only, black to move is read with the colours swapped
+	bool					  swap		= flip || (table->index.isSymmetric() && side == Side::Black);
+	int						  stm		= (swap ? 1 : 0) ^ to_index(side);
+
+	const SubTable			 &first		= distance ? table->dtzTables[0] : table->wdlTables[0][0];
+	TablebaseIndex::Placement placement = table->index.place(pieces, swap, first.groups.pieces[0]);
+	const SubTable			 &sub		= distance ? table->dtzTables[placement.file] : table->wdlTables[stm][placement.file];
+
+	if (distance && (sub.flags & STM) != stm && !(table->index.isSymmetric() && !table->index.hasPawns()))
+	{
+		state = ProbeState::ChangeSide;
+		return 0;
+	}
+
+	int value = decompress(sub, table->index.index(sub.groups, placement));
+
+	if (!distance)
+		return value - 2;
+
+	if (sub.flags & MAPPED)
+	{
+		// Map offsets by result: win, loss, cursed win, blessed loss
+		constexpr int MAP_OF_WDL[] = {1, 3, 0, 2, 0};
+		int			  at		   = sub.mapIndex[MAP_OF_WDL[static_cast<int>(wdl) + 2]] + value;
+		value					   = static_cast<int>(sub.flags & WIDE ? loadLE(table->dtzMap + 2 * at, 2) : table->dtzMap[at]);
+	}
+
+	// Distances stored in moves are rounded to the ply before the zeroing move
+	if ((wdl == Wdl::Win && !(sub.flags & WIN_PLIES)) || (wdl == Wdl::Loss && !(sub.flags & LOSS_PLIES)) || wdl == Wdl::CursedWin || wdl == Wdl::BlessedLoss)
+		value *= 2;
+
+	return value + 1;
+}
+
+
+Wdl Tablebase::search(GameEngine &position, bool zeroing, ProbeState &state) const
+{
+	const Chessboard &board = position.getBoard();
+	MoveList		  moves;
+	position.generateLegalMoves(moves);
+
+	Wdl	   best		= Wdl::Loss;
+	size_t searched = 0;
+
+	for (Move move : moves)
+	{
+		if (!move.isCapture() && !(zeroing && isPawn(board.pieceAt(move.from()))))
+			continue;
+
+		++searched;
+
+		position.makeMoveUnchecked(move);
+		Wdl value = negate(search(position, false, state));
+		position.undoMoveUnchecked();
+
+		if (state == ProbeState::Fail)
+			return Wdl::Draw;
+
+		if (value > best)
+		{
+			best = value;
+
+			if (value >= Wdl::Win)
+			{
+				state = ProbeState::Zeroing;
+				return value;
+			}
+		}
+	}
+
+	// With every move searched the stored value isn't needed (it's no answer to en passant and only captures)
+	bool noMoreMoves = searched > 0 && searched == moves.size();
+	Wdl	 value		 = best;
+
+	if (!noMoreMoves)
+	{
+		value = static_cast<Wdl>(probeTable(board.pieces(), board.getCurrentSide(), board.getMaterialKey(), false, Wdl::Draw, state));
+
+		if (state == ProbeState::Fail)
+			return Wdl::Draw;
+	}
+
+	// Where a capture wins the table may store anything
+	if (best >= value)
+	{
+		state = best > Wdl::Draw || noMoreMoves ? ProbeState::Zeroing : ProbeState::Ok;
+		return best;
+	}
+
+	state = ProbeState::Ok;
+	return value;
+}
+
+
+int Tablebase::probeDistance(GameEngine &position, Wdl &wdl, ProbeState &state) const
+{
+	state = ProbeState::Ok;
+	wdl	  = search(position, true, state);
+
+	if (state == ProbeState::Fail || wdl == Wdl::Draw)
+		return 0;
+
+	if (state == ProbeState::Zeroing)
+		return zeroingDistance(wdl);
+
+	const Chessboard &board = position.getBoard();
+	int				  dtz	= probeTable(board.pieces(), board.getCurrentSide(), board.getMaterialKey(), true, wdl, state);
+
+	if (state == ProbeState::Fail)
+		return 0;
+
+	if (state != ProbeState::ChangeSide)
+		return (dtz + (wdl == Wdl::CursedWin || wdl == Wdl::BlessedLoss ? 100 : 0)) * signOf(wdl);
+
+	// The file stores the other side to move: one ply more than the best reply
+	int		 best = NO_DISTANCE;
+	MoveList moves;
+	position.generateLegalMoves(moves);
+
+	for (Move move : moves)
+	{
+		bool zeroingMove = move.isCapture() || isPawn(board.pieceAt(move.from()));
+		Wdl	 reply		 = Wdl::Draw;
+
+		position.makeMoveUnchecked(move);
+
+		if (zeroingMove)
+		{
+			state = ProbeState::Ok;
+			dtz	  = -zeroingDistance(search(position, false, state));
+		}
+		else
+		{
+			dtz = -probeDistance(position, reply, state);
+		}
+
+		// A mate is one ply from zeroing, not two
+		if (dtz == 1 && state != ProbeState::Fail && position.isCheckmate())
+			best = 1;
+
+		if (!zeroingMove)
+			dtz += signOf(dtz);
+
+		if (dtz < best && signOf(dtz) == signOf(wdl))
+			best = dtz;
+
+		position.undoMoveUnchecked();
+
+		if (state == ProbeState::Fail)
+			return 0;
+	}
+
+	// Without legal moves the position is mate
+	return best == NO_DISTANCE ? -1 : best;
+}
+
+
+int Tablebase::decompress(const SubTable &table, uint64_t index)
+{
+	if (table.flags & SINGLE_VALUE)
+		return table.minSymbolLength;
+
+	// The sparse entry names block and offset of the value in the middle of its span, walk from there
+	const uint8_t *entry  = table.sparseIndex + 6 * (index / table.span);
+	uint32_t	   block  = static_cast<uint32_t>(loadLE(entry, 4));
+	int			   offset = static_cast<int>(loadLE(entry + 4, 2)) + static_cast<int>(index % table.span) - static_cast<int>(table.span / 2);
+
+	auto		   blockLength = [&table](uint32_t at) { return static_cast<int>(loadLE(table.blockLengths + 2 * at, 2)); };
+
+	while (offset < 0)
+		offset += blockLength(--block) + 1;
+
+	while (offset > blockLength(block))
+		offset -= blockLength(block++) + 1;
+
+	// Canonical Huffman codes, read big endian through a 64 bit window refilled by 32 bits
+	const uint8_t *pointer	  = table.data + block * table.blockSize;
+	uint64_t	   buffer	  = loadBE(pointer, 8);
+	int			   bufferSize = 64;
+	int			   symbol	  = 0;
+	pointer += 8;
+
+	while (true)
+	{
+		size_t length = 0;
+
+		while (buffer < table.base[length])
+			++length;
+
+		symbol = static_cast<int>((buffer - table.base[length]) >> (64 - length - table.minSymbolLength));
+		symbol += static_cast<int>(loadLE(table.lowestSymbols + 2 * length, 2));
+
+		if (symbol >= static_cast<int>(table.symbolLengths.size()))
+			return 0;
+
+		if (offset < table.symbolLengths[symbol] + 1)
+			break;
+
+		offset -= table.symbolLengths[symbol] + 1;
+
+		int bits = static_cast<int>(length) + table.minSymbolLength;
+		buffer <<= bits;
+		bufferSize -= bits;
+
+		if (bufferSize <= 32)
+		{
+			bufferSize += 32;
+			buffer |= loadBE(pointer, 4) << (64 - bufferSize);
+			pointer += 4;
+		}
+	}
+
+	// A symbol stands for a pair of symbols until it reaches a single value
+	while (table.symbolLengths[symbol])
+	{
+		int left = leftSymbol(table.tree, symbol);
+
+		if (offset < table.symbolLengths[left] + 1)
+		{
+			symbol = left;
+		}
+		else
+		{
+			offset -= table.symbolLengths[left] + 1;
+			symbol = rightSymbol(table.tree, symbol);
+		}
+	}
+
+	return leftSymbol(table.tree, symbol);
+}
+
+
+bool Tablebase::isProbeable(const Chessboard &board)
+{
+	return board.getCurrentCastlingRights() == Castling::None;
+}
@@ -0,0 +1,174 @@
+/*
+  ==============================================================================
+	Module:         Tablebase
+	Description:    Memory-mapped Syzygy endgame tablebases (win/draw/loss and distance to zeroing)
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+#include "TablebaseIndex.h"
+
+class Chessboard;
+class GameEngine;
+
+
+/**
+ * @brief	Game theoretic result from the view of the side to move. Cursed wins and blessed losses
+ *			are decided only without the 50 move rule: the next zeroing move is more than 100 plies away.
+ */
+enum class Wdl : int8_t
+{
+	Loss		= -2,
+	BlessedLoss = -1,
+	Draw		= 0,
+	CursedWin	= 1,
+	Win			= 2
+};
+
+
+/**
+ * @brief	Syzygy endgame tables of a directory, one file pair per material signature named by its code:
+ *			KQvK.rtbw holds the win/draw/loss of every position, KQvK.rtbz the distance to the next zeroing
+ *			move (capture or pawn move) for one side to move. The files are Huffman compressed in blocks and
+ *			mapped read-only, so only the blocks the search touches are ever loaded.
+ *
+ * The files store no en passant squares and may hold any value where a capture is the best move, so a
+ * probe first tries the captures of the position (a 1-ply search, also for the side the distance file
+ * doesn't store). Positions with castling rights are not probed.
+ */
+class Tablebase
+{
+public:
+	static constexpr std::string_view WDL_EXTENSION = ".rtbw";
+	static constexpr std::string_view DTZ_EXTENSION = ".rtbz";
+
+	using Bitboards									= TablebaseIndex::Bitboards;
+
+	/**
+	 * @brief	Map every table of the directory, replacing the tables opened before.
+	 * @return	false (logged) if the directory holds no valid table.
+	 */
+	bool						  open(const std::string &directory);
+
+	void						  close();
+
+	[[nodiscard]] bool			  isOpen() const { return !mTables.empty(); }
+	[[nodiscard]] size_t		  tableCount() const { return mTables.size(); }
+
+	/**
+	 * @brief	Whether a table for the material (or the material with colours swapped) is open.
+	 */
+	[[nodiscard]] bool			  hasTable(uint64_t materialKey) const;
+
+	/**
+	 * @brief	Most pieces of any opened table (0 if none is open).
+	 */
+	[[nodiscard]] int			  maxPieces() const { return mMaxPieces; }
+
+	/**
+	 * @brief	Number of pieces on the board (kings included).
+	 */
+	[[nodiscard]] static int	  pieceCount(const Chessboard &board);
+
+	/**
+	 * @brief	Probe the position of the engine. Captures are tried with makeMoveUnchecked and undone again.
+	 * @return	false if a table is missing or the position can't be probed.
+	 */
+	bool						  probeWDL(GameEngine &position, Wdl &wdl) const;
+
+	/**
+	 * @param	dtz		Plies to the next zeroing move with best play (1 for mated positions, 0 for draws).
+	 *					Beyond 100 plies, with a cursed win or blessed loss, it may be one ply too high.
+	 */
+	bool						  probeDTZ(GameEngine &position, Wdl &wdl, int &dtz) const;
+
+	/**
+	 * @brief	Read the stored result of a position given by its pieces, without trying its captures.
+	 *			Exact only where a capture is not the best move. Bare kings are a draw without a table.
+	 */
+	bool						  probeWDL(const Bitboards &pieces, Side side, Wdl &wdl) const;
+
+private:
+	/**
+	 * @brief	One compressed sub-table: a side to move and a file of the leading pawn.
+	 */
+	struct SubTable
+	{
+		TablebaseIndex::Groups	groups;
+		uint8_t					flags		 = 0;
+		uint64_t				blockSize	 = 0;
+		uint64_t				span		 = 0; // Values per sparse index entry
+		uint32_t				blockCount	 = 0;
+		size_t					sparseCount	 = 0;
+		size_t					lengthCount	 = 0; // Block lengths, including padding
+		int						minSymbolLength = 0; // The value itself if the sub-table holds only one
+		int						maxSymbolLength = 0;
+		const uint8_t		   *lowestSymbols = nullptr;
+		const uint8_t		   *tree		  = nullptr;
+		const uint8_t		   *sparseIndex	  = nullptr;
+		const uint8_t		   *blockLengths  = nullptr;
+		const uint8_t		   *data		  = nullptr;
+		std::vector<uint64_t>	base;			   // Lowest code of each symbol length, left aligned
+		std::vector<uint8_t>	symbolLengths;	   // Values a symbol stands for, minus one
+		std::array<uint16_t, 4> mapIndex{};		   // Distance map offsets by result
+	};
+
+	struct Table
+	{
+		TablebaseIndex									   index;
+		MappedFile										   wdl;
+		MappedFile										   dtz;
+		std::array<std::array<SubTable, TablebaseIndex::FILES>, 2> wdlTables; // By side to move and file
+		std::array<SubTable, TablebaseIndex::FILES>		   dtzTables;
+		const uint8_t									  *dtzMap = nullptr;
+	};
+
+	enum class ProbeState
+	{
+		Fail,
+		Ok,
+		ChangeSide, // The distance file stores the other side to move
+		Zeroing		// The best move is a capture or pawn move
+	};
+
+	/**
+	 * @brief	Table of the material, directly or with colours swapped (flip).
+	 */
+	const Table					 *find(uint64_t materialKey, bool &flip) const;
+
+	/**
+	 * @brief	Parse the header of a mapped file into its sub-tables.
+	 * @return	false if the file is no valid table of its material.
+	 */
+	static bool					  parse(Table &table, bool distance);
+
+	/**
+	 * @brief	Stored value of a position: a Wdl value, or with distance the plies to zeroing.
+	 */
+	int							  probeTable(const Bitboards &pieces, Side side, uint64_t materialKey, bool distance, Wdl wdl, ProbeState &state) const;
+
+	/**
+	 * @brief	Best result of the captures (and with zeroing of the pawn moves) or of the stored value.
+	 */
+	Wdl							  search(GameEngine &position, bool zeroing, ProbeState &state) const;
+
+	int							  probeDistance(GameEngine &position, Wdl &wdl, ProbeState &state) const;
+
+	static int					  decompress(const SubTable &table, uint64_t index);
+
+	/**
+	 * @brief	Whether the board can be probed: no castling rights.
+	 */
+	static bool					  isProbeable(const Chessboard &board);
+
+	std::vector<Table>			  mTables; // Sorted by material key
+	int							  mMaxPieces = 0;
+};
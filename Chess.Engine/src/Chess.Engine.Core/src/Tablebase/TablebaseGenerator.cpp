@@ -0,0 +1,789 @@
+/*
+  ==============================================================================
+	Module:         TablebaseGenerator
+	Description:    Retrograde generation of endgame tables
+  ==============================================================================
+*/
+
+#include "TablebaseGenerator.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "AttackTables.h"
+#include "Logging.h"
+#include "MaterialKey.h"
+#include "Tablebase.h"
+#include "TablebaseWriter.h"
+
+
+namespace
+{
+
+using Bitboards = TablebaseLayout::Bitboards;
+
+constexpr uint64_t BARE_KINGS		  = MaterialKey::unit(WKing) + MaterialKey::unit(BKing);
+constexpr int	   FIFTY_MOVE_PLIES = 100;
+
+
+enum State : uint8_t
+{
+	Invalid,
+	Unknown,
+	Won,
+	Lost,
+	Drawn
+};
+
+
+enum class MoveKind
+{
+	Quiet,		// Reversible piece move inside the table
+	Push,		// Pawn push inside the table
+	DoublePush, // Pawn push by two squares, may allow an en passant capture
+	Exit		// Capture or promotion into a smaller table
+};
+
+
+/**
+ * @brief	A position reached by a move (or an unmade move).
+ */
+struct Successor
+{
+	Bitboards pieces{};
+	MoveKind  kind		   = MoveKind::Quiet;
+	bool	  captures	   = false;		// The move takes a piece
+	bool	  enPassant	   = false;		// A legal en passant capture answers the double push
+	Wdl		  capture	   = Wdl::Loss; // Best result of the en passant captures for the capturing side
+};
+
+
+inline Side other(Side side)
+{
+	return side == Side::White ? Side::Black : Side::White;
+}
+
+
+inline int firstType(Side side)
+{
+	return side == Side::White ? WKing : BKing;
+}
+
+
+inline Wdl negate(Wdl wdl)
+{
+	return static_cast<Wdl>(-static_cast<int>(wdl));
+}
+
+
+/**
+ * @brief	Result without the 50 move rule: cursed wins are wins, blessed losses losses.
+ */
+inline Wdl decided(Wdl wdl)
+{
+	return wdl == Wdl::CursedWin ? Wdl::Win : wdl == Wdl::BlessedLoss ? Wdl::Loss : wdl;
+}
+
+
+U64 occupancy(const Bitboards &pieces, Side side)
+{
+	U64 occupied = 0;
+
+	for (int type = firstType(side); type < firstType(side) + 6; ++type)
+		occupied |= pieces[type];
+
+	return occupied;
+}
+
+
+/**
+ * @param	offset	Piece type of white (the colour is only needed for pawns).
+ */
+U64 attacksFrom(int offset, Side side, int square, U64 occupied)
+{
+	const AttackTables &tables = AttackTables::instance();
+	Square				sq	   = static_cast<Square>(square);
+
+	switch (offset)
+	{
+	case WKing: return tables.kingAttacks(sq);
+	case WQueen: return tables.queenAttacks(sq, occupied);
+	case WPawn: return tables.pawnAttacks(side, sq);
+	case WKnight: return tables.knightAttacks(sq);
+	case WBishop: return tables.bishopAttacks(sq, occupied);
+	default: return tables.rookAttacks(sq, occupied);
+	}
+}
+
+
+bool inCheck(const Bitboards &pieces, Side side)
+{
+	const AttackTables &tables	 = AttackTables::instance();
+	Side				attacker = other(side);
+	int					first	 = firstType(attacker);
+	U64					occupied = occupancy(pieces, Side::White) | occupancy(pieces, Side::Black);
+	Square				king	 = static_cast<Square>(BitUtils::lsb(pieces[firstType(side)]));
+
+	return (tables.pawnAttacks(side, king) & pieces[first + WPawn]) || (tables.knightAttacks(king) & pieces[first + WKnight])
+		|| (tables.kingAttacks(king) & pieces[first + WKing]) || (tables.bishopAttacks(king, occupied) & (pieces[first + WBishop] | pieces[first + WQueen]))
+		|| (tables.rookAttacks(king, occupied) & (pieces[first + WRook] | pieces[first + WQueen]));
+}
+
+
+inline int row(int square)
+{
+	return square >> 3;
+}
+
+
+/**
+ * @brief	Sort the indices and drop the duplicates.
+ */
+void makeDistinct(std::vector<size_t> &indices)
+{
+	std::sort(indices.begin(), indices.end());
+	indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+}
+
+
+class Generator
+{
+public:
+	Generator(const TablebaseLayout &layout, const Tablebase &subTables) : mLayout(layout), mSubTables(subTables) {}
+
+	bool run(TablebaseGenerationResult &result, std::vector<Wdl> &wdl, std::vector<uint16_t> &dtz);
+
+private:
+	/**
+	 * @brief	Call visit(successor) for every legal move of side.
+	 * @param	enPassant	Whether to judge the en passant answers of double pushes.
+	 */
+	template <typename Visit>
+	void forEachMove(const Bitboards &pieces, Side side, bool enPassant, Visit &&visit);
+
+	/**
+	 * @brief	Call visit(predecessor) for every position from which mover reaches the position with a move inside the
+	 *			table (pawn pushes only if withPawns). Predecessors are legal: the side to move after the move is not in check.
+	 */
+	template <typename Visit>
+	void forEachUnmove(const Bitboards &pieces, Side mover, bool withPawns, Visit &&visit);
+
+	/**
+	 * @brief	Result of a move into a smaller table for the side to move after it, without the 50 move rule.
+	 *			Tables may store anything where a capture is best, so the captures are tried like a probe does.
+	 */
+	Wdl	 probeExit(const Bitboards &pieces, Side side);
+
+	/**
+	 * @brief	Fill in the en passant captures the double push of the pawn to square allows.
+	 */
+	void evaluateEnPassant(Successor &successor, Side pusher, int square);
+
+	/**
+	 * @brief	Result of a position inside the table for its side to move (after classification).
+	 */
+	Wdl	 resultOf(size_t index) const { return mStates[index] == Won ? Wdl::Win : mStates[index] == Lost ? Wdl::Loss : Wdl::Draw; }
+
+	void classify(size_t index, const Bitboards &pieces, Side side);
+	void propagate(size_t index);
+	bool computeDistances(TablebaseGenerationResult &result);
+
+	const TablebaseLayout &mLayout;
+	const Tablebase		  &mSubTables;
+	bool				   mMissingTable = false;
+
+	std::vector<uint8_t>   mStates;
+	std::vector<uint8_t>   mCounters; // Successors not yet known to lose (plus one if a move draws)
+	std::vector<size_t>	   mQueue;
+
+	// Neighbours of one position: moves that are mirror images of each other reach the same index,
+	// so positions are counted and visited once per index, not once per move
+	std::vector<size_t>	   mNeighbours;
+	std::vector<int16_t>   mDistances;
+};
+
+
+template <typename Visit>
+void Generator::forEachMove(const Bitboards &pieces, Side side, bool enPassant, Visit &&visit)
+{
+	U64 own		 = occupancy(pieces, side);
+	U64 enemy	 = occupancy(pieces, other(side));
+	U64 occupied = own | enemy;
+	int first	 = firstType(side);
+
+	auto emit	 = [&](int type, int from, int to, int placed, MoveKind kind)
+	{
+		Successor successor;
+		successor.pieces = pieces;
+		successor.kind	 = kind;
+
+		U64 target		 = 1ULL << to;
+
+		if (enemy & target)
+		{
+			for (int captured = firstType(other(side)); captured < firstType(other(side)) + 6; ++captured)
+				successor.pieces[captured] &= ~target;
+
+			successor.kind	   = MoveKind::Exit;
+			successor.captures = true;
+		}
+
+		successor.pieces[type] &= ~(1ULL << from);
+		successor.pieces[placed] |= target;
+
+		if (inCheck(successor.pieces, side))
+			return;
+
+		if (kind == MoveKind::DoublePush && enPassant)
+			evaluateEnPassant(successor, side, to);
+
+		visit(successor);
+	};
+
+	for (int offset = WKing; offset <= WRook; ++offset)
+	{
+		int type = first + offset;
+
+		for (U64 pieceBB = pieces[type]; pieceBB; pieceBB &= pieceBB - 1)
+		{
+			int from = BitUtils::lsb(pieceBB);
+
+			if (offset != WPawn)
+			{
+				for (U64 targets = attacksFrom(offset, side, from, occupied) & ~own; targets; targets &= targets - 1)
+					emit(type, from, BitUtils::lsb(targets), type, MoveKind::Quiet);
+
+				continue;
+			}
+
+			int	 forward	   = side == Side::White ? -8 : 8;
+			int	 lastRow	   = side == Side::White ? 0 : 7;
+			int	 startRow	   = side == Side::White ? 6 : 1;
+
+			auto pawnMove	   = [&](int to, MoveKind kind)
+			{
+				if (row(to) != lastRow)
+				{
+					emit(type, from, to, type, kind);
+					return;
+				}
+
+				for (int promoted : {WQueen, WRook, WBishop, WKnight})
+					emit(type, from, to, first + promoted, MoveKind::Exit);
+			};
+
+			int push = from + forward;
+
+			if (!(occupied & (1ULL << push)))
+			{
+				pawnMove(push, MoveKind::Push);
+
+				int doublePush = push + forward;
+
+				if (row(from) == startRow && !(occupied & (1ULL << doublePush)))
+					pawnMove(doublePush, MoveKind::DoublePush);
+			}
+
+			for (U64 targets = attacksFrom(WPawn, side, from, occupied) & enemy; targets; targets &= targets - 1)
+				pawnMove(BitUtils::lsb(targets), MoveKind::Exit);
+		}
+	}
+}
+
+
+template <typename Visit>
+void Generator::forEachUnmove(const Bitboards &pieces, Side mover, bool withPawns, Visit &&visit)
+{
+	Side side	  = other(mover);
+	U64	 occupied = occupancy(pieces, Side::White) | occupancy(pieces, Side::Black);
+	int	 first	  = firstType(mover);
+
+	auto emit	  = [&](int type, int from, int to, MoveKind kind)
+	{
+		Successor predecessor;
+		predecessor.pieces = pieces;
+		predecessor.kind   = kind;
+		predecessor.pieces[type] &= ~(1ULL << from);
+		predecessor.pieces[type] |= 1ULL << to;
+
+		if (inCheck(predecessor.pieces, side))
+			return;
+
+		if (kind == MoveKind::DoublePush)
+		{
+			// The en passant answer is judged on the position after the push, the one we came from
+			predecessor.pieces = pieces;
+			evaluateEnPassant(predecessor, mover, from);
+			predecessor.pieces[type] &= ~(1ULL << from);
+			predecessor.pieces[type] |= 1ULL << to;
+		}
+
+		visit(predecessor);
+	};
+
+	for (int offset = WKing; offset <= WRook; ++offset)
+	{
+		int type = first + offset;
+
+		for (U64 pieceBB = pieces[type]; pieceBB; pieceBB &= pieceBB - 1)
+		{
+			int square = BitUtils::lsb(pieceBB);
+
+			if (offset != WPawn)
+			{
+				// Piece moves are symmetric: the squares reachable from here are the squares it came from
+				for (U64 origins = attacksFrom(offset, mover, square, occupied) & ~occupied; origins; origins &= origins - 1)
+					emit(type, square, BitUtils::lsb(origins), MoveKind::Quiet);
+
+				continue;
+			}
+
+			if (!withPawns)
+				continue;
+
+			int backward  = mover == Side::White ? 8 : -8;
+			int startRow  = mover == Side::White ? 6 : 1;
+			int origin	  = square + backward;
+
+			if (row(origin) == 0 || row(origin) == 7 || (occupied & (1ULL << origin)))
+				continue;
+
+			emit(type, square, origin, MoveKind::Push);
+
+			int doubleOrigin = origin + backward;
+
+			if (row(doubleOrigin) == startRow && !(occupied & (1ULL << doubleOrigin)))
+				emit(type, square, doubleOrigin, MoveKind::DoublePush);
+		}
+	}
+}
+
+
+Wdl Generator::probeExit(const Bitboards &pieces, Side side)
+{
+	Wdl	   best		= Wdl::Loss;
+	size_t moves	= 0;
+	size_t captures = 0;
+
+	forEachMove(pieces, side, false,
+				[&](const Successor &successor)
+				{
+					++moves;
+
+					if (!successor.captures)
+						return;
+
+					++captures;
+					best = std::max(best, negate(probeExit(successor.pieces, other(side))));
+				});
+
+	// With only captures the stored value isn't needed
+	if (moves > 0 && captures == moves)
+		return best;
+
+	Wdl stored = Wdl::Draw;
+
+	if (!mSubTables.probeWDL(pieces, side, stored))
+		mMissingTable = true;
+
+	return std::max(best, decided(stored));
+}
+
+
+void Generator::evaluateEnPassant(Successor &successor, Side pusher, int square)
+{
+	Side capturer = other(pusher);
+	int	 passed	  = pusher == Side::White ? square + 8 : square - 8;
+	int	 pawn	  = firstType(capturer) + WPawn;
+
+	// Pawns of the capturer that attack the passed square
+	U64	 takers	  = AttackTables::instance().pawnAttacks(pusher, static_cast<Square>(passed)) & successor.pieces[pawn];
+
+	for (; takers; takers &= takers - 1)
+	{
+		Bitboards after = successor.pieces;
+		after[pawn] &= ~(1ULL << BitUtils::lsb(takers));
+		after[pawn] |= 1ULL << passed;
+		after[firstType(pusher) + WPawn] &= ~(1ULL << square);
+
+		if (inCheck(after, capturer))
+			continue;
+
+		Wdl result = negate(probeExit(after, pusher));
+
+		if (!successor.enPassant || result > successor.capture)
+			successor.capture = result;
+
+		successor.enPassant = true;
+	}
+}
+
+
+void Generator::classify(size_t index, const Bitboards &pieces, Side side)
+{
+	int	 moves = 0;
+	bool wins  = false;
+	bool draws = false;
+
+	mNeighbours.clear();
+
+	forEachMove(pieces, side, true,
+				[&](const Successor &successor)
+				{
+					++moves;
+
+					if (successor.kind == MoveKind::Exit)
+					{
+						Wdl result = negate(probeExit(successor.pieces, other(side)));
+						wins |= result == Wdl::Win;
+						draws |= result == Wdl::Draw;
+					}
+					else if (!(successor.enPassant && successor.capture == Wdl::Win))
+					{
+						// A double push the opponent wins by taking en passant is a lost move like a losing exit
+						mNeighbours.push_back(mLayout.index(successor.pieces, other(side), false));
+					}
+				});
+
+	makeDistinct(mNeighbours);
+	size_t counter = mNeighbours.size();
+
+	if (moves == 0)
+		mStates[index] = inCheck(pieces, side) ? Lost : Drawn;
+	else if (wins)
+		mStates[index] = Won;
+	else if (counter == 0)
+		mStates[index] = draws ? Drawn : Lost;
+	else
+	{
+		mStates[index]	 = Unknown;
+		mCounters[index] = static_cast<uint8_t>(counter + (draws ? 1 : 0));
+		return;
+	}
+
+	if (mStates[index] != Drawn)
+		mQueue.push_back(index);
+}
+
+
+void Generator::propagate(size_t index)
+{
+	Bitboards pieces;
+	Side	  side;
+	mLayout.decode(index, pieces, side);
+
+	bool lost = mStates[index] == Lost;
+
+	mNeighbours.clear();
+
+	forEachUnmove(pieces, other(side), true,
+				  [&](const Successor &predecessor)
+				  {
+					  // The en passant answer caps what the push can reach (a win for it was counted as a loss)
+					  if (predecessor.enPassant && (predecessor.capture == Wdl::Win || (lost && predecessor.capture == Wdl::Draw)))
+						  return;
+
+					  mNeighbours.push_back(mLayout.index(predecessor.pieces, other(side), false));
+				  });
+
+	makeDistinct(mNeighbours);
+
+	for (size_t previous : mNeighbours)
+	{
+		if (mStates[previous] != Unknown)
+			continue;
+
+		if (lost)
+		{
+			mStates[previous] = Won;
+			mQueue.push_back(previous);
+		}
+		else if (--mCounters[previous] == 0)
+		{
+			mStates[previous] = Lost;
+			mQueue.push_back(previous);
+		}
+	}
+}
+
+
+bool Generator::computeDistances(TablebaseGenerationResult &result)
+{
+	// Positions by distance: a win is one ply further than its fastest reversible move into a loss (or 1 with a
+	// zeroing move that keeps the win), a loss one ply further than its slowest reversible move into a win
+	std::vector<std::vector<size_t>> levels(2);
+	std::vector<uint8_t>			&pending = mCounters;
+	std::vector<int16_t>			 longest(mLayout.size(), 0);
+
+	mDistances.assign(mLayout.size(), -1);
+
+	for (size_t index = 0; index < mLayout.size(); ++index)
+	{
+		if (mStates[index] != Won && mStates[index] != Lost)
+			continue;
+
+		Bitboards pieces;
+		Side	  side;
+		mLayout.decode(index, pieces, side);
+
+		int	 zeroing	 = 0;
+		bool zeroingWins = false;
+
+		mNeighbours.clear();
+
+		forEachMove(pieces, side, true,
+					[&](const Successor &successor)
+					{
+						if (successor.kind == MoveKind::Quiet)
+						{
+							mNeighbours.push_back(mLayout.index(successor.pieces, other(side), false));
+							return;
+						}
+
+						++zeroing;
+
+						Wdl reply = successor.kind == MoveKind::Exit ? probeExit(successor.pieces, other(side))
+																	 : resultOf(mLayout.index(successor.pieces, other(side), false));
+
+						if (successor.enPassant)
+							reply = std::max(reply, successor.capture);
+
+						zeroingWins |= reply == Wdl::Loss;
+					});
+
+		if (mStates[index] == Won)
+		{
+			if (zeroingWins)
+			{
+				mDistances[index] = 1;
+				levels[1].push_back(index);
+			}
+
+			continue;
+		}
+
+		makeDistinct(mNeighbours);
+		size_t reversible = mNeighbours.size();
+
+		pending[index]	  = static_cast<uint8_t>(reversible);
+		longest[index]	  = zeroing > 0 ? 1 : 0;
+
+		if (reversible == 0)
+		{
+			mDistances[index] = longest[index];
+			levels[longest[index]].push_back(index);
+		}
+	}
+
+	for (size_t distance = 0; distance < levels.size(); ++distance)
+	{
+		for (size_t i = 0; i < levels[distance].size(); ++i)
+		{
+			size_t	  index = levels[distance][i];
+			Bitboards pieces;
+			Side	  side;
+			mLayout.decode(index, pieces, side);
+
+			bool lost = mStates[index] == Lost;
+			int	 next = static_cast<int>(distance) + 1;
+
+			mNeighbours.clear();
+			forEachUnmove(pieces, other(side), false, [&](const Successor &predecessor) { mNeighbours.push_back(mLayout.index(predecessor.pieces, other(side), false)); });
+			makeDistinct(mNeighbours);
+
+			for (size_t previous : mNeighbours)
+			{
+				if (mDistances[previous] >= 0)
+					continue;
+
+				if (lost && mStates[previous] == Won)
+				{
+					mDistances[previous] = static_cast<int16_t>(next);
+				}
+				else if (!lost && mStates[previous] == Lost)
+				{
+					longest[previous] = static_cast<int16_t>(std::max<int>(longest[previous], next));
+
+					if (--pending[previous] != 0)
+						continue;
+
+					mDistances[previous] = std::max<int16_t>(longest[previous], static_cast<int16_t>(next));
+				}
+				else
+				{
+					continue;
+				}
+
+				if (levels.size() <= static_cast<size_t>(mDistances[previous]))
+					levels.resize(mDistances[previous] + 1);
+
+				levels[mDistances[previous]].push_back(previous);
+			}
+		}
+
+		result.maxDtz = std::max(result.maxDtz, levels[distance].empty() ? 0 : static_cast<int>(distance));
+	}
+
+	size_t unresolved = 0;
+
+	for (size_t index = 0; index < mLayout.size(); ++index)
+		unresolved += (mStates[index] == Won || mStates[index] == Lost) && mDistances[index] < 0;
+
+	if (unresolved > 0)
+	{
+		LOG_ERROR("Table {}: {} decided positions without a distance to zeroing", mLayout.code(), unresolved);
+		return false;
+	}
+
+	return true;
+}
+
+
+bool Generator::run(TablebaseGenerationResult &result, std::vector<Wdl> &wdl, std::vector<uint16_t> &dtz)
+{
+	mStates.assign(mLayout.size(), Invalid);
+	mCounters.assign(mLayout.size(), 0);
+	mQueue.clear();
+
+	for (size_t index = 0; index < mLayout.size(); ++index)
+	{
+		Bitboards pieces;
+		Side	  side;
+
+		// Unused indices, and positions whose side not to move is in check
+		if (!mLayout.decode(index, pieces, side) || inCheck(pieces, other(side)))
+			continue;
+
+		classify(index, pieces, side);
+	}
+
+	if (mMissingTable)
+		return false;
+
+	for (size_t i = 0; i < mQueue.size(); ++i)
+		propagate(mQueue[i]);
+
+	for (auto &state : mStates)
+	{
+		if (state == Unknown)
+			state = Drawn;
+	}
+
+	if (!computeDistances(result))
+		return false;
+
+	wdl.assign(mLayout.size(), Wdl::Draw);
+	dtz.assign(mLayout.size(), TablebaseWriter::UNUSED);
+
+	for (size_t index = 0; index < mLayout.size(); ++index)
+	{
+		if (mStates[index] == Invalid)
+			continue;
+
+		// Mated counts as one ply from zeroing. Without the 50 move rule in the search,
+		// a result is cursed (or blessed) if its own zeroing move is more than 100 plies away.
+		++result.positions;
+		wdl[index] = resultOf(index);
+		dtz[index] = static_cast<uint16_t>(wdl[index] == Wdl::Draw ? 0 : std::max<int>(mDistances[index], 1));
+
+		if (dtz[index] > FIFTY_MOVE_PLIES)
+			wdl[index] = wdl[index] == Wdl::Win ? Wdl::CursedWin : Wdl::BlessedLoss;
+
+		result.wins += mStates[index] == Won;
+		result.draws += mStates[index] == Drawn;
+		result.losses += mStates[index] == Lost;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief	Materials that captures and promotions lead to (bare kings excluded).
+ */
+std::vector<uint64_t> exitMaterials(uint64_t materialKey)
+{
+	std::vector<uint64_t> keys;
+
+	auto				  captures = [&](uint64_t key, Side victim)
+	{
+		for (int offset = WQueen; offset <= WRook; ++offset)
+		{
+			PieceType type = static_cast<PieceType>(firstType(victim) + offset);
+
+			if (MaterialKey::count(key, type) > 0)
+				keys.push_back(key - MaterialKey::unit(type));
+		}
+	};
+
+	for (Side side : {Side::White, Side::Black})
+	{
+		captures(materialKey, other(side));
+
+		PieceType pawn = static_cast<PieceType>(firstType(side) + WPawn);
+
+		if (MaterialKey::count(materialKey, pawn) == 0)
+			continue;
+
+		for (int promoted : {WQueen, WRook, WBishop, WKnight})
+		{
+			uint64_t key = materialKey - MaterialKey::unit(pawn) + MaterialKey::unit(static_cast<PieceType>(firstType(side) + promoted));
+			keys.push_back(key);
+			captures(key, other(side));
+		}
+	}
+
+	std::sort(keys.begin(), keys.end());
+	keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+	keys.erase(std::remove(keys.begin(), keys.end(), BARE_KINGS), keys.end());
+	return keys;
+}
+
+} // namespace
+
+
+bool TablebaseGenerator::generate(const std::string &directory, const std::string &code, TablebaseGenerationResult &result)
+{
+	result			= TablebaseGenerationResult();
+	auto	  start = std::chrono::steady_clock::now();
+
+	TablebaseLayout layout(MaterialKey::fromCode(code));
+
+	if (layout.size() == 0 || layout.code() != code)
+	{
+		LOG_ERROR("{} is no material code of a table (like KRvK, at most {} pieces)", code, TablebaseLayout::MAX_PIECES);
+		return false;
+	}
+
+	// Smaller tables first: every capture and promotion must find its table
+	Tablebase			  subTables;
+	std::vector<uint64_t> needed = exitMaterials(layout.materialKey());
+
+	if (!needed.empty())
+	{
+		subTables.open(directory);
+
+		for (uint64_t key : needed)
+		{
+			if (!subTables.hasTable(key))
+			{
+				LOG_ERROR("Table {} needs {}, generate it first", code, TablebaseLayout(key).code());
+				return false;
+			}
+		}
+	}
+
+	std::vector<Wdl>	  wdl;
+	std::vector<uint16_t> dtz;
+	Generator			  generator(layout, subTables);
+
+	if (!generator.run(result, wdl, dtz) || !TablebaseWriter::write(directory, layout, wdl, dtz))
+		return false;
+
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	LOG_INFO("Generated {}: {} positions, {} wins, {} draws, {} losses, longest zeroing distance {} plies ({:.1f} s)", code, result.positions, result.wins, result.draws,
+			 result.losses, result.maxDtz, result.seconds);
+	return true;
+}
@@ -0,0 +1,45 @@
+/*
+  ==============================================================================
+	Module:         TablebaseGenerator
+	Description:    Retrograde generation of endgame tables
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+
+struct TablebaseGenerationResult
+{
+	size_t positions = 0; // Legal positions (each stored once)
+	size_t wins		 = 0; // Won for the side to move
+	size_t draws	 = 0;
+	size_t losses	 = 0;
+	int	   maxDtz	 = 0; // Longest distance to zeroing in plies
+	double seconds	 = 0.0;
+};
+
+
+/**
+ * @brief	Builds the Syzygy table files of one material signature (see Tablebase and TablebaseWriter).
+ *
+ * Every legal position is classified once from its moves: moves that capture or promote lead into
+ * smaller tables, which are read from the target directory, so tables are generated smallest first
+ * (KQvK, ..., then KPvK which promotes into them). The remaining positions are resolved backwards:
+ * every won or lost position visits its predecessors (unmade moves), a predecessor with a move into a
+ * loss is won, one whose moves all lead into wins is lost, and what is left unresolved is drawn.
+ * The distances to zeroing follow in a second pass over the reversible moves, ordered by distance.
+ * The 50 move rule is not part of the search: a result whose zeroing move is more than 100 plies away
+ * is stored as a cursed win or blessed loss, which misses the ones that only a later phase curses.
+ */
+class TablebaseGenerator
+{
+public:
+	/**
+	 * @param	code	Material code like "KRvK" (a king per side, at most TablebaseLayout::MAX_PIECES pieces).
+	 * @return	false (logged) if the code is invalid, a smaller table is missing or the files can't be written.
+	 */
+	static bool generate(const std::string &directory, const std::string &code, TablebaseGenerationResult &result);
+};
@@ -0,0 +1,441 @@
+/*
+  ==============================================================================
+	Module:         TablebaseIndex
+	Description:    Syzygy position encoding of an endgame table
+  ==============================================================================
+*/
+
+#include "TablebaseIndex.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "BitboardUtils.h"
+#include "MaterialKey.h"
+
+
+namespace
+{
+
+constexpr int LEAD_PAWNS		= TablebaseIndex::MAX_PIECES - 2; // Most pawns of one colour beside the kings
+constexpr int UNIQUE_PLACEMENTS = 31332;						  // Three pieces, the first in the a1-d1-d4 triangle
+constexpr int KING_PLACEMENTS	= 462;							  // Two kings, the first in the triangle
+
+// Piece codes of the table files by PieceType (KQPNBR)
+constexpr uint8_t PIECE_CODES[6] = {TablebaseIndex::King, TablebaseIndex::Queen, TablebaseIndex::Pawn, TablebaseIndex::Knight, TablebaseIndex::Bishop, TablebaseIndex::Rook};
+
+
+inline int fileOf(int square)
+{
+	return square & 7;
+}
+
+
+inline int rankOf(int square)
+{
+	return square >> 3;
+}
+
+
+/**
+ * @brief	Positive above the a1-h8 diagonal, zero on it.
+ */
+inline int offDiagonal(int square)
+{
+	return rankOf(square) - fileOf(square);
+}
+
+
+/**
+ * @brief	Lookup tables of the encoding, built once.
+ */
+struct IndexTables
+{
+	int		 mapB1H1H7[64]{};						  // Squares below the a1-h8 diagonal to 0..27
+	int		 mapA1D1D4[64]{};						  // Squares of the a1-d1-d4 triangle to 0..9, diagonal last
+	int		 mapKK[10][64]{};						  // King pairs to 0..461
+	int		 mapPawns[64]{};						  // Pawn squares to 0..47, the leading pawn has the highest value
+	uint64_t binomial[TablebaseIndex::MAX_PIECES][64]{}; // binomial[k][n]: ways to choose k of n
+	int		 leadPawnIdx[LEAD_PAWNS + 1][64]{};
+	int		 leadPawnsSize[LEAD_PAWNS + 1][TablebaseIndex::FILES]{};
+
+	IndexTables()
+	{
+		int code = 0;
+
+		for (int square = 0; square < 64; ++square)
+		{
+			if (offDiagonal(square) < 0)
+				mapB1H1H7[square] = code++;
+		}
+
+		int diagonal[4]{};
+		int diagonalCount = 0;
+		code			  = 0;
+
+		for (int square = 0; square <= 27; ++square)
+		{
+			if (fileOf(square) > 3)
+				continue;
+
+			if (offDiagonal(square) < 0)
+				mapA1D1D4[square] = code++;
+			else if (offDiagonal(square) == 0)
+				diagonal[diagonalCount++] = square;
+		}
+
+		for (int i = 0; i < diagonalCount; ++i)
+			mapA1D1D4[diagonal[i]] = code++;
+
+		// If the first king is on the diagonal, the other one is not above it. Pairs on the diagonal come last.
+		int bothOnDiagonal[KING_PLACEMENTS][2]{};
+		int bothCount = 0;
+		code		  = 0;
+
+		for (int slot = 0; slot < 10; ++slot)
+		{
+			for (int first = 0; first <= 27; ++first)
+			{
+				// b1 is slot 0 like the squares outside the triangle, so it's checked by square
+				if (mapA1D1D4[first] != slot || (slot == 0 && first != 1))
+					continue;
+
+				for (int second = 0; second < 64; ++second)
+				{
+					if (std::abs(fileOf(first) - fileOf(second)) <= 1 && std::abs(rankOf(first) - rankOf(second)) <= 1)
+						continue;
+
+					if (offDiagonal(first) == 0 && offDiagonal(second) > 0)
+						continue;
+
+					if (offDiagonal(first) == 0 && offDiagonal(second) == 0)
+					{
+						bothOnDiagonal[bothCount][0]   = slot;
+						bothOnDiagonal[bothCount++][1] = second;
+					}
+					else
+					{
+						mapKK[slot][second] = code++;
+					}
+				}
+			}
+		}
+
+		for (int i = 0; i < bothCount; ++i)
+			mapKK[bothOnDiagonal[i][0]][bothOnDiagonal[i][1]] = code++;
+
+		binomial[0][0] = 1;
+
+		for (int n = 1; n < 64; ++n)
+		{
+			for (int k = 0; k < TablebaseIndex::MAX_PIECES && k <= n; ++k)
+				binomial[k][n] = (k > 0 ? binomial[k - 1][n - 1] : 0) + (k < n ? binomial[k][n - 1] : 0);
+		}
+
+		// A leading pawn on a2 leaves 47 squares to the others, every rank further up 2 less (its mirror included)
+		int available = 47;
+
+		for (int leadPawns = 1; leadPawns <= LEAD_PAWNS; ++leadPawns)
+		{
+			for (int file = 0; file < TablebaseIndex::FILES; ++file)
+			{
+				int index = 0;
+
+				for (int rank = 1; rank <= 6; ++rank)
+				{
+					int square = rank * 8 + file;
+
+					if (leadPawns == 1)
+					{
+						mapPawns[square]	 = available--;
+						mapPawns[square ^ 7] = available--;
+					}
+
+					leadPawnIdx[leadPawns][square] = index;
+					index += static_cast<int>(binomial[leadPawns - 1][mapPawns[square]]);
+				}
+
+				leadPawnsSize[leadPawns][file] = index;
+			}
+		}
+	}
+};
+
+
+const IndexTables &tables()
+{
+	static const IndexTables instance;
+	return instance;
+}
+
+} // namespace
+
+
+uint64_t TablebaseIndex::Groups::size() const
+{
+	size_t count = 0;
+
+	while (count < length.size() - 1 && length[count] != 0)
+		++count;
+
+	return factor[count];
+}
+
+
+TablebaseIndex::TablebaseIndex(uint64_t materialKey) : mMaterialKey(materialKey), mMirroredKey(MaterialKey::mirror(materialKey))
+{
+	for (int type = WKing; type <= BRook; ++type)
+	{
+		int count = MaterialKey::count(materialKey, static_cast<PieceType>(type));
+		mCount += count;
+
+		// Kings don't make a table unique, pawns do
+		if (count == 1 && type != WKing && type != BKing)
+			mUniquePieces = true;
+	}
+
+	int whitePawns = MaterialKey::count(materialKey, WPawn);
+	int blackPawns = MaterialKey::count(materialKey, BPawn);
+	mPawns		   = whitePawns + blackPawns > 0;
+
+	if (!mPawns)
+		return;
+
+	// The colour with fewer pawns leads, it compresses better
+	bool whiteLeads = blackPawns == 0 || (whitePawns > 0 && blackPawns >= whitePawns);
+	mPawnCount[0]	= whiteLeads ? whitePawns : blackPawns;
+	mPawnCount[1]	= whiteLeads ? blackPawns : whitePawns;
+	mLeadPawn		= whiteLeads ? Pawn : Pawn | Black;
+}
+
+
+bool TablebaseIndex::setGroups(Groups &groups, int leadingOrder, int pawnOrder, int file) const
+{
+	const IndexTables &t		   = tables();
+	int				   firstLength = mPawns ? 0 : mUniquePieces ? 3 : 2;
+	int				   count	   = 0;
+
+	groups.length.fill(0);
+	groups.factor.fill(0);
+	groups.length[0] = 1;
+
+	for (int i = 1; i < mCount; ++i)
+	{
+		if (--firstLength > 0 || groups.pieces[i] == groups.pieces[i - 1])
+			++groups.length[count];
+		else
+			groups.length[++count] = 1;
+	}
+
+	++count;
+
+	// The leading group's factor and the other colour's pawns can come at any position of the index
+	bool bothPawns	 = mPawns && mPawnCount[1] > 0;
+	int	 next		 = bothPawns ? 2 : 1;
+	int	 freeSquares = 64 - groups.length[0] - (bothPawns ? groups.length[1] : 0);
+
+	if (leadingOrder >= count || (bothPawns && (pawnOrder >= count || pawnOrder == leadingOrder)))
+		return false;
+
+	uint64_t factor = 1;
+
+	for (int k = 0; next < count || k == leadingOrder || (bothPawns && k == pawnOrder); ++k)
+	{
+		if (k == leadingOrder)
+		{
+			groups.factor[0] = factor;
+			factor *= mPawns ? t.leadPawnsSize[groups.length[0]][file] : mUniquePieces ? UNIQUE_PLACEMENTS : KING_PLACEMENTS;
+		}
+		else if (bothPawns && k == pawnOrder)
+		{
+			groups.factor[1] = factor;
+			factor *= t.binomial[groups.length[1]][48 - groups.length[0]];
+		}
+		else
+		{
+			groups.factor[next] = factor;
+			factor *= t.binomial[groups.length[next]][freeSquares];
+			freeSquares -= groups.length[next++];
+		}
+	}
+
+	groups.factor[count] = factor;
+	return true;
+}
+
+
+TablebaseIndex::Placement TablebaseIndex::place(const Bitboards &pieces, bool flip, uint8_t leadPawn) const
+{
+	const IndexTables &t		  = tables();
+	Placement		   placement;
+
+	// Board squares count from a8, table squares from a1; swapping the colours mirrors the ranks once more
+	int				   squareFlip = flip ? 0 : 56;
+	uint8_t			   colourFlip = flip ? Black : 0;
+	U64				   leadPawns  = 0;
+
+	if (mPawns)
+	{
+		leadPawns = pieces[pieceType(leadPawn ^ colourFlip)];
+
+		for (U64 pawns = leadPawns; pawns; pawns &= pawns - 1)
+		{
+			placement.squares[placement.count]	= BitUtils::lsb(pawns) ^ squareFlip;
+			placement.pieces[placement.count++] = leadPawn;
+		}
+
+		placement.leadPawns = placement.count;
+
+		// The pawn nearest the edge (the lowest of them) leads and selects the sub-table
+		auto lead = std::max_element(placement.squares.begin(), placement.squares.begin() + placement.count, [&t](int a, int b) { return t.mapPawns[a] < t.mapPawns[b]; });
+		std::swap(placement.squares[0], *lead);
+
+		placement.file = std::min(fileOf(placement.squares[0]), 7 - fileOf(placement.squares[0]));
+	}
+
+	for (int type = WKing; type <= BRook; ++type)
+	{
+		for (U64 bb = pieces[type] & ~leadPawns; bb; bb &= bb - 1)
+		{
+			placement.squares[placement.count]	= BitUtils::lsb(bb) ^ squareFlip;
+			placement.pieces[placement.count++] = pieceCode(static_cast<PieceType>(type)) ^ colourFlip;
+		}
+	}
+
+	return placement;
+}
+
+
+uint64_t TablebaseIndex::index(const Groups &groups, Placement placement) const
+{
+	const IndexTables &t	   = tables();
+	auto			  &squares = placement.squares;
+	int				   size	   = placement.count;
+
+	// Same piece sequence as the sub-table
+	for (int i = placement.leadPawns; i < size - 1; ++i)
+	{
+		for (int j = i + 1; j < size; ++j)
+		{
+			if (groups.pieces[i] == placement.pieces[j])
+			{
+				std::swap(placement.pieces[i], placement.pieces[j]);
+				std::swap(squares[i], squares[j]);
+				break;
+			}
+		}
+	}
+
+	// The first piece goes to files a-d
+	if (fileOf(squares[0]) > 3)
+	{
+		for (int i = 0; i < size; ++i)
+			squares[i] ^= 7;
+	}
+
+	uint64_t index = 0;
+
+	if (mPawns)
+	{
+		auto byMap = [&t](int a, int b) { return t.mapPawns[a] < t.mapPawns[b]; };
+
+		index	   = t.leadPawnIdx[placement.leadPawns][squares[0]];
+		std::stable_sort(squares.begin() + 1, squares.begin() + placement.leadPawns, byMap);
+
+		for (int i = 1; i < placement.leadPawns; ++i)
+			index += t.binomial[i][t.mapPawns[squares[i]]];
+	}
+	else
+	{
+		// Without pawns the first piece also goes to ranks 1-4 and below the diagonal
+		if (rankOf(squares[0]) > 3)
+		{
+			for (int i = 0; i < size; ++i)
+				squares[i] ^= 56;
+		}
+
+		for (int i = 0; i < groups.length[0]; ++i)
+		{
+			if (offDiagonal(squares[i]) == 0)
+				continue;
+
+			if (offDiagonal(squares[i]) > 0)
+			{
+				for (int j = i; j < size; ++j)
+					squares[j] = ((squares[j] >> 3) | (squares[j] << 3)) & 63;
+			}
+
+			break;
+		}
+
+		if (mUniquePieces)
+		{
+			int first  = squares[0];
+			int second = squares[1];
+			int third  = squares[2];
+			int adjust1 = second > first;
+			int adjust2 = (third > first) + (third > second);
+
+			if (offDiagonal(first))
+				index = (static_cast<uint64_t>(t.mapA1D1D4[first]) * 63 + (second - adjust1)) * 62 + third - adjust2;
+			else if (offDiagonal(second))
+				index = (6 * 63 + rankOf(first) * 28 + t.mapB1H1H7[second]) * 62 + third - adjust2;
+			else if (offDiagonal(third))
+				index = 6 * 63 * 62 + 4 * 28 * 62 + rankOf(first) * 7 * 28 + (rankOf(second) - adjust1) * 28 + t.mapB1H1H7[third];
+			else
+				index = 6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 + rankOf(first) * 7 * 6 + (rankOf(second) - adjust1) * 6 + (rankOf(third) - adjust2);
+		}
+		else
+		{
+			index = t.mapKK[t.mapA1D1D4[squares[0]]][squares[1]];
+		}
+	}
+
+	index *= groups.factor[0];
+
+	// The other groups by the squares left free, the other colour's pawns only on ranks 2-7
+	int	 groupStart		= groups.length[0];
+	bool remainingPawns = mPawns && mPawnCount[1] > 0;
+
+	for (int next = 1; next < MAX_PIECES && groups.length[next] != 0; ++next)
+	{
+		std::stable_sort(squares.begin() + groupStart, squares.begin() + groupStart + groups.length[next]);
+
+		uint64_t value = 0;
+
+		for (int i = 0; i < groups.length[next]; ++i)
+		{
+			int square = squares[groupStart + i];
+			int adjust = 0;
+
+			for (int j = 0; j < groupStart; ++j)
+				adjust += squares[j] < square;
+
+			value += t.binomial[i + 1][square - adjust - (remainingPawns ? 8 : 0)];
+		}
+
+		remainingPawns = false;
+		index += value * groups.factor[next];
+		groupStart += groups.length[next];
+	}
+
+	return index;
+}
+
+
+uint8_t TablebaseIndex::pieceCode(PieceType type)
+{
+	return type < BKing ? PIECE_CODES[type] : PIECE_CODES[type - BKing] | Black;
+}
+
+
+PieceType TablebaseIndex::pieceType(uint8_t code)
+{
+	for (int type = WKing; type <= WRook; ++type)
+	{
+		if (PIECE_CODES[type] == (code & 7))
+			return static_cast<PieceType>(code & Black ? type + BKing : type);
+	}
+
+	return PieceType::None;
+}
@@ -0,0 +1,146 @@
+/*
+  ==============================================================================
+	Module:         TablebaseIndex
+	Description:    Syzygy position encoding of an endgame table
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "BitboardTypes.h"
+
+
+namespace SyzygyFormat
+{
+
+constexpr uint8_t WDL_MAGIC[]  = {0x71, 0xE8, 0x23, 0x5D};
+constexpr uint8_t DTZ_MAGIC[]  = {0xD7, 0x66, 0x0C, 0xA5};
+constexpr size_t  MAGIC_SIZE   = 4;
+
+// Header flags of a file
+constexpr uint8_t SPLIT		   = 1; // Two sides to move (the material is not symmetric)
+constexpr uint8_t HAS_PAWNS	   = 2;
+
+// Flags of a sub-table
+constexpr uint8_t STM		   = 1; // Side to move of a distance sub-table
+constexpr uint8_t MAPPED	   = 2; // Distances go through the map
+constexpr uint8_t WIN_PLIES	   = 4; // Win distances are stored in plies, not moves
+constexpr uint8_t LOSS_PLIES   = 8;
+constexpr uint8_t WIDE		   = 16; // 16 bit map entries
+constexpr uint8_t SINGLE_VALUE = 128;
+
+constexpr int	  LEAF		   = 0xFFF; // Right symbol of a tree entry that stands for one value
+
+} // namespace SyzygyFormat
+
+
+/**
+ * @brief	Maps positions of one material signature to the indices of Syzygy tables (.rtbw/.rtbz).
+ *
+ * A table is stored for the colours of its file name (white is the first part of "KRvK"). Tables with
+ * pawns are split into 4 sub-tables by the file of the leading pawn (mirrored onto files a-d), tables
+ * without pawns use the 8 board symmetries and encode the first pieces jointly (the kings, or three
+ * pieces if a piece is unique). The remaining pieces are encoded group by group, a group being pieces
+ * of the same kind whose order doesn't matter. Squares are counted from a1 as in the table files.
+ */
+class TablebaseIndex
+{
+public:
+	static constexpr int MAX_PIECES = 6;
+	static constexpr int FILES		= 4;
+
+	using Bitboards					= std::array<U64, 12>;
+
+	// Piece codes of the table files, black pieces have bit 3 set
+	enum Piece : uint8_t
+	{
+		NoPiece = 0,
+		Pawn	= 1,
+		Knight	= 2,
+		Bishop	= 3,
+		Rook	= 4,
+		Queen	= 5,
+		King	= 6,
+		Black	= 8
+	};
+
+	/**
+	 * @brief	Piece order and group sizes of one sub-table, as given by the table file.
+	 */
+	struct Groups
+	{
+		std::array<uint8_t, MAX_PIECES>		pieces{}; // Piece codes in encoding order
+		std::array<int, MAX_PIECES + 1>		length{}; // Pieces per group, zero terminated
+		std::array<uint64_t, MAX_PIECES + 1> factor{}; // Index weight per group, the entry after the last group is the size
+
+		[[nodiscard]] uint64_t				size() const;
+	};
+
+	/**
+	 * @brief	Squares of a position in the colours of the table, leading pawns first.
+	 */
+	struct Placement
+	{
+		std::array<int, MAX_PIECES>		squares{}; // a1 = 0
+		std::array<uint8_t, MAX_PIECES> pieces{};
+		int								count	  = 0;
+		int								leadPawns = 0;
+		int								file	  = 0; // Sub-table (file of the leading pawn, 0 without pawns)
+	};
+
+	TablebaseIndex() = default;
+	explicit TablebaseIndex(uint64_t materialKey);
+
+	[[nodiscard]] uint64_t materialKey() const { return mMaterialKey; }
+	[[nodiscard]] uint64_t mirroredKey() const { return mMirroredKey; }
+	[[nodiscard]] int	   pieceCount() const { return mCount; }
+	[[nodiscard]] bool	   hasPawns() const { return mPawns; }
+	[[nodiscard]] bool	   isSymmetric() const { return mMaterialKey == mMirroredKey; }
+	[[nodiscard]] int	   files() const { return mPawns ? FILES : 1; }
+
+	/**
+	 * @brief	Pawns of the leading colour (index 0) and of the other colour.
+	 */
+	[[nodiscard]] int	   pawnCount(int group) const { return mPawnCount[group]; }
+
+	/**
+	 * @brief	Leading pawn of the table: the colour with fewer (but some) pawns, white if equal.
+	 *			Table files name it themselves, this is the choice of the Syzygy generator.
+	 */
+	[[nodiscard]] uint8_t  leadPawn() const { return mLeadPawn; }
+
+	/**
+	 * @brief	Fill in group lengths and factors of a sub-table whose pieces are set.
+	 * @param	leadingOrder	Position of the leading group in the index (order nibble of the file).
+	 * @param	pawnOrder		Position of the other colour's pawns if both colours have pawns.
+	 * @return	false if the orders don't fit the groups.
+	 */
+	bool				   setGroups(Groups &groups, int leadingOrder, int pawnOrder, int file) const;
+
+	/**
+	 * @brief	Squares of a position with this material (or the colours swapped if flip is set).
+	 * @param	leadPawn	Leading pawn code of the table (ignored without pawns).
+	 */
+	[[nodiscard]] Placement place(const Bitboards &pieces, bool flip, uint8_t leadPawn) const;
+
+	/**
+	 * @brief	Index of a placement in the sub-table of its file.
+	 */
+	[[nodiscard]] uint64_t index(const Groups &groups, Placement placement) const;
+
+	[[nodiscard]] static uint8_t   pieceCode(PieceType type);
+	[[nodiscard]] static PieceType pieceType(uint8_t code);
+
+private:
+	uint64_t			   mMaterialKey	 = 0;
+	uint64_t			   mMirroredKey	 = 0;
+	int					   mCount		 = 0;
+	bool				   mPawns		 = false;
+	bool				   mUniquePieces = false;
+	std::array<int, 2>	   mPawnCount{};
+	uint8_t				   mLeadPawn = NoPiece;
+};
@@ -0,0 +1,244 @@
+/*
+  ==============================================================================
+	Module:         TablebaseLayout
+	Description:    Position indexing of an endgame table
+  ==============================================================================
+*/
+
+#include "TablebaseLayout.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "BitboardUtils.h"
+#include "MaterialKey.h"
+
+
+namespace
+{
+
+constexpr int		  PAWN_KING_SLOTS = 32; // Files a-d
+constexpr int		  KING_SLOTS	  = 10; // a1-d1-d4 triangle
+
+// Squares of the triangle slots (a8 = 0): a1, b1, c1, d1, b2, c2, d2, c3, d3, d4
+constexpr int		  TRIANGLE_SQUARES[KING_SLOTS] = {56, 57, 58, 59, 49, 50, 51, 42, 43, 35};
+
+
+constexpr std::array<int, 64> buildTriangleSlots()
+{
+	std::array<int, 64> slots{};
+	slots.fill(-1);
+
+	for (int slot = 0; slot < KING_SLOTS; ++slot)
+		slots[TRIANGLE_SQUARES[slot]] = slot;
+
+	return slots;
+}
+
+constexpr std::array<int, 64> TRIANGLE_SLOTS = buildTriangleSlots();
+
+// Order of the piece letters in a material code
+constexpr PieceType			  CODE_ORDER[]	 = {WQueen, WRook, WBishop, WKnight, WPawn};
+
+
+constexpr PieceType			  swapColour(PieceType type)
+{
+	return static_cast<PieceType>(type < BKing ? type + BKing : type - BKing);
+}
+
+
+/**
+ * @brief	Mirror at the a1-h8 diagonal (a8 = 0 indexing).
+ */
+constexpr int transpose(int square)
+{
+	return (7 - (square & 7)) * 8 + (7 - (square >> 3));
+}
+
+} // namespace
+
+
+TablebaseLayout::TablebaseLayout(uint64_t materialKey)
+{
+	if (!isValid(materialKey))
+		return;
+
+	mMaterialKey = materialKey;
+	mTypes[0]	 = WKing;
+	mTypes[1]	 = BKing;
+	mCount		 = 2;
+
+	for (int type = WQueen; type <= BRook; ++type)
+	{
+		if (type == BKing)
+			continue;
+
+		for (int i = 0; i < MaterialKey::count(materialKey, static_cast<PieceType>(type)); ++i)
+			mTypes[mCount++] = static_cast<PieceType>(type);
+	}
+
+	mPawns = MaterialKey::count(materialKey, WPawn) + MaterialKey::count(materialKey, BPawn) > 0;
+	mSize  = static_cast<size_t>(mPawns ? PAWN_KING_SLOTS : KING_SLOTS) * 2;
+
+	for (int i = 1; i < mCount; ++i)
+		mSize *= 64;
+}
+
+
+std::string TablebaseLayout::code() const
+{
+	std::string text = "K";
+
+	for (PieceType type : CODE_ORDER)
+		text.append(MaterialKey::count(mMaterialKey, type), asciiPieces[type]);
+
+	text += "vK";
+
+	for (PieceType type : CODE_ORDER)
+		text.append(MaterialKey::count(mMaterialKey, swapColour(type)), asciiPieces[type]);
+
+	return text;
+}
+
+
+bool TablebaseLayout::isValid(uint64_t materialKey)
+{
+	if (MaterialKey::count(materialKey, WKing) != 1 || MaterialKey::count(materialKey, BKing) != 1)
+		return false;
+
+	int pieces = 0;
+
+	for (int type = WKing; type <= BRook; ++type)
+		pieces += MaterialKey::count(materialKey, static_cast<PieceType>(type));
+
+	return pieces <= MAX_PIECES;
+}
+
+
+uint64_t TablebaseLayout::keyOf(const Bitboards &pieces)
+{
+	uint64_t key = 0;
+
+	for (int type = WKing; type <= BRook; ++type)
+		key += BitUtils::popCount(pieces[type]) * MaterialKey::unit(static_cast<PieceType>(type));
+
+	return key;
+}
+
+
+size_t TablebaseLayout::index(const Bitboards &pieces, Side side, bool flip) const
+{
+	// Squares in index order, seen from the stored side (flip: black becomes white, ranks mirrored)
+	Squares squares{};
+
+	for (int i = 0; i < mCount;)
+	{
+		PieceType type	 = mTypes[i];
+		U64		  pieceBB = pieces[flip ? swapColour(type) : type];
+
+		for (; i < mCount && mTypes[i] == type; ++i, pieceBB &= pieceBB - 1)
+		{
+			assert(pieceBB && "The position must have the material of the table");
+			squares[i] = flip ? BitUtils::lsb(pieceBB) ^ 56 : BitUtils::lsb(pieceBB);
+		}
+	}
+
+	int sideIndex = to_index(side) ^ (flip ? 1 : 0);
+
+	if ((squares[0] & 7) > 3)
+	{
+		for (int i = 0; i < mCount; ++i)
+			squares[i] ^= 7;
+	}
+
+	if (!mPawns)
+	{
+		// King onto ranks 1-4, then below the a1-h8 diagonal
+		if ((squares[0] >> 3) < 4)
+		{
+			for (int i = 0; i < mCount; ++i)
+				squares[i] ^= 56;
+		}
+
+		int rank = 7 - (squares[0] >> 3);
+		int file = squares[0] & 7;
+
+		if (rank >= file)
+		{
+			Squares mirrored = squares;
+
+			for (int i = 0; i < mCount; ++i)
+				mirrored[i] = transpose(mirrored[i]);
+
+			sortGroups(mirrored);
+
+			if (rank > file)
+				return compose(mirrored, sideIndex);
+
+			// King on the diagonal: both placements are stored, the smaller index is the one used
+			sortGroups(squares);
+			return std::min(compose(squares, sideIndex), compose(mirrored, sideIndex));
+		}
+	}
+
+	sortGroups(squares);
+	return compose(squares, sideIndex);
+}
+
+
+bool TablebaseLayout::decode(size_t index, Bitboards &pieces, Side &side) const
+{
+	if (index >= mSize)
+		return false;
+
+	Squares squares{};
+	size_t	rest = index >> 1;
+
+	for (int i = mCount - 1; i > 0; --i, rest >>= 6)
+		squares[i] = static_cast<int>(rest & 63);
+
+	squares[0] = mPawns ? static_cast<int>(rest / 4 * 8 + rest % 4) : TRIANGLE_SQUARES[rest];
+
+	pieces.fill(0);
+	U64 occupied = 0;
+
+	for (int i = 0; i < mCount; ++i)
+	{
+		U64 square = 1ULL << squares[i];
+
+		if (occupied & square)
+			return false;
+
+		if ((mTypes[i] == WPawn || mTypes[i] == BPawn) && ((squares[i] >> 3) == 0 || (squares[i] >> 3) == 7))
+			return false;
+
+		occupied |= square;
+		pieces[mTypes[i]] |= square;
+	}
+
+	side = (index & 1) ? Side::Black : Side::White;
+
+	// Unsorted groups and the mirrored duplicates of diagonal placements map to another index
+	return this->index(pieces, side, false) == index;
+}
+
+
+void TablebaseLayout::sortGroups(Squares &squares) const
+{
+	for (int i = 2; i < mCount; ++i)
+	{
+		for (int j = i; j > 2 && mTypes[j - 1] == mTypes[j] && squares[j - 1] > squares[j]; --j)
+			std::swap(squares[j - 1], squares[j]);
+	}
+}
+
+
+size_t TablebaseLayout::compose(const Squares &squares, int side) const
+{
+	size_t index = static_cast<size_t>(mPawns ? (squares[0] >> 3) * 4 + (squares[0] & 7) : TRIANGLE_SLOTS[squares[0]]);
+
+	for (int i = 1; i < mCount; ++i)
+		index = index * 64 + squares[i];
+
+	return index * 2 + side;
+}
@@ -0,0 +1,85 @@
+/*
+  ==============================================================================
+	Module:         TablebaseLayout
+	Description:    Position indexing of the endgame table generator
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "BitboardTypes.h"
+
+
+/**
+ * @brief	Maps the positions of one material signature to the generator's indices and back.
+ *
+ * This is the working index of TablebaseGenerator, it is not written to disk: TablebaseWriter stores the
+ * results in the Syzygy encoding of TablebaseIndex. The side with more material plays white. The index
+ * is built from the white king's slot, the squares of the other pieces (black king first, then by piece
+ * type) and the side to move. The white king is mirrored onto files a-d, and without pawns also onto the
+ * a1-d1-d4 triangle (10 slots). Pieces of the same type are sorted, and positions with the king on the
+ * diagonal use the smaller of the two mirrored indices, so every position has exactly one index.
+ */
+class TablebaseLayout
+{
+public:
+	static constexpr int MAX_PIECES = 6;
+
+	using Bitboards					= std::array<U64, 12>;
+
+	TablebaseLayout()				= default;
+	explicit TablebaseLayout(uint64_t materialKey);
+
+	[[nodiscard]] uint64_t materialKey() const { return mMaterialKey; }
+	[[nodiscard]] int	   pieceCount() const { return mCount; }
+	[[nodiscard]] bool	   hasPawns() const { return mPawns; }
+
+	/**
+	 * @brief	Number of indices (including the unused ones of illegal or duplicate placements).
+	 */
+	[[nodiscard]] size_t   size() const { return mSize; }
+
+	/**
+	 * @brief	Material code in the usual table naming: white pieces, 'v', black pieces ("KRPvKR").
+	 */
+	[[nodiscard]] std::string code() const;
+
+	/**
+	 * @brief	Whether the material fits a layout: one king per side, at most MAX_PIECES pieces.
+	 */
+	[[nodiscard]] static bool isValid(uint64_t materialKey);
+
+	/**
+	 * @brief	Material key of the pieces (see MaterialKey).
+	 */
+	[[nodiscard]] static uint64_t keyOf(const Bitboards &pieces);
+
+	/**
+	 * @brief	Index of a position with exactly this material, or with colours swapped if flip is set.
+	 *			Works on the bitboards only and does not allocate.
+	 */
+	[[nodiscard]] size_t   index(const Bitboards &pieces, Side side, bool flip) const;
+
+	/**
+	 * @brief	Position of an index.
+	 * @return	false if the index is unused: pieces on the same square, pawns on the back ranks,
+	 *			or a placement that is stored under another index.
+	 */
+	bool				   decode(size_t index, Bitboards &pieces, Side &side) const;
+
+private:
+	using Squares = std::array<int, MAX_PIECES>;
+
+	void		  sortGroups(Squares &squares) const;
+	size_t		  compose(const Squares &squares, int side) const;
+
+	std::array<PieceType, MAX_PIECES> mTypes{}; // Index order: white king, black king, the others by type
+	int								  mCount	   = 0;
+	bool							  mPawns	   = false;
+	size_t							  mSize		   = 0;
+	uint64_t						  mMaterialKey = 0;
+};
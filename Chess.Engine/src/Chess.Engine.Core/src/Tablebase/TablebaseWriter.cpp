@@ -0,0 +1,502 @@
+/*
+  ==============================================================================
+	Module:         TablebaseWriter
+	Description:    Syzygy table files of a generated endgame table
+  ==============================================================================
+*/
+
+#include "TablebaseWriter.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <queue>
+
+#include "BitboardUtils.h"
+#include "Logging.h"
+#include "MaterialKey.h"
+
+
+namespace
+{
+
+using namespace SyzygyFormat;
+using Bitboards						 = TablebaseIndex::Bitboards;
+
+constexpr int BLOCK_SIZE_LOG		 = 5;
+constexpr int MAX_CODE_LENGTH		 = 24;	  // The decoder holds at least 33 bits
+constexpr int MAX_VALUE				 = 0xFFF; // Values are 12 bit tree entries
+constexpr int DONT_CARE				 = -1;
+constexpr int FIFTY_MOVE_PLIES		 = 100;
+
+
+/**
+ * @brief	One encoded sub-table, in the parts the file keeps apart.
+ */
+struct EncodedTable
+{
+	std::string sizes; // Flags and Huffman code
+	std::string sparseIndex;
+	std::string blockLengths;
+	std::string blocks;
+};
+
+
+inline void appendLE(std::string &bytes, uint64_t value, int count)
+{
+	for (int i = 0; i < count; ++i, value >>= 8)
+		bytes += static_cast<char>(value & 0xFF);
+}
+
+
+inline void align(std::string &bytes, size_t alignment)
+{
+	bytes.append((alignment - bytes.size() % alignment) % alignment, '\0');
+}
+
+
+/**
+ * @brief	One of the 8 board symmetries (bit 0 mirrors the files, bit 1 the ranks, bit 2 at the diagonal).
+ */
+Bitboards transform(const Bitboards &pieces, int symmetry)
+{
+	Bitboards image{};
+
+	for (size_t type = 0; type < pieces.size(); ++type)
+	{
+		for (U64 bb = pieces[type]; bb; bb &= bb - 1)
+		{
+			int square = BitUtils::lsb(bb);
+
+			if (symmetry & 1)
+				square ^= 7;
+
+			if (symmetry & 2)
+				square ^= 56;
+
+			if (symmetry & 4)
+				square = ((square >> 3) | (square << 3)) & 63;
+
+			image[type] |= 1ULL << square;
+		}
+	}
+
+	return image;
+}
+
+
+/**
+ * @brief	Piece order of the sub-tables: leading pawns and other pawns first, or with the kings first
+ *			and a unique piece third. The remaining pieces follow in groups of their kind.
+ */
+TablebaseIndex::Groups pieceOrder(const TablebaseIndex &index)
+{
+	TablebaseIndex::Groups groups;
+	uint64_t			   left	 = index.materialKey();
+	int					   count = 0;
+
+	auto				   take	 = [&](PieceType type)
+	{
+		groups.pieces[count++] = TablebaseIndex::pieceCode(type);
+		left -= MaterialKey::unit(type);
+	};
+
+	if (index.hasPawns())
+	{
+		PieceType lead	= TablebaseIndex::pieceType(index.leadPawn());
+		PieceType other = lead == WPawn ? BPawn : WPawn;
+
+		for (PieceType pawn : {lead, other})
+		{
+			while (MaterialKey::count(left, pawn) > 0)
+				take(pawn);
+		}
+	}
+
+	take(WKing);
+	take(BKing);
+
+	if (!index.hasPawns())
+	{
+		for (int type = WQueen; type <= BRook; ++type)
+		{
+			if (type != BKing && MaterialKey::count(left, static_cast<PieceType>(type)) == 1)
+			{
+				take(static_cast<PieceType>(type));
+				break;
+			}
+		}
+	}
+
+	for (int type = WQueen; type <= BRook; ++type)
+	{
+		while (MaterialKey::count(left, static_cast<PieceType>(type)) > 0)
+			take(static_cast<PieceType>(type));
+	}
+
+	return groups;
+}
+
+
+/**
+ * @brief	Huffman code lengths, flattened until no code is longer than MAX_CODE_LENGTH.
+ */
+std::vector<int> codeLengths(std::vector<uint64_t> weights)
+{
+	size_t count = weights.size();
+
+	if (count == 1)
+		return {1};
+
+	while (true)
+	{
+		using Node = std::pair<uint64_t, size_t>;
+		std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+		std::vector<size_t>												 parent(2 * count - 1, 0);
+		size_t															 next = count;
+
+		for (size_t i = 0; i < count; ++i)
+			queue.push({weights[i], i});
+
+		while (queue.size() > 1)
+		{
+			Node first = queue.top();
+			queue.pop();
+			Node second = queue.top();
+			queue.pop();
+
+			parent[first.second] = parent[second.second] = next;
+			queue.push({first.first + second.first, next++});
+		}
+
+		std::vector<int> lengths(count, 0);
+		int				 longest = 0;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			for (size_t node = i; node != next - 1; node = parent[node])
+				++lengths[i];
+
+			longest = std::max(longest, lengths[i]);
+		}
+
+		if (longest <= MAX_CODE_LENGTH)
+			return lengths;
+
+		for (uint64_t &weight : weights)
+			weight = (weight + 1) / 2;
+	}
+}
+
+
+/**
+ * @brief	Compress the values of a sub-table. Don't care values take the most common value.
+ */
+EncodedTable encode(std::vector<int> &values, uint8_t flags)
+{
+	EncodedTable		  table;
+	std::vector<uint64_t> frequencies(MAX_VALUE + 1, 0);
+
+	for (int value : values)
+	{
+		if (value != DONT_CARE)
+			++frequencies[value];
+	}
+
+	int common = static_cast<int>(std::max_element(frequencies.begin(), frequencies.end()) - frequencies.begin());
+
+	for (int &value : values)
+	{
+		if (value == DONT_CARE)
+		{
+			value = common;
+			++frequencies[common];
+		}
+	}
+
+	std::vector<int> used;
+
+	for (int value = 0; value <= MAX_VALUE; ++value)
+	{
+		if (frequencies[value] > 0)
+			used.push_back(value);
+	}
+
+	if (used.size() == 1 && used[0] <= 0xFF)
+	{
+		table.sizes += static_cast<char>(flags | SINGLE_VALUE);
+		table.sizes += static_cast<char>(used[0]);
+		return table;
+	}
+
+	std::vector<uint64_t> weights;
+
+	for (int value : used)
+		weights.push_back(frequencies[value]);
+
+	// Canonical code: longer codes get the lower symbols, the codes of a length follow the longer ones
+	std::vector<int>	lengths = codeLengths(weights);
+	std::vector<size_t> bySymbol(used.size());
+
+	for (size_t i = 0; i < bySymbol.size(); ++i)
+		bySymbol[i] = i;
+
+	std::stable_sort(bySymbol.begin(), bySymbol.end(), [&lengths](size_t a, size_t b) { return lengths[a] > lengths[b]; });
+
+	int				 minLength = *std::min_element(lengths.begin(), lengths.end());
+	int				 maxLength = *std::max_element(lengths.begin(), lengths.end());
+	int				 levels	   = maxLength - minLength + 1;
+
+	std::vector<int> perLength(levels, 0);
+
+	for (int length : lengths)
+		++perLength[length - minLength];
+
+	std::vector<int>	  lowestSymbol(levels, 0);
+	std::vector<uint64_t> base(levels, 0);
+
+	for (int i = levels - 2; i >= 0; --i)
+	{
+		lowestSymbol[i] = lowestSymbol[i + 1] + perLength[i + 1];
+		base[i]			= (base[i + 1] + perLength[i + 1]) / 2;
+	}
+
+	std::vector<uint64_t> codes(MAX_VALUE + 1, 0);
+	std::vector<int>	  codeLength(MAX_VALUE + 1, 0);
+	std::vector<int>	  seen(levels, 0);
+
+	for (size_t symbol = 0; symbol < bySymbol.size(); ++symbol)
+	{
+		size_t value		   = bySymbol[symbol];
+		int	   level		   = lengths[value] - minLength;
+		codes[used[value]]	   = base[level] + seen[level]++;
+		codeLength[used[value]] = lengths[value];
+	}
+
+	// Blocks of whole codes, most significant bit first
+	size_t				  blockSize = size_t(1) << BLOCK_SIZE_LOG;
+	std::vector<uint64_t> firstValue;
+	size_t				  bits = 8 * blockSize;
+
+	for (size_t i = 0; i < values.size(); ++i)
+	{
+		int length = codeLength[values[i]];
+
+		if (bits + length > 8 * blockSize)
+		{
+			firstValue.push_back(i);
+			table.blocks.append(blockSize, '\0');
+			bits = 0;
+		}
+
+		for (int bit = length - 1; bit >= 0; --bit, ++bits)
+		{
+			if (codes[values[i]] >> bit & 1)
+				table.blocks[table.blocks.size() - blockSize + bits / 8] |= static_cast<char>(0x80 >> (bits % 8));
+		}
+	}
+
+	size_t blockCount = firstValue.size();
+	firstValue.push_back(values.size());
+
+	for (size_t block = 0; block < blockCount; ++block)
+		appendLE(table.blockLengths, firstValue[block + 1] - firstValue[block] - 1, 2);
+
+	// About one sparse entry per block; an entry names the block and offset of the value in the middle of its span
+	int spanLog = 0;
+
+	while (spanLog < 15 && (uint64_t(2) << spanLog) * blockCount <= values.size())
+		++spanLog;
+
+	uint64_t span = uint64_t(1) << spanLog;
+
+	for (uint64_t start = 0; start < values.size(); start += span)
+	{
+		uint64_t middle = start + span / 2;
+		uint64_t block	= blockCount - 1;
+		uint64_t offset = firstValue[blockCount] - 1 - firstValue[block] + (middle - (values.size() - 1));
+
+		if (middle < values.size())
+		{
+			block  = std::upper_bound(firstValue.begin(), firstValue.end(), middle) - firstValue.begin() - 1;
+			offset = middle - firstValue[block];
+		}
+
+		appendLE(table.sparseIndex, block, 4);
+		appendLE(table.sparseIndex, offset, 2);
+	}
+
+	table.sizes += static_cast<char>(flags);
+	table.sizes += static_cast<char>(BLOCK_SIZE_LOG);
+	table.sizes += static_cast<char>(spanLog);
+	table.sizes += '\0'; // No padding of the block lengths
+	appendLE(table.sizes, blockCount, 4);
+	table.sizes += static_cast<char>(maxLength);
+	table.sizes += static_cast<char>(minLength);
+
+	for (int level = 0; level < levels; ++level)
+		appendLE(table.sizes, lowestSymbol[level], 2);
+
+	// Every symbol is a leaf of the pair tree: its value and no right symbol
+	appendLE(table.sizes, bySymbol.size(), 2);
+
+	for (size_t value : bySymbol)
+	{
+		table.sizes += static_cast<char>(used[value] & 0xFF);
+		table.sizes += static_cast<char>((used[value] >> 8 & 0xF) | 0xF0);
+		table.sizes += static_cast<char>(0xFF);
+	}
+
+	if (bySymbol.size() & 1)
+		table.sizes += '\0';
+
+	return table;
+}
+
+
+/**
+ * @brief	Assemble and write one file from its sub-tables (file by file, side by side).
+ */
+bool writeFile(const std::string &path, const uint8_t *magic, const TablebaseIndex &index, const TablebaseIndex::Groups &groups, const std::vector<EncodedTable> &tables)
+{
+	std::string bytes(reinterpret_cast<const char *>(magic), MAGIC_SIZE);
+	bytes += static_cast<char>((index.isSymmetric() ? 0 : SPLIT) | (index.hasPawns() ? HAS_PAWNS : 0));
+
+	bool bothPawns = index.hasPawns() && index.pawnCount(1) > 0;
+
+	for (int f = 0; f < index.files(); ++f)
+	{
+		// The leading group comes first in the index, then the other pawns
+		bytes += '\0';
+
+		if (bothPawns)
+			bytes += static_cast<char>(0x11);
+
+		for (int k = 0; k < index.pieceCount(); ++k)
+			bytes += static_cast<char>(groups.pieces[k] | groups.pieces[k] << 4);
+	}
+
+	align(bytes, 2);
+
+	for (const EncodedTable &table : tables)
+		bytes += table.sizes;
+
+	align(bytes, 2);
+
+	for (const EncodedTable &table : tables)
+		bytes += table.sparseIndex;
+
+	for (const EncodedTable &table : tables)
+		bytes += table.blockLengths;
+
+	for (const EncodedTable &table : tables)
+	{
+		align(bytes, 64);
+		bytes += table.blocks;
+	}
+
+	// The decoder reads ahead of the last block, and the files end 16 bytes past a multiple of 64
+	bytes.append(8, '\0');
+	bytes.append((64 + 16 - bytes.size() % 64) % 64, '\0');
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+
+	if (!file)
+	{
+		LOG_ERROR("Could not write the table file {}", path);
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief	Stored distance of a position: plies before the zeroing move, cursed ones in moves beyond the 100 plies.
+ */
+int storedDistance(Wdl wdl, int dtz)
+{
+	int plies = std::max(dtz, 1);
+
+	switch (wdl)
+	{
+	case Wdl::Win:
+	case Wdl::Loss: return std::min(plies - 1, MAX_VALUE);
+	case Wdl::CursedWin:
+	case Wdl::BlessedLoss: return std::min((plies - FIFTY_MOVE_PLIES) / 2, MAX_VALUE);
+	default: return 0;
+	}
+}
+
+} // namespace
+
+
+bool TablebaseWriter::write(const std::string &directory, const TablebaseLayout &layout, const std::vector<Wdl> &wdl, const std::vector<uint16_t> &dtz)
+{
+	if (wdl.size() != layout.size() || dtz.size() != layout.size())
+	{
+		LOG_ERROR("Table {} needs {} results, got {} and {} distances", layout.code(), layout.size(), wdl.size(), dtz.size());
+		return false;
+	}
+
+	TablebaseIndex						index(layout.materialKey());
+	int									sides = index.isSymmetric() ? 1 : 2;
+	int									files = index.files();
+	TablebaseIndex::Groups				order = pieceOrder(index);
+
+	std::vector<TablebaseIndex::Groups> groups(files, order);
+	std::vector<std::vector<int>>		wdlValues(files * sides);
+	std::vector<std::vector<int>>		dtzValues(files);
+
+	for (int f = 0; f < files; ++f)
+	{
+		index.setGroups(groups[f], 0, 1, f);
+		dtzValues[f].assign(groups[f].size(), DONT_CARE);
+
+		for (int side = 0; side < sides; ++side)
+			wdlValues[f * sides + side].assign(groups[f].size(), DONT_CARE);
+	}
+
+	// Pawns only allow the file mirror
+	int symmetries = index.hasPawns() ? 2 : 8;
+
+	for (size_t i = 0; i < layout.size(); ++i)
+	{
+		Bitboards pieces{};
+		Side	  side = Side::White;
+
+		if (dtz[i] == UNUSED || !layout.decode(i, pieces, side))
+			continue;
+
+		// Symmetric material stores white to move, black to move is read with the colours swapped
+		if (sides == 1 && side == Side::Black)
+			continue;
+
+		for (int symmetry = 0; symmetry < symmetries; ++symmetry)
+		{
+			TablebaseIndex::Placement placement = index.place(transform(pieces, symmetry), false, index.leadPawn());
+			uint64_t				  at		= index.index(groups[placement.file], placement);
+
+			wdlValues[placement.file * sides + (sides == 1 ? 0 : to_index(side))][at] = static_cast<int>(wdl[i]) + 2;
+
+			if (side == Side::White)
+				dtzValues[placement.file][at] = storedDistance(wdl[i], dtz[i]);
+		}
+	}
+
+	std::vector<EncodedTable> wdlTables;
+	std::vector<EncodedTable> dtzTables;
+
+	for (auto &values : wdlValues)
+		wdlTables.push_back(encode(values, 0));
+
+	for (auto &values : dtzValues)
+		dtzTables.push_back(encode(values, WIN_PLIES | LOSS_PLIES));
+
+	std::string base = (std::filesystem::path(directory) / layout.code()).string();
+
+	return writeFile(base + std::string(Tablebase::WDL_EXTENSION), WDL_MAGIC, index, order, wdlTables)
+		&& writeFile(base + std::string(Tablebase::DTZ_EXTENSION), DTZ_MAGIC, index, order, dtzTables);
+}
@@ -0,0 +1,38 @@
+/*
+  ==============================================================================
+	Module:         TablebaseWriter
+	Description:    Syzygy table files of a generated endgame table
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Tablebase.h"
+#include "TablebaseLayout.h"
+
+
+/**
+ * @brief	Writes the results of a generated table as a Syzygy file pair (see Tablebase).
+ *
+ * Every position of the layout is stored under each of its symmetric images, since the Syzygy index
+ * picks its own representative. The win/draw/loss file holds both sides to move (one for symmetric
+ * material), the distance file white to move only, in plies. Illegal indices take the most common value
+ * of their sub-table. Values are Huffman coded in 32 byte blocks without pair compression.
+ */
+class TablebaseWriter
+{
+public:
+	// Distance of a layout index that holds no position
+	static constexpr uint16_t UNUSED = 0xFFFF;
+
+	/**
+	 * @param	wdl		Result of every index of the layout.
+	 * @param	dtz		Plies to the next zeroing move of every index (1 for mated positions), or UNUSED.
+	 * @return	false (logged) if a file can't be written.
+	 */
+	static bool				  write(const std::string &directory, const TablebaseLayout &layout, const std::vector<Wdl> &wdl, const std::vector<uint16_t> &dtz);
+};
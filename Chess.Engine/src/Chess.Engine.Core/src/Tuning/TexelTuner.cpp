@@ -0,0 +1,674 @@
+/*
+  ==============================================================================
+	Module:         TexelTuner
+	Description:    Logistic regression tuning of the evaluation's material and piece-square values
+  ==============================================================================
+*/
+
+#include "TexelTuner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <thread>
+
+#include "Evaluation.h"
+#include "GameEngine.h"
+#include "Logging.h"
+#include "Evaluation/MoveEvaluation.h"
+
+
+namespace
+{
+
+constexpr int	 MAX_QUIESCENCE_DEPTH = 8;
+constexpr int	 INFINITE_SCORE		  = 1'000'000;
+constexpr size_t LINES_PER_CHUNK	  = 1 << 16;
+constexpr double LOG10				  = 2.302585092994046;
+
+
+int resolveThreads(int threads)
+{
+	if (threads > 0)
+		return threads;
+
+	return std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+/**
+ * @brief	Capture-only search that also returns the line leading to its quiet leaf.
+ */
+int quiescence(GameEngine &engine, const MoveEvaluation &ordering, int alpha, int beta, int depth, std::vector<Move> &line)
+{
+	line.clear();
+
+	bool exact;
+	int	 standPat = Evaluation::evaluate(engine.getBoard(), alpha, beta, exact);
+
+	if (standPat >= beta)
+		return beta;
+
+	alpha = std::max(alpha, standPat);
+
+	if (depth >= MAX_QUIESCENCE_DEPTH)
+		return alpha;
+
+	MoveList moves;
+	MoveList captures;
+	engine.generateLegalMoves(moves);
+
+	for (size_t i = 0; i < moves.size(); ++i)
+	{
+		if (moves[i].isCapture())
+			captures.push(moves[i]);
+	}
+
+	ordering.orderCaptures(captures, engine.getBoard());
+
+	std::vector<Move> childLine;
+
+	for (size_t i = 0; i < captures.size(); ++i)
+	{
+		if (!engine.makeMoveUnchecked(captures[i]))
+			continue;
+
+		int score = -quiescence(engine, ordering, -beta, -alpha, depth + 1, childLine);
+		engine.undoMoveUnchecked();
+
+		if (score >= beta)
+			return beta;
+
+		if (score > alpha)
+		{
+			alpha = score;
+			line.assign(1, captures[i]);
+			line.insert(line.end(), childLine.begin(), childLine.end());
+		}
+	}
+
+	return alpha;
+}
+
+
+double sigmoid(double k, double eval)
+{
+	return 1.0 / (1.0 + std::pow(10.0, -k * eval / 400.0));
+}
+
+} // namespace
+
+
+//=========================================================================
+// Parameters
+//=========================================================================
+
+TuningParameters TuningParameters::fromEvaluation()
+{
+	return fromWeights(ConstexprWeights::get());
+}
+
+
+TuningParameters TuningParameters::fromWeights(const EvalWeights &weights)
+{
+	TuningParameters params;
+
+	for (int type = 0; type < PIECE_TYPES; ++type)
+	{
+		for (int sq = 0; sq < 64; ++sq)
+		{
+			params.mg[pstIndex(type, sq)] = mgScore(weights.pst[type][sq]);
+			params.eg[pstIndex(type, sq)] = egScore(weights.pst[type][sq]);
+		}
+
+		params.mg[materialIndex(type)] = mgScore(weights.material[type]);
+		params.eg[materialIndex(type)] = egScore(weights.material[type]);
+	}
+
+	return params;
+}
+
+
+EvalWeights TuningParameters::toWeights(const EvalWeights &base) const
+{
+	EvalWeights weights = base;
+
+	auto		round	= [this](int index) { return makeScore(static_cast<int>(std::lround(mg[index])), static_cast<int>(std::lround(eg[index]))); };
+
+	for (int type = 0; type < PIECE_TYPES; ++type)
+	{
+		for (int sq = 0; sq < 64; ++sq)
+			weights.pst[type][sq] = round(pstIndex(type, sq));
+
+		weights.material[type] = round(materialIndex(type));
+	}
+
+	return weights;
+}
+
+
+//=========================================================================
+// Dataset
+//=========================================================================
+
+bool TuningDataset::load(const std::string &path, int threads, size_t maxPositions)
+{
+	std::ifstream file(path);
+
+	if (!file)
+	{
+		LOG_ERROR("Could not open tuning dataset {}", path);
+		return false;
+	}
+
+	threads = resolveThreads(threads);
+
+	std::vector<std::string> lines;
+	lines.reserve(LINES_PER_CHUNK);
+
+	std::string line;
+	size_t		read = 0;
+
+	while (std::getline(file, line) && (maxPositions == 0 || read < maxPositions))
+	{
+		lines.push_back(std::move(line));
+		++read;
+
+		if (lines.size() == LINES_PER_CHUNK)
+		{
+			addLines(lines, threads);
+			lines.clear();
+		}
+	}
+
+	addLines(lines, threads);
+
+	LOG_INFO("Loaded {} tuning positions from {} ({} skipped, {:.1f} MB)", mPositions.size(), path, mSkipped, memoryUsage() / (1024.0 * 1024.0));
+	return true;
+}
+
+
+void TuningDataset::addLines(const std::vector<std::string> &lines, int threads)
+{
+	if (lines.empty())
+		return;
+
+	threads = std::min<int>(threads, static_cast<int>(lines.size()));
+
+	std::vector<TuningDataset> parts(threads);
+	std::vector<std::thread>   workers;
+
+	for (int t = 0; t < threads; ++t)
+	{
+		workers.emplace_back(
+			[&lines, &parts, t, threads]
+			{
+				GameEngine engine;
+				engine.init();
+
+				TuningDataset &part	 = parts[t];
+				size_t		   begin = lines.size() * t / threads;
+				size_t		   end	 = lines.size() * (t + 1) / threads;
+
+				std::string	   fen;
+				double		   result;
+				FenPosition	   position;
+
+				for (size_t i = begin; i < end; ++i)
+				{
+					// Parsed without Chessboard::parseFEN() to skip broken lines silently
+					if (!parseLine(lines[i], fen, result) || Fen::parse(fen, position) != FenError::None || Fen::validate(position) != FenError::None)
+					{
+						++part.mSkipped;
+						continue;
+					}
+
+					engine.getBoard().setPosition(position);
+					part.add(engine, result);
+				}
+			});
+	}
+
+	for (auto &worker : workers)
+		worker.join();
+
+	for (const auto &part : parts)
+		append(part);
+}
+
+
+void TuningDataset::add(GameEngine &engine, double result)
+{
+	MoveEvaluation	  ordering;
+	std::vector<Move> line;
+	quiescence(engine, ordering, -INFINITE_SCORE, INFINITE_SCORE, 0, line);
+
+	int played = 0;
+
+	for (Move move : line)
+	{
+		if (!engine.makeMoveUnchecked(move))
+			break;
+		++played;
+	}
+
+	addBoard(engine.getBoard(), result);
+
+	for (; played > 0; --played)
+		engine.undoMoveUnchecked();
+}
+
+
+void TuningDataset::addBoard(const Chessboard &board, double result)
+{
+	// Specialized endgame scores don't depend on the tuned values
+	int endgame;
+
+	if (Endgames::probe(board, endgame))
+	{
+		++mSkipped;
+		return;
+	}
+
+	const auto &pieces = board.pieces();
+
+	int			counts[TuningParameters::COUNT] = {};
+
+	for (int piece = 0; piece < 12; ++piece)
+	{
+		bool isWhite = piece < PieceType::BKing;
+		int	 type	 = isWhite ? piece : piece - PieceType::BKing;
+		int	 sign	 = isWhite ? 1 : -1;
+
+		for (U64 bb = pieces[piece]; bb; bb &= bb - 1)
+		{
+			int sq = BitUtils::lsb(bb);
+			counts[TuningParameters::pstIndex(type, isWhite ? sq : PieceSquareTables::mirrorSquare(sq))] += sign;
+			counts[TuningParameters::materialIndex(type)] += sign;
+		}
+	}
+
+	TuningPosition position;
+	position.firstFeature = static_cast<uint32_t>(mFeatures.size());
+	position.phase		  = static_cast<uint8_t>(std::min(board.getPhase(), GamePhase::MAX));
+	position.result		  = static_cast<uint8_t>(std::lround(result * 2.0));
+
+	for (int index = 0; index < TuningParameters::COUNT; ++index)
+	{
+		if (counts[index] == 0)
+			continue;
+
+		mFeatures.push_back(static_cast<uint16_t>((counts[index] << 9) | index));
+		++position.featureCount;
+	}
+
+	// Everything the tuned values don't cover, as blended by the evaluation
+	int eval			= Evaluation::evaluate(board);
+	eval				= board.getCurrentSide() == Side::White ? eval : -eval;
+	position.fixedScore = static_cast<int16_t>(eval - GamePhase::interpolate(board.getPieceScore(), board.getPhase()));
+
+	mPositions.push_back(position);
+}
+
+
+void TuningDataset::append(const TuningDataset &other)
+{
+	uint32_t offset = static_cast<uint32_t>(mFeatures.size());
+
+	for (TuningPosition position : other.mPositions)
+	{
+		position.firstFeature += offset;
+		mPositions.push_back(position);
+	}
+
+	mFeatures.insert(mFeatures.end(), other.mFeatures.begin(), other.mFeatures.end());
+	mSkipped += other.mSkipped;
+}
+
+
+bool TuningDataset::parseLine(std::string_view line, std::string &fen, double &result)
+{
+	struct Notation
+	{
+		std::string_view text;
+		double			 result;
+	};
+
+	static constexpr Notation notations[] = {
+		{"1/2-1/2", 0.5}, {"1-0", 1.0}, {"0-1", 0.0}, {"[1.0]", 1.0}, {"[0.5]", 0.5}, {"[0.0]", 0.0},
+	};
+
+	// Placement, side, castling and en passant, followed by the move counters if the line has them
+	size_t fenEnd = 0;
+	int	   fields = 0;
+
+	while (fields < 6)
+	{
+		size_t start = line.find_first_not_of(" \t", fenEnd);
+
+		if (start == std::string_view::npos)
+			break;
+
+		size_t end = std::min(line.find_first_of(" \t", start), line.size());
+
+		if (fields >= 4 && line.substr(start, end - start).find_first_not_of("0123456789") != std::string_view::npos)
+			break;
+
+		fenEnd = end;
+		++fields;
+	}
+
+	if (fields < 4)
+		return false;
+
+	std::string_view rest = line.substr(fenEnd);
+
+	for (const Notation &notation : notations)
+	{
+		if (rest.find(notation.text) == std::string_view::npos)
+			continue;
+
+		fen.assign(line.substr(0, fenEnd));
+		result = notation.result;
+		return true;
+	}
+
+	return false;
+}
+
+
+void TuningDataset::clear()
+{
+	mPositions.clear();
+	mFeatures.clear();
+	mSkipped = 0;
+}
+
+
+//=========================================================================
+// Tuner
+//=========================================================================
+
+TexelTuner::TexelTuner(const TuningDataset &dataset, int threads) : mDataset(dataset), mThreads(resolveThreads(threads)) {}
+
+
+double TexelTuner::evaluate(const TuningParameters &params, size_t index) const
+{
+	const TuningPosition &position = mDataset.position(index);
+
+	double				  mg	   = 0.0;
+	double				  eg	   = 0.0;
+
+	for (uint32_t i = position.firstFeature; i < position.firstFeature + position.featureCount; ++i)
+	{
+		uint16_t feature = mDataset.feature(i);
+		int		 param	 = TuningDataset::featureIndex(feature);
+		int		 count	 = TuningDataset::featureCount(feature);
+
+		mg += count * params.mg[param];
+		eg += count * params.eg[param];
+	}
+
+	return (mg * position.phase + eg * (GamePhase::MAX - position.phase)) / GamePhase::MAX + position.fixedScore;
+}
+
+
+double TexelTuner::accumulate(const TuningParameters &params, size_t begin, size_t end, TuningParameters *gradient) const
+{
+	double loss = 0.0;
+
+	for (size_t index = begin; index < end; ++index)
+	{
+		const TuningPosition &position	  = mDataset.position(index);
+
+		double				  result	  = position.result / 2.0;
+		double				  probability = std::clamp(sigmoid(mScaling, evaluate(params, index)), 1e-12, 1.0 - 1e-12);
+
+		loss -= result * std::log(probability) + (1.0 - result) * std::log(1.0 - probability);
+
+		if (!gradient)
+			continue;
+
+		// d loss / d eval of the logistic loss, split between the phases
+		double slope   = (probability - result) * mScaling * LOG10 / 400.0;
+		double mgSlope = slope * position.phase / GamePhase::MAX;
+		double egSlope = slope - mgSlope;
+
+		for (uint32_t i = position.firstFeature; i < position.firstFeature + position.featureCount; ++i)
+		{
+			uint16_t feature = mDataset.feature(i);
+			int		 param	 = TuningDataset::featureIndex(feature);
+			int		 count	 = TuningDataset::featureCount(feature);
+
+			gradient->mg[param] += mgSlope * count;
+			gradient->eg[param] += egSlope * count;
+		}
+	}
+
+	return loss;
+}
+
+
+double TexelTuner::accumulateParallel(const TuningParameters &params, TuningParameters *gradient) const
+{
+	size_t						  size	  = mDataset.size();
+	int							  threads = static_cast<int>(std::min<size_t>(mThreads, std::max<size_t>(size, 1)));
+
+	std::vector<double>			  losses(threads, 0.0);
+	std::vector<TuningParameters> gradients(gradient ? threads : 0);
+	std::vector<std::thread>	  workers;
+
+	for (int t = 0; t < threads; ++t)
+	{
+		workers.emplace_back([&, t]
+							 { losses[t] = accumulate(params, size * t / threads, size * (t + 1) / threads, gradient ? &gradients[t] : nullptr); });
+	}
+
+	for (auto &worker : workers)
+		worker.join();
+
+	double loss = 0.0;
+
+	for (int t = 0; t < threads; ++t)
+	{
+		loss += losses[t];
+
+		if (!gradient)
+			continue;
+
+		for (int i = 0; i < TuningParameters::COUNT; ++i)
+		{
+			gradient->mg[i] += gradients[t].mg[i];
+			gradient->eg[i] += gradients[t].eg[i];
+		}
+	}
+
+	return loss;
+}
+
+
+double TexelTuner::loss(const TuningParameters &params) const
+{
+	if (mDataset.size() == 0)
+		return 0.0;
+
+	return accumulateParallel(params, nullptr) / mDataset.size();
+}
+
+
+double TexelTuner::gradient(const TuningParameters &params, TuningParameters &gradient) const
+{
+	gradient = TuningParameters{};
+
+	if (mDataset.size() == 0)
+		return 0.0;
+
+	double loss = accumulateParallel(params, &gradient);
+
+	for (int i = 0; i < TuningParameters::COUNT; ++i)
+	{
+		gradient.mg[i] /= mDataset.size();
+		gradient.eg[i] /= mDataset.size();
+	}
+
+	return loss / mDataset.size();
+}
+
+
+double TexelTuner::fitScalingConstant(const TuningParameters &params)
+{
+	// The loss is convex in K, narrow the range by golden section search
+	constexpr double ratio = 0.6180339887498949;
+
+	double			 low   = 0.05;
+	double			 high  = 5.0;
+
+	auto			 lossFor = [&](double k)
+	{
+		mScaling = k;
+		return loss(params);
+	};
+
+	double a	 = high - ratio * (high - low);
+	double b	 = low + ratio * (high - low);
+	double lossA = lossFor(a);
+	double lossB = lossFor(b);
+
+	for (int i = 0; i < 40; ++i)
+	{
+		if (lossA < lossB)
+		{
+			high  = b;
+			b	  = a;
+			lossB = lossA;
+			a	  = high - ratio * (high - low);
+			lossA = lossFor(a);
+		}
+		else
+		{
+			low	  = a;
+			a	  = b;
+			lossA = lossB;
+			b	  = low + ratio * (high - low);
+			lossB = lossFor(b);
+		}
+	}
+
+	mScaling = (low + high) / 2.0;
+	return mScaling;
+}
+
+
+double TexelTuner::tune(TuningParameters &params, int epochs, double learningRate)
+{
+	// Adam: per-parameter step sizes, so rarely seen squares still move
+	constexpr double beta1	 = 0.9;
+	constexpr double beta2	 = 0.999;
+	constexpr double epsilon = 1e-8;
+
+	TuningParameters moment;
+	TuningParameters velocity;
+	TuningParameters grad;
+
+	for (int epoch = 1; epoch <= epochs; ++epoch)
+	{
+		double epochLoss   = gradient(params, grad);
+
+		double correction1 = 1.0 - std::pow(beta1, epoch);
+		double correction2 = 1.0 - std::pow(beta2, epoch);
+
+		auto   step		   = [&](double &value, double &m, double &v, double g)
+		{
+			m = beta1 * m + (1.0 - beta1) * g;
+			v = beta2 * v + (1.0 - beta2) * g * g;
+			value -= learningRate * (m / correction1) / (std::sqrt(v / correction2) + epsilon);
+		};
+
+		for (int i = 0; i < TuningParameters::COUNT; ++i)
+		{
+			// The king carries no material, both kings are always on the board
+			if (i == TuningParameters::materialIndex(0))
+				continue;
+
+			step(params.mg[i], moment.mg[i], velocity.mg[i], grad.mg[i]);
+			step(params.eg[i], moment.eg[i], velocity.eg[i], grad.eg[i]);
+		}
+
+		if (epoch == 1 || epoch % 10 == 0 || epoch == epochs)
+			LOG_INFO("Epoch {}: loss {:.6f}", epoch, epochLoss);
+	}
+
+	return loss(params);
+}
+
+
+bool TexelTuner::writeHeader(const TuningParameters &params, const std::string &path)
+{
+	std::ofstream file(path);
+
+	if (!file)
+	{
+		LOG_ERROR("Could not create {}", path);
+		return false;
+	}
+
+	static constexpr const char *names[TuningParameters::PIECE_TYPES] = {"King", "Queen", "Pawn", "Knight", "Bishop", "Rook"};
+
+	auto writeMaterial = [&](const char *name, const std::array<double, TuningParameters::COUNT> &values)
+	{
+		file << "constexpr int " << name << "[" << TuningParameters::PIECE_TYPES << "] = {";
+
+		for (int type = 0; type < TuningParameters::PIECE_TYPES; ++type)
+			file << (type ? ", " : "") << std::lround(values[TuningParameters::materialIndex(type)]);
+
+		file << "};\n";
+	};
+
+	auto writeTables = [&](const char *name, const std::array<double, TuningParameters::COUNT> &values)
+	{
+		file << "\nconstexpr int " << name << "[" << TuningParameters::PIECE_TYPES << "][64] =\n{\n";
+
+		for (int type = 0; type < TuningParameters::PIECE_TYPES; ++type)
+		{
+			file << "\t// " << names[type] << "\n\t{\n";
+
+			for (int rank = 0; rank < 8; ++rank)
+			{
+				file << "\t\t";
+
+				for (int fileIndex = 0; fileIndex < 8; ++fileIndex)
+				{
+					std::string value = std::to_string(std::lround(values[TuningParameters::pstIndex(type, rank * 8 + fileIndex)]));
+					file << std::string(value.size() < 4 ? 4 - value.size() : 0, ' ') << value << ",";
+				}
+
+				file << "\n";
+			}
+
+			file << "\t},\n";
+		}
+
+		file << "};\n";
+	};
+
+	file << "/*\n"
+		 << "  ==============================================================================\n"
+		 << "\tModule:         TunedParameters\n"
+		 << "\tDescription:    Material and piece-square values generated by the Texel tuner\n"
+		 << "  ==============================================================================\n"
+		 << "*/\n\n"
+		 << "#pragma once\n\n\n"
+		 << "namespace TunedParameters\n{\n\n"
+		 << "// PieceType order of the white pieces (King, Queen, Pawn, Knight, Bishop, Rook),\n"
+		 << "// squares from white's perspective (a8 = index 0)\n\n"
+		 << "// clang-format off\n";
+
+	writeMaterial("MATERIAL_MG", params.mg);
+	writeMaterial("MATERIAL_EG", params.eg);
+	writeTables("PST_MG", params.mg);
+	writeTables("PST_EG", params.eg);
+
+	file << "// clang-format on\n\n} // namespace TunedParameters\n";
+
+	return static_cast<bool>(file);
+}
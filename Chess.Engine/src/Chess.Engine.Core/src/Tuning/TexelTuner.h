@@ -0,0 +1,205 @@
+/*
+  ==============================================================================
+	Module:         TexelTuner
+	Description:    Logistic regression tuning of the evaluation's material and piece-square values
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "EvalWeights.h"
+#include "Score.h"
+
+
+class Chessboard;
+class GameEngine;
+
+
+/**
+ * @brief	Parameters the tuner fits: piece-square and material values of every piece type,
+ *			each as a midgame/endgame pair. Types follow the PieceType order of the white pieces
+ *			(King, Queen, Pawn, Knight, Bishop, Rook), squares are from white's perspective (a8 = 0).
+ */
+struct TuningParameters
+{
+	static constexpr int		 PIECE_TYPES = 6;
+	static constexpr int		 PST_COUNT	 = PIECE_TYPES * 64;
+	static constexpr int		 COUNT		 = PST_COUNT + PIECE_TYPES; // piece-square values followed by the material values
+
+	std::array<double, COUNT>	 mg{};
+	std::array<double, COUNT>	 eg{};
+
+	static constexpr int		 pstIndex(int type, int sq) { return type * 64 + sq; }
+	static constexpr int		 materialIndex(int type) { return PST_COUNT + type; }
+
+	/**
+	 * @brief	The values the evaluation currently uses (PieceValues and PieceSquareTables).
+	 */
+	[[nodiscard]] static TuningParameters fromEvaluation();
+
+	/**
+	 * @brief	Material and piece-square values of a weight set.
+	 */
+	[[nodiscard]] static TuningParameters fromWeights(const EvalWeights &weights);
+
+	/**
+	 * @brief	The base weights with the tuned values (rounded to centipawns), e.g. to save them
+	 *			as JSON for the runtime weights.
+	 */
+	[[nodiscard]] EvalWeights			  toWeights(const EvalWeights &base = EvalWeights::defaults()) const;
+};
+
+
+/**
+ * @brief	Quiet position reduced to what the tuned terms need.
+ *			Its features (white - black piece counts per parameter) are stored in the dataset's shared feature pool.
+ */
+struct TuningPosition
+{
+	uint32_t firstFeature = 0;
+	uint8_t	 featureCount = 0;
+	uint8_t	 phase		  = 0; // GamePhase, clamped to GamePhase::MAX
+	uint8_t	 result		  = 0; // white's result in half points: 0 loss, 1 draw, 2 win
+	int16_t	 fixedScore	  = 0; // terms that are not tuned (pawn structure, mobility, king safety), white's view
+};
+
+
+/**
+ * @brief	Training positions in a compact in-memory format (about 50 bytes per position).
+ *			Loading resolves every position to a quiet one with a quiescence search, so the
+ *			tuning epochs only read the packed features and never touch a board.
+ */
+class TuningDataset
+{
+public:
+	/**
+	 * @brief	Stream an EPD/FEN file with game results and append its positions.
+	 *			Accepted result notations: c9 "1-0" / "0-1" / "1/2-1/2" and [1.0] / [0.5] / [0.0].
+	 *			Lines without a result or with an invalid position are skipped, as are positions
+	 *			that resolve to an endgame with a specialized evaluation.
+	 * @param	threads			Worker threads, 0 for all cores.
+	 * @param	maxPositions	Stop after this many positions, 0 for the whole file.
+	 */
+	bool								load(const std::string &path, int threads = 0, size_t maxPositions = 0);
+
+	/**
+	 * @brief	Append the quiet position reached from the engine's position.
+	 * @param	result	White's result: 1 win, 0.5 draw, 0 loss.
+	 */
+	void								add(GameEngine &engine, double result);
+
+	/**
+	 * @brief	Split a dataset line into its FEN and white's result.
+	 */
+	[[nodiscard]] static bool			parseLine(std::string_view line, std::string &fen, double &result);
+
+	void								clear();
+
+	[[nodiscard]] size_t				size() const { return mPositions.size(); }
+	[[nodiscard]] size_t				memoryUsage() const { return mPositions.size() * sizeof(TuningPosition) + mFeatures.size() * sizeof(uint16_t); }
+	[[nodiscard]] size_t				getSkipped() const { return mSkipped; }
+
+	[[nodiscard]] const TuningPosition &position(size_t index) const { return mPositions[index]; }
+
+	/**
+	 * @brief	Feature i of a position: parameter index in bits 0-8, signed count in bits 9-15.
+	 */
+	[[nodiscard]] uint16_t				feature(size_t index) const { return mFeatures[index]; }
+
+	static constexpr int				featureIndex(uint16_t feature) { return feature & 0x1FF; }
+	static constexpr int				featureCount(uint16_t feature) { return static_cast<int16_t>(feature) >> 9; }
+
+private:
+	static_assert(TuningParameters::COUNT <= 0x1FF, "Parameter index must fit into 9 bits");
+
+	/**
+	 * @brief	Pack the tuned features and the fixed score of a (quiet) board position.
+	 */
+	void								addBoard(const Chessboard &board, double result);
+
+	/**
+	 * @brief	Resolve the lines in parallel and append them in file order.
+	 */
+	void								addLines(const std::vector<std::string> &lines, int threads);
+
+	void								append(const TuningDataset &other);
+
+
+	std::vector<TuningPosition>			mPositions;
+	std::vector<uint16_t>				mFeatures;
+	size_t								mSkipped = 0;
+};
+
+
+/**
+ * @brief	Texel tuning: minimizes the logistic loss between the game results and the win probability
+ *			sigmoid(K * eval) over the dataset with Adam gradient descent. Loss and gradient are
+ *			accumulated in parallel over slices of the dataset.
+ */
+class TexelTuner
+{
+public:
+	/**
+	 * @param	threads	Worker threads, 0 for all cores.
+	 */
+	explicit TexelTuner(const TuningDataset &dataset, int threads = 0);
+
+	/**
+	 * @brief	Find the scaling constant K that best maps the parameters' evaluations to the results.
+	 */
+	double						 fitScalingConstant(const TuningParameters &params);
+
+	void						 setScalingConstant(double k) { mScaling = k; }
+	[[nodiscard]] double		 getScalingConstant() const { return mScaling; }
+
+	/**
+	 * @brief	Mean logistic loss of the dataset.
+	 */
+	[[nodiscard]] double		 loss(const TuningParameters &params) const;
+
+	/**
+	 * @brief	Gradient of the mean loss with respect to every parameter.
+	 * @return	Mean loss.
+	 */
+	double						 gradient(const TuningParameters &params, TuningParameters &gradient) const;
+
+	/**
+	 * @brief	Run gradient descent epochs (one pass over the dataset each).
+	 * @return	Loss after the last epoch.
+	 */
+	double						 tune(TuningParameters &params, int epochs, double learningRate);
+
+	/**
+	 * @brief	White's evaluation of a dataset position with the given parameters.
+	 */
+	[[nodiscard]] double		 evaluate(const TuningParameters &params, size_t index) const;
+
+	/**
+	 * @brief	Write the parameters as a header of constexpr tables (rounded to centipawns).
+	 */
+	static bool					 writeHeader(const TuningParameters &params, const std::string &path);
+
+	[[nodiscard]] int			 getThreadCount() const { return mThreads; }
+
+private:
+	/**
+	 * @brief	Loss (and optionally gradient) of positions [begin, end).
+	 */
+	double						 accumulate(const TuningParameters &params, size_t begin, size_t end, TuningParameters *gradient) const;
+
+	/**
+	 * @brief	Sum of accumulate() over all threads.
+	 */
+	double						 accumulateParallel(const TuningParameters &params, TuningParameters *gradient) const;
+
+
+	const TuningDataset			&mDataset;
+	int							 mThreads;
+	double						 mScaling = 1.0; // K of sigmoid(K * eval / 400)
+};
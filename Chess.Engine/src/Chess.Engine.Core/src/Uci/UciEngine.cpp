@@ -0,0 +1,614 @@
+/*
+  ==============================================================================
+	Module:         UciEngine
+	Description:    Universal Chess Interface front-end of the engine
+  ==============================================================================
+*/
+
+#include "UciEngine.h"
+
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <sstream>
+
+#include "Logging.h"
+#include "Notation/MoveNotation.h"
+
+
+namespace
+{
+
+using Clock						   = std::chrono::steady_clock;
+
+constexpr std::string_view START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+constexpr unsigned long	   POLL_MS	 = 5; // Search info and deadline polling interval
+
+
+/**
+ * @brief	Cut the next whitespace separated token off the front of text.
+ */
+std::string_view nextToken(std::string_view &text)
+{
+	size_t start = text.find_first_not_of(" \t\r\n");
+
+	if (start == std::string_view::npos)
+	{
+		text = {};
+		return {};
+	}
+
+	size_t			 end   = text.find_first_of(" \t\r\n", start);
+	std::string_view token = text.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+	text				   = end == std::string_view::npos ? std::string_view{} : text.substr(end);
+	return token;
+}
+
+
+std::string_view trim(std::string_view text)
+{
+	size_t start = text.find_first_not_of(" \t\r\n");
+
+	if (start == std::string_view::npos)
+		return {};
+
+	size_t end = text.find_last_not_of(" \t\r\n");
+	return text.substr(start, end - start + 1);
+}
+
+
+template <typename T>
+bool parseNumber(std::string_view text, T &value)
+{
+	auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+	return result.ec == std::errc() && result.ptr == text.data() + text.size();
+}
+
+
+bool equalsIgnoreCase(std::string_view a, std::string_view b)
+{
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y) { return std::tolower(static_cast<unsigned char>(x)) == std::tolower(static_cast<unsigned char>(y)); });
+}
+
+
+int64_t ticksFromNow(int milliseconds)
+{
+	return (Clock::now() + std::chrono::milliseconds(milliseconds)).time_since_epoch().count();
+}
+
+
+std::string formatInfo(const SearchInfo &info, int multiPV, int depth, int score, int mateIn, const std::array<Move, SearchInfo::MAX_PV> &pv, int pvLength)
+{
+	std::ostringstream line;
+
+	line << "info depth " << depth << " seldepth " << std::max(info.selDepth, depth) << " multipv " << multiPV << " score ";
+
+	if (mateIn != 0)
+		line << "mate " << mateIn;
+	else
+		line << "cp " << score;
+
+	line << " nodes " << info.nodes << " nps " << info.nps << " hashfull " << info.hashFull << " tbhits " << info.tbHits << " time " << info.timeMs << " pv";
+
+	for (int i = 0; i < pvLength; ++i)
+		line << ' ' << MoveNotation::toUCI(pv[i]);
+
+	return line.str();
+}
+
+} // namespace
+
+
+UciEngine::UciEngine(Output output) : mOutput(std::move(output))
+{
+	mEngine.init();
+	mEngine.resetGame();
+
+	// Full strength without randomization. Pondering is driven by the GUI ("go ponder"), not by the CPU player.
+	mConfig.enabled				= true;
+	mConfig.difficulty			= CPUDifficulty::Hard;
+	mConfig.enableRandomization = false;
+	mConfig.enablePondering		= false;
+	mConfig.maxDepth			= MAX_DEPTH;
+	mConfig.hashMegabytes		= DEFAULT_HASH_MB;
+	mCPU.configure(mConfig);
+
+	mMonitor.start();
+}
+
+
+UciEngine::~UciEngine()
+{
+	mCPU.cancelCalculation();
+	mMonitor.stop();
+}
+
+
+void UciEngine::loop(std::istream &input)
+{
+	std::string line;
+
+	while (std::getline(input, line))
+	{
+		if (!handleCommand(line))
+			return;
+	}
+
+	// End of input behaves like "quit"
+	handleCommand("quit");
+}
+
+
+bool UciEngine::handleCommand(std::string_view line)
+{
+	std::string_view arguments = line;
+	std::string_view command   = nextToken(arguments);
+
+	if (command.empty())
+		return true;
+
+	if (command == "uci")
+		sendIdentification();
+	else if (command == "isready")
+		send("readyok");
+	else if (command == "ucinewgame")
+		newGame();
+	else if (command == "setoption")
+		setOption(arguments);
+	else if (command == "position")
+		setPosition(arguments);
+	else if (command == "go")
+		go(arguments);
+	else if (command == "stop")
+		stopSearch();
+	else if (command == "ponderhit")
+		ponderHit();
+	else if (command == "quit")
+	{
+		cancelSearch();
+		return false;
+	}
+	else
+		send("info string Unknown command: " + std::string(command));
+
+	return true;
+}
+
+
+bool UciEngine::isSearching() const
+{
+	std::lock_guard<std::mutex> lock(mStateMutex);
+	return mSearching;
+}
+
+
+bool UciEngine::parseGo(std::string_view arguments, UciGoParameters &params)
+{
+	params = UciGoParameters();
+
+	for (std::string_view keyword = nextToken(arguments); !keyword.empty(); keyword = nextToken(arguments))
+	{
+		if (keyword == "infinite")
+		{
+			params.infinite = true;
+			continue;
+		}
+
+		if (keyword == "ponder")
+		{
+			params.ponder = true;
+			continue;
+		}
+
+		std::string_view value = nextToken(arguments);
+		bool			 valid = false;
+
+		if (keyword == "depth")
+			valid = parseNumber(value, params.depth) && params.depth > 0;
+		else if (keyword == "nodes")
+			valid = parseNumber(value, params.nodes) && params.nodes > 0;
+		else if (keyword == "movetime")
+			valid = parseNumber(value, params.moveTimeMs) && params.moveTimeMs > 0;
+		else if (keyword == "wtime")
+			valid = parseNumber(value, params.whiteTimeMs); // may be negative when the GUI lets the clock run over
+		else if (keyword == "btime")
+			valid = parseNumber(value, params.blackTimeMs);
+		else if (keyword == "winc")
+			valid = parseNumber(value, params.whiteIncMs) && params.whiteIncMs >= 0;
+		else if (keyword == "binc")
+			valid = parseNumber(value, params.blackIncMs) && params.blackIncMs >= 0;
+		else if (keyword == "movestogo")
+			valid = parseNumber(value, params.movesToGo) && params.movesToGo >= 0;
+
+		if (!valid)
+			return false;
+	}
+
+	return true;
+}
+
+
+int UciEngine::allocateTime(const UciGoParameters &params, Side side)
+{
+	if (params.moveTimeMs > 0)
+		return std::max(params.moveTimeMs - MOVE_OVERHEAD_MS, 1);
+
+	int time	  = side == Side::White ? params.whiteTimeMs : params.blackTimeMs;
+	int increment = side == Side::White ? params.whiteIncMs : params.blackIncMs;
+
+	if (time == 0 && increment == 0)
+		return 0; // no clock
+
+	int movesToGo = params.movesToGo > 0 ? std::min(params.movesToGo, DEFAULT_MOVES_TO_GO) : DEFAULT_MOVES_TO_GO;
+	int budget	  = time / movesToGo + increment * 3 / 4;
+
+	// Never plan to use more than what is left on the clock after the overhead
+	budget		  = std::min(budget, time - MOVE_OVERHEAD_MS);
+
+	return std::max(budget, 1);
+}
+
+
+void UciEngine::sendIdentification()
+{
+	send("id name Chess.Engine");
+	send("id author Jens W. Langenberg");
+	send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) + " min 1 max " + std::to_string(MAX_HASH_MB));
+	send("option name Threads type spin default 1 min 1 max 1");
+	send("option name MultiPV type spin default 1 min 1 max " + std::to_string(MAX_MULTI_PV));
+	send("option name Ponder type check default false");
+	send("option name BookFile type string default <empty>");
+	send("option name TablebasePath type string default <empty>");
+	send("option name TablebaseProbeDepth type spin default 1 min 1 max 100");
+	send("uciok");
+}
+
+
+void UciEngine::setOption(std::string_view arguments)
+{
+	// "name <id> [value <x>]", the id may contain spaces
+	if (nextToken(arguments) != "name")
+	{
+		send("info string Invalid setoption command");
+		return;
+	}
+
+	std::string_view name  = trim(arguments);
+	std::string_view value = {};
+	size_t			 split = arguments.find(" value ");
+
+	if (split != std::string_view::npos)
+	{
+		name  = trim(arguments.substr(0, split));
+		value = trim(arguments.substr(split + 7));
+	}
+
+	int number = 0;
+
+	if (equalsIgnoreCase(name, "Hash") && parseNumber(value, number))
+	{
+		cancelSearch();
+		mConfig.hashMegabytes = static_cast<size_t>(std::clamp(number, 1, MAX_HASH_MB));
+		mCPU.configure(mConfig);
+	}
+	else if (equalsIgnoreCase(name, "MultiPV") && parseNumber(value, number))
+	{
+		cancelSearch();
+		mConfig.multiPV = std::clamp(number, 1, MAX_MULTI_PV);
+		mCPU.configure(mConfig);
+	}
+	else if (equalsIgnoreCase(name, "Threads") && parseNumber(value, number))
+	{
+		if (number != 1)
+			send("info string The search runs on a single thread");
+	}
+	else if (equalsIgnoreCase(name, "BookFile"))
+	{
+		cancelSearch();
+		mConfig.openingBook = value == "<empty>" ? std::string() : std::string(value);
+		mCPU.configure(mConfig);
+	}
+	else if (equalsIgnoreCase(name, "TablebasePath"))
+	{
+		cancelSearch();
+		mConfig.tablebasePath = value == "<empty>" ? std::string() : std::string(value);
+		mCPU.configure(mConfig);
+	}
+	else if (equalsIgnoreCase(name, "TablebaseProbeDepth") && parseNumber(value, number))
+	{
+		cancelSearch();
+		mConfig.tablebaseProbeDepth = std::clamp(number, 1, 100);
+		mCPU.configure(mConfig);
+	}
+	else if (equalsIgnoreCase(name, "Ponder"))
+	{
+		// Nothing to set up, the GUI decides when to ponder
+	}
+	else
+	{
+		send("info string Unknown option or invalid value: " + std::string(name));
+	}
+}
+
+
+void UciEngine::newGame()
+{
+	cancelSearch();
+
+	// Configuring clears the transposition table and the evaluation cache
+	mCPU.configure(mConfig);
+
+	mEngine.resetGame();
+}
+
+
+bool UciEngine::setPosition(std::string_view arguments)
+{
+	cancelSearch();
+
+	std::string_view type = nextToken(arguments);
+	std::string_view fen;
+
+	if (type == "startpos")
+	{
+		fen = START_FEN;
+	}
+	else if (type == "fen")
+	{
+		size_t movesStart = arguments.find("moves");
+		fen				  = trim(arguments.substr(0, movesStart));
+		arguments		  = movesStart == std::string_view::npos ? std::string_view{} : arguments.substr(movesStart);
+	}
+
+	if (fen.empty())
+	{
+		send("info string Invalid position command");
+		return false;
+	}
+
+	mEngine.resetGame();
+
+	if (!mEngine.getBoard().parseFEN(fen))
+	{
+		send("info string Invalid FEN " + std::string(fen));
+		return false;
+	}
+
+	if (nextToken(arguments) != "moves")
+		return true;
+
+	MoveList legalMoves;
+
+	for (std::string_view text = nextToken(arguments); !text.empty(); text = nextToken(arguments))
+	{
+		mEngine.generateLegalMoves(legalMoves);
+
+		auto move = std::find_if(legalMoves.begin(), legalMoves.end(), [text](Move candidate) { return MoveNotation::toUCI(candidate) == text; });
+
+		if (move == legalMoves.end() || !mEngine.makeMoveUnchecked(*move))
+		{
+			LOG_WARNING("UCI position: illegal move {}", std::string(text));
+			send("info string Illegal move " + std::string(text) + ", position set up to the previous move");
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+void UciEngine::go(std::string_view arguments)
+{
+	UciGoParameters params;
+
+	if (!parseGo(arguments, params))
+	{
+		send("info string Invalid go command");
+		return;
+	}
+
+	cancelSearch();
+
+	int time  = allocateTime(params, mEngine.getBoard().getCurrentSide());
+	int depth = params.depth > 0 ? std::min(params.depth, MAX_DEPTH) : MAX_DEPTH;
+
+	// Clock limits are watched by the monitor, so a ponder search can get its deadline later
+	mCPU.setSearchLimits(depth, params.nodes, 0);
+
+	{
+		std::lock_guard<std::mutex> lock(mStateMutex);
+		mSearching	  = true;
+		mHoldResult	  = params.infinite || params.ponder;
+		mPondering	  = params.ponder;
+		mHasResult	  = false;
+		mPonderTimeMs = params.ponder ? time : 0;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mOutputMutex);
+		mInfoDepth = 0;
+		mInfoLines = mConfig.multiPV;
+	}
+
+	armDeadline(params.infinite || params.ponder ? 0 : time);
+
+	mCPU.calculateMoveAsync([this](Move move) { onBestMove(move); });
+	mMonitor.triggerEvent();
+}
+
+
+void UciEngine::stopSearch()
+{
+	{
+		std::lock_guard<std::mutex> lock(mStateMutex);
+
+		if (!mSearching)
+			return;
+
+		mHoldResult = false;
+		mPondering	= false;
+
+		if (mHasResult)
+		{
+			sendBestMove(mResult, mResultPonder);
+			return;
+		}
+	}
+
+	// The search ends at its next node and reports through onBestMove()
+	mCPU.finishCalculation();
+}
+
+
+void UciEngine::ponderHit()
+{
+	std::lock_guard<std::mutex> lock(mStateMutex);
+
+	if (!mSearching || !mPondering)
+		return;
+
+	// The expected move was played, the search continues as the real search
+	mPondering	= false;
+	mHoldResult = false;
+
+	if (mHasResult)
+	{
+		sendBestMove(mResult, mResultPonder);
+		return;
+	}
+
+	armDeadline(mPonderTimeMs);
+}
+
+
+void UciEngine::cancelSearch()
+{
+	mCPU.cancelCalculation();
+	armDeadline(0);
+
+	std::lock_guard<std::mutex> lock(mStateMutex);
+	mSearching	= false;
+	mHoldResult = false;
+	mPondering	= false;
+	mHasResult	= false;
+}
+
+
+void UciEngine::onBestMove(Move move)
+{
+	Move						ponder = mCPU.getPonderMove();
+
+	std::lock_guard<std::mutex> lock(mStateMutex);
+
+	if (!mSearching)
+		return;
+
+	if (mHoldResult)
+	{
+		mHasResult	  = true;
+		mResult		  = move;
+		mResultPonder = ponder;
+		return;
+	}
+
+	sendBestMove(move, ponder);
+}
+
+
+void UciEngine::sendBestMove(Move move, Move ponder)
+{
+	mSearching = false;
+	mHasResult = false;
+	armDeadline(0);
+
+	sendSearchInfo();
+
+	std::string line = "bestmove " + (move.isValid() ? MoveNotation::toUCI(move) : std::string("0000"));
+
+	if (move.isValid() && ponder.isValid())
+		line += " ponder " + MoveNotation::toUCI(ponder);
+
+	send(line);
+}
+
+
+void UciEngine::sendSearchInfo()
+{
+	std::lock_guard<std::mutex> lock(mOutputMutex);
+
+	SearchInfo					info;
+
+	if (!mCPU.getSearchInfoChannel().tryRead(info, mInfoSequence) || info.pvLength == 0)
+		return;
+
+	// All lines are sent once per iteration, progress updates in between only refresh the best line
+	if (mInfoLines > 1 && info.depth != mInfoDepth)
+	{
+		std::vector<SearchLine> lines = mCPU.getSearchLines();
+
+		if (lines.size() > 1)
+		{
+			mInfoDepth = info.depth;
+
+			for (size_t i = 0; i < lines.size(); ++i)
+				mOutput(formatInfo(info, static_cast<int>(i) + 1, lines[i].depth, lines[i].score, lines[i].mateIn, lines[i].pv, lines[i].pvLength));
+
+			return;
+		}
+	}
+
+	mInfoDepth = info.depth;
+	mOutput(formatInfo(info, 1, info.depth, info.score, info.mateIn, info.pv, info.pvLength));
+}
+
+
+unsigned long UciEngine::monitorSearch()
+{
+	sendSearchInfo();
+
+	int64_t deadline = mDeadline.load();
+
+	if (deadline == 0)
+		return POLL_MS;
+
+	int64_t now = Clock::now().time_since_epoch().count();
+
+	if (now >= deadline)
+	{
+		// Only finish if no new deadline was armed in the meantime
+		if (mDeadline.compare_exchange_strong(deadline, 0))
+			mCPU.finishCalculation();
+
+		return POLL_MS;
+	}
+
+	auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::duration(deadline - now)).count() + 1;
+	return static_cast<unsigned long>(std::min<int64_t>(remaining, POLL_MS));
+}
+
+
+void UciEngine::armDeadline(int milliseconds)
+{
+	mDeadline.store(milliseconds > 0 ? ticksFromNow(milliseconds) : 0);
+}
+
+
+void UciEngine::send(const std::string &line)
+{
+	std::lock_guard<std::mutex> lock(mOutputMutex);
+	mOutput(line);
+}
+
+
+void UciEngine::SearchMonitor::run()
+{
+	while (isRunning())
+	{
+		// Sleep until a search is started
+		if (!waitForEvent())
+			continue;
+
+		while (isRunning() && mOwner.isSearching())
+			waitForEvent(mOwner.monitorSearch());
+	}
+}
@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+	Module:         UciEngine
+	Description:    Universal Chess Interface front-end of the engine
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <istream>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+#include "CPUPlayer.h"
+#include "GameEngine.h"
+#include "SearchInfo.h"
+#include "ThreadBase.h"
+
+
+/**
+ * @brief	Limits of a "go" command.
+ */
+struct UciGoParameters
+{
+	int		 depth		 = 0; // 0 for no depth limit
+	uint64_t nodes		 = 0; // 0 for no node limit
+	int		 moveTimeMs	 = 0; // Exact time per move, 0 if the clock decides
+	int		 whiteTimeMs = 0;
+	int		 blackTimeMs = 0;
+	int		 whiteIncMs	 = 0;
+	int		 blackIncMs	 = 0;
+	int		 movesToGo	 = 0; // Moves to the next time control, 0 for sudden death
+	bool	 infinite	 = false;
+	bool	 ponder		 = false;
+};
+
+
+/**
+ * @brief	UCI engine driven by text commands on top of GameEngine and CPUPlayer.
+ *
+ * Threads:
+ *  - The caller's thread parses the commands, so "stop", "ponderhit" and "isready" are answered while a search runs.
+ *  - The CPU player's search worker searches and reports the best move.
+ *  - A monitor thread streams the search info and ends the search once its time is up.
+ *
+ * A search of "go infinite" or "go ponder" that finishes early holds its best move back until "stop" or "ponderhit".
+ */
+class UciEngine
+{
+public:
+	using Output						= std::function<void(const std::string &)>;
+
+	static constexpr int MAX_DEPTH			 = 64;
+	static constexpr int MAX_MULTI_PV		 = 64;
+	static constexpr int DEFAULT_HASH_MB	 = 64;
+	static constexpr int MAX_HASH_MB		 = 4096;
+	static constexpr int MOVE_OVERHEAD_MS	 = 30; // Reserved per move for the communication with the GUI
+	static constexpr int DEFAULT_MOVES_TO_GO = 30; // Moves the remaining time is split over in sudden death
+
+	/**
+	 * @param	output	Receives every response line (without the line break), called from several threads but never concurrently.
+	 */
+	explicit UciEngine(Output output);
+	~UciEngine();
+
+	UciEngine(const UciEngine &)			= delete;
+	UciEngine &operator=(const UciEngine &) = delete;
+
+	/**
+	 * @brief	Execute commands line by line until "quit" or the end of the input.
+	 */
+	void						 loop(std::istream &input);
+
+	/**
+	 * @brief	Execute one command line.
+	 * @return	false after "quit".
+	 */
+	bool						 handleCommand(std::string_view line);
+
+	/**
+	 * @brief	true from "go" until the best move has been sent.
+	 */
+	bool						 isSearching() const;
+
+	const GameEngine			&getEngine() const { return mEngine; }
+
+	/**
+	 * @brief	Parse the arguments of a "go" command (everything after "go").
+	 * @return	false on an unknown keyword or a missing or malformed value.
+	 */
+	[[nodiscard]] static bool	 parseGo(std::string_view arguments, UciGoParameters &params);
+
+	/**
+	 * @brief	Search time for the side to move, 0 if the command sets no clock.
+	 */
+	[[nodiscard]] static int	 allocateTime(const UciGoParameters &params, Side side);
+
+
+private:
+	/**
+	 * @brief	Streams the search info and watches the deadline while a search runs.
+	 */
+	class SearchMonitor : public ThreadBase
+	{
+	public:
+		explicit SearchMonitor(UciEngine &owner) : mOwner(owner) {}
+		~SearchMonitor() override { stop(); }
+
+	protected:
+		void run() override;
+
+	private:
+		UciEngine &mOwner;
+	};
+
+	void						 sendIdentification();
+	void						 setOption(std::string_view arguments);
+	void						 newGame();
+	bool						 setPosition(std::string_view arguments);
+	void						 go(std::string_view arguments);
+	void						 stopSearch();
+	void						 ponderHit();
+
+	/**
+	 * @brief	Discard the running search without sending a best move.
+	 */
+	void						 cancelSearch();
+
+	/**
+	 * @brief	Search worker callback with the chosen move.
+	 */
+	void						 onBestMove(Move move);
+
+	/**
+	 * @brief	Send the best move, preceded by the newest search info. Requires mStateMutex.
+	 */
+	void						 sendBestMove(Move move, Move ponder);
+
+	/**
+	 * @brief	Send search info published since the last call.
+	 */
+	void						 sendSearchInfo();
+
+	/**
+	 * @brief	Monitor tick: stream the info and finish the search at its deadline.
+	 * @return	Milliseconds until the monitor should look again.
+	 */
+	unsigned long				 monitorSearch();
+
+	void						 armDeadline(int milliseconds);
+	void						 send(const std::string &line);
+
+	Output						 mOutput;
+	std::mutex					 mOutputMutex;
+
+	GameEngine					 mEngine;
+	CPUPlayer					 mCPU{mEngine};
+	CPUConfiguration			 mConfig;
+
+	// Search state (guarded by mStateMutex)
+	mutable std::mutex			 mStateMutex;
+	bool						 mSearching	   = false;
+	bool						 mHoldResult   = false; // "go infinite" or "go ponder": the best move waits for stop / ponderhit
+	bool						 mPondering	   = false;
+	bool						 mHasResult	   = false; // Search finished while the result is held
+	Move						 mResult	   = {};
+	Move						 mResultPonder = {};
+	int							 mPonderTimeMs = 0; // Time budget that starts with ponderhit
+
+	// Deadline of the running search in steady clock ticks, 0 for none
+	std::atomic<int64_t>		 mDeadline{0};
+
+	// Last search info sent (guarded by mOutputMutex)
+	uint64_t					 mInfoSequence = 0;
+	int							 mInfoDepth	   = 0;
+	int							 mInfoLines	   = 1; // MultiPV of the running search
+
+	SearchMonitor				 mMonitor{*this};
+};
@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+	Module:         Tuner - main
+	Description:    Offline Texel tuning of the evaluation's material and piece-square values
+  ==============================================================================
+*/
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+#include "TexelTuner.h"
+
+
+static void printUsage()
+{
+	std::cout << "Usage: Chess.Engine.Tuner <dataset> [options]\n"
+			  << "  Dataset lines: FEN followed by the game result (c9 \"1-0\" or [1.0] notation)\n\n"
+			  << "  --out <file>       Generated header (default TunedParameters.h)\n"
+			  << "  --epochs <n>       Gradient descent epochs (default 200)\n"
+			  << "  --rate <x>         Learning rate in centipawns per step (default 1.0)\n"
+			  << "  --threads <n>      Worker threads (default all cores)\n"
+			  << "  --limit <n>        Use only the first n positions\n"
+			  << "  --k <x>            Sigmoid scaling constant (default fitted to the dataset)\n";
+}
+
+
+int main(int argc, char *argv[])
+{
+	if (argc < 2)
+	{
+		printUsage();
+		return 1;
+	}
+
+	std::string dataset = argv[1];
+	std::string output	= "TunedParameters.h";
+	std::string json;
+	int			epochs	= 200;
+	double		rate	= 1.0;
+	int			threads = 0;
+	size_t		limit	= 0;
+	double		scaling = 0.0;
+
+	for (int i = 2; i + 1 < argc; i += 2)
+	{
+		std::string option = argv[i];
+		const char *value  = argv[i + 1];
+
+		if (option == "--out")
+			output = value;
+		else if (option == "--json")
+			json = value;
+		else if (option == "--epochs")
+			epochs = std::atoi(value);
+		else if (option == "--rate")
+			rate = std::atof(value);
+		else if (option == "--threads")
+			threads = std::atoi(value);
+		else if (option == "--limit")
+			limit = std::strtoull(value, nullptr, 10);
+		else if (option == "--k")
+			scaling = std::atof(value);
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+
+	using Clock = std::chrono::steady_clock;
+
+	TuningDataset positions;
+	auto		  start = Clock::now();
+
+	if (!positions.load(dataset, threads, limit) || positions.size() == 0)
+	{
+		std::cout << "No positions loaded from " << dataset << "\n";
+		return 1;
+	}
+
+	auto loaded = Clock::now();
+	std::cout << "Loaded " << positions.size() << " positions (" << positions.getSkipped() << " skipped, " << positions.memoryUsage() / (1024 * 1024) << " MB) in "
+			  << std::chrono::duration<double>(loaded - start).count() << " s\n";
+
+	TexelTuner		 tuner(positions, threads);
+	TuningParameters params = TuningParameters::fromEvaluation();
+
+	if (scaling > 0.0)
+		tuner.setScalingConstant(scaling);
+	else
+		tuner.fitScalingConstant(params);
+
+	std::cout << "K = " << tuner.getScalingConstant() << ", initial loss " << tuner.loss(params) << " (" << tuner.getThreadCount() << " threads)\n";
+
+	double loss	   = tuner.tune(params, epochs, rate);
+	double seconds = std::chrono::duration<double>(Clock::now() - loaded).count();
+
+	std::cout << "Final loss " << loss << " after " << epochs << " epochs in " << seconds << " s (" << positions.size() * epochs / seconds / 1e6
+			  << " M positions/s)\n";
+
+	if (!TexelTuner::writeHeader(params, output))
+		return 1;
+
+	std::cout << "Wrote " << output << "\n";
+
+	if (!json.empty())
+	{
+		RuntimeWeights::set(params.toWeights());
+
+		if (!RuntimeWeights::save(json))
+			return 1;
+
+		std::cout << "Wrote " << json << "\n";
+	}
+
+	return 0;
+}
@@ -0,0 +1,27 @@
+/*
+  ==============================================================================
+	Module:         Uci - main
+	Description:    UCI engine executable for chess GUIs and testing tools
+  ==============================================================================
+*/
+
+#include <iostream>
+#include <string>
+
+#include "UciEngine.h"
+
+
+int main()
+{
+	std::ios::sync_with_stdio(false);
+
+	UciEngine engine(
+		[](const std::string &line)
+		{
+			// GUIs read line by line, every response has to leave the process right away
+			std::cout << line << std::endl;
+		});
+
+	engine.loop(std::cin);
+	return 0;
+}
@@ -0,0 +1,105 @@
+#!/usr/bin/env python3
+"""
+Compare two Google Benchmark JSON results and flag regressions.
+
+    Engine.Core.Benchmarks --benchmark_out=results.json --benchmark_out_format=json
+    python compare_benchmarks.py baseline.json results.json --threshold 10
+
+A benchmark regresses if it got slower than the baseline by more than the threshold (in percent).
+Runs with --benchmark_repetitions are compared by their median. To store a new baseline, copy the
+results file over the baseline.
+
+Exit code: 0 without regressions, 1 on regressions, 2 on unreadable input.
+"""
+
+import argparse
+import json
+import sys
+
+TIME_UNITS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+def load_times(path, metric):
+    """Benchmark name -> time in nanoseconds (the median aggregate if the run has repetitions)."""
+    with open(path, encoding="utf-8") as file:
+        document = json.load(file)
+
+    iterations = {}
+    medians = {}
+
+    for benchmark in document.get("benchmarks", []):
+        if benchmark.get("error_occurred"):
+            continue
+
+        time = benchmark[metric] * TIME_UNITS[benchmark.get("time_unit", "ns")]
+
+        if benchmark.get("run_type") == "aggregate":
+            if benchmark.get("aggregate_name") == "median":
+                medians[benchmark["run_name"]] = time
+        else:
+            # Without repetitions every benchmark has a single iteration run
+            iterations.setdefault(benchmark.get("run_name", benchmark["name"]), time)
+
+    iterations.update(medians)
+    return iterations
+
+
+def format_time(nanoseconds):
+    for unit in ("s", "ms", "us"):
+        if nanoseconds >= TIME_UNITS[unit]:
+            return f"{nanoseconds / TIME_UNITS[unit]:.2f} {unit}"
+
+    return f"{nanoseconds:.1f} ns"
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Flag benchmark regressions against a stored baseline.")
+    parser.add_argument("baseline", help="Google Benchmark JSON output to compare against")
+    parser.add_argument("results", help="Google Benchmark JSON output of the current build")
+    parser.add_argument("--threshold", type=float, default=10.0, help="slowdown in percent that counts as a regression (default 10)")
+    parser.add_argument("--metric", choices=("cpu_time", "real_time"), default="cpu_time", help="time to compare (default cpu_time)")
+    args = parser.parse_args()
+
+    try:
+        baseline = load_times(args.baseline, args.metric)
+        results = load_times(args.results, args.metric)
+    except (OSError, ValueError, KeyError) as error:
+        print(f"Could not read the benchmark results: {error}", file=sys.stderr)
+        return 2
+
+    regressions = []
+    width = max((len(name) for name in results), default=10)
+
+    print(f"{'Benchmark':<{width}}  {'Baseline':>12}  {'Current':>12}  {'Change':>8}")
+
+    for name, current in results.items():
+        if name not in baseline:
+            print(f"{name:<{width}}  {'-':>12}  {format_time(current):>12}  {'new':>8}")
+            continue
+
+        previous = baseline[name]
+        change = (current - previous) / previous * 100.0 if previous > 0 else 0.0
+        flag = ""
+
+        if change > args.threshold:
+            regressions.append((name, change))
+            flag = "  REGRESSION"
+
+        print(f"{name:<{width}}  {format_time(previous):>12}  {format_time(current):>12}  {change:>+7.1f}%{flag}")
+
+    for name in baseline:
+        if name not in results:
+            print(f"{name:<{width}}  {format_time(baseline[name]):>12}  {'-':>12}  {'missing':>8}")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s) over {args.threshold:g}%:")
+        for name, change in regressions:
+            print(f"  {name}: {change:+.1f}%")
+        return 1
+
+    print(f"\nNo regressions over {args.threshold:g}%")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
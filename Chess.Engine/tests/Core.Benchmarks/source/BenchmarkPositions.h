@@ -0,0 +1,50 @@
+/*
+  ==============================================================================
+	Module:			Benchmark Positions
+	Description:    Representative positions the core microbenchmarks run on
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+
+namespace CoreBenchmarks
+{
+
+struct BenchmarkPosition
+{
+	const char *name;
+	const char *fen;
+};
+
+// clang-format off
+inline constexpr BenchmarkPosition POSITIONS[] = {
+	{"Opening",		"r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3"},
+	{"Middlegame",	"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10"},
+	{"Endgame",		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1"},
+	{"Promotion",	"n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1"},
+};
+// clang-format on
+
+
+/**
+ * @brief	Register one benchmark per position, named "<name>/<position>".
+ * @param	function	Called as function(state, fen).
+ */
+template <typename Function>
+bool registerPerPosition(const std::string &name, Function function)
+{
+	for (const auto &position : POSITIONS)
+	{
+		const char *fen = position.fen;
+		benchmark::RegisterBenchmark((name + "/" + position.name).c_str(), [function, fen](benchmark::State &state) { function(state, fen); });
+	}
+
+	return true;
+}
+
+} // namespace CoreBenchmarks
@@ -0,0 +1,145 @@
+/*
+  ==============================================================================
+	Module:			Board Benchmarks
+	Description:    FEN parsing, EPD batch loading, position packing and slider attack lookups
+  ==============================================================================
+*/
+
+#include "BenchmarkPositions.h"
+
+#include "AttackTables.h"
+#include "Chessboard.h"
+#include "Epd.h"
+#include "PackedPosition.h"
+
+
+namespace CoreBenchmarks
+{
+
+static void parseFEN(benchmark::State &state, const char *fen)
+{
+	Chessboard board;
+	board.init();
+
+	for (auto _ : state)
+	{
+		board.parseFEN(fen);
+		benchmark::DoNotOptimize(board.getHash());
+	}
+}
+
+
+static void fenParse(benchmark::State &state, const char *fen)
+{
+	FenPosition position;
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(Fen::parse(fen, position));
+		benchmark::DoNotOptimize(position);
+	}
+}
+
+
+static void epdBatchParse(benchmark::State &state)
+{
+	constexpr int LINES = 100000;
+
+	std::string	  text;
+
+	for (int i = 0; i < LINES; ++i)
+	{
+		text += POSITIONS[i % std::size(POSITIONS)].fen;
+		text += " bm e4; id \"bench\";\n";
+	}
+
+	std::vector<FenPosition> positions;
+
+	for (auto _ : state)
+	{
+		EpdLoadResult result = EpdBatchLoader::parse(text, positions, static_cast<int>(state.range(0)));
+		benchmark::DoNotOptimize(result);
+	}
+
+	state.SetItemsProcessed(state.iterations() * LINES);
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+}
+
+
+static void packPositions(benchmark::State &state, const char *fen)
+{
+	constexpr size_t COUNT = 1024;
+
+	FenPosition		 position;
+	Fen::parse(fen, position);
+
+	std::vector<FenPosition>	positions(COUNT, position);
+	std::vector<PackedPosition> packed(COUNT);
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(PackedPosition::packAll(positions.data(), nullptr, packed.data(), COUNT));
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * COUNT);
+}
+
+
+static void unpackPositions(benchmark::State &state, const char *fen)
+{
+	constexpr size_t COUNT = 1024;
+
+	FenPosition		 position;
+	Fen::parse(fen, position);
+
+	PackedPosition packed;
+	[[maybe_unused]] bool ok = PackedPosition::pack(position, {}, packed);
+
+	std::vector<PackedPosition> source(COUNT, packed);
+	std::vector<FenPosition>	positions(COUNT);
+
+	for (auto _ : state)
+	{
+		PackedPosition::unpackAll(source.data(), positions.data(), nullptr, COUNT);
+		benchmark::ClobberMemory();
+	}
+
+	state.SetItemsProcessed(state.iterations() * COUNT);
+}
+
+
+static void sliderAttacks(benchmark::State &state, const char *fen)
+{
+	Chessboard board;
+	board.init();
+	board.parseFEN(fen);
+
+	const AttackTables &tables	  = AttackTables::instance();
+	const U64			occupancy = board.occ()[to_index(Side::Both)];
+
+	for (auto _ : state)
+	{
+		U64 attacks = 0;
+
+		for (int sq = 0; sq < 64; ++sq)
+			attacks ^= tables.rookAttacks(Square(sq), occupancy) ^ tables.bishopAttacks(Square(sq), occupancy);
+
+		benchmark::DoNotOptimize(attacks);
+	}
+
+	// One item is a rook and a bishop lookup on one square
+	state.SetItemsProcessed(state.iterations() * 64);
+}
+
+
+BENCHMARK(epdBatchParse)->Name("EpdBatchLoader/parse")->ArgName("threads")->Arg(1)->Arg(0)->UseRealTime();
+
+
+[[maybe_unused]] static const bool registered = registerPerPosition("Chessboard/parseFEN", parseFEN) &&
+												registerPerPosition("Fen/parse", fenParse) &&
+												registerPerPosition("PackedPosition/packAll", packPositions) &&
+												registerPerPosition("PackedPosition/unpackAll", unpackPositions) &&
+												registerPerPosition("AttackTables/sliderAttacks", sliderAttacks);
+
+} // namespace CoreBenchmarks
@@ -0,0 +1,30 @@
+/*
+  ==============================================================================
+	Module:			Evaluation Benchmarks
+	Description:    Static evaluation of the benchmark positions
+  ==============================================================================
+*/
+
+#include "BenchmarkPositions.h"
+
+#include "Chessboard.h"
+#include "Evaluation.h"
+
+
+namespace CoreBenchmarks
+{
+
+static void evaluate(benchmark::State &state, const char *fen)
+{
+	Chessboard board;
+	board.init();
+	board.parseFEN(fen);
+
+	for (auto _ : state)
+		benchmark::DoNotOptimize(Evaluation::evaluate(board));
+}
+
+
+[[maybe_unused]] static const bool registered = registerPerPosition("Evaluation/evaluate", evaluate);
+
+} // namespace CoreBenchmarks
@@ -0,0 +1,109 @@
+/*
+  ==============================================================================
+	Module:			Move Benchmarks
+	Description:    Move generation, legality filtering, execution and ordering
+  ==============================================================================
+*/
+
+#include "BenchmarkPositions.h"
+
+#include "Evaluation/MoveEvaluation.h"
+#include "Execution/MoveExecution.h"
+#include "Generation/MoveGeneration.h"
+#include "Validation/MoveValidation.h"
+
+
+namespace CoreBenchmarks
+{
+
+/**
+ * @brief	Board with the move components wired to it, like the GameEngine does.
+ */
+struct MoveComponents
+{
+	explicit MoveComponents(const char *fen) : generation(board), execution(board), validation(board, generation, execution)
+	{
+		board.init();
+		board.parseFEN(fen);
+	}
+
+	Chessboard	   board;
+	MoveGeneration generation;
+	MoveExecution  execution;
+	MoveValidation validation;
+};
+
+
+static void generateAllMoves(benchmark::State &state, const char *fen)
+{
+	MoveComponents components(fen);
+
+	for (auto _ : state)
+	{
+		MoveList moves;
+		components.generation.generateAllMoves(moves);
+		benchmark::DoNotOptimize(moves);
+	}
+}
+
+
+static void generateLegalMoves(benchmark::State &state, const char *fen)
+{
+	MoveComponents components(fen);
+
+	for (auto _ : state)
+	{
+		MoveList moves;
+		components.validation.generateLegalMoves(moves);
+		benchmark::DoNotOptimize(moves);
+	}
+}
+
+
+static void makeUnmakeMove(benchmark::State &state, const char *fen)
+{
+	MoveComponents components(fen);
+
+	MoveList	   moves;
+	components.validation.generateLegalMoves(moves);
+
+	for (auto _ : state)
+	{
+		for (size_t i = 0; i < moves.size(); ++i)
+		{
+			components.execution.makeMove(moves[i]);
+			components.execution.unmakeMove();
+		}
+
+		benchmark::ClobberMemory();
+	}
+
+	// One item is a make/unmake pair
+	state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * moves.size()));
+}
+
+
+static void orderMoves(benchmark::State &state, const char *fen)
+{
+	MoveComponents components(fen);
+	MoveEvaluation ordering;
+
+	MoveList	   legalMoves;
+	components.validation.generateLegalMoves(legalMoves);
+
+	for (auto _ : state)
+	{
+		// Includes copying the unordered list (a few hundred bytes)
+		MoveList moves = legalMoves;
+		ordering.orderMoves(moves, components.board, Move(), 0);
+		benchmark::DoNotOptimize(moves);
+	}
+}
+
+
+[[maybe_unused]] static const bool registered = registerPerPosition("MoveGeneration/generateAllMoves", generateAllMoves) &&
+												registerPerPosition("MoveValidation/generateLegalMoves", generateLegalMoves) &&
+												registerPerPosition("MoveExecution/makeUnmakeMove", makeUnmakeMove) &&
+												registerPerPosition("MoveEvaluation/orderMoves", orderMoves);
+
+} // namespace CoreBenchmarks
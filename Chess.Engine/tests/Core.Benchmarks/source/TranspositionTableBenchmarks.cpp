@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+	Module:			TranspositionTable Benchmarks
+	Description:    Store and probe of the search's transposition table
+  ==============================================================================
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include "TranspositionTable.h"
+
+
+namespace CoreBenchmarks
+{
+
+constexpr size_t KEY_COUNT = 1 << 16;
+
+
+static std::vector<uint64_t> randomKeys(uint32_t seed)
+{
+	std::mt19937_64		  random(seed);
+	std::vector<uint64_t> keys(KEY_COUNT);
+
+	for (auto &key : keys)
+		key = random();
+
+	return keys;
+}
+
+
+static void transpositionStore(benchmark::State &state)
+{
+	const auto		   keys = randomKeys(1);
+	TranspositionTable table;
+	size_t			   i = 0;
+
+	for (auto _ : state)
+	{
+		table.store(keys[i], static_cast<int>(i & 7), 0, TranspositionEntry::NodeType::Exact, Move());
+		i = (i + 1) & (KEY_COUNT - 1);
+	}
+}
+
+
+static void transpositionProbe(benchmark::State &state)
+{
+	// Range 0 probes stored positions, range 1 positions that were never stored
+	const auto		   stored = randomKeys(1);
+	const auto		   probed = state.range(0) == 0 ? stored : randomKeys(2);
+
+	TranspositionTable table;
+
+	for (uint64_t key : stored)
+		table.store(key, 4, 0, TranspositionEntry::NodeType::Exact, Move());
+
+	size_t i = 0;
+
+	for (auto _ : state)
+	{
+		int	 score = 0;
+		Move move;
+		benchmark::DoNotOptimize(table.probe(probed[i], 4, -100, 100, score, move));
+		i = (i + 1) & (KEY_COUNT - 1);
+	}
+}
+
+
+BENCHMARK(transpositionStore)->Name("TranspositionTable/store");
+BENCHMARK(transpositionProbe)->Name("TranspositionTable/probe")->ArgName("miss")->Arg(0)->Arg(1);
+
+} // namespace CoreBenchmarks
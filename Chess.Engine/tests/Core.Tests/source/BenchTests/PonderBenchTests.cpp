@@ -0,0 +1,37 @@
+/*
+  ==============================================================================
+	Module:			PonderBench Tests
+	Description:    Testing the self-play ponder measurement
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include "PonderBench.h"
+
+
+namespace BenchTests
+{
+
+TEST(PonderBenchTest, MeasuresBothRuns)
+{
+	PonderBenchOptions options;
+	options.games			 = 1;
+	options.moveTimeMs		 = 20;
+	options.maxPlies		 = 8;
+
+	PonderBenchResult result = PonderBench::run(options);
+
+	// The measured player moves first, so it replies on every second ply of both runs
+	EXPECT_EQ(result.pondering.replies, 4);
+	EXPECT_EQ(result.baseline.replies, 4);
+	EXPECT_GT(result.baseline.meanLatencyMs(), 0.0);
+
+	// Every reply after the first resolves the ponder search started after the previous one
+	EXPECT_GT(result.ponder.started, 0);
+	EXPECT_LE(result.ponder.hits + result.ponder.misses, 3);
+	EXPECT_EQ(result.ponder.hits + result.ponder.misses, result.ponder.started - 1);
+	EXPECT_LE(result.ponder.instantReplies, result.ponder.hits);
+}
+
+} // namespace BenchTests
@@ -0,0 +1,92 @@
+/*
+  ==============================================================================
+	Module:			SearchBench Tests
+	Description:    Testing the reproducibility and the output of the search benchmark
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include "GameEngine.h"
+#include "SearchBench.h"
+
+
+namespace BenchTests
+{
+
+TEST(SearchBenchTest, PositionsAreLegal)
+{
+	GameEngine engine;
+	engine.init();
+
+	EXPECT_GE(SearchBench::positions().size(), 50u);
+
+	for (std::string_view fen : SearchBench::positions())
+	{
+		engine.getBoard().parseFEN(fen);
+
+		MoveList moves;
+		engine.generateLegalMoves(moves);
+
+		// Every position needs a real search (no mate, stalemate or single reply)
+		EXPECT_GT(moves.size(), 1u) << fen;
+	}
+}
+
+
+TEST(SearchBenchTest, NodeSignatureIsReproducible)
+{
+	SearchBenchOptions options;
+	options.depth			 = 2;
+
+	SearchBenchResult first	 = SearchBench::run(options);
+	SearchBenchResult second = SearchBench::run(options);
+
+	ASSERT_EQ(first.positions.size(), SearchBench::positions().size());
+	EXPECT_GT(first.signature(), 0u);
+	EXPECT_EQ(first.signature(), second.signature());
+
+	for (size_t i = 0; i < first.positions.size(); ++i)
+	{
+		EXPECT_EQ(first.positions[i].nodes, second.positions[i].nodes) << first.positions[i].fen;
+		EXPECT_EQ(first.positions[i].bestMove, second.positions[i].bestMove) << first.positions[i].fen;
+	}
+}
+
+
+TEST(SearchBenchTest, NodeLimitBoundsEveryPosition)
+{
+	SearchBenchOptions options;
+	options.nodeLimit		 = 2000;
+
+	int				  reported = 0;
+	SearchBenchResult result   = SearchBench::run(options, [&reported](const SearchBenchPosition &) { ++reported; });
+
+	EXPECT_EQ(reported, static_cast<int>(result.positions.size()));
+
+	for (const auto &position : result.positions)
+	{
+		EXPECT_TRUE(position.bestMove.isValid()) << position.fen;
+		EXPECT_LE(position.nodes, options.nodeLimit + 64) << position.fen;
+	}
+}
+
+
+TEST(SearchBenchTest, JsonHasTotalsAndPositions)
+{
+	SearchBenchOptions options;
+	options.depth			 = 1;
+
+	SearchBenchResult result = SearchBench::run(options);
+	auto			  json	 = nlohmann::json::parse(result.toJson());
+
+	EXPECT_EQ(json.at("depth").get<int>(), 1);
+	EXPECT_EQ(json.at("signature").get<uint64_t>(), result.signature());
+	EXPECT_EQ(json.at("nodes").get<uint64_t>(), result.nodes);
+	ASSERT_EQ(json.at("positions").size(), result.positions.size());
+	EXPECT_EQ(json.at("positions")[0].at("fen").get<std::string>(), SearchBench::positions()[0]);
+	EXPECT_EQ(json.at("positions")[0].at("bestMove").get<std::string>().size(), 4u);
+}
+
+} // namespace BenchTests
@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+	Module:			TestSuite Tests
+	Description:    Testing the EPD test suite runner and its time-to-solution statistics
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <filesystem>
+#include <fstream>
+
+#include "TestSuite.h"
+
+
+namespace BenchTests
+{
+
+// Mates in one, with and without check marks on the bm moves
+const char *MATE_SUITE[] = {
+	"6k1/5ppp/8/8/8/8/8/R5K1 w - - bm Ra8#; id \"mate.001\";",
+	"r5k1/8/8/8/8/8/5PPP/6K1 b - - bm Ra1#; id \"mate.002\";",
+	"6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - bm Ra8; id \"mate.003\";",
+	"k7/8/1K6/8/8/8/7Q/8 w - - bm Qh8#; id \"mate.004\";",
+};
+
+
+TEST(TestSuiteTest, ResolvesMovesAndSkipsBrokenLines)
+{
+	TestSuite suite;
+
+	EXPECT_TRUE(suite.add(MATE_SUITE[0]));
+	EXPECT_TRUE(suite.add("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - bm e2e4 Nf3; am f3;"));
+
+	EXPECT_FALSE(suite.add("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - id \"no bm\";"));
+	EXPECT_FALSE(suite.add("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - bm e5;")) << "Illegal move";
+	EXPECT_FALSE(suite.add("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBN w KQkq - bm e4;")) << "Broken position";
+
+	ASSERT_EQ(suite.entries().size(), 2u);
+
+	const TestSuiteEntry &opening = suite.entries()[1];
+	ASSERT_EQ(opening.bestMoves.size(), 2u);
+	ASSERT_EQ(opening.avoidMoves.size(), 1u);
+
+	EXPECT_TRUE(opening.isCorrect(Move(Square::e2, Square::e4, MoveFlag::DoublePawnPush)));
+	EXPECT_TRUE(opening.isCorrect(Move(Square::g1, Square::f3, MoveFlag::Quiet)));
+	EXPECT_FALSE(opening.isCorrect(Move(Square::d2, Square::d4, MoveFlag::DoublePawnPush)));
+	EXPECT_FALSE(opening.isCorrect(Move(Square::f2, Square::f3, MoveFlag::Quiet)));
+}
+
+
+TEST(TestSuiteTest, SolvesMatesConcurrently)
+{
+	auto path = (std::filesystem::temp_directory_path() / "test_suite_mates.epd").string();
+
+	{
+		std::ofstream file(path);
+		file << "# mates in one\n";
+
+		for (const char *line : MATE_SUITE)
+			file << line << "\n";
+	}
+
+	TestSuite suite;
+	ASSERT_TRUE(suite.load(path));
+	std::filesystem::remove(path);
+
+	ASSERT_EQ(suite.entries().size(), std::size(MATE_SUITE));
+
+	TestSuiteOptions options;
+	options.threads		  = 2;
+	options.moveTimeMs	  = 0;
+	options.nodeLimit	  = 20000;
+	options.maxDepth	  = 4;
+	options.hashMegabytes = 1;
+
+	size_t			reported = 0;
+	TestSuiteResult result	 = suite.run(options, [&reported](const TestSuitePositionResult &) { ++reported; });
+
+	EXPECT_EQ(reported, suite.entries().size());
+	ASSERT_EQ(result.positions.size(), suite.entries().size());
+	EXPECT_EQ(result.solvedCount(), suite.entries().size());
+
+	for (size_t i = 0; i < result.positions.size(); ++i)
+	{
+		const auto &position = result.positions[i];
+
+		EXPECT_EQ(position.id, suite.entries()[i].record.id) << "Results stay in suite order";
+		EXPECT_TRUE(position.solved) << position.id;
+		EXPECT_GE(position.solveDepth, 1) << position.id;
+		EXPECT_LE(position.solveNodes, position.nodes) << position.id;
+		EXPECT_LE(position.solveSeconds, position.seconds) << position.id;
+	}
+
+	EXPECT_LE(result.solveSecondsPercentile(50), result.solveSecondsPercentile(100));
+	EXPECT_LE(result.solveNodesPercentile(50), result.solveNodesPercentile(100));
+
+	auto json = nlohmann::json::parse(result.toJson());
+	EXPECT_EQ(json.at("solved").get<size_t>(), result.solvedCount());
+	EXPECT_EQ(json.at("positions").size(), result.positions.size());
+	EXPECT_EQ(json.at("timeToSolution").at("p50").at("nodes").get<uint64_t>(), result.solveNodesPercentile(50));
+}
+
+
+TEST(TestSuiteTest, PercentilesUseNearestRank)
+{
+	TestSuiteResult result;
+
+	for (int i = 1; i <= 10; ++i)
+	{
+		TestSuitePositionResult position;
+		position.solved		  = i != 10; // The slowest one is not solved
+		position.solveSeconds = i * 0.1;
+		position.solveNodes	  = static_cast<uint64_t>(i) * 100;
+		result.positions.push_back(position);
+	}
+
+	EXPECT_EQ(result.solvedCount(), 9u);
+	EXPECT_EQ(result.solveNodesPercentile(0), 100u);
+	EXPECT_EQ(result.solveNodesPercentile(50), 500u);
+	EXPECT_EQ(result.solveNodesPercentile(90), 900u);
+	EXPECT_EQ(result.solveNodesPercentile(100), 900u);
+	EXPECT_DOUBLE_EQ(result.solveSecondsPercentile(50), 0.5);
+
+	EXPECT_EQ(TestSuiteResult().solveNodesPercentile(50), 0u);
+}
+
+} // namespace BenchTests
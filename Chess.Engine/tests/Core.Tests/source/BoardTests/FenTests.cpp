@@ -0,0 +1,305 @@
+/*
+  ==============================================================================
+	Module:			FEN Tests
+	Description:    Testing FEN / EPD parsing, writing and batch loading
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "Chessboard.h"
+#include "Epd.h"
+
+
+namespace BoardTests
+{
+
+TEST(FenTest, RoundTripsThroughTheBoard)
+{
+	const std::string fens[] = {
+		std::string(Fen::START_POSITION),
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 17 42",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+		"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 b Kq - 0 10",
+	};
+
+	for (const auto &fen : fens)
+	{
+		Chessboard board;
+		board.init();
+
+		ASSERT_TRUE(board.parseFEN(fen)) << fen;
+		EXPECT_EQ(board.toFEN(), fen);
+	}
+}
+
+
+TEST(FenTest, ReadsTheMoveCounters)
+{
+	Chessboard board;
+	board.init();
+
+	ASSERT_TRUE(board.parseFEN("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 b - - 37 113"));
+	EXPECT_EQ(board.getHalfMoveClock(), 37);
+	EXPECT_EQ(board.getMoveCounter(), 113);
+
+	ASSERT_TRUE(board.parseFEN("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 b - -")) << "The counters are optional";
+	EXPECT_EQ(board.getHalfMoveClock(), 0);
+	EXPECT_EQ(board.getMoveCounter(), 1);
+}
+
+
+TEST(FenTest, SameHashAsTheMovesLeadingThere)
+{
+	Chessboard board;
+	board.init();
+	uint64_t startHash = board.getHash();
+
+	ASSERT_TRUE(board.parseFEN("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1"));
+	EXPECT_NE(board.getHash(), startHash);
+
+	ASSERT_TRUE(board.parseFEN(Fen::START_POSITION));
+	EXPECT_EQ(board.getHash(), startHash);
+}
+
+
+TEST(FenTest, ReportsTheBrokenField)
+{
+	struct Case
+	{
+		const char *fen;
+		FenError	error;
+	};
+
+	const Case cases[] = {
+		{"", FenError::PiecePlacement},
+		{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1", FenError::PiecePlacement},
+		{"rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", FenError::PiecePlacement},
+		{"rnbqkbnr/ppppxppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", FenError::PiecePlacement},
+		{"rnbqkbnr/ppppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", FenError::PiecePlacement},
+		{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR", FenError::SideToMove},
+		{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR x KQkq - 0 1", FenError::SideToMove},
+		{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w", FenError::Castling},
+		{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkx - 0 1", FenError::Castling},
+		{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KKq - 0 1", FenError::Castling},
+		{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq", FenError::EnPassant},
+		{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq i6 0 1", FenError::EnPassant},
+		{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e3 0 1", FenError::EnPassant},
+		{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 70000 1", FenError::HalfMoveClock},
+		{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 0", FenError::FullMoveNumber},
+		{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1x", FenError::FullMoveNumber},
+	};
+
+	for (const auto &test : cases)
+	{
+		FenPosition position;
+		EXPECT_EQ(Fen::parse(test.fen, position), test.error) << test.fen;
+	}
+}
+
+
+TEST(FenTest, ValidateRejectsUnplayablePositions)
+{
+	FenPosition position;
+
+	ASSERT_EQ(Fen::parse("8/8/8/8/8/8/8/8 w - -", position), FenError::None);
+	EXPECT_EQ(Fen::validate(position), FenError::KingCount);
+
+	ASSERT_EQ(Fen::parse("k7/8/8/8/8/8/8/KK6 w - -", position), FenError::None);
+	EXPECT_EQ(Fen::validate(position), FenError::KingCount);
+
+	ASSERT_EQ(Fen::parse("k6P/8/8/8/8/8/8/K7 w - -", position), FenError::None);
+	EXPECT_EQ(Fen::validate(position), FenError::PawnOnBackRank);
+
+	// More than a game can reach, or than the engine's fixed-size structures hold
+	ASSERT_EQ(Fen::parse("k7/8/QQQQQQQQ/QQQQQQQQ/8/8/8/K7 w - -", position), FenError::None);
+	EXPECT_EQ(Fen::validate(position), FenError::PieceTypeCount);
+
+	ASSERT_EQ(Fen::parse("k7/8/8/QQQQQQQQ/RRRRRRRR/N7/8/K7 w - -", position), FenError::None);
+	EXPECT_EQ(Fen::validate(position), FenError::PieceCount);
+
+	ASSERT_EQ(Fen::parse("k7/8/8/8/pppppppp/p7/8/K7 w - -", position), FenError::None);
+	EXPECT_EQ(Fen::validate(position), FenError::PawnCount);
+
+	ASSERT_EQ(Fen::parse("rnbqkbnr/qqqqqqqq/8/8/8/8/QQQQQQQQ/RNBQKBNR w - -", position), FenError::None);
+	EXPECT_EQ(Fen::validate(position), FenError::None);
+
+	// The side not to move is in check
+	ASSERT_EQ(Fen::parse("k6R/8/8/8/8/8/8/K7 w - -", position), FenError::None);
+	EXPECT_EQ(Fen::validate(position), FenError::OpponentInCheck);
+
+	ASSERT_EQ(Fen::parse("k6R/8/8/8/8/8/8/K7 b - -", position), FenError::None);
+	EXPECT_EQ(Fen::validate(position), FenError::None);
+
+	ASSERT_EQ(Fen::parse("8/8/8/8/8/2k5/1P6/K7 w - -", position), FenError::None);
+	EXPECT_EQ(Fen::validate(position), FenError::OpponentInCheck);
+
+	ASSERT_EQ(Fen::parse("8/8/8/8/8/1n6/8/K1k5 b - -", position), FenError::None);
+	EXPECT_EQ(Fen::validate(position), FenError::OpponentInCheck);
+
+	ASSERT_EQ(Fen::parse(Fen::START_POSITION, position), FenError::None);
+	EXPECT_EQ(Fen::validate(position), FenError::None);
+}
+
+
+TEST(FenTest, RejectedFenLeavesTheBoardUnchanged)
+{
+	Chessboard board;
+	board.init();
+	uint64_t hash = board.getHash();
+
+	EXPECT_FALSE(board.parseFEN("8/8/8/8/8/8/8/8 w - - 0 1"));
+	EXPECT_FALSE(board.parseFEN("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR"));
+
+	EXPECT_EQ(board.getHash(), hash);
+	EXPECT_EQ(board.toFEN(), Fen::START_POSITION);
+}
+
+
+TEST(EpdTest, ParsesTheCommonOpcodes)
+{
+	EpdRecord record;
+
+	ASSERT_EQ(Epd::parse("2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - bm Qg6 Qh3; am Qf4; id \"WAC.001\"; c0 \"mate; in 3\"; acd 12; ce 320;", record), FenError::None);
+
+	EXPECT_EQ(record.bestMoves, (std::vector<std::string>{"Qg6", "Qh3"}));
+	EXPECT_EQ(record.avoidMoves, (std::vector<std::string>{"Qf4"}));
+	EXPECT_EQ(record.id, "WAC.001");
+	EXPECT_EQ(record.comment, "mate; in 3") << "A quoted operand may hold semicolons";
+	EXPECT_EQ(record.depth, 12);
+	ASSERT_EQ(record.operations.size(), 1u);
+	EXPECT_EQ(record.operations[0].first, "ce");
+	EXPECT_EQ(record.operations[0].second, "320");
+	EXPECT_EQ(record.position.side, Side::White);
+}
+
+
+TEST(EpdTest, MoveCountersFromFieldsOrOpcodes)
+{
+	EpdRecord fields;
+	EpdRecord opcodes;
+
+	ASSERT_EQ(Epd::parse("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 5 30 bm Rb1;", fields), FenError::None);
+	ASSERT_EQ(Epd::parse("8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - hmvc 5; fmvn 30; bm Rb1", opcodes), FenError::None);
+
+	EXPECT_EQ(fields, opcodes);
+	EXPECT_EQ(fields.position.halfMoveClock, 5);
+	EXPECT_EQ(fields.position.fullMoveNumber, 30);
+}
+
+
+TEST(EpdTest, RoundTrips)
+{
+	const char *lines[] = {
+		"2rr3k/pp3pp1/1nnqbN1p/3pN3/2pP4/2P3Q1/PPB4P/R4RK1 w - - bm Qg6; id \"WAC.001\";",
+		"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 bm e5 c5; am a5; id \"open\"; c0 \"king pawn\"; acd 20; hmvc 3; fmvn 9; ce 15; pv e5 Nf3;",
+		"8/8/8/8/8/8/8/k6K w - - noop;",
+	};
+
+	for (const char *line : lines)
+	{
+		EpdRecord record;
+		ASSERT_EQ(Epd::parse(line, record), FenError::None) << line;
+
+		std::string written = Epd::toString(record);
+		EXPECT_EQ(written, line);
+
+		EpdRecord reparsed;
+		ASSERT_EQ(Epd::parse(written, reparsed), FenError::None);
+		EXPECT_EQ(reparsed, record);
+	}
+}
+
+
+TEST(EpdTest, RejectsMalformedOperations)
+{
+	EpdRecord record;
+
+	EXPECT_EQ(Epd::parse("8/8/8/8/8/8/8/k6K w - - id \"unterminated;", record), FenError::Operation);
+	EXPECT_EQ(Epd::parse("8/8/8/8/8/8/8/k6K w - - acd deep;", record), FenError::Operation);
+	EXPECT_EQ(Epd::parse("8/8/8/8/8/8/8/k6K w - - ;", record), FenError::Operation);
+	EXPECT_EQ(Epd::parse("8/8/8/8/8/8/8/k6K w - - fmvn 0;", record), FenError::FullMoveNumber);
+}
+
+
+TEST(EpdBatchLoaderTest, MatchesSingleLineParsingAndKeepsTheOrder)
+{
+	const std::string fens[] = {
+		std::string(Fen::START_POSITION),
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 17 42",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+	};
+
+	// Large enough to be split over several threads, with a broken line, a comment and a blank line
+	std::string text;
+	size_t		lines = 0;
+
+	for (int i = 0; i < 20000; ++i)
+	{
+		text += fens[i % 4];
+		text += i % 2 ? " bm e4; id \"x\";\r\n" : "\n";
+		++lines;
+
+		if (i == 777)
+		{
+			text += "# comment\n\nnot a position\n";
+			lines += 3;
+		}
+	}
+
+	std::vector<FenPosition> single;
+	std::vector<FenPosition> parallel;
+
+	EpdLoadResult			 singleResult	= EpdBatchLoader::parse(text, single, 1);
+	EpdLoadResult			 parallelResult = EpdBatchLoader::parse(text, parallel, 4);
+
+	ASSERT_EQ(single.size(), 20000u);
+	EXPECT_EQ(single, parallel);
+	EXPECT_EQ(singleResult.lines, 20001u);
+	EXPECT_EQ(singleResult.invalid, 1u);
+	EXPECT_EQ(singleResult.firstInvalidLine, 781u);
+	EXPECT_EQ(singleResult.firstError, FenError::PiecePlacement);
+	EXPECT_EQ(parallelResult.firstInvalidLine, singleResult.firstInvalidLine);
+
+	for (size_t i = 0; i < single.size(); ++i)
+	{
+		FenPosition expected;
+		ASSERT_EQ(Fen::parse(fens[i % 4], expected), FenError::None);
+		ASSERT_EQ(single[i], expected) << "Position " << i;
+	}
+}
+
+
+TEST(EpdBatchLoaderTest, LoadsAMappedFile)
+{
+	auto path = (std::filesystem::temp_directory_path() / "epd_batch_loader_test.epd").string();
+
+	{
+		std::ofstream file(path, std::ios::binary);
+		file << Fen::START_POSITION << "\n"
+			 << "8/8/8/8/8/8/8/8 w - -\n"
+			 << "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - bm Rb1;";
+	}
+
+	std::vector<FenPosition> positions;
+	EpdLoadResult			 result;
+
+	ASSERT_TRUE(EpdBatchLoader::load(path, positions, result));
+	std::filesystem::remove(path);
+
+	ASSERT_EQ(positions.size(), 2u) << "The last line needs no line break";
+	EXPECT_EQ(result.invalid, 1u);
+	EXPECT_EQ(result.firstInvalidLine, 2u);
+	EXPECT_EQ(result.firstError, FenError::KingCount);
+	EXPECT_EQ(Fen::toString(positions[1]), "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+
+	EXPECT_FALSE(EpdBatchLoader::load(path, positions, result)) << "The file is gone";
+}
+
+} // namespace BoardTests
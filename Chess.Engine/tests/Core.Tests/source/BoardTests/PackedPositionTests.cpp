@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+	Module:			Packed Position Tests
+	Description:    Testing the 32 byte position encoding and its file streams
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+#include "Chessboard.h"
+#include "PackedPosition.h"
+
+
+namespace BoardTests
+{
+
+const char *PACKED_TEST_FENS[] = {
+	"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+	"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1",
+	"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+	"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w Kq - 3 17",
+	"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 b - - 255 8191",
+	"n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+	"4k3/8/8/8/8/8/8/4K3 w - - 99 120",
+};
+
+
+TEST(PackedPositionTest, RoundTripsThroughFen)
+{
+	for (const char *fen : PACKED_TEST_FENS)
+	{
+		FenPosition position;
+		ASSERT_EQ(Fen::parse(fen, position), FenError::None) << fen;
+
+		PackedAnnotation annotation{-1234, PackedResult::Draw, Move(Square::e2, Square::e4, MoveFlag::DoublePawnPush)};
+		PackedPosition	 packed;
+		ASSERT_TRUE(PackedPosition::pack(position, annotation, packed)) << fen;
+
+		FenPosition		 unpacked;
+		PackedAnnotation unpackedAnnotation;
+		packed.unpack(unpacked, &unpackedAnnotation);
+
+		EXPECT_EQ(unpacked, position) << fen;
+		EXPECT_EQ(unpackedAnnotation, annotation) << fen;
+		EXPECT_EQ(Fen::toString(unpacked), fen);
+	}
+}
+
+
+TEST(PackedPositionTest, RoundTripsThroughTheBoard)
+{
+	Chessboard board;
+	board.init();
+	ASSERT_TRUE(board.parseFEN(PACKED_TEST_FENS[3]));
+
+	PackedPosition packed;
+	ASSERT_TRUE(PackedPosition::pack(board, {}, packed));
+
+	Chessboard restored;
+	restored.init();
+	packed.unpack(restored);
+
+	EXPECT_EQ(restored.toFEN(), PACKED_TEST_FENS[3]);
+	EXPECT_EQ(restored.getHash(), board.getHash());
+	EXPECT_EQ(restored.getPieceScore(), board.getPieceScore());
+}
+
+
+TEST(PackedPositionTest, LayoutIsLittleEndian)
+{
+	FenPosition position;
+	ASSERT_EQ(Fen::parse("4k3/8/8/8/8/8/8/4K3 b - - 5 2", position), FenError::None);
+
+	PackedPosition packed;
+	ASSERT_TRUE(PackedPosition::pack(position, {300, PackedResult::WhiteWin, Move()}, packed));
+
+	const uint8_t expected[PackedPosition::SIZE] = {
+		0x10, 0, 0, 0, 0, 0, 0, 0x10, // e8 (bit 4) and e1 (bit 60)
+		0x06, 0, 0, 0, 0, 0, 0, 0,	  // black king first, then the white king (type 0)
+		0, 0, 0, 0, 0, 0, 0, 0,
+		0x01, 0x2E, 0x10, 0x00, 0x2C, 0x01, 0, 0, // black, result 3 << 9, clocks 5 << 11 and 2 << 19, score 300
+	};
+
+	EXPECT_EQ(std::memcmp(packed.data(), expected, PackedPosition::SIZE), 0);
+}
+
+
+TEST(PackedPositionTest, RejectsWhatCannotBeStoredExactly)
+{
+	FenPosition		 position;
+	PackedPosition	 packed;
+	PackedAnnotation none;
+
+	ASSERT_EQ(Fen::parse("4k3/8/8/8/8/8/8/4K3 w - - 256 1", position), FenError::None);
+	EXPECT_FALSE(PackedPosition::pack(position, none, packed)) << "Halfmove clock out of range";
+
+	ASSERT_EQ(Fen::parse("4k3/8/8/8/8/8/8/4K3 w - - 0 8192", position), FenError::None);
+	EXPECT_FALSE(PackedPosition::pack(position, none, packed)) << "Fullmove number out of range";
+
+	ASSERT_EQ(Fen::parse("rnbqkbnr/pppppppp/8/8/8/7N/PPPPPPPP/RNBQKBNR w KQkq - 0 1", position), FenError::None);
+	EXPECT_FALSE(PackedPosition::pack(position, none, packed)) << "33 pieces";
+
+	ASSERT_EQ(Fen::parse("4k3/8/8/8/8/8/8/4K3 w - - 0 1", position), FenError::None);
+	position.pieces[WQueen] = position.pieces[WKing];
+	EXPECT_FALSE(PackedPosition::pack(position, none, packed)) << "Two pieces on one square";
+}
+
+
+TEST(PackedPositionTest, BulkMatchesSinglePositions)
+{
+	std::vector<FenPosition>	  positions;
+	std::vector<PackedAnnotation> annotations;
+
+	for (int i = 0; i < 100; ++i)
+	{
+		FenPosition position;
+		ASSERT_EQ(Fen::parse(PACKED_TEST_FENS[i % std::size(PACKED_TEST_FENS)], position), FenError::None);
+		positions.push_back(position);
+		annotations.push_back({static_cast<int16_t>(i * 7 - 300), static_cast<PackedResult>(i % 4), Move(static_cast<uint16_t>(i))});
+	}
+
+	positions[42].halfMoveClock = 1000;
+
+	std::vector<PackedPosition> packed(positions.size());
+	EXPECT_EQ(PackedPosition::packAll(positions.data(), annotations.data(), packed.data(), positions.size()), 1u);
+	EXPECT_EQ(packed[42], PackedPosition()) << "A rejected position is left zero";
+
+	std::vector<FenPosition>	  unpacked(positions.size());
+	std::vector<PackedAnnotation> unpackedAnnotations(positions.size());
+	PackedPosition::unpackAll(packed.data(), unpacked.data(), unpackedAnnotations.data(), packed.size());
+
+	for (size_t i = 0; i < positions.size(); ++i)
+	{
+		if (i == 42)
+			continue;
+
+		PackedPosition single;
+		ASSERT_TRUE(PackedPosition::pack(positions[i], annotations[i], single));
+		EXPECT_EQ(packed[i], single);
+		EXPECT_EQ(unpacked[i], positions[i]);
+		EXPECT_EQ(unpackedAnnotations[i], annotations[i]);
+	}
+}
+
+
+TEST(PackedPositionTest, StreamsThroughAFile)
+{
+	auto path = (std::filesystem::temp_directory_path() / "packed_position_test.bin").string();
+
+	std::vector<PackedPosition> written;
+
+	for (int i = 0; i < 10000; ++i)
+	{
+		FenPosition position;
+		ASSERT_EQ(Fen::parse(PACKED_TEST_FENS[i % std::size(PACKED_TEST_FENS)], position), FenError::None);
+
+		PackedPosition packed;
+		ASSERT_TRUE(PackedPosition::pack(position, {static_cast<int16_t>(i), PackedResult::Unknown, Move()}, packed));
+		written.push_back(packed);
+	}
+
+	{
+		PackedPositionWriter writer;
+		ASSERT_TRUE(writer.open(path));
+		ASSERT_TRUE(writer.write(written.front()));
+		ASSERT_TRUE(writer.write(written.data() + 1, written.size() - 1));
+		EXPECT_EQ(writer.count(), written.size());
+		ASSERT_TRUE(writer.close());
+	}
+
+	EXPECT_EQ(std::filesystem::file_size(path), PackedFileHeader::SIZE + written.size() * PackedPosition::SIZE);
+
+	PackedPositionReader		reader;
+	std::vector<PackedPosition> read;
+	PackedPosition				buffer[777];
+
+	ASSERT_TRUE(reader.open(path));
+	EXPECT_EQ(reader.version(), PackedFileHeader::VERSION);
+
+	for (size_t count = reader.read(buffer, std::size(buffer)); count > 0; count = reader.read(buffer, std::size(buffer)))
+		read.insert(read.end(), buffer, buffer + count);
+
+	EXPECT_EQ(read, written);
+
+	reader.close();
+	std::filesystem::remove(path);
+}
+
+
+TEST(PackedPositionTest, ReaderRejectsForeignFiles)
+{
+	auto path = (std::filesystem::temp_directory_path() / "packed_position_foreign.bin").string();
+
+	{
+		std::ofstream file(path, std::ios::binary);
+		file << "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1\n";
+	}
+
+	PackedPositionReader reader;
+	EXPECT_FALSE(reader.open(path));
+
+	{
+		std::ofstream file(path, std::ios::binary);
+		file.write("CPOS\x02\x00\x20\x00", 8);
+	}
+
+	EXPECT_FALSE(reader.open(path)) << "Newer version";
+
+	std::filesystem::remove(path);
+	EXPECT_FALSE(reader.open(path)) << "Missing file";
+}
+
+} // namespace BoardTests
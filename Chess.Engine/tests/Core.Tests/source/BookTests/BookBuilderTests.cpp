@@ -0,0 +1,234 @@
+/*
+  ==============================================================================
+	Module:			Book Builder Tests
+	Description:    Testing the PGN to Polyglot book builder
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+#include "BookBuilder.h"
+#include "PolyglotBook.h"
+
+
+namespace BookTests
+{
+
+const char *BUILDER_PGN = R"([Event "Comments and variations"]
+[Site "?"]
+[Result "1-0"]
+
+1. e4 {best by test} e5 2. Nf3 (2. Bc4 Nf6) Nc6 $1 3. Bb5 1-0
+
+[Event "Glued move numbers"]
+[Result "0-1"]
+
+1.e4 c5 2.Nf3 d6 0-1
+
+[Event "Line comment"]
+[Result "1/2-1/2"]
+
+1. d4 d5 ; the queen's gambit follows
+2. c4 1/2-1/2
+
+[Event "Unfinished"]
+[Result "*"]
+
+1. e4 *
+
+[Event "Illegal move"]
+[Result "1-0"]
+
+1. e4 e5 2. Ke3 1-0
+
+[Event "Set up"]
+[SetUp "1"]
+[FEN "4k3/8/8/8/8/8/8/4K2R w K - 0 1"]
+[Result "1-0"]
+
+1. O-O Kd7 1-0
+)";
+
+
+// Long games, so a tiny memory budget spills many runs whatever shards the keys fall into
+const char *LONG_GAMES_PGN = R"(
+[Event "Opera game"]
+[Result "1-0"]
+
+1. e4 e5 2. Nf3 d6 3. d4 Bg4 4. dxe5 Bxf3 5. Qxf3 dxe5 6. Bc4 Nf6 7. Qb3 Qe7 8. Nc3 c6 9. Bg5 b5
+10. Nxb5 cxb5 11. Bxb5+ Nbd7 12. O-O-O Rd8 13. Rxd7 Rxd7 14. Rd1 Qe6 15. Bxd7+ Nxd7 16. Qb8+ Nxb8 17. Rd8# 1-0
+
+[Event "Immortal game"]
+[Result "1-0"]
+
+1. e4 e5 2. f4 exf4 3. Bc4 Qh4+ 4. Kf1 b5 5. Bxb5 Nf6 6. Nf3 Qh6 7. d3 Nh5 8. Nh4 Qg5 9. Nf5 c6
+10. g4 Nf6 11. Rg1 cxb5 12. h4 Qg6 13. h5 Qg5 14. Qf3 Ng8 15. Bxf4 Qf6 16. Nc3 Bc5 17. Nd5 Qxb2
+18. Bd6 Bxg1 19. e5 Qxa1+ 20. Ke2 Na6 21. Nxg7+ Kd8 22. Qf6+ Nxf6 23. Be7# 1-0
+)";
+
+
+class BookBuilderTests : public ::testing::Test
+{
+protected:
+	std::filesystem::path mDirectory = std::filesystem::temp_directory_path() / "book_builder_test";
+	std::string			  mPgnPath;
+	std::string			  mBookPath;
+
+	void				  SetUp() override
+	{
+		std::filesystem::create_directories(mDirectory);
+		mPgnPath  = (mDirectory / "games.pgn").string();
+		mBookPath = (mDirectory / "book.bin").string();
+
+		std::ofstream file(mPgnPath, std::ios::binary);
+		file << BUILDER_PGN;
+	}
+
+	void TearDown() override { std::filesystem::remove_all(mDirectory); }
+
+	static uint64_t keyOf(const char *fen)
+	{
+		FenPosition position;
+		EXPECT_EQ(Fen::parse(fen, position), FenError::None);
+		return PolyglotBook::computeKey(position);
+	}
+
+	void appendLongGames() const
+	{
+		std::ofstream file(mPgnPath, std::ios::binary | std::ios::app);
+		file << LONG_GAMES_PGN;
+	}
+
+	static std::string readFile(const std::string &path)
+	{
+		std::ifstream file(path, std::ios::binary);
+		return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+	}
+};
+
+
+TEST_F(BookBuilderTests, CountsResultsFromTheMoverView)
+{
+	BookBuildOptions options;
+	options.minGames = 1;
+
+	BookBuildResult result;
+	ASSERT_TRUE(BookBuilder::build(mPgnPath, mBookPath, options, result));
+
+	EXPECT_EQ(result.games, 5u);
+	EXPECT_EQ(result.skippedGames, 1u) << "The unfinished game";
+	EXPECT_EQ(result.brokenGames, 1u);
+	EXPECT_EQ(result.samples, 5u + 4u + 3u + 2u + 2u);
+
+	PolyglotBook book;
+	ASSERT_TRUE(book.open(mBookPath));
+	EXPECT_EQ(book.size(), result.entries);
+
+	// e4: two wins and a loss for white (weight 2 * 2), d4: a draw (weight 1)
+	uint64_t start = keyOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+	ASSERT_EQ(book.count(start), 2u);
+
+	PolyglotEntry first	 = book.entry(book.lowerBound(start));
+	PolyglotEntry second = book.entry(book.lowerBound(start) + 1);
+
+	EXPECT_EQ(first.move, PolyglotBook::encodeMove(Move(Square::d2, Square::d4, MoveFlag::DoublePawnPush)));
+	EXPECT_EQ(first.weight, 1);
+	EXPECT_EQ(second.move, PolyglotBook::encodeMove(Move(Square::e2, Square::e4, MoveFlag::DoublePawnPush)));
+	EXPECT_EQ(second.weight, 4);
+
+	// After 1. e4 black lost both games with e5 (weight 0, left out) and won with c5
+	uint64_t afterE4 = keyOf("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+	ASSERT_EQ(book.count(afterE4), 1u);
+	EXPECT_EQ(book.entry(book.lowerBound(afterE4)).move, PolyglotBook::encodeMove(Move(Square::c7, Square::c5, MoveFlag::DoublePawnPush)));
+
+	// The set up game starts from its FEN
+	EXPECT_EQ(book.count(keyOf("4k3/8/8/8/8/8/8/4K2R w K - 0 1")), 1u);
+
+	for (size_t i = 1; i < book.size(); ++i)
+		EXPECT_LE(book.entry(i - 1).key, book.entry(i).key) << "Entries are sorted by key";
+}
+
+
+TEST_F(BookBuilderTests, FiltersByGamesAndPly)
+{
+	BookBuildOptions options;
+	options.minGames = 2;
+	options.maxPly	 = 1;
+
+	BookBuildResult result;
+	ASSERT_TRUE(BookBuilder::build(mPgnPath, mBookPath, options, result));
+
+	// Only 1. e4 was played twice among the first plies
+	PolyglotBook book;
+	ASSERT_TRUE(book.open(mBookPath));
+	ASSERT_EQ(book.size(), 1u);
+	EXPECT_EQ(book.entry(0).move, PolyglotBook::encodeMove(Move(Square::e2, Square::e4, MoveFlag::DoublePawnPush)));
+}
+
+
+TEST_F(BookBuilderTests, SpilledRunsGiveTheSameBook)
+{
+	appendLongGames();
+
+	BookBuildOptions options;
+	options.minGames = 1;
+
+	BookBuildResult inMemory;
+	ASSERT_TRUE(BookBuilder::build(mPgnPath, mBookPath, options, inMemory));
+	EXPECT_EQ(inMemory.spilledRuns, 0u);
+
+	std::string expected = readFile(mBookPath);
+
+	options.maxEntries	  = 1;
+	options.tempDirectory = (mDirectory / "runs").string();
+	std::filesystem::create_directories(options.tempDirectory);
+
+	BookBuildResult spilled;
+	ASSERT_TRUE(BookBuilder::build(mPgnPath, mBookPath, options, spilled));
+
+	EXPECT_GT(spilled.spilledRuns, 0u);
+	EXPECT_EQ(spilled.entries, inMemory.entries);
+	EXPECT_EQ(readFile(mBookPath), expected);
+	EXPECT_TRUE(std::filesystem::is_empty(options.tempDirectory)) << "Runs are removed after the merge";
+}
+
+
+TEST_F(BookBuilderTests, RunsBeyondTheFanInAreMergedInPasses)
+{
+	appendLongGames();
+
+	BookBuildOptions options;
+	options.minGames = 1;
+
+	BookBuildResult inMemory;
+	ASSERT_TRUE(BookBuilder::build(mPgnPath, mBookPath, options, inMemory));
+
+	std::string expected = readFile(mBookPath);
+
+	options.maxEntries	  = 1;
+	options.maxMergeRuns  = 2;
+	options.tempDirectory = (mDirectory / "runs").string();
+	std::filesystem::create_directories(options.tempDirectory);
+
+	BookBuildResult spilled;
+	ASSERT_TRUE(BookBuilder::build(mPgnPath, mBookPath, options, spilled));
+
+	ASSERT_GT(spilled.spilledRuns, 4u) << "More runs than two passes of the fan-in can merge";
+	EXPECT_GE(spilled.mergePasses, 2u);
+	EXPECT_EQ(spilled.entries, inMemory.entries);
+	EXPECT_EQ(readFile(mBookPath), expected);
+	EXPECT_TRUE(std::filesystem::is_empty(options.tempDirectory)) << "Intermediate runs are removed too";
+}
+
+
+TEST_F(BookBuilderTests, MissingInputFails)
+{
+	BookBuildResult result;
+	EXPECT_FALSE(BookBuilder::build((mDirectory / "missing.pgn").string(), mBookPath, BookBuildOptions(), result));
+}
+
+} // namespace BookTests
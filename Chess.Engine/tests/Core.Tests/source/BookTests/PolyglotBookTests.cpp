@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+	Module:			Polyglot Book Tests
+	Description:    Testing the opening book keys, move encoding, probing and the CPU's use of it
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "CPUPlayer.h"
+#include "GameEngine.h"
+#include "Notation/MoveNotation.h"
+#include "PolyglotBook.h"
+
+
+namespace BookTests
+{
+
+const char *START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+
+static uint64_t keyOf(const char *fen)
+{
+	FenPosition position;
+	EXPECT_EQ(Fen::parse(fen, position), FenError::None) << fen;
+	return PolyglotBook::computeKey(position);
+}
+
+
+static void writeBook(const std::string &path, std::vector<PolyglotEntry> entries)
+{
+	std::sort(entries.begin(), entries.end(), [](const PolyglotEntry &a, const PolyglotEntry &b) { return a.key < b.key; });
+
+	std::ofstream file(path, std::ios::binary);
+
+	for (const auto &entry : entries)
+	{
+		char bytes[PolyglotBook::ENTRY_SIZE];
+		PolyglotBook::writeEntry(entry, bytes);
+		file.write(bytes, sizeof(bytes));
+	}
+}
+
+
+class PolyglotBookTests : public ::testing::Test
+{
+protected:
+	std::string mPath = (std::filesystem::temp_directory_path() / "polyglot_book_test.bin").string();
+
+	void		TearDown() override { std::filesystem::remove(mPath); }
+
+	void		writeStartBook()
+	{
+		uint64_t start = keyOf(START_FEN);
+
+		writeBook(mPath, {
+							 {start - 1, PolyglotBook::encodeMove(Move(Square::a2, Square::a3)), 50, 0},
+							 {start, PolyglotBook::encodeMove(Move(Square::e2, Square::e4, MoveFlag::DoublePawnPush)), 300, 0},
+							 {start, PolyglotBook::encodeMove(Move(Square::d2, Square::d4, MoveFlag::DoublePawnPush)), 100, 0},
+							 {start, PolyglotBook::encodeMove(Move(Square::e2, Square::e5)), 1000, 0}, // Illegal
+							 {start, PolyglotBook::encodeMove(Move(Square::c2, Square::c4, MoveFlag::DoublePawnPush)), 0, 0}, // Never played
+							 {start + 1, PolyglotBook::encodeMove(Move(Square::h2, Square::h3)), 50, 0},
+						 });
+	}
+};
+
+
+TEST(PolyglotEncodingTest, MovesUsePolyglotLayout)
+{
+	EXPECT_EQ(PolyglotBook::encodeMove(Move(Square::e2, Square::e4, MoveFlag::DoublePawnPush)), 796);
+	EXPECT_EQ(PolyglotBook::encodeMove(Move(Square::e1, Square::g1, MoveFlag::KingCastle)), 263) << "Castling is king takes rook (e1h1)";
+	EXPECT_EQ(PolyglotBook::encodeMove(Move(Square::e7, Square::e8, MoveFlag::QueenPromotion)), 19772);
+
+	GameEngine engine;
+	engine.init();
+	ASSERT_TRUE(engine.getBoard().parseFEN("r3k2r/1P6/8/8/8/p7/8/R3K2R w KQkq - 0 1"));
+
+	MoveList legalMoves;
+	engine.generateLegalMoves(legalMoves);
+
+	for (Move move : legalMoves)
+		EXPECT_EQ(PolyglotBook::decodeMove(PolyglotBook::encodeMove(move), legalMoves), move) << MoveNotation::toUCI(move);
+
+	// e1g1 is accepted for castling too
+	EXPECT_EQ(PolyglotBook::decodeMove(262, legalMoves), Move(Square::e1, Square::g1, MoveFlag::KingCastle));
+	EXPECT_FALSE(PolyglotBook::decodeMove(PolyglotBook::encodeMove(Move(Square::e1, Square::e3)), legalMoves).isValid()) << "No legal move";
+}
+
+
+TEST(PolyglotEncodingTest, EntriesAreBigEndian)
+{
+	PolyglotEntry entry{0x0102030405060708ULL, 0x090A, 0x0B0C, 0x0D0E0F10};
+	char		  bytes[PolyglotBook::ENTRY_SIZE];
+	PolyglotBook::writeEntry(entry, bytes);
+
+	for (int i = 0; i < 16; ++i)
+		EXPECT_EQ(bytes[i], static_cast<char>(i + 1));
+
+	EXPECT_EQ(PolyglotBook::readEntry(bytes), entry);
+}
+
+
+TEST(PolyglotKeyTest, KeysFollowThePositionRules)
+{
+	uint64_t start = keyOf(START_FEN);
+
+	EXPECT_NE(start, keyOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR b KQkq - 0 1")) << "Side to move";
+	EXPECT_NE(start, keyOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w Qkq - 0 1")) << "Castling rights";
+	EXPECT_EQ(start, keyOf("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 12 40")) << "Clocks are not part of the key";
+
+	// The en passant file only counts if a pawn can take
+	EXPECT_EQ(keyOf("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1"), keyOf("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1"));
+	EXPECT_NE(keyOf("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"), keyOf("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq - 0 3"));
+
+	Chessboard board;
+	board.init();
+	ASSERT_TRUE(board.parseFEN(START_FEN));
+	EXPECT_EQ(PolyglotBook::computeKey(board), start);
+}
+
+
+TEST(PolyglotKeyTest, KeysMatchThePolyglotReference)
+{
+	// Reference keys of the Polyglot book format specification
+	EXPECT_EQ(keyOf(START_FEN), 0x463B96181691FC9CULL);
+	EXPECT_EQ(keyOf("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1"), 0x823C9B50FD114196ULL) << "e2e4";
+	EXPECT_EQ(keyOf("rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2"), 0x0756B94461C50FB0ULL) << "e2e4 d7d5";
+	EXPECT_EQ(keyOf("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2"), 0x662FAFB965DB29D4ULL) << "e2e4 d7d5 e4e5";
+	EXPECT_EQ(keyOf("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"), 0x22A48B5A8E47FF78ULL) << "e2e4 d7d5 e4e5 f7f5 (en passant)";
+	EXPECT_EQ(keyOf("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR b kq - 0 3"), 0x652A607CA3F242C1ULL) << "... e1e2";
+	EXPECT_EQ(keyOf("rnbq1bnr/ppp1pkpp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR w - - 0 4"), 0x00FDD303C946BDD9ULL) << "... e1e2 e8f7";
+	EXPECT_EQ(keyOf("rnbqkbnr/p1pppppp/8/8/PpP4P/8/1P1PPPP1/RNBQKBNR b KQkq c3 0 3"), 0x3C8123EA7B067637ULL) << "a2a4 b7b5 h2h4 b5b4 c2c4 (en passant)";
+	EXPECT_EQ(keyOf("rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4"), 0x5C3F9B829B279560ULL) << "... b4c3 a1a3";
+}
+
+
+TEST_F(PolyglotBookTests, ProbeFindsTheLegalWeightedMoves)
+{
+	writeStartBook();
+
+	PolyglotBook book;
+	ASSERT_TRUE(book.open(mPath));
+	EXPECT_EQ(book.size(), 6u);
+
+	uint64_t start = keyOf(START_FEN);
+	EXPECT_EQ(book.lowerBound(start), 1u);
+	EXPECT_EQ(book.count(start), 4u);
+	EXPECT_EQ(book.count(start + 2), 0u);
+
+	GameEngine engine;
+	engine.init();
+	ASSERT_TRUE(engine.getBoard().parseFEN(START_FEN));
+
+	MoveList legalMoves;
+	engine.generateLegalMoves(legalMoves);
+
+	Move e4 = Move(Square::e2, Square::e4, MoveFlag::DoublePawnPush);
+	Move d4 = Move(Square::d2, Square::d4, MoveFlag::DoublePawnPush);
+
+	EXPECT_EQ(book.probe(engine.getBoard(), legalMoves), e4) << "Heaviest legal move without randomness";
+
+	std::mt19937 random(42);
+	int			 e4Count = 0;
+	int			 d4Count = 0;
+
+	for (int i = 0; i < 4000; ++i)
+	{
+		Move move = book.probe(engine.getBoard(), legalMoves, &random);
+		ASSERT_TRUE(move == e4 || move == d4) << MoveNotation::toUCI(move);
+		(move == e4 ? e4Count : d4Count)++;
+	}
+
+	// 3 : 1 by weight
+	EXPECT_NEAR(static_cast<double>(e4Count) / 4000.0, 0.75, 0.05);
+
+	ASSERT_TRUE(engine.getBoard().parseFEN("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1"));
+	engine.generateLegalMoves(legalMoves);
+	EXPECT_FALSE(book.probe(engine.getBoard(), legalMoves).isValid()) << "Position not in the book";
+}
+
+
+TEST_F(PolyglotBookTests, OpenRejectsBrokenFiles)
+{
+	{
+		std::ofstream file(mPath, std::ios::binary);
+		file << "not a book";
+	}
+
+	PolyglotBook book;
+	EXPECT_FALSE(book.open(mPath));
+	EXPECT_FALSE(book.isOpen());
+
+	std::filesystem::remove(mPath);
+	EXPECT_FALSE(book.open(mPath)) << "Missing file";
+}
+
+
+TEST_F(PolyglotBookTests, CPUPlaysFromTheBookWithoutSearching)
+{
+	writeStartBook();
+
+	GameEngine engine;
+	engine.init();
+	ASSERT_TRUE(engine.getBoard().parseFEN(START_FEN));
+
+	CPUPlayer		 cpu(engine);
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.cpuColor			   = Side::White;
+	config.difficulty		   = CPUDifficulty::Hard;
+	config.maxDepth			   = 3;
+	config.enableRandomization = false;
+	config.enablePondering	   = false;
+	config.openingBook		   = mPath;
+	cpu.configure(config);
+
+	EXPECT_EQ(cpu.calculateMove(), Move(Square::e2, Square::e4, MoveFlag::DoublePawnPush));
+	EXPECT_EQ(cpu.getNodesSearched(), 0u);
+
+	// Out of the book the CPU searches
+	ASSERT_TRUE(engine.getBoard().parseFEN("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1"));
+	EXPECT_TRUE(cpu.calculateMove().isValid());
+	EXPECT_GT(cpu.getNodesSearched(), 0u);
+
+	// Closing the book (an empty path) is a configuration change as well
+	config.openingBook = "";
+	cpu.configure(config);
+	ASSERT_TRUE(engine.getBoard().parseFEN(START_FEN));
+	EXPECT_TRUE(cpu.calculateMove().isValid());
+	EXPECT_GT(cpu.getNodesSearched(), 0u);
+}
+
+} // namespace BookTests
@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+	Module:			Endgame Tests
+	Description:    Testing the material key, the endgame dispatch and the KPK bitbase
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include "Endgame.h"
+#include "Evaluation.h"
+#include "GameEngine.h"
+#include "KPKBitbase.h"
+
+
+namespace EvaluationTests
+{
+
+class EndgameTest : public ::testing::Test
+{
+protected:
+	void SetUp() override { mEngine.init(); }
+
+	/**
+	 * @brief	Specialized score (white's view) of a position, fails if no endgame function applies.
+	 */
+	int	 endgameScore(const char *fen)
+	{
+		mEngine.getBoard().parseFEN(fen);
+
+		int score = 0;
+		EXPECT_TRUE(Endgames::probe(mEngine.getBoard(), score)) << fen;
+		return score;
+	}
+
+	bool isSpecialized(const char *fen)
+	{
+		mEngine.getBoard().parseFEN(fen);
+
+		int score;
+		return Endgames::probe(mEngine.getBoard(), score);
+	}
+
+	bool isInsufficient(const char *fen)
+	{
+		mEngine.getBoard().parseFEN(fen);
+		return Endgames::isInsufficientMaterial(mEngine.getBoard());
+	}
+
+	GameEngine mEngine;
+};
+
+
+TEST_F(EndgameTest, MaterialKeyCountsPieces)
+{
+	mEngine.getBoard().parseFEN("8/8/8/4k3/8/8/8/R3K3 w - - 0 1");
+	EXPECT_EQ(mEngine.getBoard().getMaterialKey(), MaterialKey::fromCode("KRK"));
+
+	mEngine.getBoard().parseFEN("r3k3/8/8/8/4K3/8/8/8 b - - 0 1");
+	EXPECT_EQ(mEngine.getBoard().getMaterialKey(), MaterialKey::mirror(MaterialKey::fromCode("KRK")));
+
+	mEngine.resetGame();
+	uint64_t start = mEngine.getBoard().getMaterialKey();
+	EXPECT_EQ(start, MaterialKey::fromCode("KQPPPPPPPPNNBBRRKQPPPPPPPPNNBBRR"));
+	EXPECT_EQ(MaterialKey::count(start, BPawn), 8);
+	EXPECT_EQ(MaterialKey::mirror(start), start);
+
+	// Captures and promotions change the key, undo restores it
+	mEngine.getBoard().parseFEN("4k3/1P6/8/8/8/8/8/4K1n1 w - - 0 1");
+	Chessboard &board  = mEngine.getBoard();
+	uint64_t	before = board.getMaterialKey();
+
+	board.removePiece(WPawn, Square::b7);
+	board.addPiece(WQueen, Square::b8);
+	EXPECT_EQ(board.getMaterialKey(), MaterialKey::fromCode("KQKN"));
+
+	board.removePiece(WQueen, Square::b8);
+	board.addPiece(WPawn, Square::b7);
+	EXPECT_EQ(board.getMaterialKey(), before);
+}
+
+
+TEST_F(EndgameTest, KPKBitbaseKnowsTheBasics)
+{
+	// King on the sixth rank in front of its pawn wins with either side to move
+	EXPECT_GT(endgameScore("3k4/8/3K4/3P4/8/8/8/8 w - - 0 1"), Endgames::KNOWN_WIN);
+	EXPECT_GT(endgameScore("3k4/8/3K4/3P4/8/8/8/8 b - - 0 1"), Endgames::KNOWN_WIN);
+
+	// The defending king reaches the corner of the rook pawn
+	EXPECT_EQ(endgameScore("1k6/8/8/8/P7/2K5/8/8 w - - 0 1"), 0);
+
+	// The pawn is lost
+	EXPECT_EQ(endgameScore("8/8/8/4k3/3P4/8/8/7K b - - 0 1"), 0);
+
+	// The king is outside the square of the pawn
+	EXPECT_GT(endgameScore("k7/8/8/7P/8/8/8/K7 w - - 0 1"), Endgames::KNOWN_WIN);
+
+	// Opposition: the side to move decides
+	EXPECT_EQ(endgameScore("8/4k3/8/4K3/4P3/8/8/8 w - - 0 1"), 0);
+	EXPECT_GT(endgameScore("8/4k3/8/4K3/4P3/8/8/8 b - - 0 1"), Endgames::KNOWN_WIN);
+
+	EXPECT_GT(KPKBitbase::countWins(), 0u);
+}
+
+
+TEST_F(EndgameTest, EndgamesAreColourSymmetric)
+{
+	const std::pair<const char *, const char *> positions[] = {
+		{"8/8/8/4k3/8/8/8/R3K3 w - - 0 1", "r3k3/8/8/8/4K3/8/8/8 b - - 0 1"},
+		{"8/8/2k5/8/8/8/8/3QK3 b - - 0 1", "3qk3/8/8/8/8/2K5/8/8 w - - 0 1"},
+		{"k7/8/8/7P/8/8/8/K7 w - - 0 1", "k7/8/8/8/7p/8/8/K7 b - - 0 1"},
+		{"3k4/8/3K4/3P4/8/8/8/8 b - - 0 1", "8/8/8/8/3p4/3k4/8/3K4 w - - 0 1"},
+		{"7k/8/8/8/8/8/8/2B1KN2 w - - 0 1", "2b1kn2/8/8/8/8/8/8/7K b - - 0 1"},
+		{"8/8/8/3k4/8/2b5/8/R3K3 w - - 0 1", "r3k3/8/2B5/8/3K4/8/8/8 b - - 0 1"},
+	};
+
+	for (const auto &[fen, mirrored] : positions)
+		EXPECT_EQ(endgameScore(fen), -endgameScore(mirrored)) << fen;
+}
+
+
+TEST_F(EndgameTest, MatingMaterialIsAWin)
+{
+	EXPECT_GT(endgameScore("8/8/8/4k3/8/8/8/R3K3 w - - 0 1"), Endgames::KNOWN_WIN);
+	EXPECT_LT(endgameScore("3qk3/8/8/8/8/2K5/8/8 w - - 0 1"), -Endgames::KNOWN_WIN);
+
+	// The losing king is driven to the edge
+	EXPECT_GT(endgameScore("7k/8/8/8/8/8/8/R3K3 w - - 0 1"), endgameScore("8/8/8/4k3/8/8/8/R3K3 w - - 0 1"));
+
+	// Bishop and knight mate in the corner of the bishop's colour (h8 for the dark squared bishop)
+	EXPECT_GT(endgameScore("7k/8/8/8/8/8/8/2B1KN2 w - - 0 1"), endgameScore("k7/8/8/8/8/8/8/2B1KN2 w - - 0 1"));
+
+	// The evaluation returns it from the side to move
+	mEngine.getBoard().parseFEN("8/8/8/4k3/8/8/8/R3K3 b - - 0 1");
+	EXPECT_LT(Evaluation::evaluate(mEngine.getBoard()), -Endgames::KNOWN_WIN);
+}
+
+
+TEST_F(EndgameTest, DrawishEndgamesStayClose)
+{
+	EXPECT_EQ(endgameScore("8/8/8/4k3/8/8/8/1N2K3 w - - 0 1"), 0);
+	EXPECT_EQ(endgameScore("8/8/8/4k3/8/8/8/1NN1K3 w - - 0 1"), 0);
+
+	int rookBishop = endgameScore("8/8/8/3k4/8/2b5/8/R3K3 w - - 0 1");
+	int rookKnight = endgameScore("8/8/8/3k4/8/2n5/8/R3K3 w - - 0 1");
+
+	EXPECT_GE(rookBishop, 0);
+	EXPECT_LT(rookBishop, PieceValues::PAWN);
+	EXPECT_GE(rookKnight, 0);
+	EXPECT_LT(rookKnight, PieceValues::PAWN);
+
+	// A knight far from its king is in danger
+	EXPECT_GT(endgameScore("8/8/8/3k4/8/8/8/R3K2n w - - 0 1"), rookKnight);
+}
+
+
+TEST_F(EndgameTest, WrongBishopRookPawnIsDrawn)
+{
+	// Light squared bishop, h8 is dark
+	EXPECT_EQ(endgameScore("7k/8/8/8/8/8/7P/5BK1 w - - 0 1"), 0);
+	EXPECT_EQ(endgameScore("6k1/8/8/8/7P/7P/8/5BK1 w - - 0 1"), 0);
+	EXPECT_EQ(endgameScore("5bk1/7p/8/8/8/8/8/7K b - - 0 1"), 0);
+
+	// Right bishop, king too far, or pawns on several files: the general evaluation decides
+	EXPECT_FALSE(isSpecialized("7k/8/8/8/8/8/7P/2B3K1 w - - 0 1"));
+	EXPECT_FALSE(isSpecialized("8/8/8/8/k7/8/7P/5BK1 w - - 0 1"));
+	EXPECT_FALSE(isSpecialized("7k/8/8/8/8/8/6PP/5BK1 w - - 0 1"));
+}
+
+
+TEST_F(EndgameTest, InsufficientMaterialIsDetected)
+{
+	EXPECT_TRUE(isInsufficient("8/8/8/4k3/8/8/8/4K3 w - - 0 1"));
+	EXPECT_TRUE(isInsufficient("8/8/8/4k3/8/8/8/2B1K3 w - - 0 1"));
+	EXPECT_TRUE(isInsufficient("8/8/8/4k3/8/8/8/1n2K3 b - - 0 1"));
+
+	// Bishops on squares of one colour only
+	EXPECT_TRUE(isInsufficient("5b2/8/8/4k3/8/8/8/2B1K3 w - - 0 1"));
+	EXPECT_TRUE(isInsufficient("5b2/8/8/4k3/8/8/8/B1B1K3 w - - 0 1"));
+
+	// Mate is possible (even if not forced)
+	EXPECT_FALSE(isInsufficient("2b5/8/8/4k3/8/8/8/2B1K3 w - - 0 1"));
+	EXPECT_FALSE(isInsufficient("8/8/8/4k3/8/8/8/1NN1K3 w - - 0 1"));
+	EXPECT_FALSE(isInsufficient("8/8/8/4k3/8/8/8/1N2K1n1 w - - 0 1"));
+	EXPECT_FALSE(isInsufficient("8/8/8/4k3/8/8/8/1B2K1n1 w - - 0 1"));
+	EXPECT_FALSE(isInsufficient("8/8/8/4k3/8/8/4P3/4K3 w - - 0 1"));
+
+	// The bishops of one colour are scored as a draw although no table entry covers them
+	EXPECT_EQ(endgameScore("5b2/8/8/4k3/8/8/8/B1B1K3 w - - 0 1"), 0);
+}
+
+} // namespace EvaluationTests
@@ -0,0 +1,160 @@
+/*
+  ==============================================================================
+	Module:			EvalWeights Tests
+	Description:    Testing the evaluation weight policies and the JSON weight files
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <random>
+
+#include "Evaluation.h"
+#include "GameEngine.h"
+
+
+namespace EvaluationTests
+{
+
+// The production weights are folded at compile time
+static_assert(ConstexprWeights::get().mobilityBound(1) == 35);
+static_assert(mgScore(ConstexprWeights::get().kingFilesRange()) == 3 * 12 + 3 * 6 + 3 * (12 + 10));
+static_assert(egScore(ConstexprWeights::get().kingFilesRange()) == 0);
+
+
+class EvalWeightsTest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		mEngine.init();
+		RuntimeWeights::reset();
+	}
+
+	void	   TearDown() override { RuntimeWeights::reset(); }
+
+	GameEngine mEngine;
+};
+
+
+TEST_F(EvalWeightsTest, DefaultsMatchTheBoardScores)
+{
+	const EvalWeights &weights = ConstexprWeights::get();
+
+	for (int type = 0; type < EvalWeights::PIECE_TYPES; ++type)
+	{
+		for (int sq = 0; sq < 64; ++sq)
+		{
+			EXPECT_EQ(PieceSquareTables::SCORES[type][sq], weights.material[type] + weights.pst[type][sq]) << "type " << type << " square " << sq;
+			EXPECT_EQ(PieceSquareTables::SCORES[type + 6][sq], -(weights.material[type] + weights.pst[type][sq ^ 56])) << "type " << type << " square " << sq;
+		}
+	}
+}
+
+
+TEST_F(EvalWeightsTest, RuntimeDefaultsMatchProductionEvaluation)
+{
+	std::mt19937 random(5);
+
+	for (int game = 0; game < 10; ++game)
+	{
+		mEngine.resetGame();
+
+		for (int ply = 0; ply < 120; ++ply)
+		{
+			MoveList moves;
+			mEngine.generateLegalMoves(moves);
+
+			if (moves.size() == 0)
+				break;
+
+			ASSERT_TRUE(mEngine.makeMoveUnchecked(moves[random() % moves.size()]));
+
+			const Chessboard &board = mEngine.getBoard();
+			ASSERT_EQ(TunableEvaluation::evaluate(board), Evaluation::evaluate(board));
+
+			for (int window : {-300, 0, 300})
+			{
+				bool productionExact;
+				bool runtimeExact;
+				int	 production = Evaluation::evaluate(board, window - 20, window + 20, productionExact);
+				int	 runtime	= TunableEvaluation::evaluate(board, window - 20, window + 20, runtimeExact);
+
+				EXPECT_EQ(runtime, production);
+				EXPECT_EQ(runtimeExact, productionExact);
+			}
+		}
+	}
+}
+
+
+TEST_F(EvalWeightsTest, ChangedWeightsOnlyAffectTheRuntimePolicy)
+{
+	mEngine.getBoard().parseFEN("4k3/8/8/8/3N4/8/7P/4K3 w - - 0 1");
+
+	int			production = Evaluation::evaluate(mEngine.getBoard());
+
+	EvalWeights weights	   = RuntimeWeights::get();
+	weights.material[WKnight] += makeScore(80, 80);
+	RuntimeWeights::set(weights);
+
+	EXPECT_EQ(Evaluation::evaluate(mEngine.getBoard()), production);
+	EXPECT_EQ(TunableEvaluation::evaluate(mEngine.getBoard()), production + 80);
+}
+
+
+TEST_F(EvalWeightsTest, JsonRoundTrip)
+{
+	EvalWeights weights = RuntimeWeights::get();
+	weights.pst[WPawn][12] = makeScore(-7, 33);
+	weights.mobility[2]	   = makeScore(3, 6);
+	weights.openFile	   = makeScore(-25, -5);
+	weights.kingDangerMax  = 350;
+	RuntimeWeights::set(weights);
+
+	std::string json = RuntimeWeights::toJson();
+	RuntimeWeights::reset();
+	ASSERT_NE(RuntimeWeights::get(), weights);
+
+	ASSERT_TRUE(RuntimeWeights::fromJson(json));
+	EXPECT_EQ(RuntimeWeights::get(), weights);
+
+	auto path = (std::filesystem::temp_directory_path() / "eval_weights_test.json").string();
+	ASSERT_TRUE(RuntimeWeights::save(path));
+	RuntimeWeights::reset();
+
+	ASSERT_TRUE(RuntimeWeights::load(path));
+	EXPECT_EQ(RuntimeWeights::get(), weights);
+
+	std::filesystem::remove(path);
+}
+
+
+TEST_F(EvalWeightsTest, MissingTermsKeepProductionValues)
+{
+	ASSERT_TRUE(RuntimeWeights::fromJson(R"({"material": {"knight": [400, 380]}, "kingSafety": {"dangerMax": 300}})"));
+
+	EvalWeights expected			= EvalWeights::defaults();
+	expected.material[WKnight]		= makeScore(400, 380);
+	expected.kingDangerMax			= 300;
+
+	EXPECT_EQ(RuntimeWeights::get(), expected);
+}
+
+
+TEST_F(EvalWeightsTest, InvalidJsonLeavesWeightsUntouched)
+{
+	EvalWeights weights = RuntimeWeights::get();
+	weights.shieldNear	= makeScore(20, 0);
+	RuntimeWeights::set(weights);
+
+	EXPECT_FALSE(RuntimeWeights::fromJson("{ not json"));
+	EXPECT_FALSE(RuntimeWeights::fromJson(R"({"material": {"rook": [500]}})"));
+	EXPECT_FALSE(RuntimeWeights::fromJson(R"({"pst": {"pawn": {"mg": [1, 2, 3]}}})"));
+	EXPECT_FALSE(RuntimeWeights::fromJson(R"({"material": {"queen": [90000, 900]}})"));
+	EXPECT_FALSE(RuntimeWeights::load("does/not/exist.json"));
+
+	EXPECT_EQ(RuntimeWeights::get(), weights);
+}
+
+} // namespace EvaluationTests
@@ -0,0 +1,612 @@
+/*
+  ==============================================================================
+	Module:			Evaluation Tests
+	Description:    Testing the static evaluation of the chess engine
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+#include <cctype>
+#include <initializer_list>
+#include <random>
+#include <sstream>
+#include <thread>
+#include <type_traits>
+
+#include "EvalCache.h"
+#include "Evaluation.h"
+#include "GameEngine.h"
+
+
+namespace EvaluationTests
+{
+
+class EvaluationTest : public ::testing::Test
+{
+protected:
+	void	   SetUp() override { mEngine.init(); }
+
+	/**
+	 * @brief	Play random legal moves, checking the board's incremental state after every move and every undo.
+	 */
+	void	   playRandomMoves(int plies, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		int			 played = 0;
+
+		for (; played < plies; ++played)
+		{
+			MoveList moves;
+			mEngine.generateLegalMoves(moves);
+
+			if (moves.size() == 0)
+				break;
+
+			Move move = moves[random() % moves.size()];
+			ASSERT_TRUE(mEngine.makeMoveUnchecked(move));
+			ASSERT_TRUE(Evaluation::verifyPieceScore(mEngine.getBoard())) << "Score out of sync after " << MoveNotation::toUCI(move);
+			ASSERT_TRUE(pawnHashIsConsistent()) << "Pawn hash out of sync after " << MoveNotation::toUCI(move);
+		}
+
+		for (; played > 0; --played)
+		{
+			ASSERT_TRUE(mEngine.undoMoveUnchecked());
+			ASSERT_TRUE(Evaluation::verifyPieceScore(mEngine.getBoard())) << "Score out of sync after undo";
+			ASSERT_TRUE(pawnHashIsConsistent()) << "Pawn hash out of sync after undo";
+		}
+	}
+
+	bool pawnHashIsConsistent()
+	{
+		Chessboard copy = mEngine.getBoard();
+		copy.computeHash();
+		return copy.getPawnHash() == mEngine.getBoard().getPawnHash();
+	}
+
+	/**
+	 * @brief	Same position with colours swapped (ranks mirrored, side to move and castling rights swapped).
+	 */
+	static std::string mirrorFEN(const std::string &fen)
+	{
+		std::istringstream stream(fen);
+		std::string		   placement, side, castling, enPassant, halfMove, fullMove;
+		stream >> placement >> side >> castling >> enPassant >> halfMove >> fullMove;
+
+		std::string mirrored;
+		size_t		end = placement.size();
+
+		while (true)
+		{
+			size_t start = placement.rfind('/', end - 1);
+			size_t from	 = start == std::string::npos ? 0 : start + 1;
+			mirrored += placement.substr(from, end - from);
+
+			if (start == std::string::npos)
+				break;
+
+			mirrored += '/';
+			end = start;
+		}
+
+		auto swapCase = [](std::string text)
+		{
+			for (char &c : text)
+				c = std::isupper(c) ? std::tolower(c) : std::toupper(c);
+			return text;
+		};
+
+		if (enPassant != "-")
+			enPassant[1] = enPassant[1] == '3' ? '6' : '3';
+
+		return swapCase(mirrored) + (side == "w" ? " b " : " w ") + swapCase(castling) + " " + enPassant + " " + halfMove + " " + fullMove;
+	}
+
+	static U64 squares(std::initializer_list<Square> list)
+	{
+		U64 bb = 0;
+		for (Square sq : list)
+			BitUtils::setBit(bb, to_index(sq));
+		return bb;
+	}
+
+	GameEngine mEngine;
+};
+
+
+/**
+ * @brief	Evaluation tests run with both weight policies: the production constants and
+ *			the runtime weights (reset to the production values before every test).
+ */
+template <typename Eval>
+class EvaluationPolicyTest : public EvaluationTest
+{
+protected:
+	void SetUp() override
+	{
+		EvaluationTest::SetUp();
+		RuntimeWeights::reset();
+	}
+};
+
+struct PolicyNames
+{
+	template <typename Eval>
+	static std::string GetName(int)
+	{
+		return std::is_same_v<Eval, Evaluation> ? "Constexpr" : "Runtime";
+	}
+};
+
+using Policies = ::testing::Types<Evaluation, TunableEvaluation>;
+TYPED_TEST_SUITE(EvaluationPolicyTest, Policies, PolicyNames);
+
+
+TYPED_TEST(EvaluationPolicyTest, StartPositionIsBalanced)
+{
+	EXPECT_EQ(this->mEngine.getBoard().getPieceScore(), 0) << "Symmetric position should have no material or placement advantage";
+	EXPECT_EQ(TypeParam::evaluate(this->mEngine.getBoard()), 0);
+}
+
+
+TEST_F(EvaluationTest, ParsedPositionsHaveConsistentScore)
+{
+	const char *fens[] = {
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+	};
+
+	for (const char *fen : fens)
+	{
+		mEngine.getBoard().parseFEN(fen);
+		EXPECT_TRUE(Evaluation::verifyPieceScore(mEngine.getBoard())) << fen;
+	}
+}
+
+
+TEST_F(EvaluationTest, AddAndRemovePieceUpdateScore)
+{
+	Chessboard &board  = mEngine.getBoard();
+	int			before = board.getPieceScore();
+
+	board.addPiece(PieceType::WQueen, Square::d4);
+	EXPECT_EQ(board.getPieceScore(), before + PieceSquareTables::score(PieceType::WQueen, Square::d4));
+
+	board.movePiece(PieceType::WQueen, Square::d4, Square::a4);
+	EXPECT_TRUE(Evaluation::verifyPieceScore(board));
+
+	board.removePiece(PieceType::WQueen, Square::a4);
+	EXPECT_EQ(board.getPieceScore(), before);
+}
+
+
+TEST_F(EvaluationTest, IncrementalScoreSurvivesMakeAndUndo)
+{
+	// Captures, promotions, castling and en passant all occur in these positions
+	mEngine.getBoard().parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+	int initialScore = mEngine.getBoard().getPieceScore();
+
+	for (uint32_t seed = 1; seed <= 20; ++seed)
+		playRandomMoves(60, seed);
+
+	EXPECT_EQ(mEngine.getBoard().getPieceScore(), initialScore) << "Undoing every move should restore the score";
+
+	mEngine.getBoard().parseFEN("rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8");
+
+	for (uint32_t seed = 1; seed <= 20; ++seed)
+		playRandomMoves(60, seed);
+}
+
+
+TYPED_TEST(EvaluationPolicyTest, ScoreIsFromSideToMove)
+{
+	// White is a queen up
+	this->mEngine.getBoard().parseFEN("4k3/8/8/8/8/8/8/3QK3 w - - 0 1");
+	int whiteToMove = TypeParam::evaluate(this->mEngine.getBoard());
+
+	this->mEngine.getBoard().parseFEN("4k3/8/8/8/8/8/8/3QK3 b - - 0 1");
+	int blackToMove = TypeParam::evaluate(this->mEngine.getBoard());
+
+	EXPECT_GT(whiteToMove, PieceValues::QUEEN / 2);
+	EXPECT_EQ(whiteToMove, -blackToMove);
+}
+
+
+TEST_F(EvaluationTest, PackedScoreKeepsBothHalves)
+{
+	const int values[] = {0, 1, -1, 250, -250, 9000, -9000};
+
+	for (int mg : values)
+	{
+		for (int eg : values)
+		{
+			Score score = makeScore(mg, eg);
+			EXPECT_EQ(mgScore(score), mg);
+			EXPECT_EQ(egScore(score), eg);
+
+			Score sum = score + makeScore(10, -20) - makeScore(-5, 7);
+			EXPECT_EQ(mgScore(sum), mg + 15);
+			EXPECT_EQ(egScore(sum), eg - 27);
+		}
+	}
+
+	EXPECT_EQ(mgScore(scaleScore(makeScore(-12, 30), 3)), -36);
+	EXPECT_EQ(egScore(scaleScore(makeScore(-12, 30), 3)), 90);
+}
+
+
+TEST_F(EvaluationTest, PhaseTracksNonPawnMaterial)
+{
+	EXPECT_EQ(mEngine.getBoard().getPhase(), GamePhase::MAX) << "All pieces on the board is the full midgame";
+
+	mEngine.getBoard().parseFEN("4k3/4p3/8/8/8/8/4P3/4K3 w - - 0 1");
+	EXPECT_EQ(mEngine.getBoard().getPhase(), 0) << "Pawn endgame";
+
+	mEngine.getBoard().parseFEN("r3k3/8/8/8/8/8/8/3QK3 w - - 0 1");
+	EXPECT_EQ(mEngine.getBoard().getPhase(), GamePhase::ROOK + GamePhase::QUEEN);
+
+	mEngine.getBoard().removePiece(PieceType::WQueen, Square::d1);
+	EXPECT_EQ(mEngine.getBoard().getPhase(), GamePhase::ROOK);
+}
+
+
+TYPED_TEST(EvaluationPolicyTest, KingIsCentralisedInEndgame)
+{
+	this->mEngine.getBoard().parseFEN("4k3/4p3/8/8/4K3/8/4P3/8 w - - 0 1");
+	int centralKing = TypeParam::evaluate(this->mEngine.getBoard());
+
+	this->mEngine.getBoard().parseFEN("4k3/4p3/8/8/8/8/4P3/K7 w - - 0 1");
+	int cornerKing = TypeParam::evaluate(this->mEngine.getBoard());
+
+	EXPECT_GT(centralKing, cornerKing) << "Without pieces the king belongs in the centre";
+}
+
+
+TYPED_TEST(EvaluationPolicyTest, KingStaysShelteredInMidgame)
+{
+	this->mEngine.getBoard().parseFEN("rnbq1rk1/pppppppp/8/8/8/8/PPPPPPPP/RNBQ1RK1 w - - 0 1");
+	int castledKing = TypeParam::evaluate(this->mEngine.getBoard());
+
+	this->mEngine.getBoard().parseFEN("rnbq1rk1/pppppppp/8/8/4K3/8/PPPPPPPP/RNBQ1R2 w - - 0 1");
+	int centralKing = TypeParam::evaluate(this->mEngine.getBoard());
+
+	EXPECT_GT(castledKing, centralKing) << "With all pieces on the board the king belongs behind its pawns";
+}
+
+
+
+TEST_F(EvaluationTest, PawnWeaknessesArePenalised)
+{
+	U64	  enemy	   = squares({Square::a7, Square::b7, Square::c7});
+
+	// Doubled and isolated e-pawns against a healthy d/e pair
+	Score weak	   = PawnStructure::evaluate(squares({Square::e2, Square::e3}), enemy).score;
+	Score healthy  = PawnStructure::evaluate(squares({Square::d2, Square::e3}), enemy).score;
+
+	EXPECT_LT(mgScore(weak), mgScore(healthy));
+	EXPECT_LT(egScore(weak), egScore(healthy));
+
+	// e3 can no longer be defended by a pawn and f5 controls its stop square
+	Score backward = PawnStructure::evaluate(squares({Square::d4, Square::e3}), squares({Square::f5})).score;
+	Score free	   = PawnStructure::evaluate(squares({Square::d4, Square::e3}), squares({Square::f6})).score;
+
+	EXPECT_LT(mgScore(backward), mgScore(free));
+}
+
+
+TEST_F(EvaluationTest, PassedPawnsAreDetected)
+{
+	PawnEntry entry = PawnStructure::evaluate(squares({Square::a5, Square::e4}), squares({Square::d6, Square::h3}));
+
+	EXPECT_EQ(entry.passed, squares({Square::a5, Square::h3})) << "e4 is stopped by d6, d6 by e4";
+
+	// Further advanced passers are worth more
+	Score sixth	 = PawnStructure::evaluate(squares({Square::a6}), 0).score;
+	Score fourth = PawnStructure::evaluate(squares({Square::a4}), 0).score;
+
+	EXPECT_GT(egScore(sixth), egScore(fourth));
+}
+
+
+TEST_F(EvaluationTest, PawnStructureIsColourSymmetric)
+{
+	const U64 white[] = {
+		squares({Square::a2, Square::b2, Square::c3, Square::e4, Square::e3, Square::g5}),
+		squares({Square::d5, Square::c4, Square::f2, Square::g2, Square::h2}),
+		squares({Square::b6, Square::h4}),
+	};
+	const U64 black[] = {
+		squares({Square::a7, Square::b6, Square::d6, Square::f7, Square::h7}),
+		squares({Square::c6, Square::e6, Square::f7, Square::g7}),
+		squares({Square::a7, Square::c7, Square::g3}),
+	};
+
+	for (int i = 0; i < 3; ++i)
+	{
+		PawnEntry entry	  = PawnStructure::evaluate(white[i], black[i]);
+		PawnEntry flipped = PawnStructure::evaluate(BitUtils::flipVertical(black[i]), BitUtils::flipVertical(white[i]));
+
+		EXPECT_EQ(entry.score, -flipped.score) << "Position " << i;
+		EXPECT_EQ(entry.passed, BitUtils::flipVertical(flipped.passed)) << "Position " << i;
+	}
+}
+
+
+TEST_F(EvaluationTest, MostPiecesPerSideAreEvaluated)
+{
+	// 15 pieces besides the king fill every attack slot of a side
+	Chessboard &board = mEngine.getBoard();
+	ASSERT_TRUE(board.parseFEN("rnbqkbnr/qqqqqqqq/8/8/8/8/QQQQQQQQ/RNBQKBNR w - - 0 1"));
+	int white = Evaluation::evaluate(board);
+
+	ASSERT_TRUE(board.parseFEN("rnbqkbnr/qqqqqqqq/8/8/8/8/QQQQQQQQ/RNBQKBNR b - - 0 1"));
+	EXPECT_EQ(Evaluation::evaluate(board), white);
+}
+
+
+TEST_F(EvaluationTest, PawnHashTracksPawnsOnly)
+{
+	Chessboard &board = mEngine.getBoard();
+	uint64_t	start = board.getPawnHash();
+
+	EXPECT_NE(start, 0u);
+
+	board.movePiece(PieceType::WKnight, Square::g1, Square::f3);
+	EXPECT_EQ(board.getPawnHash(), start) << "Piece moves leave the pawn key untouched";
+
+	board.movePiece(PieceType::WPawn, Square::e2, Square::e4);
+	EXPECT_NE(board.getPawnHash(), start);
+
+	board.movePiece(PieceType::WPawn, Square::e4, Square::e2);
+	EXPECT_EQ(board.getPawnHash(), start);
+
+	mEngine.getBoard().parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+	for (uint32_t seed = 1; seed <= 10; ++seed)
+		playRandomMoves(60, seed);
+}
+
+
+TEST_F(EvaluationTest, PawnTableMatchesDirectEvaluation)
+{
+	PawnHashTable table;
+	Chessboard	 &board = mEngine.getBoard();
+
+	board.parseFEN("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+
+	std::mt19937 random(7);
+
+	for (int ply = 0; ply < 40; ++ply)
+	{
+		U64		  whitePawns = board.pieces()[PieceType::WPawn];
+		U64		  blackPawns = board.pieces()[PieceType::BPawn];
+		PawnEntry direct	 = PawnStructure::evaluate(whitePawns, blackPawns);
+
+		EXPECT_EQ(table.probe(board.getPawnHash(), whitePawns, blackPawns).score, direct.score);
+		EXPECT_EQ(table.probe(board.getPawnHash(), whitePawns, blackPawns).score, direct.score) << "Second probe is a hit";
+
+		MoveList moves;
+		mEngine.generateLegalMoves(moves);
+		if (moves.size() == 0)
+			break;
+
+		ASSERT_TRUE(mEngine.makeMoveUnchecked(moves[random() % moves.size()]));
+	}
+
+	EXPECT_GE(table.getHits() * 2, table.getProbes());
+}
+
+
+
+TEST_F(EvaluationTest, BitboardKernelsMatchScalar)
+{
+	std::mt19937_64 random(42);
+
+	for (int round = 0; round < 1000; ++round)
+	{
+		U64 bitboards[8];
+		int counts[8];
+		U64 mask = random() & random();
+
+		for (U64 &bb : bitboards)
+			bb = random() & random();
+
+		BitKernels::popCountMasked(bitboards, 8, mask, counts);
+
+		U64 expectedUnion = 0;
+		for (int i = 0; i < 8; ++i)
+		{
+			EXPECT_EQ(counts[i], BitUtils::popCount(bitboards[i] & mask));
+			expectedUnion |= bitboards[i];
+		}
+
+		EXPECT_EQ(BitKernels::unionAll(bitboards, 8), expectedUnion);
+	}
+}
+
+
+TYPED_TEST(EvaluationPolicyTest, LazyEvaluationStaysOnTheSameSideOfTheWindow)
+{
+	std::mt19937 random(11);
+	TypeParam::resetLazyStatistics();
+
+	for (int game = 0; game < 20; ++game)
+	{
+		this->mEngine.resetGame();
+
+		for (int ply = 0; ply < 120; ++ply)
+		{
+			MoveList moves;
+			this->mEngine.generateLegalMoves(moves);
+
+			if (moves.size() == 0)
+				break;
+
+			ASSERT_TRUE(this->mEngine.makeMoveUnchecked(moves[random() % moves.size()]));
+
+			const Chessboard &board = this->mEngine.getBoard();
+			int				  full	= TypeParam::evaluate(board);
+
+			for (int offset : {-2000, -600, -150, 0, 150, 600, 2000})
+			{
+				int	 alpha = full + offset - 50;
+				int	 beta  = full + offset + 50;
+				bool exact;
+				int	 lazy  = TypeParam::evaluate(board, alpha, beta, exact);
+
+				if (exact)
+					EXPECT_EQ(lazy, full);
+				else if (lazy >= beta)
+					EXPECT_GE(full, beta) << "Lazy fail-high must be a real fail-high";
+				else
+				{
+					EXPECT_LE(lazy, alpha);
+					EXPECT_LE(full, alpha) << "Lazy fail-low must be a real fail-low";
+				}
+			}
+		}
+	}
+
+	EXPECT_GT(TypeParam::getLazyExits(), 0u);
+	EXPECT_LT(TypeParam::getLazyExits(), TypeParam::getLazyEvaluations());
+}
+
+
+TEST_F(EvaluationTest, EvalCacheVerifiesKey)
+{
+	EvalCache cache;
+	uint64_t  hash = 0x123456789ABCDEF0ull;
+	int		  score;
+
+	EXPECT_FALSE(cache.probe(hash, score));
+
+	cache.store(hash, -321);
+	ASSERT_TRUE(cache.probe(hash, score));
+	EXPECT_EQ(score, -321);
+
+	// Same slot, different key
+	EXPECT_FALSE(cache.probe(hash ^ (1ull << 40), score));
+	EXPECT_EQ(cache.getProbes(), 3u);
+	EXPECT_EQ(cache.getHits(), 1u);
+
+	cache.clear();
+	EXPECT_FALSE(cache.probe(hash, score));
+}
+
+
+TEST_F(EvaluationTest, EvalCacheEntriesAreNeverTorn)
+{
+	// 64 keys share 8 slots, every thread stores the score derived from the key: a mixed entry would show up as a wrong score
+	std::mt19937_64			 random(7);
+	std::vector<uint64_t>	 keys(64);
+
+	for (size_t i = 0; i < keys.size(); ++i)
+		keys[i] = (random() & ~(EvalCache::ENTRIES - 1)) | (i % 8);
+
+	EvalCache				 cache;
+	std::atomic<int>		 wrong{0};
+	std::vector<std::thread> threads;
+
+	for (int t = 0; t < 4; ++t)
+	{
+		threads.emplace_back(
+			[&cache, &keys, &wrong, t]
+			{
+				std::mt19937 pick(t);
+
+				for (int i = 0; i < 200000; ++i)
+				{
+					uint64_t hash	  = keys[pick() % keys.size()];
+					int		 expected = static_cast<int>((hash >> 48) & 0x7FFF) - 16384;
+					int		 score;
+
+					if (cache.probe(hash, score) && score != expected)
+						++wrong;
+
+					cache.store(hash, expected);
+				}
+			});
+	}
+
+	for (auto &thread : threads)
+		thread.join();
+
+	EXPECT_EQ(wrong.load(), 0);
+	EXPECT_GT(cache.getHits(), 0u);
+}
+
+
+TYPED_TEST(EvaluationPolicyTest, EvaluationIsColourSymmetric)
+{
+	const std::string fens[] = {
+		"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		"r2q1rk1/ppp2ppp/2np1n2/2b1p1B1/2B1P1b1/2NP1N2/PPP2PPP/R2Q1RK1 w - - 2 8",
+		"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+		"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+		"2kr3r/ppp2ppp/2n5/2b1q3/4n3/2N2N2/PPPB1PPP/R2QKB1R w KQ - 0 10",
+	};
+
+	for (const std::string &fen : fens)
+	{
+		this->mEngine.getBoard().parseFEN(fen);
+		int original = TypeParam::evaluate(this->mEngine.getBoard());
+
+		this->mEngine.getBoard().parseFEN(this->mirrorFEN(fen));
+		int mirrored = TypeParam::evaluate(this->mEngine.getBoard());
+
+		EXPECT_EQ(original, mirrored) << fen << " vs " << this->mirrorFEN(fen);
+	}
+}
+
+
+TYPED_TEST(EvaluationPolicyTest, CentralKnightIsMoreMobile)
+{
+	// The pawn keeps the knight endgame out of the specialized draw evaluation
+	this->mEngine.getBoard().parseFEN("4k3/8/8/8/3N4/8/7P/4K3 w - - 0 1");
+	int central = TypeParam::evaluate(this->mEngine.getBoard());
+
+	this->mEngine.getBoard().parseFEN("4k3/8/8/8/8/8/7P/N3K3 w - - 0 1");
+	int corner = TypeParam::evaluate(this->mEngine.getBoard());
+
+	EXPECT_GT(central, corner);
+
+	// Squares attacked by enemy pawns don't count
+	this->mEngine.getBoard().parseFEN("4k3/8/8/2p1p3/3N4/8/8/4K3 w - - 0 1");
+	int restricted = TypeParam::evaluate(this->mEngine.getBoard());
+
+	this->mEngine.getBoard().parseFEN("4k3/2p1p3/8/8/3N4/8/8/4K3 w - - 0 1");
+	int free	   = TypeParam::evaluate(this->mEngine.getBoard());
+
+	EXPECT_LT(restricted, free);
+}
+
+
+TYPED_TEST(EvaluationPolicyTest, OpenKingIsPenalised)
+{
+	// Symmetric Italian game with both kings castled
+	const char *sheltered = "r1bq1rk1/pppp1ppp/2n2n2/2b1p3/2B1P3/2N2N2/PPPP1PPP/R1BQ1RK1 w - - 0 1";
+
+	// White loses the g-pawn in front of its king, black a rook pawn far from its king
+	const char *exposed	  = "r1bq1rk1/1ppp1ppp/2n2n2/2b1p3/2B1P3/2N2N2/PPPP1P1P/R1BQ1RK1 w - - 0 1";
+
+	this->mEngine.getBoard().parseFEN(sheltered);
+	EXPECT_EQ(TypeParam::evaluate(this->mEngine.getBoard()), 0);
+
+	this->mEngine.getBoard().parseFEN(exposed);
+	EXPECT_LT(TypeParam::evaluate(this->mEngine.getBoard()), -20);
+}
+
+
+TYPED_TEST(EvaluationPolicyTest, AttackedKingIsPenalised)
+{
+	// Queen and knight hitting f2 and h2 against the same pieces on the queenside
+	this->mEngine.getBoard().parseFEN("6k1/5ppp/8/8/6nq/8/5PPP/6K1 w - - 0 1");
+	int attacked = TypeParam::evaluate(this->mEngine.getBoard());
+
+	this->mEngine.getBoard().parseFEN("6k1/5ppp/8/8/nq6/8/5PPP/6K1 w - - 0 1");
+	int quiet	 = TypeParam::evaluate(this->mEngine.getBoard());
+
+	EXPECT_LT(attacked, quiet);
+}
+
+} // namespace EvaluationTests
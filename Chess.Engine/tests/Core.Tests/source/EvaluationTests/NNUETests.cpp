@@ -0,0 +1,245 @@
+/*
+  ==============================================================================
+	Module:			NNUE Tests
+	Description:    Testing the NNUE evaluation, its accumulator and kernels
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <random>
+
+#include "EvalCache.h"
+#include "Evaluation.h"
+#include "GameEngine.h"
+
+
+namespace EvaluationTests
+{
+
+class NNUETest : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		mEngine.init();
+		NNUE::initRandom(1);
+	}
+
+	void TearDown() override
+	{
+		NNUE::unload();
+		NNUE::setEnabled(true);
+		NNUE::setKernel(NNUEKernels::bestSupported());
+	}
+
+	/**
+	 * @brief	Play random legal moves and take them back, checking the incremental accumulator after every change.
+	 */
+	void playRandomMoves(int plies, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+		int			 played = 0;
+
+		for (; played < plies; ++played)
+		{
+			MoveList moves;
+			mEngine.generateLegalMoves(moves);
+
+			if (moves.size() == 0)
+				break;
+
+			Move move = moves[random() % moves.size()];
+			ASSERT_TRUE(mEngine.makeMoveUnchecked(move));
+			ASSERT_TRUE(NNUE::verifyAccumulator(mEngine.getBoard())) << "Accumulator out of sync after " << MoveNotation::toUCI(move);
+
+			// Evaluating refreshes perspectives invalidated by king moves
+			(void)NNUE::evaluate(mEngine.getBoard());
+		}
+
+		for (; played > 0; --played)
+		{
+			ASSERT_TRUE(mEngine.undoMoveUnchecked());
+			ASSERT_TRUE(NNUE::verifyAccumulator(mEngine.getBoard())) << "Accumulator out of sync after undo";
+			(void)NNUE::evaluate(mEngine.getBoard());
+		}
+	}
+
+	int evaluateFEN(const char *fen)
+	{
+		mEngine.getBoard().parseFEN(fen);
+		return Evaluation::evaluate(mEngine.getBoard());
+	}
+
+	GameEngine					   mEngine;
+
+	static constexpr const char	  *FENS[] = {
+		  "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+		  "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+		  "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+		  "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+	  };
+};
+
+
+TEST_F(NNUETest, NetworkIsUsedOnlyWhenActive)
+{
+	EXPECT_TRUE(NNUE::isActive());
+
+	NNUE::setEnabled(false);
+	int classical = evaluateFEN(FENS[1]);
+
+	NNUE::setEnabled(true);
+	int network = evaluateFEN(FENS[1]);
+
+	EXPECT_EQ(network, NNUE::evaluate(mEngine.getBoard()));
+	EXPECT_NE(network, classical) << "A random network should not reproduce the classical score";
+
+	NNUE::unload();
+	EXPECT_FALSE(NNUE::isActive());
+	EXPECT_EQ(evaluateFEN(FENS[1]), classical);
+}
+
+
+TEST_F(NNUETest, EvalCacheForgetsTheOldEvaluator)
+{
+	EvalCache cache;
+	uint64_t  hash	= 0x123456789ABCDEF0ull;
+	int		  score = 0;
+
+	cache.store(hash, 42);
+	ASSERT_TRUE(cache.probe(hash, score));
+
+	// Switching to the classical evaluation, back to a new network and to the first one again
+	NNUE::setEnabled(false);
+	EXPECT_FALSE(cache.probe(hash, score));
+	cache.store(hash, 7);
+
+	NNUE::setEnabled(true);
+	NNUE::initRandom(2);
+	EXPECT_FALSE(cache.probe(hash, score));
+
+	NNUE::setEnabled(false);
+	ASSERT_TRUE(cache.probe(hash, score));
+	EXPECT_EQ(score, 7);
+}
+
+
+TEST_F(NNUETest, InvalidFileKeepsCurrentNetwork)
+{
+	int before = evaluateFEN(FENS[1]);
+
+	EXPECT_FALSE(NNUE::load("does-not-exist.nnue"));
+	EXPECT_TRUE(NNUE::isLoaded());
+	EXPECT_EQ(evaluateFEN(FENS[1]), before);
+}
+
+
+TEST_F(NNUETest, IncrementalAccumulatorMatchesRefresh)
+{
+	for (const char *fen : FENS)
+	{
+		mEngine.getBoard().parseFEN(fen);
+		(void)NNUE::evaluate(mEngine.getBoard());
+
+		for (uint32_t seed = 1; seed <= 10; ++seed)
+			playRandomMoves(40, seed);
+	}
+}
+
+
+TEST_F(NNUETest, AccumulatorIsRefreshedForNewNetwork)
+{
+	int first = evaluateFEN(FENS[1]);
+
+	NNUE::initRandom(2);
+	int second = Evaluation::evaluate(mEngine.getBoard());
+
+	EXPECT_NE(first, second) << "Values computed with the old network must not be reused";
+	EXPECT_TRUE(NNUE::verifyAccumulator(mEngine.getBoard()));
+}
+
+
+TEST_F(NNUETest, EvaluationIsColourSymmetric)
+{
+	// Each position and its colour-flipped mirror
+	const char *pairs[][2] = {
+		{"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", "r3k2r/pppbbppp/2n2q1P/1P2p3/3pn3/BN2PNP1/P1PPQPB1/R3K2R b KQkq - 0 1"},
+		{"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", "8/4p1p1/8/1r3P1K/kp5R/3P4/2P5/8 b - - 0 1"},
+	};
+
+	for (const auto &pair : pairs)
+		EXPECT_EQ(evaluateFEN(pair[0]), evaluateFEN(pair[1])) << pair[0];
+}
+
+
+TEST_F(NNUETest, KernelsProduceIdenticalScores)
+{
+	std::vector<int> reference;
+
+	ASSERT_TRUE(NNUE::setKernel(NNUEKernel::Scalar));
+	for (const char *fen : FENS)
+		reference.push_back(evaluateFEN(fen));
+
+	for (NNUEKernel kernel : {NNUEKernel::SSE4, NNUEKernel::AVX2})
+	{
+		if (!NNUE::setKernel(kernel))
+			continue; // not supported by this CPU
+
+		for (size_t i = 0; i < std::size(FENS); ++i)
+			EXPECT_EQ(evaluateFEN(FENS[i]), reference[i]) << NNUEKernels::name(kernel) << " " << FENS[i];
+	}
+}
+
+
+TEST_F(NNUETest, AffineKernelsMatchScalar)
+{
+	constexpr int		 inputs	 = 64;
+	constexpr int		 outputs = 8;
+
+	std::mt19937		 random(3);
+	std::vector<uint8_t> input(inputs);
+	std::vector<int8_t>	 weights(inputs * outputs);
+	std::vector<int32_t> bias(outputs);
+
+	for (auto &value : input)
+		value = static_cast<uint8_t>(random() % 128);
+	for (auto &value : weights)
+		value = static_cast<int8_t>(random() % 256 - 128);
+	for (auto &value : bias)
+		value = static_cast<int32_t>(random() % 2001) - 1000;
+
+	int32_t expected[outputs];
+	NNUEKernels::affineScalar(input.data(), inputs, weights.data(), bias.data(), expected, outputs);
+
+	for (NNUEKernel kernel : {NNUEKernel::SSE4, NNUEKernel::AVX2})
+	{
+		if (!NNUEKernels::isSupported(kernel))
+			continue;
+
+		int32_t actual[outputs];
+		NNUEKernels::affineFor(kernel)(input.data(), inputs, weights.data(), bias.data(), actual, outputs);
+
+		for (int o = 0; o < outputs; ++o)
+			EXPECT_EQ(actual[o], expected[o]) << NNUEKernels::name(kernel);
+	}
+}
+
+
+TEST_F(NNUETest, SaveAndLoadRoundTrip)
+{
+	auto path	  = (std::filesystem::temp_directory_path() / "nnue_roundtrip_test.nnue").string();
+	int	 original = evaluateFEN(FENS[1]);
+
+	ASSERT_TRUE(NNUE::save(path));
+
+	NNUE::initRandom(99);
+	EXPECT_NE(Evaluation::evaluate(mEngine.getBoard()), original);
+
+	ASSERT_TRUE(NNUE::load(path));
+	EXPECT_EQ(Evaluation::evaluate(mEngine.getBoard()), original);
+
+	std::filesystem::remove(path);
+}
+
+} // namespace EvaluationTests
@@ -7,6 +7,7 @@
 
 #include <gtest/gtest.h>
 
+#include "GameEngine.h"
 #include "Notation/MoveNotation.h"
 
 namespace MoveTests
@@ -666,4 +667,73 @@ TEST_F(MoveNotationTests, BlackPawnPromotion)
 	EXPECT_EQ(notation, "e1=Q") << "Black pawn promotion should use same format";
 }
 
+
+//=============================================================================
+// SAN PARSING TESTS
+//=============================================================================
+
+static Move parseSAN(std::string_view fen, std::string_view san)
+{
+	GameEngine engine;
+	engine.init();
+	engine.getBoard().parseFEN(fen);
+
+	MoveList legalMoves;
+	engine.generateLegalMoves(legalMoves);
+
+	return MoveNotation::fromSAN(san, engine.getBoard(), legalMoves);
+}
+
+
+TEST(MoveNotationSANParsing, PawnAndPieceMoves)
+{
+	const char *start = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+	EXPECT_EQ(parseSAN(start, "e4"), Move(Square::e2, Square::e4, MoveFlag::DoublePawnPush));
+	EXPECT_EQ(parseSAN(start, "e3"), Move(Square::e2, Square::e3, MoveFlag::Quiet));
+	EXPECT_EQ(parseSAN(start, "Nf3!"), Move(Square::g1, Square::f3, MoveFlag::Quiet));
+	EXPECT_FALSE(parseSAN(start, "e5").isValid()) << "No pawn reaches e5";
+	EXPECT_FALSE(parseSAN(start, "Nd2").isValid()) << "Blocked square";
+	EXPECT_FALSE(parseSAN(start, "").isValid());
+}
+
+
+TEST(MoveNotationSANParsing, CapturesAndEnPassant)
+{
+	EXPECT_EQ(parseSAN("rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2", "exd5"), Move(Square::e4, Square::d5, MoveFlag::Capture));
+	EXPECT_EQ(parseSAN("rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", "exf6"), Move(Square::e5, Square::f6, MoveFlag::EnPassant));
+}
+
+
+TEST(MoveNotationSANParsing, Disambiguation)
+{
+	const char *knights = "4k3/8/8/8/8/8/8/1N2KN2 w - - 0 1";
+
+	EXPECT_FALSE(parseSAN(knights, "Nd2").isValid()) << "Both knights reach d2";
+	EXPECT_EQ(parseSAN(knights, "Nbd2"), Move(Square::b1, Square::d2, MoveFlag::Quiet));
+	EXPECT_EQ(parseSAN(knights, "Nfd2"), Move(Square::f1, Square::d2, MoveFlag::Quiet));
+	EXPECT_EQ(parseSAN(knights, "Nb1d2"), Move(Square::b1, Square::d2, MoveFlag::Quiet));
+
+	const char *rooks = "4k3/R7/8/8/8/8/8/R3K3 w - - 0 1";
+
+	EXPECT_EQ(parseSAN(rooks, "R1a4"), Move(Square::a1, Square::a4, MoveFlag::Quiet));
+	EXPECT_EQ(parseSAN(rooks, "R7a4+"), Move(Square::a7, Square::a4, MoveFlag::Quiet));
+}
+
+
+TEST(MoveNotationSANParsing, CastlingAndPromotion)
+{
+	const char *castling = "r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1";
+
+	EXPECT_EQ(parseSAN(castling, "O-O"), Move(Square::e1, Square::g1, MoveFlag::KingCastle));
+	EXPECT_EQ(parseSAN(castling, "0-0-0"), Move(Square::e1, Square::c1, MoveFlag::QueenCastle));
+
+	const char *promotion = "3r3k/4P3/8/8/8/8/8/K7 w - - 0 1";
+
+	EXPECT_EQ(parseSAN(promotion, "e8=Q+"), Move(Square::e7, Square::e8, MoveFlag::QueenPromotion));
+	EXPECT_EQ(parseSAN(promotion, "e8N"), Move(Square::e7, Square::e8, MoveFlag::KnightPromotion));
+	EXPECT_EQ(parseSAN(promotion, "exd8=R#"), Move(Square::e7, Square::d8, MoveFlag::RookPromoCapture));
+	EXPECT_FALSE(parseSAN(promotion, "e8").isValid()) << "Promotion piece missing";
+}
+
 } // namespace MoveTests
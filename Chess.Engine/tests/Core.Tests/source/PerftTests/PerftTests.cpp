@@ -0,0 +1,238 @@
+/*
+  ==============================================================================
+	Module:			Perft Tests
+	Description:    Testing the perft node counts against the published reference counts
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+
+#include "Notation/MoveNotation.h"
+#include "Perft.h"
+
+
+namespace PerftTests
+{
+
+constexpr const char *START_POSITION = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+constexpr const char *KIWIPETE		 = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+
+
+TEST(PerftTest, StartPositionCounts)
+{
+	Perft perft(1, 0);
+
+	EXPECT_EQ(perft.run(START_POSITION, 0).nodes, 1u);
+	EXPECT_EQ(perft.run(START_POSITION, 1).nodes, 20u);
+	EXPECT_EQ(perft.run(START_POSITION, 2).nodes, 400u);
+	EXPECT_EQ(perft.run(START_POSITION, 3).nodes, 8902u);
+	EXPECT_EQ(perft.run(START_POSITION, 4).nodes, 197281u);
+}
+
+
+TEST(PerftTest, ReferencePositionsMatch)
+{
+	struct Reference
+	{
+		const char *fen;
+		int			depth;
+		uint64_t	nodes;
+	};
+
+	// Castling, en passant, promotions and checks from the standard perft positions
+	const Reference references[] = {
+		{KIWIPETE, 3, 97862},
+		{"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, 43238},
+		{"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467},
+		{"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379},
+		{"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 3, 89890},
+	};
+
+	Perft perft(2, 16);
+
+	for (const auto &reference : references)
+		EXPECT_EQ(perft.run(reference.fen, reference.depth).nodes, reference.nodes) << reference.fen;
+}
+
+
+TEST(PerftTest, ThreadsAndHashKeepTheCount)
+{
+	Perft		plain(1, 0);
+	Perft		parallel(4, 16);
+
+	PerftResult reference = plain.run(KIWIPETE, 3);
+	PerftResult first	  = parallel.run(KIWIPETE, 3);
+	PerftResult second	  = parallel.run(KIWIPETE, 3);
+
+	EXPECT_EQ(reference.hashHits, 0u);
+	EXPECT_EQ(first.nodes, reference.nodes);
+	EXPECT_EQ(second.nodes, reference.nodes);
+
+	// The second run finds the subtrees of the first one
+	EXPECT_GT(second.hashHits, first.hashHits);
+}
+
+
+TEST(PerftTest, HashTableStoresByPositionAndDepth)
+{
+	PerftHashTable table(1);
+	uint64_t	   nodes = 0;
+
+	ASSERT_TRUE(table.enabled());
+	EXPECT_FALSE(table.probe(0x1234, 3, nodes));
+
+	table.store(0x1234, 3, 97862);
+	ASSERT_TRUE(table.probe(0x1234, 3, nodes));
+	EXPECT_EQ(nodes, 97862u);
+
+	EXPECT_FALSE(table.probe(0x1234, 4, nodes)) << "Other depth";
+	EXPECT_FALSE(table.probe(0x1234 + table.size(), 3, nodes)) << "Other position in the same slot";
+
+	table.clear();
+	EXPECT_FALSE(table.probe(0x1234, 3, nodes));
+
+	EXPECT_FALSE(PerftHashTable(0).enabled());
+}
+
+
+TEST(PerftTest, DivideSumsToTheTotal)
+{
+	Perft						  perft(2, 16);
+	std::vector<PerftDivideEntry> entries;
+
+	PerftResult					  result = perft.divide(START_POSITION, 3, entries);
+
+	ASSERT_EQ(entries.size(), 20u);
+	EXPECT_EQ(result.nodes, 8902u);
+
+	uint64_t sum = 0;
+
+	for (const auto &entry : entries)
+	{
+		sum += entry.nodes;
+
+		if (MoveNotation::toUCI(entry.move) == "e2e4")
+			EXPECT_EQ(entry.nodes, 600u);
+		else if (MoveNotation::toUCI(entry.move) == "g1f3")
+			EXPECT_EQ(entry.nodes, 440u);
+	}
+
+	EXPECT_EQ(sum, result.nodes);
+}
+
+
+TEST(PerftTest, ParseSuiteLine)
+{
+	std::string							  fen;
+	std::vector<std::pair<int, uint64_t>> counts;
+
+	ASSERT_TRUE(Perft::parseSuiteLine("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1 ;D1 20 ;D2 400 ;D3 8902\r", fen, counts));
+	EXPECT_EQ(fen, START_POSITION);
+	ASSERT_EQ(counts.size(), 3u);
+	EXPECT_EQ(counts[0], std::make_pair(1, uint64_t{20}));
+	EXPECT_EQ(counts[2], std::make_pair(3, uint64_t{8902}));
+
+	EXPECT_FALSE(Perft::parseSuiteLine("", fen, counts));
+	EXPECT_FALSE(Perft::parseSuiteLine("# comment ;D1 20", fen, counts));
+	EXPECT_FALSE(Perft::parseSuiteLine(START_POSITION, fen, counts)) << "No counts";
+	EXPECT_FALSE(Perft::parseSuiteLine("8/8/4k3/8/8/4K3/8/8 w - - 0 1 ;D1 x", fen, counts));
+	EXPECT_FALSE(Perft::parseSuiteLine("8/8/4k3/8/8/4K3/8/8 w - - 0 1 ;bm e4", fen, counts));
+}
+
+
+TEST(PerftTest, SuiteFailsOnMismatch)
+{
+	auto path = (std::filesystem::temp_directory_path() / "perft_suite_test.epd").string();
+
+	{
+		std::ofstream file(path);
+		file << START_POSITION << " ;D1 20 ;D2 400 ;D3 8902\n";
+		file << KIWIPETE << " ;D1 48 ;D2 2039\n";
+	}
+
+	Perft					perft(2, 16);
+	std::vector<PerftCheck> checks;
+	int						reported = 0;
+
+	EXPECT_TRUE(perft.runSuite(path, 0, checks, [&reported](const PerftCheck &) { ++reported; }));
+	EXPECT_EQ(checks.size(), 5u);
+	EXPECT_EQ(reported, 5);
+
+	EXPECT_TRUE(perft.runSuite(path, 2, checks));
+	EXPECT_EQ(checks.size(), 4u) << "Depth 3 is skipped";
+
+	{
+		std::ofstream file(path);
+		file << KIWIPETE << " ;D1 48 ;D2 2040\n";
+	}
+
+	EXPECT_FALSE(perft.runSuite(path, 0, checks));
+	ASSERT_EQ(checks.size(), 2u);
+	EXPECT_TRUE(checks[0].passed());
+	EXPECT_FALSE(checks[1].passed());
+	EXPECT_EQ(checks[1].result.nodes, 2039u);
+
+	std::filesystem::remove(path);
+
+	EXPECT_FALSE(perft.runSuite(path, 0, checks)) << "Missing file";
+}
+
+
+TEST(PerftTest, MalformedSuiteLineFailsTheSuite)
+{
+	auto path = (std::filesystem::temp_directory_path() / "perft_malformed_suite_test.epd").string();
+
+	{
+		std::ofstream file(path);
+		file << "# Start position\n";
+		file << START_POSITION << " ;D1 20\n";
+		file << "\n";
+		file << START_POSITION << " ;D1 2O\n"; // Letter O
+	}
+
+	Perft					perft(1, 0);
+	std::vector<PerftCheck> checks;
+
+	EXPECT_FALSE(perft.runSuite(path, 0, checks));
+	ASSERT_EQ(checks.size(), 2u) << "Comments and blank lines are skipped";
+	EXPECT_TRUE(checks[0].passed());
+	EXPECT_EQ(checks[0].line, 2);
+	EXPECT_FALSE(checks[1].parsed);
+	EXPECT_FALSE(checks[1].passed());
+	EXPECT_EQ(checks[1].line, 4);
+
+	std::filesystem::remove(path);
+}
+
+
+TEST(PerftTest, InvalidPositionIsReportedNotCounted)
+{
+	Perft		perft(1, 0);
+	PerftResult result = perft.run("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQ1BNR w KQkq - 0 1", 2);
+
+	EXPECT_FALSE(result.valid) << "No white king";
+	EXPECT_EQ(result.nodes, 0u);
+	EXPECT_TRUE(perft.run(START_POSITION, 1).valid);
+
+	auto path = (std::filesystem::temp_directory_path() / "perft_invalid_suite_test.epd").string();
+
+	{
+		std::ofstream file(path);
+		file << START_POSITION << " ;D1 20\n";
+		file << "not a fen ;D1 20 ;D2 400\n";
+	}
+
+	std::vector<PerftCheck> checks;
+
+	EXPECT_FALSE(perft.runSuite(path, 0, checks));
+	ASSERT_EQ(checks.size(), 2u) << "The invalid line is reported once, not for every depth";
+	EXPECT_TRUE(checks[0].passed());
+	EXPECT_FALSE(checks[1].result.valid);
+	EXPECT_FALSE(checks[1].passed());
+
+	std::filesystem::remove(path);
+}
+
+} // namespace PerftTests
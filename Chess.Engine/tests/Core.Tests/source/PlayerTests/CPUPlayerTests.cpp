@@ -8,6 +8,7 @@
 #include <gtest/gtest.h>
 #include <thread>
 #include <chrono>
+#include <atomic>
 
 #include "PLayer/CPUPlayer.h"
 
@@ -308,6 +309,7 @@ TEST_F(CPUPlayerTests, NoRandomizationProducesSameMove)
 	config.cpuColor			   = Side::White;
 	config.difficulty		   = CPUDifficulty::Easy;
 	config.enableRandomization = false;
+	config.seed				   = 1; // Budgeted searches otherwise go deeper on the table the last one left
 
 	mCPUPlayer.configure(config);
 
@@ -410,4 +412,487 @@ TEST_F(CPUPlayerTests, HandlesNoLegalMoves)
 }
 
 
+TEST_F(CPUPlayerTests, PonderMoveIsPredictedAfterSearch)
+{
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.cpuColor			   = Side::White;
+	config.difficulty		   = CPUDifficulty::Easy;
+	config.enableRandomization = false;
+
+	mCPUPlayer.configure(config);
+
+	Move move = mCPUPlayer.calculateMove();
+	ASSERT_TRUE(move.isValid());
+	ASSERT_TRUE(mEngine.makeMove(move).success);
+
+	Move ponderMove = mCPUPlayer.getPonderMove();
+	EXPECT_TRUE(ponderMove.isValid()) << "Search should predict the opponent's reply";
+	EXPECT_TRUE(mEngine.isMoveLegal(ponderMove)) << "Predicted reply should be legal for the opponent";
+}
+
+
+TEST_F(CPUPlayerTests, PonderHitDeliversMoveForCurrentPosition)
+{
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.cpuColor			   = Side::White;
+	config.difficulty		   = CPUDifficulty::Easy;
+	config.enableRandomization = false;
+	config.enablePondering	   = true;
+
+	mCPUPlayer.configure(config);
+
+	Move move = mCPUPlayer.calculateMove();
+	ASSERT_TRUE(mEngine.makeMove(move).success);
+
+	// Read before pondering, the ponder search predicts the next reply
+	Move expectedReply = mCPUPlayer.getPonderMove();
+
+	ASSERT_TRUE(mCPUPlayer.startPondering()) << "Pondering should start after the CPU moved";
+	EXPECT_TRUE(mCPUPlayer.isPondering());
+
+	ASSERT_TRUE(mEngine.makeMove(expectedReply).success);
+
+	std::atomic<bool> callbackCalled{false};
+	Move			  receivedMove;
+
+	auto callback = [&](Move m)
+	{
+		receivedMove = m;
+		callbackCalled.store(true);
+	};
+
+	bool hit = mCPUPlayer.ponderHit(expectedReply, callback);
+
+	EXPECT_TRUE(hit) << "Playing the predicted move should be a ponder hit";
+	EXPECT_FALSE(mCPUPlayer.isPondering()) << "Ponder search should have become the real search";
+
+	for (int i = 0; i < 100 && !callbackCalled.load(); ++i)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	ASSERT_TRUE(callbackCalled.load()) << "Ponder hit should deliver a move";
+	EXPECT_TRUE(mEngine.isMoveLegal(receivedMove)) << "Delivered move must be legal in the actual position";
+
+	PonderStatistics stats = mCPUPlayer.getPonderStatistics();
+	EXPECT_EQ(stats.started, 1);
+	EXPECT_EQ(stats.hits, 1);
+	EXPECT_EQ(stats.misses, 0);
+}
+
+
+TEST_F(CPUPlayerTests, PonderMissCancelsPonderSearch)
+{
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.cpuColor			   = Side::White;
+	config.difficulty		   = CPUDifficulty::Easy;
+	config.enableRandomization = false;
+	config.enablePondering	   = true;
+
+	mCPUPlayer.configure(config);
+
+	Move move = mCPUPlayer.calculateMove();
+	ASSERT_TRUE(mEngine.makeMove(move).success);
+	Move expectedReply = mCPUPlayer.getPonderMove();
+	ASSERT_TRUE(mCPUPlayer.startPondering());
+
+	// Play any legal move other than the predicted one
+	MoveList replies;
+	mEngine.generateLegalMoves(replies);
+
+	Move other{};
+	for (Move reply : replies)
+	{
+		if (reply != expectedReply)
+		{
+			other = reply;
+			break;
+		}
+	}
+
+	ASSERT_TRUE(mEngine.makeMove(other).success);
+
+	bool callbackCalled = false;
+	bool hit			= mCPUPlayer.ponderHit(other, [&](Move) { callbackCalled = true; });
+
+	EXPECT_FALSE(hit) << "A different move should be a ponder miss";
+	EXPECT_FALSE(mCPUPlayer.isPondering()) << "Ponder search should be cancelled on a miss";
+	EXPECT_FALSE(mCPUPlayer.isCalculating());
+	EXPECT_FALSE(callbackCalled) << "A ponder miss must not deliver a move";
+	EXPECT_EQ(mCPUPlayer.getPonderStatistics().misses, 1);
+
+	// Regular search still works afterwards
+	Move reply = mCPUPlayer.calculateMove();
+	EXPECT_TRUE(mEngine.isMoveLegal(reply));
+}
+
+
+TEST_F(CPUPlayerTests, PonderingDisabledDoesNotStart)
+{
+	CPUConfiguration config;
+	config.enabled		   = true;
+	config.cpuColor		   = Side::White;
+	config.difficulty	   = CPUDifficulty::Easy;
+	config.enablePondering = false;
+
+	mCPUPlayer.configure(config);
+
+	Move move = mCPUPlayer.calculateMove();
+	ASSERT_TRUE(mEngine.makeMove(move).success);
+
+	EXPECT_FALSE(mCPUPlayer.startPondering()) << "Pondering should respect the configuration";
+	EXPECT_FALSE(mCPUPlayer.isPondering());
+}
+
+
+TEST_F(CPUPlayerTests, OnlyHardPondersByDefault)
+{
+	EXPECT_FALSE(CPUPlayer::strengthForDifficulty(CPUDifficulty::Easy, 6).ponder);
+	EXPECT_FALSE(CPUPlayer::strengthForDifficulty(CPUDifficulty::Medium, 6).ponder);
+	EXPECT_TRUE(CPUPlayer::strengthForDifficulty(CPUDifficulty::Hard, 6).ponder);
+
+	CPUConfiguration config;
+	config.enabled	  = true;
+	config.cpuColor	  = Side::White;
+	config.difficulty = CPUDifficulty::Easy;
+
+	mCPUPlayer.configure(config);
+
+	Move move = mCPUPlayer.calculateMove();
+	ASSERT_TRUE(mEngine.makeMove(move).success);
+	EXPECT_FALSE(mCPUPlayer.startPondering()) << "Weak levels must not think on the opponent's clock";
+}
+
+
+TEST_F(CPUPlayerTests, ResetPonderForgetsTheExpectedReply)
+{
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.cpuColor			   = Side::White;
+	config.difficulty		   = CPUDifficulty::Easy;
+	config.enableRandomization = false;
+	config.enablePondering	   = true;
+
+	mCPUPlayer.configure(config);
+
+	Move move = mCPUPlayer.calculateMove();
+	ASSERT_TRUE(mEngine.makeMove(move).success);
+	ASSERT_TRUE(mCPUPlayer.startPondering());
+
+	// Undoing the CPU's move leaves a reply from the old line, which must not be pondered on later
+	mCPUPlayer.resetPonder();
+	ASSERT_TRUE(mEngine.undoMove());
+
+	EXPECT_FALSE(mCPUPlayer.isPondering());
+	EXPECT_FALSE(mCPUPlayer.getPonderMove().isValid());
+	EXPECT_FALSE(mCPUPlayer.startPondering());
+}
+
+
+TEST_F(CPUPlayerTests, MultiPVReturnsRankedDistinctLines)
+{
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.cpuColor			   = Side::White;
+	config.difficulty		   = CPUDifficulty::Hard;
+	config.maxDepth			   = 4;
+	config.enableRandomization = false;
+
+	mCPUPlayer.configure(config);
+
+	std::vector<SearchLine> lines = mCPUPlayer.analyzePosition(4);
+
+	ASSERT_EQ(lines.size(), 4u) << "Should return the requested number of lines";
+
+	for (size_t i = 0; i < lines.size(); ++i)
+	{
+		EXPECT_TRUE(mEngine.isMoveLegal(lines[i].move)) << "Line " << i << " move must be legal";
+		EXPECT_EQ(lines[i].depth, 4) << "Lines should come from the last completed iteration";
+		ASSERT_GE(lines[i].pvLength, 1);
+		EXPECT_EQ(lines[i].pv[0], lines[i].move) << "PV should start with the line's move";
+
+		if (i > 0)
+			EXPECT_GE(lines[i - 1].score, lines[i].score) << "Lines should be ranked best first";
+
+		for (size_t j = 0; j < i; ++j)
+			EXPECT_NE(lines[i].move, lines[j].move) << "Lines should start with different moves";
+	}
+}
+
+
+TEST_F(CPUPlayerTests, MultiPVScoresAreExact)
+{
+	// White wins the undefended queen with Rxd8, every other move leaves the rook en prise to the queen
+	mEngine.getBoard().clear();
+
+	mEngine.getBoard().addPiece(PieceType::WKing, Square::g1);
+	mEngine.getBoard().addPiece(PieceType::WRook, Square::d1);
+	mEngine.getBoard().addPiece(PieceType::WPawn, Square::f2);
+	mEngine.getBoard().addPiece(PieceType::WPawn, Square::g2);
+	mEngine.getBoard().addPiece(PieceType::WPawn, Square::h3);
+
+	mEngine.getBoard().addPiece(PieceType::BKing, Square::a6);
+	mEngine.getBoard().addPiece(PieceType::BQueen, Square::d8);
+	mEngine.getBoard().addPiece(PieceType::BPawn, Square::a7);
+	mEngine.getBoard().addPiece(PieceType::BPawn, Square::b7);
+
+	mEngine.getBoard().setSide(Side::White);
+	mEngine.getBoard().updateOccupancies();
+
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.cpuColor			   = Side::White;
+	config.difficulty		   = CPUDifficulty::Easy;
+	config.enableRandomization = false;
+
+	mCPUPlayer.configure(config);
+
+	std::vector<SearchLine> lines = mCPUPlayer.analyzePosition(3);
+
+	ASSERT_EQ(lines.size(), 3u);
+	EXPECT_EQ(lines[0].move.to(), Square::d8) << "Winning the queen should rank first";
+
+	// With a single narrowing window every other move would report the same fail-low bound
+	EXPECT_EQ(lines[0].mateIn, 0);
+	EXPECT_EQ(lines[1].mateIn, 0);
+	EXPECT_GT(lines[0].score - lines[1].score, 500) << "Second line should be scored on its own, not as a bound of the first";
+}
+
+
+TEST_F(CPUPlayerTests, SingleLineSearchMatchesBestMultiPVLine)
+{
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.cpuColor			   = Side::White;
+	config.difficulty		   = CPUDifficulty::Hard;
+	config.maxDepth			   = 4;
+	config.enableRandomization = false;
+
+	mCPUPlayer.configure(config);
+	Move best = mCPUPlayer.calculateMove();
+
+	mCPUPlayer.configure(config); // fresh transposition table
+	std::vector<SearchLine> lines = mCPUPlayer.analyzePosition(3);
+
+	ASSERT_FALSE(lines.empty());
+	EXPECT_EQ(lines[0].move, best) << "First MultiPV line should be the single-PV best move";
+}
+
+
+TEST_F(CPUPlayerTests, NodeBudgetBoundsSearch)
+{
+	CPUConfiguration config;
+	config.enabled	  = true;
+	config.cpuColor	  = Side::White;
+	config.difficulty = CPUDifficulty::Easy;
+
+	mCPUPlayer.configure(config);
+
+	StrengthLevel strength = mCPUPlayer.getStrengthLevel();
+	ASSERT_GT(strength.nodeLimit, 0u) << "Easy should search a node budget";
+
+	Move move = mCPUPlayer.calculateMove();
+
+	EXPECT_TRUE(mEngine.isMoveLegal(move));
+	EXPECT_LE(mCPUPlayer.getNodesSearched(), strength.nodeLimit) << "Search should stop at its node budget";
+	EXPECT_GT(mCPUPlayer.getNodesSearched(), strength.nodeLimit / 2) << "Search should use its budget";
+}
+
+
+TEST_F(CPUPlayerTests, WeakLevelsStopOnTheirBudgetOnly)
+{
+	for (CPUDifficulty difficulty : {CPUDifficulty::Easy, CPUDifficulty::Medium})
+	{
+		StrengthLevel strength = CPUPlayer::strengthForDifficulty(difficulty, 6);
+		EXPECT_GT(strength.nodeLimit, 0u);
+		EXPECT_EQ(strength.moveTimeMs, 0) << "A clock would make the weak levels depend on the machine's load";
+	}
+}
+
+
+TEST_F(CPUPlayerTests, BudgetedSearchKeepsTheTable)
+{
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.cpuColor			   = Side::White;
+	config.difficulty		   = CPUDifficulty::Easy;
+	config.enableRandomization = false;
+
+	// Games reuse the table of the previous move
+	mCPUPlayer.configure(config);
+	mCPUPlayer.calculateMove();
+	uint64_t coldHits = mCPUPlayer.getTranspositionHits();
+	mCPUPlayer.calculateMove();
+	EXPECT_GT(mCPUPlayer.getTranspositionHits(), coldHits) << "The second search should find the first one's entries";
+
+	// A seed asks for reproducible searches, each starting from an empty table
+	config.seed = 7;
+	mCPUPlayer.configure(config);
+	mCPUPlayer.calculateMove();
+	coldHits = mCPUPlayer.getTranspositionHits();
+	mCPUPlayer.calculateMove();
+	EXPECT_EQ(mCPUPlayer.getTranspositionHits(), coldHits);
+}
+
+
+TEST_F(CPUPlayerTests, SkillAlwaysPlaysAFoundMate)
+{
+	// Back rank mate with Rd8, every other line is a plain rook-up evaluation
+	for (uint32_t seed = 1; seed <= 20; ++seed)
+	{
+		ASSERT_TRUE(mEngine.getBoard().parseFEN("6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1"));
+
+		CPUConfiguration config;
+		config.enabled	  = true;
+		config.cpuColor	  = Side::White;
+		config.difficulty = CPUDifficulty::Easy;
+		config.skillLevel = 0;
+		config.seed		  = seed;
+
+		mCPUPlayer.configure(config);
+
+		Move move = mCPUPlayer.calculateMove();
+		EXPECT_EQ(move.from(), Square::d1) << "seed " << seed;
+		EXPECT_EQ(move.to(), Square::d8) << "seed " << seed;
+	}
+}
+
+
+TEST_F(CPUPlayerTests, CancelledSearchLeavesNoScoresInTable)
+{
+	// White is a queen down, a cancelled child scoring 0 would look like the best move
+	constexpr const char *POSITION = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNB1KBNR w KQkq - 0 1";
+	constexpr int		  DEPTH	   = 4;
+
+	CPUConfiguration	  config;
+	config.enabled			   = true;
+	config.cpuColor			   = Side::White;
+	config.difficulty		   = CPUDifficulty::Hard;
+	config.maxDepth			   = DEPTH;
+	config.enableRandomization = false;
+
+	// Reference search on a fresh table
+	GameEngine freshEngine;
+	freshEngine.init();
+	freshEngine.getBoard().parseFEN(POSITION);
+
+	CPUPlayer freshPlayer(freshEngine);
+	freshPlayer.configure(config);
+	std::vector<SearchLine> expected  = freshPlayer.analyzePosition(1);
+	uint64_t				fullNodes = freshPlayer.getNodesSearched();
+	ASSERT_FALSE(expected.empty());
+	ASSERT_LT(expected[0].score, -500);
+
+	// Node budgets that stop the search all over the tree
+	for (uint64_t nodeLimit = 100; nodeLimit < fullNodes; nodeLimit = nodeLimit * 9 / 8)
+	{
+		mEngine.getBoard().parseFEN(POSITION);
+		mCPUPlayer.configure(config);
+		mCPUPlayer.setSearchLimits(DEPTH, nodeLimit, 0);
+		mCPUPlayer.calculateMove();
+
+		// Same table, no budget
+		mCPUPlayer.setSearchLimits(DEPTH, 0, 0);
+		std::vector<SearchLine> lines = mCPUPlayer.analyzePosition(1);
+
+		ASSERT_FALSE(lines.empty());
+		EXPECT_EQ(lines[0].score, expected[0].score) << "After a search cancelled at " << nodeLimit << " nodes";
+	}
+}
+
+
+TEST_F(CPUPlayerTests, QuiescenceReusesCachedEvaluations)
+{
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.cpuColor			   = Side::White;
+	config.difficulty		   = CPUDifficulty::Hard;
+	config.maxDepth			   = 4;
+	config.enableRandomization = false;
+
+	mCPUPlayer.configure(config);
+	mEngine.getBoard().parseFEN("r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+
+	Move move = mCPUPlayer.calculateMove();
+
+	EXPECT_TRUE(mEngine.isMoveLegal(move));
+	EXPECT_GT(mCPUPlayer.getEvalCache().getProbes(), 0u);
+	EXPECT_GT(mCPUPlayer.getEvalCache().getHits(), 0u) << "Transpositions should hit the evaluation cache";
+}
+
+
+TEST_F(CPUPlayerTests, SeededSelfPlayIsReproducible)
+{
+	auto playGame = [](uint32_t seed)
+	{
+		GameEngine engine;
+		engine.init();
+		engine.resetGame();
+
+		CPUPlayer		 cpu(engine);
+		CPUConfiguration config;
+		config.enabled	  = true;
+		config.difficulty = CPUDifficulty::Easy;
+		config.seed		  = seed;
+		cpu.configure(config);
+
+		std::vector<uint16_t> moves;
+
+		for (int ply = 0; ply < 12; ++ply)
+		{
+			Move move = cpu.calculateMove();
+			if (!move.isValid() || !engine.makeMove(move).success)
+				break;
+
+			moves.push_back(move.raw());
+		}
+
+		return moves;
+	};
+
+	std::vector<uint16_t> first	 = playGame(1234);
+	std::vector<uint16_t> second = playGame(1234);
+
+	EXPECT_EQ(first.size(), 12u);
+	EXPECT_EQ(first, second) << "The same seed should replay the same game";
+}
+
+
+TEST_F(CPUPlayerTests, SkillErrorStaysWithinMargin)
+{
+	// Rxd8 wins the queen, every other move loses the rook: far more than the weakest skill's error margin
+	mEngine.getBoard().clear();
+
+	mEngine.getBoard().addPiece(PieceType::WKing, Square::g1);
+	mEngine.getBoard().addPiece(PieceType::WRook, Square::d1);
+	mEngine.getBoard().addPiece(PieceType::WPawn, Square::f2);
+	mEngine.getBoard().addPiece(PieceType::WPawn, Square::g2);
+	mEngine.getBoard().addPiece(PieceType::WPawn, Square::h3);
+
+	mEngine.getBoard().addPiece(PieceType::BKing, Square::a6);
+	mEngine.getBoard().addPiece(PieceType::BQueen, Square::d8);
+	mEngine.getBoard().addPiece(PieceType::BPawn, Square::a7);
+	mEngine.getBoard().addPiece(PieceType::BPawn, Square::b7);
+
+	mEngine.getBoard().setSide(Side::White);
+	mEngine.getBoard().updateOccupancies();
+
+	for (uint32_t seed = 1; seed <= 20; ++seed)
+	{
+		CPUConfiguration config;
+		config.enabled	  = true;
+		config.cpuColor	  = Side::White;
+		config.difficulty = CPUDifficulty::Easy;
+		config.skillLevel = 0;
+		config.seed		  = seed;
+
+		mCPUPlayer.configure(config);
+
+		Move move = mCPUPlayer.calculateMove();
+		EXPECT_EQ(move.to(), Square::d8) << "Seed " << seed << " gave away the rook";
+	}
+}
+
+
 } // namespace PlayerTests
@@ -0,0 +1,163 @@
+/*
+  ==============================================================================
+	Module:			SearchInfo Tests
+	Description:    Testing the search info channel and its delivery to the UI side
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include "SearchInfo.h"
+#include "SearchInfoDispatcher.h"
+#include "PLayer/CPUPlayer.h"
+
+
+namespace PlayerTests
+{
+
+TEST(SearchInfoChannelTests, ReadReturnsLatestPublishedValue)
+{
+	SearchInfoChannel channel;
+	uint64_t		  lastSequence = 0;
+	SearchInfo		  info;
+
+	EXPECT_FALSE(channel.tryRead(info, lastSequence)) << "Nothing published yet";
+
+	SearchInfo first;
+	first.depth = 1;
+	channel.publish(first);
+
+	SearchInfo second;
+	second.depth = 2;
+	second.nodes = 1234;
+	channel.publish(second);
+
+	ASSERT_TRUE(channel.tryRead(info, lastSequence));
+	EXPECT_EQ(info.depth, 2) << "Reader should only see the newest value";
+	EXPECT_EQ(info.nodes, 1234u);
+
+	EXPECT_FALSE(channel.tryRead(info, lastSequence)) << "Same value should not be read twice";
+}
+
+
+TEST(SearchInfoChannelTests, ConcurrentReadsAreNeverTorn)
+{
+	SearchInfoChannel channel;
+	std::atomic<bool> done{false};
+
+	std::thread		  writer(
+		  [&]
+		  {
+			  for (int i = 1; i <= 20000; ++i)
+			  {
+				  SearchInfo info;
+				  info.depth	= i;
+				  info.score	= i;
+				  info.nodes	= static_cast<uint64_t>(i);
+				  info.pvLength = i % SearchInfo::MAX_PV;
+				  channel.publish(info);
+			  }
+			  done.store(true);
+		  });
+
+	uint64_t lastSequence = 0;
+	int		 reads		  = 0;
+	bool	 consistent	  = true;
+
+	bool	 finished	  = false;
+
+	while (!finished)
+	{
+		finished = done.load(); // one more read after the writer is done
+
+		SearchInfo info;
+		if (channel.tryRead(info, lastSequence))
+		{
+			++reads;
+			consistent &= info.score == info.depth && info.nodes == static_cast<uint64_t>(info.depth) && info.pvLength == info.depth % SearchInfo::MAX_PV;
+		}
+	}
+
+	writer.join();
+
+	EXPECT_TRUE(consistent) << "Reader observed a partially written value";
+	EXPECT_GT(reads, 0);
+}
+
+
+TEST(SearchInfoDispatcherTests, DeliversPublishedInfoOffTheSearchThread)
+{
+	SearchInfoChannel	 channel;
+	SearchInfoDispatcher dispatcher(channel, 5);
+
+	std::atomic<int>	 receivedDepth{0};
+	std::thread::id		 deliveryThread;
+
+	dispatcher.setCallback(
+		[&](const SearchInfo &info)
+		{
+			deliveryThread = std::this_thread::get_id();
+			receivedDepth.store(info.depth);
+		});
+	dispatcher.start();
+
+	channel.setActive(true);
+	dispatcher.onSearchStarted();
+
+	SearchInfo info;
+	info.depth = 7;
+	info.final = true;
+	channel.publish(info);
+	channel.setActive(false);
+
+	for (int i = 0; i < 100 && receivedDepth.load() == 0; ++i)
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+	dispatcher.stop();
+
+	EXPECT_EQ(receivedDepth.load(), 7) << "Dispatcher should deliver the final report";
+	EXPECT_NE(deliveryThread, std::this_thread::get_id()) << "Delivery should happen on the dispatcher thread";
+}
+
+
+TEST(SearchInfoTests, CPUSearchReportsDepthNodesAndPV)
+{
+	GameEngine engine;
+	engine.init();
+	engine.resetGame();
+
+	CPUPlayer		 cpu(engine);
+	CPUConfiguration config;
+	config.enabled			   = true;
+	config.cpuColor			   = Side::White;
+	config.difficulty		   = CPUDifficulty::Hard;
+	config.maxDepth			   = 4;
+	config.enableRandomization = false;
+	cpu.configure(config);
+
+	Move	   move			= cpu.calculateMove();
+
+	uint64_t   lastSequence = 0;
+	SearchInfo info;
+	ASSERT_TRUE(cpu.getSearchInfoChannel().tryRead(info, lastSequence)) << "Search should publish its result";
+
+	EXPECT_TRUE(info.final);
+	EXPECT_EQ(info.depth, 4) << "Hard difficulty searches to the configured depth";
+	EXPECT_GE(info.selDepth, info.depth);
+	EXPECT_GT(info.nodes, 0u);
+	EXPECT_EQ(info.mateIn, 0);
+	ASSERT_GE(info.pvLength, 1);
+	EXPECT_EQ(info.pv[0], move) << "PV should start with the chosen move";
+
+	// The whole PV must be playable
+	for (int i = 0; i < info.pvLength; ++i)
+	{
+		ASSERT_TRUE(engine.isMoveLegal(info.pv[i])) << "PV move " << i << " is illegal";
+		ASSERT_TRUE(engine.makeMove(info.pv[i]).success);
+	}
+}
+
+} // namespace PlayerTests
@@ -0,0 +1,128 @@
+/*
+  ==============================================================================
+	Module:			SearchWorker Tests
+	Description:    Testing the persistent search thread of the CPU player
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include "SearchWorker.h"
+
+
+namespace PlayerTests
+{
+
+TEST(SearchWorkerTests, PostRunsTaskOnSameWorkerThread)
+{
+	std::atomic<int> runs{0};
+	std::thread::id	 firstThread;
+	std::atomic<bool> sameThread{true};
+
+	SearchWorker	 worker(
+		[&](std::stop_token)
+		{
+			if (runs.load() == 0)
+				firstThread = std::this_thread::get_id();
+			else if (firstThread != std::this_thread::get_id())
+				sameThread.store(false);
+
+			runs.fetch_add(1);
+		});
+
+	for (int i = 0; i < 5; ++i)
+	{
+		worker.post();
+		worker.waitIdle();
+	}
+
+	EXPECT_EQ(runs.load(), 5) << "Every request should run the task exactly once";
+	EXPECT_TRUE(sameThread.load()) << "All requests should be served by the same thread";
+	EXPECT_NE(firstThread, std::this_thread::get_id()) << "Task should not run on the caller thread";
+	EXPECT_FALSE(worker.isBusy());
+}
+
+
+TEST(SearchWorkerTests, CancelStopsRunningTask)
+{
+	std::atomic<bool> started{false};
+	std::atomic<bool> sawStop{false};
+
+	SearchWorker	  worker(
+		 [&](std::stop_token stopToken)
+		 {
+			 started.store(true);
+
+			 while (!stopToken.stop_requested())
+				 std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+			 sawStop.store(true);
+		 });
+
+	worker.post();
+
+	while (!started.load())
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	EXPECT_TRUE(worker.isBusy()) << "Worker should be busy while the task runs";
+
+	worker.cancel();
+
+	EXPECT_TRUE(sawStop.load()) << "Cancel should request a stop and wait for the task";
+	EXPECT_FALSE(worker.isBusy()) << "Worker should be parked after cancel";
+}
+
+
+TEST(SearchWorkerTests, NewRequestIsNotCancelledByPreviousCancel)
+{
+	std::atomic<bool> lastRunStopped{true};
+
+	SearchWorker	  worker([&](std::stop_token stopToken) { lastRunStopped.store(stopToken.stop_requested()); });
+
+	worker.post();
+	worker.cancel();
+
+	worker.post();
+	worker.waitIdle();
+
+	EXPECT_FALSE(lastRunStopped.load()) << "Each request should get a fresh stop token";
+}
+
+
+TEST(SearchWorkerTests, StatisticsRecordFirstNodeLatency)
+{
+	SearchWorker *self = nullptr;
+	SearchWorker  worker([&](std::stop_token) { self->markFirstNode(); });
+	self = &worker;
+
+	for (int i = 0; i < 3; ++i)
+	{
+		worker.post();
+		worker.waitIdle();
+	}
+
+	SearchWorkerStatistics stats = worker.getStatistics();
+
+	EXPECT_EQ(stats.requests, 3u);
+	EXPECT_GT(stats.lastFirstNodeUs, 0.0);
+	EXPECT_GE(stats.maxFirstNodeUs, stats.lastFirstNodeUs);
+	EXPECT_GT(stats.averageFirstNodeUs(), 0.0);
+}
+
+
+TEST(SearchWorkerTests, ScratchStackIsPreallocated)
+{
+	SearchWorker worker([](std::stop_token) {});
+
+	SearchPly	&first = worker.ply(0);
+	SearchPly	&last  = worker.ply(SearchWorker::MAX_PLY - 1);
+
+	EXPECT_TRUE(first.moves.empty());
+	EXPECT_TRUE(last.captures.empty());
+	EXPECT_NE(&first, &last);
+}
+
+} // namespace PlayerTests
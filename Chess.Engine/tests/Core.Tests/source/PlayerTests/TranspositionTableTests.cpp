@@ -0,0 +1,129 @@
+/*
+  ==============================================================================
+	Module:			TranspositionTable Tests
+	Description:    Testing the search transposition table
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include "TranspositionTable.h"
+
+
+namespace PlayerTests
+{
+
+using NodeType = TranspositionEntry::NodeType;
+
+
+TEST(TranspositionTableTests, ProbeMissesUnknownPosition)
+{
+	TranspositionTable table;
+	int				   score	= 0;
+	Move			   bestMove = Move::none();
+
+	EXPECT_FALSE(table.probe(0x1234, 1, -100, 100, score, bestMove));
+	EXPECT_FALSE(bestMove.isValid());
+}
+
+
+TEST(TranspositionTableTests, ExactEntryIsUsedAtEqualOrLowerDepth)
+{
+	TranspositionTable table;
+	Move			   stored(Square::e2, Square::e4, MoveFlag::DoublePawnPush);
+	table.store(0x1234, 4, 35, NodeType::Exact, stored);
+
+	int	 score	  = 0;
+	Move bestMove = Move::none();
+
+	EXPECT_TRUE(table.probe(0x1234, 4, -100, 100, score, bestMove));
+	EXPECT_EQ(score, 35);
+	EXPECT_EQ(bestMove, stored);
+
+	score	 = 0;
+	bestMove = Move::none();
+
+	EXPECT_FALSE(table.probe(0x1234, 5, -100, 100, score, bestMove)) << "Shallower entry must not cut a deeper search";
+	EXPECT_EQ(score, 0);
+	EXPECT_EQ(bestMove, stored) << "The move is still returned for ordering";
+}
+
+
+TEST(TranspositionTableTests, BoundsOnlyCutOutsideTheWindow)
+{
+	TranspositionTable table;
+	table.store(1, 3, 150, NodeType::LowerBound, Move::none());
+	table.store(2, 3, -150, NodeType::UpperBound, Move::none());
+
+	int	 score	  = 0;
+	Move bestMove = Move::none();
+
+	EXPECT_TRUE(table.probe(1, 3, -100, 100, score, bestMove));
+	EXPECT_EQ(score, 150);
+	EXPECT_FALSE(table.probe(1, 3, -100, 200, score, bestMove));
+
+	EXPECT_TRUE(table.probe(2, 3, -100, 100, score, bestMove));
+	EXPECT_EQ(score, -150);
+	EXPECT_FALSE(table.probe(2, 3, -200, 100, score, bestMove));
+}
+
+
+TEST(TranspositionTableTests, DeeperEntryIsKept)
+{
+	TranspositionTable table;
+	table.store(7, 6, 10, NodeType::Exact, Move::none());
+	table.store(7, 2, 99, NodeType::Exact, Move::none());
+
+	int	 score	  = 0;
+	Move bestMove = Move::none();
+
+	ASSERT_TRUE(table.probe(7, 2, -100, 100, score, bestMove));
+	EXPECT_EQ(score, 10);
+	EXPECT_EQ(table.size(), 1u);
+
+	table.clear();
+	EXPECT_EQ(table.size(), 0u);
+	EXPECT_EQ(table.hashFull(), 0);
+}
+
+TEST(TranspositionTableTests, FullBucketReplacesOldAndShallowEntries)
+{
+	// One bucket: every position competes for the same slots
+	TranspositionTable table;
+	table.setCapacity(TranspositionTable::BUCKET_SIZE);
+	ASSERT_EQ(table.capacity(), TranspositionTable::BUCKET_SIZE);
+
+	int	 score	  = 0;
+	Move bestMove = Move::none();
+
+	for (uint64_t hash = 1; hash <= 4; ++hash)
+		table.store(hash, static_cast<int>(hash), 0, NodeType::Exact, Move::none());
+
+	EXPECT_EQ(table.hashFull(), 1000);
+
+	// The next search first replaces the old entries, the shallowest of them
+	table.newSearch();
+	table.store(5, 1, 0, NodeType::Exact, Move::none());
+	EXPECT_FALSE(table.probe(1, 0, -100, 100, score, bestMove));
+	EXPECT_TRUE(table.probe(5, 0, -100, 100, score, bestMove));
+
+	table.store(6, 1, 0, NodeType::Exact, Move::none());
+	EXPECT_FALSE(table.probe(2, 0, -100, 100, score, bestMove));
+	EXPECT_TRUE(table.probe(5, 0, -100, 100, score, bestMove)) << "Entries of the running search go last";
+
+	// Then the remaining old entries, then the shallowest entry of the running search
+	table.store(7, 9, 0, NodeType::Exact, Move::none());
+	table.store(8, 9, 0, NodeType::Exact, Move::none());
+	table.store(9, 9, 0, NodeType::Exact, Move::none());
+	EXPECT_FALSE(table.probe(3, 0, -100, 100, score, bestMove));
+	EXPECT_FALSE(table.probe(4, 0, -100, 100, score, bestMove));
+	EXPECT_FALSE(table.probe(5, 0, -100, 100, score, bestMove));
+
+	for (uint64_t hash = 6; hash <= 9; ++hash)
+		EXPECT_TRUE(table.probe(hash, 0, -100, 100, score, bestMove)) << hash;
+
+	EXPECT_EQ(table.size(), TranspositionTable::BUCKET_SIZE);
+}
+
+
+} // namespace PlayerTests
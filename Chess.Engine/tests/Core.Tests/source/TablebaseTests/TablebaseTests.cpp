@@ -0,0 +1,575 @@
+/*
+  ==============================================================================
+	Module:			Tablebase Tests
+	Description:    Testing the endgame table indexing, generation and probing
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <climits>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <map>
+
+#include "AttackTables.h"
+#include "BitboardUtils.h"
+#include "CPUPlayer.h"
+#include "Fen.h"
+#include "KPKBitbase.h"
+#include "Tablebase.h"
+#include "TablebaseGenerator.h"
+#include "TablebaseIndex.h"
+#include "TablebaseLayout.h"
+
+
+namespace TablebaseTests
+{
+
+TablebaseLayout::Bitboards piecesOf(const char *fen, Side &side)
+{
+	FenPosition position;
+	EXPECT_EQ(Fen::parse(fen, position), FenError::None) << fen;
+	side = position.side;
+	return position.pieces;
+}
+
+
+size_t indexOf(const TablebaseLayout &layout, const char *fen, bool flip = false)
+{
+	Side side	= Side::White;
+	auto pieces = piecesOf(fen, side);
+	return layout.index(pieces, side, flip);
+}
+
+
+TEST(TablebaseLayoutTests, CodeAndSize)
+{
+	TablebaseLayout rook(MaterialKey::fromCode("KRvK"));
+	EXPECT_EQ(rook.code(), "KRvK");
+	EXPECT_EQ(rook.pieceCount(), 3);
+	EXPECT_FALSE(rook.hasPawns());
+	EXPECT_EQ(rook.size(), 10u * 64 * 64 * 2);
+
+	TablebaseLayout pawn(MaterialKey::fromCode("KPvK"));
+	EXPECT_TRUE(pawn.hasPawns());
+	EXPECT_EQ(pawn.size(), 32u * 64 * 64 * 2);
+
+	// Letters are ordered by piece value on both sides
+	EXPECT_EQ(TablebaseLayout(MaterialKey::fromCode("KNRvKPB")).code(), "KRNvKBP");
+
+	EXPECT_FALSE(TablebaseLayout::isValid(MaterialKey::fromCode("KQvQ")));
+	EXPECT_FALSE(TablebaseLayout::isValid(MaterialKey::fromCode("KQRBNvKQ")));
+	EXPECT_EQ(TablebaseLayout(MaterialKey::fromCode("KQvQ")).size(), 0u);
+}
+
+
+TEST(TablebaseLayoutTests, SymmetricPositionsShareAnIndex)
+{
+	TablebaseLayout layout(MaterialKey::fromCode("KRvK"));
+	size_t			index = indexOf(layout, "8/8/8/8/8/2k5/8/R3K3 w - - 0 1");
+
+	EXPECT_EQ(indexOf(layout, "8/8/8/8/8/5k2/8/3K3R w - - 0 1"), index); // Files mirrored
+	EXPECT_EQ(indexOf(layout, "R3K3/8/2k5/8/8/8/8/8 w - - 0 1"), index); // Ranks mirrored
+	EXPECT_EQ(indexOf(layout, "8/8/8/K7/8/2k5/8/R7 w - - 0 1"), index);	 // Mirrored at the a1-h8 diagonal
+	EXPECT_EQ(indexOf(layout, "r3k3/8/2K5/8/8/8/8/8 b - - 0 1", true), index); // Colours swapped
+
+	EXPECT_NE(indexOf(layout, "8/8/8/8/8/2k5/8/R3K3 b - - 0 1"), index);
+	EXPECT_NE(indexOf(layout, "8/8/8/8/8/3k4/8/R3K3 w - - 0 1"), index);
+
+	// Two knights are one group, their order doesn't matter
+	TablebaseLayout knights(MaterialKey::fromCode("KNNvK"));
+	Side			side	= Side::White;
+	auto			pieces	= piecesOf("8/8/8/4k3/8/1N6/6N1/4K3 w - - 0 1", side);
+	size_t			twoKnights = knights.index(pieces, side, false);
+
+	Side			decodedSide = Side::Both;
+	TablebaseLayout::Bitboards decoded{};
+	ASSERT_TRUE(knights.decode(twoKnights, decoded, decodedSide));
+	EXPECT_EQ(decodedSide, side);
+	EXPECT_EQ(knights.index(decoded, decodedSide, false), twoKnights);
+	EXPECT_EQ(BitUtils::popCount(decoded[WKnight]), 2);
+}
+
+
+TEST(TablebaseLayoutTests, EveryPositionHasOneIndex)
+{
+	// Decoding accepts exactly one index per position: counting the accepted indices counts the positions
+	TablebaseLayout layout(MaterialKey::fromCode("KRvK"));
+	size_t			accepted = 0;
+
+	for (size_t index = 0; index < layout.size(); ++index)
+	{
+		TablebaseLayout::Bitboards pieces{};
+		Side					   side = Side::White;
+
+		if (layout.decode(index, pieces, side))
+			++accepted;
+	}
+
+	// Placements of the three pieces up to the 8 board symmetries (Burnside): only the two diagonal
+	// mirrors keep placements fixed, those with every piece on their diagonal. Times two sides to move.
+	size_t placements = 64 * 63 * 62;
+	size_t onDiagonal = 8 * 7 * 6;
+	EXPECT_EQ(accepted, (placements + 2 * onDiagonal) / 8 * 2);
+}
+
+
+
+uint64_t syzygyIndexOf(const char *code, std::initializer_list<uint8_t> order, const char *fen)
+{
+	TablebaseIndex			 index(MaterialKey::fromCode(code));
+	TablebaseIndex::Groups	 groups;
+	Side					 side	= Side::White;
+	auto					 pieces = piecesOf(fen, side);
+
+	std::copy(order.begin(), order.end(), groups.pieces.begin());
+	TablebaseIndex::Placement placement = index.place(pieces, false, index.leadPawn());
+	EXPECT_TRUE(index.setGroups(groups, 0, 0xF, placement.file)) << code;
+
+	return index.index(groups, placement);
+}
+
+
+TEST(TablebaseIndexTests, MatchesTheSyzygyEncoding)
+{
+	using Piece = TablebaseIndex::Piece;
+
+	// Sub-table sizes of the format: 31332 placements of three unique pieces, 462 of the two kings,
+	// and with pawns 6 squares of the leading pawn per file times the squares left to the others
+	TablebaseIndex		   queen(MaterialKey::fromCode("KQvK"));
+	TablebaseIndex::Groups groups;
+	groups.pieces = {Piece::King, Piece::Queen, Piece::King | Piece::Black};
+	ASSERT_TRUE(queen.setGroups(groups, 0, 0xF, 0));
+	EXPECT_EQ(groups.size(), 31332u);
+
+	TablebaseIndex queens(MaterialKey::fromCode("KQQvK"));
+	groups.pieces = {Piece::King, Piece::King | Piece::Black, Piece::Queen, Piece::Queen};
+	ASSERT_TRUE(queens.setGroups(groups, 0, 0xF, 0));
+	EXPECT_EQ(groups.size(), 462u * (62 * 61 / 2));
+
+	TablebaseIndex pawn(MaterialKey::fromCode("KPvK"));
+	groups.pieces = {Piece::Pawn, Piece::King, Piece::King | Piece::Black};
+
+	for (int file = 0; file < TablebaseIndex::FILES; ++file)
+	{
+		ASSERT_TRUE(pawn.setGroups(groups, 0, 0xF, file));
+		EXPECT_EQ(groups.size(), 6u * 63 * 62);
+	}
+
+	// Indices worked out by hand from the encoding of the Syzygy probing code (squares from a1 = 0):
+	// Kb1 Qd5 kf7 has the first piece below the diagonal, (0 * 63 + 35 - 1) * 62 + 53 - 2
+	EXPECT_EQ(syzygyIndexOf("KQvK", {Piece::King, Piece::Queen, Piece::King | Piece::Black}, "8/5k2/8/3Q4/8/8/8/1K6 w - - 0 1"), 2159u);
+
+	// Kg7 Qa1 kc6 mirrors to Kb2 Qh8 kf3: two pieces on the diagonal, 6*63*62 + 4*28*62 + 1*7*28 + 6*28 + 15
+	EXPECT_EQ(syzygyIndexOf("KQvK", {Piece::King, Piece::Queen, Piece::King | Piece::Black}, "8/6K1/2k5/8/8/8/8/Q7 w - - 0 1"), 30759u);
+
+	// Kb1 kh8 is king pair 57, the queens on a1 and h1 add C(0, 1) + C(6, 2) = 15 times 462
+	EXPECT_EQ(syzygyIndexOf("KQQvK", {Piece::King, Piece::King | Piece::Black, Piece::Queen, Piece::Queen}, "7k/8/8/8/8/8/8/QK5Q b - - 0 1"), 57u + 15 * 462);
+
+	// Pe4 Ke1 ke8 mirrors to the d-file: pawn slot 2, then 3 * 6 for the king and (59 - 2) * 6 * 63 for the other one
+	EXPECT_EQ(syzygyIndexOf("KPvK", {Piece::Pawn, Piece::King, Piece::King | Piece::Black}, "4k3/8/8/8/4P3/8/8/4K3 w - - 0 1"), 2u + 3 * 6 + 57 * 6 * 63);
+}
+
+
+TEST(TablebaseIndexTests, ReadsASingleValueFile)
+{
+	// KNvK.rtbw as the format lays it out byte by byte: every position of either side to move is a draw,
+	// so both sub-tables store their value in the header. The (empty) data starts at the next multiple
+	// of 64 bytes and the file ends with a 16 byte checksum, which probing doesn't read.
+	uint8_t fileBytes[64 + 16] = {
+		0x71, 0xE8, 0x23, 0x5D, // WDL magic
+		0x01,					// Split: one sub-table per side to move
+		0x00,					// Order of the leading group (white and black to move)
+		0x66, 0x22, 0xEE,		// King, knight, black king for both sides to move
+		0x00,					// Word alignment
+		0x80, 0x02,				// White to move: a single value, draw (stored as the result + 2)
+		0x80, 0x02,				// Black to move
+	};
+
+	std::filesystem::path directory = std::filesystem::temp_directory_path() / "tablebase_fixture_test";
+	std::filesystem::remove_all(directory);
+	std::filesystem::create_directories(directory);
+
+	{
+		std::ofstream file(directory / "KNvK.rtbw", std::ios::binary);
+		file.write(reinterpret_cast<const char *>(fileBytes), sizeof(fileBytes));
+	}
+
+	Tablebase tablebase;
+	ASSERT_TRUE(tablebase.open(directory.string()));
+	EXPECT_TRUE(tablebase.hasTable(MaterialKey::fromCode("KNvK")));
+
+	for (const char *fen : {"8/8/3k4/8/8/3K4/8/6N1 w - - 0 1", "8/8/3k4/8/8/3K4/8/6N1 b - - 0 1", "6n1/8/3k4/8/8/3K4/8/8 w - - 0 1"})
+	{
+		Side side	= Side::White;
+		auto pieces = piecesOf(fen, side);
+		Wdl	 wdl	= Wdl::Win;
+
+		ASSERT_TRUE(tablebase.probeWDL(pieces, side, wdl)) << fen;
+		EXPECT_EQ(wdl, Wdl::Draw) << fen;
+	}
+
+	// A pawn table's header on the same material
+	fileBytes[4] |= 0x02;
+
+	{
+		std::ofstream file(directory / "KNvK.rtbw", std::ios::binary | std::ios::trunc);
+		file.write(reinterpret_cast<const char *>(fileBytes), sizeof(fileBytes));
+	}
+
+	EXPECT_FALSE(tablebase.open(directory.string()));
+
+	std::filesystem::remove_all(directory);
+}
+
+
+class TablebaseTests : public ::testing::Test
+{
+protected:
+	static inline std::filesystem::path								mDirectory = std::filesystem::temp_directory_path() / "tablebase_test";
+	static inline std::map<std::string, TablebaseGenerationResult> mResults;
+	Tablebase														mTablebase;
+
+	static void														SetUpTestSuite()
+	{
+		std::filesystem::remove_all(mDirectory);
+		std::filesystem::create_directories(mDirectory);
+
+		// KPvK promotes into the others, so it comes last
+		for (const char *code : {"KQvK", "KRvK", "KBvK", "KNvK", "KPvK"})
+			ASSERT_TRUE(TablebaseGenerator::generate(mDirectory.string(), code, mResults[code])) << code;
+	}
+
+	static void TearDownTestSuite() { std::filesystem::remove_all(mDirectory); }
+
+	void		SetUp() override { ASSERT_TRUE(mTablebase.open(mDirectory.string())); }
+
+	Wdl			probe(const char *fen, int *dtz = nullptr)
+	{
+		GameEngine engine;
+		engine.init();
+		EXPECT_TRUE(engine.getBoard().parseFEN(fen)) << fen;
+
+		Wdl	 wdl	  = Wdl::Draw;
+		int	 distance = 0;
+		bool found	  = mTablebase.probeDTZ(engine, wdl, distance);
+		EXPECT_TRUE(found) << fen;
+
+		if (dtz)
+			*dtz = distance;
+
+		return wdl;
+	}
+};
+
+
+TEST_F(TablebaseTests, OpensTheGeneratedTables)
+{
+	EXPECT_EQ(mTablebase.tableCount(), 5u);
+	EXPECT_EQ(mTablebase.maxPieces(), 3);
+	EXPECT_TRUE(mTablebase.hasTable(MaterialKey::fromCode("KQvK")));
+	EXPECT_TRUE(mTablebase.hasTable(MaterialKey::fromCode("KvKR"))); // Colours swapped
+	EXPECT_FALSE(mTablebase.hasTable(MaterialKey::fromCode("KQvKR")));
+}
+
+
+TEST_F(TablebaseTests, WritesSyzygyFiles)
+{
+	for (const char *code : {"KQvK", "KPvK"})
+	{
+		for (std::string_view extension : {Tablebase::WDL_EXTENSION, Tablebase::DTZ_EXTENSION})
+		{
+			std::filesystem::path path = mDirectory / (std::string(code) + std::string(extension));
+			ASSERT_TRUE(std::filesystem::exists(path)) << path;
+
+			// Magic number, and the padding that makes the files 16 bytes longer than a multiple of 64
+			std::ifstream file(path, std::ios::binary);
+			uint8_t		  magic[4] = {};
+			file.read(reinterpret_cast<char *>(magic), sizeof(magic));
+
+			const uint8_t *expected = extension == Tablebase::WDL_EXTENSION ? SyzygyFormat::WDL_MAGIC : SyzygyFormat::DTZ_MAGIC;
+			EXPECT_TRUE(std::equal(magic, magic + 4, expected)) << path;
+			EXPECT_EQ(std::filesystem::file_size(path) % 64, 16u) << path;
+		}
+	}
+}
+
+
+TEST_F(TablebaseTests, GenerationStatistics)
+{
+	// Longest distances to mate with the queen (10 moves) and the rook (16 moves), in plies from the defender's move
+	EXPECT_EQ(mResults["KQvK"].maxDtz, 20);
+	EXPECT_EQ(mResults["KRvK"].maxDtz, 32);
+
+	for (const char *code : {"KBvK", "KNvK"})
+	{
+		const TablebaseGenerationResult &result = mResults[code];
+		EXPECT_GT(result.positions, 0u) << code;
+		EXPECT_EQ(result.wins, 0u) << code;
+		EXPECT_EQ(result.losses, 0u) << code;
+		EXPECT_EQ(result.draws, result.positions) << code;
+	}
+
+	const TablebaseGenerationResult &queen = mResults["KQvK"];
+	EXPECT_EQ(queen.wins + queen.draws + queen.losses, queen.positions);
+	EXPECT_GT(queen.wins, queen.draws);
+}
+
+
+TEST_F(TablebaseTests, PawnEndingMatchesTheBitbase)
+{
+	const AttackTables &attacks	  = AttackTables::instance();
+	size_t				compared  = 0;
+	size_t				wins	  = 0;
+
+	auto				distance = [](int a, int b) { return std::max(std::abs(a % 8 - b % 8), std::abs(a / 8 - b / 8)); };
+
+	for (int pawn = 8; pawn < 56; ++pawn)
+	{
+		if (pawn % 8 > 3)
+			continue;
+
+		for (int whiteKing = 0; whiteKing < 64; ++whiteKing)
+		{
+			for (int blackKing = 0; blackKing < 64; ++blackKing)
+			{
+				if (whiteKing == pawn || blackKing == pawn || distance(whiteKing, blackKing) < 2)
+					continue;
+
+				for (Side side : {Side::White, Side::Black})
+				{
+					// With white to move, black must not be in check
+					if (side == Side::White && (attacks.pawnAttacks(Side::White, static_cast<Square>(pawn)) & (1ULL << blackKing)))
+						continue;
+
+					TablebaseLayout::Bitboards pieces{};
+					pieces[WKing] = 1ULL << whiteKing;
+					pieces[WPawn] = 1ULL << pawn;
+					pieces[BKing] = 1ULL << blackKing;
+
+					Wdl wdl		  = Wdl::Draw;
+					ASSERT_TRUE(mTablebase.probeWDL(pieces, side, wdl));
+
+					bool won = KPKBitbase::probe(static_cast<Square>(whiteKing), static_cast<Square>(pawn), static_cast<Square>(blackKing), side);
+					EXPECT_EQ(wdl, won ? (side == Side::White ? Wdl::Win : Wdl::Loss) : Wdl::Draw)
+						<< "K " << whiteKing << " P " << pawn << " k " << blackKing << " side " << to_index(side);
+
+					++compared;
+					wins += won ? 1 : 0;
+				}
+			}
+		}
+	}
+
+	EXPECT_GT(compared, 100000u);
+	EXPECT_GT(wins, compared / 2);
+}
+
+
+TEST_F(TablebaseTests, ProbesBoards)
+{
+	int dtz = 0;
+
+	// Mate in one, and the same position with colours swapped
+	EXPECT_EQ(probe("k7/8/1K6/8/8/8/8/6Q1 w - - 0 1", &dtz), Wdl::Win);
+	EXPECT_EQ(dtz, 1);
+	EXPECT_EQ(probe("6q1/8/8/8/8/1k6/8/K7 b - - 0 1", &dtz), Wdl::Win);
+	EXPECT_EQ(dtz, 1);
+
+	// Mated, stalemated and a rook that is lost at once
+	EXPECT_EQ(probe("k7/1Q6/1K6/8/8/8/8/8 b - - 0 1", &dtz), Wdl::Loss);
+	EXPECT_EQ(dtz, 1);
+	EXPECT_EQ(probe("k7/2Q5/1K6/8/8/8/8/8 b - - 0 1"), Wdl::Draw);
+	EXPECT_EQ(probe("8/8/8/8/8/8/1k6/1R2K3 b - - 0 1"), Wdl::Draw);
+
+	// Bare kings need no table
+	EXPECT_EQ(probe("8/8/3k4/8/8/3K4/8/8 w - - 0 1"), Wdl::Draw);
+
+	// A rook pawn with the defending king in front is a draw, a pawn escorted by its king wins
+	EXPECT_EQ(probe("8/8/8/8/8/k7/P7/K7 w - - 0 1"), Wdl::Draw);
+	EXPECT_EQ(probe("4k3/8/4P3/4K3/8/8/8/8 w - - 0 1"), Wdl::Draw);
+	EXPECT_EQ(probe("4k3/8/4K3/4P3/8/8/8/8 w - - 0 1"), Wdl::Win);
+	EXPECT_EQ(probe("4k3/8/4K3/4P3/8/8/8/8 b - - 0 1"), Wdl::Loss);
+
+	// The pawn move is the zeroing move, the distance file holds only white to move
+	EXPECT_EQ(probe("8/8/8/8/8/8/4P2k/4K3 w - - 0 1", &dtz), Wdl::Win);
+	EXPECT_EQ(dtz, 1);
+	EXPECT_EQ(probe("8/8/8/8/8/8/4P3/k3K3 b - - 0 1", &dtz), Wdl::Loss);
+	EXPECT_EQ(dtz, 2);
+}
+
+
+TEST_F(TablebaseTests, DistancesFollowTheMoves)
+{
+	// A win is one ply further from zeroing than the best reply, a loss as far as the longest one
+	TablebaseLayout layout(MaterialKey::fromCode("KRvK"));
+	size_t			checked = 0;
+
+	for (size_t index = 0; index < layout.size(); index += 31)
+	{
+		FenPosition position;
+
+		if (!layout.decode(index, position.pieces, position.side) || Fen::validate(position) != FenError::None)
+			continue;
+
+		std::string fen = Fen::toString(position);
+		GameEngine	engine;
+		engine.init();
+		ASSERT_TRUE(engine.getBoard().parseFEN(fen)) << fen;
+
+		Wdl wdl = Wdl::Draw;
+		int dtz = 0;
+		ASSERT_TRUE(mTablebase.probeDTZ(engine, wdl, dtz)) << fen;
+
+		if (wdl == Wdl::Draw)
+			continue;
+
+		MoveList moves;
+		engine.generateLegalMoves(moves);
+
+		if (moves.empty())
+		{
+			EXPECT_EQ(wdl, Wdl::Loss) << fen;
+			EXPECT_EQ(dtz, 1) << fen;
+			continue;
+		}
+
+		int best = wdl == Wdl::Win ? INT_MAX : 0;
+
+		for (const Move &move : moves)
+		{
+			ASSERT_TRUE(engine.makeMoveUnchecked(move));
+			Wdl reply		  = Wdl::Draw;
+			int replyDistance = 0;
+			ASSERT_TRUE(mTablebase.probeDTZ(engine, reply, replyDistance)) << fen;
+			engine.undoMoveUnchecked();
+
+			if (wdl == Wdl::Win && reply == Wdl::Loss)
+				best = std::min(best, replyDistance);
+			else if (wdl == Wdl::Loss)
+			{
+				EXPECT_EQ(reply, Wdl::Win) << fen;
+				best = std::max(best, replyDistance);
+			}
+		}
+
+		// Only a mated reply is 1 ply from zeroing in this material, and mate in one counts 1 ply as well
+		EXPECT_EQ(dtz, wdl == Wdl::Win && best == 1 ? 1 : best + 1) << fen;
+		++checked;
+	}
+
+	EXPECT_GT(checked, 1000u);
+}
+
+
+TEST_F(TablebaseTests, UnprobeablePositions)
+{
+	GameEngine engine;
+	engine.init();
+	Chessboard &board = engine.getBoard();
+	Wdl			wdl	  = Wdl::Draw;
+
+	// Castling rights are not part of the tables
+	ASSERT_TRUE(board.parseFEN("4k3/8/8/8/8/8/8/R3K3 w Q - 0 1"));
+	EXPECT_FALSE(mTablebase.probeWDL(engine, wdl));
+
+	// En passant captures are tried by the probe itself
+	ASSERT_TRUE(board.parseFEN("8/8/8/7k/4P3/8/8/4K3 b - e3 0 1"));
+	EXPECT_TRUE(mTablebase.probeWDL(engine, wdl));
+
+	// Material without a table
+	ASSERT_TRUE(board.parseFEN("4k3/8/8/8/8/8/8/R3K2R w - - 0 1"));
+	EXPECT_FALSE(mTablebase.probeWDL(engine, wdl));
+
+	Tablebase empty;
+	EXPECT_FALSE(empty.open((mDirectory / "missing").string()));
+	EXPECT_FALSE(empty.isOpen());
+}
+
+
+TEST_F(TablebaseTests, GenerationNeedsTheSmallerTables)
+{
+	std::filesystem::path	  directory = mDirectory / "incomplete";
+	std::filesystem::create_directories(directory);
+	TablebaseGenerationResult result;
+
+	EXPECT_FALSE(TablebaseGenerator::generate(directory.string(), "KPvK", result));
+	EXPECT_FALSE(TablebaseGenerator::generate(directory.string(), "KQvQ", result));
+	EXPECT_FALSE(TablebaseGenerator::generate(directory.string(), "KRv", result));
+}
+
+
+class TablebaseCPUTests : public TablebaseTests
+{
+protected:
+	CPUConfiguration configFor(Side side) const
+	{
+		CPUConfiguration config;
+		config.enabled			   = true;
+		config.cpuColor			   = side;
+		config.difficulty		   = CPUDifficulty::Hard;
+		config.maxDepth			   = 3;
+		config.enableRandomization = false;
+		config.enablePondering	   = false;
+		config.tablebasePath	   = mDirectory.string();
+		return config;
+	}
+};
+
+
+TEST_F(TablebaseCPUTests, SearchUsesTheTables)
+{
+	GameEngine engine;
+	engine.init();
+	ASSERT_TRUE(engine.getBoard().parseFEN("8/8/8/3k4/8/8/3r4/3QK3 w - - 0 1"));
+
+	CPUPlayer cpu(engine);
+	cpu.configure(configFor(Side::White));
+
+	// Taking the rook enters a won table position
+	Move move = cpu.calculateMove();
+	EXPECT_EQ(move.to(), Square::d2);
+	EXPECT_GT(cpu.getTablebaseHits(), 0u);
+}
+
+
+TEST_F(TablebaseCPUTests, CPUWinsTheRookEnding)
+{
+	GameEngine engine;
+	engine.init();
+	ASSERT_TRUE(engine.getBoard().parseFEN("8/8/8/4k3/8/8/8/R3K3 w - - 0 1"));
+
+	// Both sides play from the tables: the defender resists as long as possible
+	CPUPlayer white(engine);
+	CPUPlayer black(engine);
+	white.configure(configFor(Side::White));
+	black.configure(configFor(Side::Black));
+
+	int whiteMoves = 0;
+
+	while (!engine.isCheckmate() && whiteMoves < 50)
+	{
+		CPUPlayer &cpu	= engine.getBoard().getCurrentSide() == Side::White ? white : black;
+		Move	   move = cpu.calculateMove();
+		ASSERT_TRUE(move.isValid());
+		ASSERT_TRUE(engine.makeMove(move).success);
+
+		if (engine.getBoard().getCurrentSide() == Side::Black)
+		{
+			++whiteMoves;
+
+			// Every move keeps the win
+			Wdl wdl = Wdl::Draw;
+			ASSERT_TRUE(mTablebase.probeWDL(engine, wdl));
+			ASSERT_EQ(wdl, Wdl::Loss) << "after white move " << whiteMoves;
+		}
+	}
+
+	EXPECT_TRUE(engine.isCheckmate());
+	EXPECT_LE(whiteMoves, 50);
+}
+
+} // namespace TablebaseTests
@@ -0,0 +1,239 @@
+/*
+  ==============================================================================
+	Module:			TexelTuner Tests
+	Description:    Testing the tuning dataset, the loss gradient and the header output
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include "Evaluation.h"
+#include "GameEngine.h"
+#include "TexelTuner.h"
+
+
+namespace TuningTests
+{
+
+class TexelTunerTest : public ::testing::Test
+{
+protected:
+	void SetUp() override { mEngine.init(); }
+
+	/**
+	 * @brief	Positions from random games, labelled with the side ahead in material.
+	 */
+	void buildDataset(TuningDataset &dataset, int games, uint32_t seed)
+	{
+		std::mt19937 random(seed);
+
+		for (int game = 0; game < games; ++game)
+		{
+			mEngine.resetGame();
+
+			for (int ply = 0; ply < 80; ++ply)
+			{
+				MoveList moves;
+				mEngine.generateLegalMoves(moves);
+
+				if (moves.size() == 0)
+					break;
+
+				ASSERT_TRUE(mEngine.makeMoveUnchecked(moves[random() % moves.size()]));
+
+				int	   material = mgScore(mEngine.getBoard().getPieceScore());
+				double result	= material > 150 ? 1.0 : material < -150 ? 0.0 : 0.5;
+				dataset.add(mEngine, result);
+			}
+		}
+	}
+
+	GameEngine mEngine;
+};
+
+
+TEST_F(TexelTunerTest, ParseLineAcceptsResultNotations)
+{
+	std::string fen;
+	double		result = -1.0;
+
+	ASSERT_TRUE(TuningDataset::parseLine("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 c9 \"1-0\";", fen, result));
+	EXPECT_EQ(fen, "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3");
+	EXPECT_EQ(result, 1.0);
+
+	ASSERT_TRUE(TuningDataset::parseLine("8/8/4k3/8/8/4K3/8/8 w - - 0 60 [0.5]", fen, result));
+	EXPECT_EQ(fen, "8/8/4k3/8/8/4K3/8/8 w - - 0 60");
+	EXPECT_EQ(result, 0.5);
+
+	ASSERT_TRUE(TuningDataset::parseLine("8/8/4k3/8/8/4K3/8/8 w - - c9 \"0-1\";", fen, result));
+	EXPECT_EQ(result, 0.0);
+
+	ASSERT_TRUE(TuningDataset::parseLine("8/8/4k3/8/8/4K3/8/8 w - - c9 \"1/2-1/2\";", fen, result));
+	EXPECT_EQ(result, 0.5);
+
+	EXPECT_FALSE(TuningDataset::parseLine("8/8/4k3/8/8/4K3/8/8 w - -", fen, result)) << "No result";
+	EXPECT_FALSE(TuningDataset::parseLine("1-0", fen, result)) << "No position";
+}
+
+
+TEST_F(TexelTunerTest, FeaturesReproduceEvaluation)
+{
+	// Positions without captures are already quiet, the packed features must give back their evaluation
+	std::mt19937	 random(5);
+	TuningDataset	 dataset;
+	std::vector<int> expected;
+
+	for (int game = 0; game < 10; ++game)
+	{
+		mEngine.resetGame();
+
+		for (int ply = 0; ply < 100; ++ply)
+		{
+			MoveList moves;
+			mEngine.generateLegalMoves(moves);
+
+			if (moves.size() == 0)
+				break;
+
+			bool quiet = true;
+			for (size_t i = 0; i < moves.size(); ++i)
+				quiet = quiet && !moves[i].isCapture();
+
+			if (quiet)
+			{
+				int eval = Evaluation::evaluate(mEngine.getBoard());
+				expected.push_back(mEngine.getBoard().getCurrentSide() == Side::White ? eval : -eval);
+				dataset.add(mEngine, 0.5);
+			}
+
+			ASSERT_TRUE(mEngine.makeMoveUnchecked(moves[random() % moves.size()]));
+		}
+	}
+
+	ASSERT_EQ(dataset.size(), expected.size());
+	ASSERT_GT(dataset.size(), 50u);
+
+	TuningParameters params = TuningParameters::fromEvaluation();
+	TexelTuner		 tuner(dataset, 1);
+
+	for (size_t i = 0; i < dataset.size(); ++i)
+		EXPECT_NEAR(tuner.evaluate(params, i), expected[i], 1.5) << "Position " << i; // blending terms separately rounds differently
+}
+
+
+TEST_F(TexelTunerTest, ParallelGradientMatchesSingleThread)
+{
+	TuningDataset dataset;
+	buildDataset(dataset, 10, 1);
+
+	TuningParameters params = TuningParameters::fromEvaluation();
+	TuningParameters single;
+	TuningParameters parallel;
+
+	TexelTuner		 one(dataset, 1);
+	TexelTuner		 four(dataset, 4);
+
+	double			 lossOne  = one.gradient(params, single);
+	double			 lossFour = four.gradient(params, parallel);
+
+	EXPECT_NEAR(lossOne, lossFour, 1e-9);
+
+	for (int i = 0; i < TuningParameters::COUNT; ++i)
+	{
+		EXPECT_NEAR(single.mg[i], parallel.mg[i], 1e-12) << i;
+		EXPECT_NEAR(single.eg[i], parallel.eg[i], 1e-12) << i;
+	}
+}
+
+
+TEST_F(TexelTunerTest, TuningReducesLoss)
+{
+	TuningDataset dataset;
+	buildDataset(dataset, 20, 2);
+
+	TuningParameters params = TuningParameters::fromEvaluation();
+	TexelTuner		 tuner(dataset);
+
+	tuner.fitScalingConstant(params);
+	double before = tuner.loss(params);
+	double after  = tuner.tune(params, 30, 2.0);
+
+	EXPECT_LT(after, before);
+	EXPECT_EQ(params.mg[TuningParameters::materialIndex(0)], 0.0) << "The king has no material value";
+}
+
+
+TEST_F(TexelTunerTest, LoadIsIndependentOfThreadCount)
+{
+	auto path = (std::filesystem::temp_directory_path() / "texel_tuner_test.epd").string();
+
+	{
+		std::ofstream file(path);
+		file << "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 c9 \"1/2-1/2\";\n"
+			 << "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - c9 \"1-0\";\n"
+			 << "not a position\n"
+			 << "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1 [0.0]\n"
+			 << "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8 [1.0]\n"
+			 << "8/8/8/8/8/8/8/8 w - - [0.5]\n";
+	}
+
+	TuningDataset single;
+	TuningDataset parallel;
+
+	ASSERT_TRUE(single.load(path, 1));
+	ASSERT_TRUE(parallel.load(path, 3));
+	std::filesystem::remove(path);
+
+	EXPECT_EQ(single.size(), 4u);
+	EXPECT_EQ(single.getSkipped(), 2u) << "Lines without a result or without kings are skipped";
+	ASSERT_EQ(parallel.size(), single.size());
+
+	TuningParameters params = TuningParameters::fromEvaluation();
+	TexelTuner		 tunerSingle(single, 1);
+	TexelTuner		 tunerParallel(parallel, 1);
+
+	for (size_t i = 0; i < single.size(); ++i)
+	{
+		EXPECT_EQ(parallel.position(i).result, single.position(i).result);
+		EXPECT_EQ(tunerParallel.evaluate(params, i), tunerSingle.evaluate(params, i));
+	}
+}
+
+
+TEST_F(TexelTunerTest, HeaderContainsTables)
+{
+	auto path = (std::filesystem::temp_directory_path() / "TunedParametersTest.h").string();
+
+	ASSERT_TRUE(TexelTuner::writeHeader(TuningParameters::fromEvaluation(), path));
+
+	std::ifstream	  file(path);
+	std::stringstream content;
+	content << file.rdbuf();
+	file.close();
+	std::filesystem::remove(path);
+
+	EXPECT_NE(content.str().find("constexpr int MATERIAL_MG[6] = {0, 900, 100, 320, 330, 500};"), std::string::npos);
+	EXPECT_NE(content.str().find("constexpr int PST_EG[6][64] ="), std::string::npos);
+	EXPECT_NE(content.str().find("namespace TunedParameters"), std::string::npos);
+}
+
+
+TEST_F(TexelTunerTest, TunedValuesConvertToRuntimeWeights)
+{
+	TuningParameters params = TuningParameters::fromEvaluation();
+	EXPECT_EQ(params.toWeights(), EvalWeights::defaults());
+
+	params.mg[TuningParameters::materialIndex(WKnight)] = 341.6;
+	params.eg[TuningParameters::pstIndex(WPawn, 20)]	= -12.4;
+
+	EvalWeights weights									= params.toWeights();
+	EXPECT_EQ(weights.material[WKnight], makeScore(342, PieceValues::KNIGHT));
+	EXPECT_EQ(egScore(weights.pst[WPawn][20]), -12);
+	EXPECT_EQ(weights.mobility[0], EvalWeights::defaults().mobility[0]);
+}
+
+} // namespace TuningTests
@@ -0,0 +1,288 @@
+/*
+  ==============================================================================
+	Module:			UciEngine Tests
+	Description:    Testing the UCI front-end command handling and search control
+  ==============================================================================
+*/
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "UciEngine.h"
+#include "Notation/MoveNotation.h"
+
+
+namespace UciTests
+{
+
+using namespace std::chrono_literals;
+
+
+TEST(UciGoTests, ParseReadsAllLimits)
+{
+	UciGoParameters params;
+
+	ASSERT_TRUE(UciEngine::parseGo("wtime 60000 btime 55000 winc 1000 binc 500 movestogo 20 depth 12 nodes 500000", params));
+	EXPECT_EQ(params.whiteTimeMs, 60000);
+	EXPECT_EQ(params.blackTimeMs, 55000);
+	EXPECT_EQ(params.whiteIncMs, 1000);
+	EXPECT_EQ(params.blackIncMs, 500);
+	EXPECT_EQ(params.movesToGo, 20);
+	EXPECT_EQ(params.depth, 12);
+	EXPECT_EQ(params.nodes, 500000u);
+	EXPECT_FALSE(params.infinite);
+
+	ASSERT_TRUE(UciEngine::parseGo("ponder movetime 250", params));
+	EXPECT_TRUE(params.ponder);
+	EXPECT_EQ(params.moveTimeMs, 250);
+	EXPECT_EQ(params.depth, 0) << "Every command starts from cleared limits";
+
+	ASSERT_TRUE(UciEngine::parseGo("", params));
+	ASSERT_TRUE(UciEngine::parseGo("infinite", params));
+	EXPECT_TRUE(params.infinite);
+}
+
+
+TEST(UciGoTests, ParseRejectsMalformedCommands)
+{
+	UciGoParameters params;
+
+	EXPECT_FALSE(UciEngine::parseGo("depth", params)) << "Missing value";
+	EXPECT_FALSE(UciEngine::parseGo("depth x", params));
+	EXPECT_FALSE(UciEngine::parseGo("depth 0", params));
+	EXPECT_FALSE(UciEngine::parseGo("nodes -5", params));
+	EXPECT_FALSE(UciEngine::parseGo("mate 3", params)) << "Unsupported keyword";
+}
+
+
+TEST(UciGoTests, AllocateTimeFollowsTheClock)
+{
+	UciGoParameters params;
+
+	EXPECT_EQ(UciEngine::allocateTime(params, Side::White), 0) << "No clock, no deadline";
+
+	params.moveTimeMs = 1000;
+	EXPECT_EQ(UciEngine::allocateTime(params, Side::Black), 1000 - UciEngine::MOVE_OVERHEAD_MS);
+
+	params			   = UciGoParameters();
+	params.whiteTimeMs = 60000;
+	params.blackTimeMs = 3000;
+	params.whiteIncMs  = 1000;
+
+	EXPECT_EQ(UciEngine::allocateTime(params, Side::White), 60000 / UciEngine::DEFAULT_MOVES_TO_GO + 750);
+	EXPECT_EQ(UciEngine::allocateTime(params, Side::Black), 3000 / UciEngine::DEFAULT_MOVES_TO_GO);
+
+	params.movesToGo = 2;
+	EXPECT_EQ(UciEngine::allocateTime(params, Side::Black), 1500) << "Time is split over the moves to the next control";
+
+	params.blackTimeMs = 20;
+	EXPECT_EQ(UciEngine::allocateTime(params, Side::Black), 1) << "Almost flagged: move immediately";
+}
+
+
+class UciEngineTests : public ::testing::Test
+{
+protected:
+	std::mutex				 mMutex;
+	std::condition_variable	 mChanged;
+	std::vector<std::string> mLines;
+
+	UciEngine				 mUci{[this](const std::string &line)
+					  {
+						  {
+							  std::lock_guard<std::mutex> lock(mMutex);
+							  mLines.push_back(line);
+						  }
+						  mChanged.notify_all();
+					  }};
+
+	void					 TearDown() override { mUci.handleCommand("quit"); }
+
+	/**
+	 * @brief	Wait for an output line starting with prefix and return it (empty on timeout).
+	 */
+	std::string				 waitFor(const std::string &prefix, std::chrono::milliseconds timeout)
+	{
+		std::unique_lock<std::mutex> lock(mMutex);
+		std::string					 found;
+
+		mChanged.wait_for(lock, timeout,
+						  [&]
+						  {
+							  for (const auto &line : mLines)
+							  {
+								  if (line.rfind(prefix, 0) == 0)
+								  {
+									  found = line;
+									  return true;
+								  }
+							  }
+							  return false;
+						  });
+
+		return found;
+	}
+
+	std::vector<std::string> lines()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		return mLines;
+	}
+
+	bool					 isLegal(const std::string &uciMove)
+	{
+		GameEngine engine;
+		engine.snapshotFrom(mUci.getEngine());
+
+		MoveList moves;
+		engine.generateLegalMoves(moves);
+
+		for (Move move : moves)
+		{
+			if (MoveNotation::toUCI(move) == uciMove)
+				return true;
+		}
+
+		return false;
+	}
+
+	static std::string		 moveOf(const std::string &bestMoveLine) { return bestMoveLine.substr(9, bestMoveLine.find(' ', 9) - 9); }
+};
+
+
+TEST_F(UciEngineTests, HandshakeListsOptions)
+{
+	mUci.handleCommand("uci");
+	mUci.handleCommand("isready");
+
+	auto output = lines();
+
+	ASSERT_GE(output.size(), 4u);
+	EXPECT_EQ(output.front().rfind("id name", 0), 0u);
+	EXPECT_NE(std::find(output.begin(), output.end(), "option name Hash type spin default 64 min 1 max 4096"), output.end());
+	EXPECT_NE(std::find(output.begin(), output.end(), "uciok"), output.end());
+	EXPECT_EQ(output.back(), "readyok");
+}
+
+
+TEST_F(UciEngineTests, PositionAppliesMoves)
+{
+	mUci.handleCommand("position startpos moves g1f3 g8f6 b1c3");
+
+	GameEngine expected;
+	expected.init();
+	expected.getBoard().parseFEN("rnbqkb1r/pppppppp/5n2/8/8/2N2N2/PPPPPPPP/R1BQKB1R b KQkq - 3 2");
+
+	EXPECT_EQ(mUci.getEngine().getBoard().getHash(), expected.getBoard().getHash());
+	EXPECT_EQ(mUci.getEngine().getBoard().getCurrentSide(), Side::Black);
+
+	mUci.handleCommand("position fen 8/4k3/8/4K3/4P3/8/8/8 w - - 0 1 moves e5d5");
+	expected.getBoard().parseFEN("8/4k3/8/3K4/4P3/8/8/8 b - - 1 1");
+
+	EXPECT_EQ(mUci.getEngine().getBoard().getHash(), expected.getBoard().getHash());
+}
+
+
+TEST_F(UciEngineTests, IllegalMoveIsReported)
+{
+	mUci.handleCommand("position startpos moves e2e4 e7e4");
+
+	EXPECT_FALSE(waitFor("info string Illegal move e7e4", 0ms).empty());
+	EXPECT_EQ(mUci.getEngine().getBoard().getCurrentSide(), Side::Black) << "Moves up to the illegal one are kept";
+}
+
+
+TEST_F(UciEngineTests, GoDepthStreamsInfoAndBestMove)
+{
+	mUci.handleCommand("position startpos");
+	mUci.handleCommand("go depth 3");
+
+	std::string bestMove = waitFor("bestmove", 30s);
+	ASSERT_FALSE(bestMove.empty());
+	EXPECT_TRUE(isLegal(moveOf(bestMove))) << bestMove;
+	EXPECT_FALSE(mUci.isSearching());
+
+	auto output = lines();
+	auto info	= std::find_if(output.begin(), output.end(), [](const std::string &line) { return line.rfind("info depth 3 ", 0) == 0; });
+
+	ASSERT_NE(info, output.end()) << "The final iteration is reported before the best move";
+	EXPECT_NE(info->find(" score cp "), std::string::npos);
+	EXPECT_NE(info->find(" pv "), std::string::npos);
+	EXPECT_LT(info - output.begin(), std::find(output.begin(), output.end(), bestMove) - output.begin());
+}
+
+
+TEST_F(UciEngineTests, StopEndsInfiniteSearch)
+{
+	mUci.handleCommand("position fen r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+	mUci.handleCommand("go infinite");
+
+	ASSERT_FALSE(waitFor("info depth", 30s).empty());
+	EXPECT_TRUE(waitFor("bestmove", 200ms).empty()) << "An infinite search only ends on stop";
+
+	auto start = std::chrono::steady_clock::now();
+	mUci.handleCommand("stop");
+
+	std::string bestMove = waitFor("bestmove", 5s);
+	auto		elapsed	 = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+	ASSERT_FALSE(bestMove.empty());
+	EXPECT_TRUE(isLegal(moveOf(bestMove))) << bestMove;
+	EXPECT_LT(elapsed, 1000ms) << "Stop is answered without finishing the iteration";
+}
+
+
+TEST_F(UciEngineTests, MoveTimeEndsTheSearch)
+{
+	mUci.handleCommand("position startpos");
+
+	auto start = std::chrono::steady_clock::now();
+	mUci.handleCommand("go movetime 300");
+
+	std::string bestMove = waitFor("bestmove", 10s);
+	auto		elapsed	 = std::chrono::steady_clock::now() - start;
+
+	ASSERT_FALSE(bestMove.empty());
+	EXPECT_TRUE(isLegal(moveOf(bestMove)));
+	EXPECT_LT(elapsed, 3s);
+}
+
+
+TEST_F(UciEngineTests, PonderSearchWaitsForPonderHit)
+{
+	mUci.handleCommand("position startpos moves e2e4");
+	mUci.handleCommand("go ponder wtime 2000 btime 2000");
+
+	EXPECT_TRUE(waitFor("bestmove", 500ms).empty()) << "A ponder search never ends on its own clock";
+
+	mUci.handleCommand("ponderhit");
+
+	std::string bestMove = waitFor("bestmove", 10s);
+	ASSERT_FALSE(bestMove.empty());
+	EXPECT_TRUE(isLegal(moveOf(bestMove)));
+}
+
+
+TEST_F(UciEngineTests, MultiPVReportsRankedLines)
+{
+	mUci.handleCommand("setoption name MultiPV value 3");
+	mUci.handleCommand("position startpos");
+	mUci.handleCommand("go depth 3");
+
+	ASSERT_FALSE(waitFor("bestmove", 30s).empty());
+
+	EXPECT_FALSE(waitFor("info depth 3 seldepth", 0ms).empty());
+
+	auto output = lines();
+	bool second = std::any_of(output.begin(), output.end(), [](const std::string &line) { return line.find(" multipv 2 ") != std::string::npos; });
+	bool third	= std::any_of(output.begin(), output.end(), [](const std::string &line) { return line.find(" multipv 3 ") != std::string::npos; });
+
+	EXPECT_TRUE(second);
+	EXPECT_TRUE(third);
+}
+
+} // namespace UciTests
@@ -27,6 +27,7 @@ namespace Chess.UI.Services
         event Action LegalMovesCalculated;
         event Action PawnPromotionRequired;
         event Action BoardStateChanged;
+        event Action<SearchInfoEvent> SearchInfoReceived;
     }
 
 
@@ -51,6 +52,7 @@ namespace Chess.UI.Services
             BoardStateChanged = 9,
             PawnPromotion = 10,
             LegalMovesCalculated = 11,
+            SearchInfo = 12,
         }
 
 
@@ -129,6 +131,10 @@ namespace Chess.UI.Services
                         HandleLegalMovesCalculated();
                         break;
 
+                    case DelegateMessage.SearchInfo:
+                        HandleSearchInfo(data);
+                        break;
+
                     default:
                         Logger.LogWarning($"Unhandled delegate message: {delegateMessage}");
                         break;
@@ -182,6 +188,21 @@ namespace Chess.UI.Services
         }
 
 
+        private void HandleSearchInfo(nint data)
+        {
+            if (data == nint.Zero)
+            {
+                Logger.LogError("HandleSearchInfo received null data pointer");
+                return;
+            }
+
+            SearchInfoEvent searchInfo = Marshal.PtrToStructure<SearchInfoEvent>(data);
+
+            Logger.LogDebug($"Search info: depth={searchInfo.depth} score={searchInfo.score} nodes={searchInfo.nodes} pv={searchInfo.pv}");
+            SearchInfoReceived?.Invoke(searchInfo);
+        }
+
+
         private void HandlePawnPromotionRequired()
         {
             Logger.LogInfo("Pawn promotion required");
@@ -302,6 +323,7 @@ namespace Chess.UI.Services
         public event Action LegalMovesCalculated;
         public event Action PawnPromotionRequired;
         public event Action BoardStateChanged;
+        public event Action<SearchInfoEvent> SearchInfoReceived;
 
         #endregion
 
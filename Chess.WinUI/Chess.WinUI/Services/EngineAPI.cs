@@ -442,5 +442,24 @@ namespace Chess.UI.Services
             public string moveNotation;
         }
 
+
+        [StructLayout(LayoutKind.Sequential, CharSet = CharSet.Ansi)]
+        public struct SearchInfoEvent
+        {
+            public int depth;
+            public int selDepth;
+            public int score;           // Centipawns from the CPU's point of view
+            public int mateIn;          // Moves to mate (negative if the CPU gets mated), 0 if none
+            public ulong nodes;
+            public ulong nps;
+            public int hashFull;        // Permille
+            public int timeMs;
+            public int pondering;
+            public int pvLength;
+
+            [MarshalAs(UnmanagedType.ByValTStr, SizeConst = 250)]
+            public string pv;           // UCI moves, space separated
+        }
+
     }
 }